@@ -99,5 +99,14 @@ int main(int argc, char** argv)
     std::cout << "\nStopping recording.\n";
     mavsdk.stop_tlog_recording();
 
+    const auto stats = mavsdk.tlog_stats();
+    std::cout << "Wrote " << stats.messages_written << " messages (" << stats.bytes_written
+              << " bytes)";
+    if (stats.messages_dropped > 0) {
+        std::cout << ", dropped " << stats.messages_dropped << " messages ("
+                  << stats.bytes_dropped << " bytes)";
+    }
+    std::cout << ".\n";
+
     return 0;
 }
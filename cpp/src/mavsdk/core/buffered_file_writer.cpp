@@ -0,0 +1,176 @@
+#include "buffered_file_writer.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include "log.hpp"
+
+namespace mavsdk {
+
+BufferedFileWriter::BufferedFileWriter(Options options) : _options(options)
+{
+    // Without a minimum the writer thread would spin.
+    _options.flush_interval = std::max(_options.flush_interval, std::chrono::milliseconds(1));
+}
+
+BufferedFileWriter::~BufferedFileWriter()
+{
+    stop();
+}
+
+bool BufferedFileWriter::start(const std::string& path, const std::vector<uint8_t>& file_header)
+{
+    if (_thread.joinable()) {
+        LogErr("Already writing to file");
+        return false;
+    }
+
+    _stream.open(path, std::ios::binary | std::ios::trunc);
+    if (!_stream.is_open()) {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        // Both buffers are allocated once and swapped, so recording does not allocate.
+        _active.reserve(_options.buffer_size);
+        _pending.reserve(_options.buffer_size);
+        _should_exit = false;
+        _failed = false;
+    }
+
+    if (!file_header.empty() && !write_to_disk(file_header)) {
+        _stream.close();
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _running = true;
+    }
+
+    _thread = std::thread(&BufferedFileWriter::run, this);
+    return true;
+}
+
+void BufferedFileWriter::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_running) {
+            return;
+        }
+        _should_exit = true;
+    }
+    _cv.notify_one();
+
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _running = false;
+    }
+
+    if (_stream.is_open()) {
+        _stream.close();
+    }
+}
+
+bool BufferedFileWriter::write_record(
+    const uint8_t* header, std::size_t header_len, const uint8_t* data, std::size_t len)
+{
+    const std::size_t record_len = header_len + len;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (!_running || _should_exit) {
+        return false;
+    }
+
+    if (_failed || record_len > _options.buffer_size) {
+        ++_stats.records_dropped;
+        _stats.bytes_dropped += record_len;
+        return false;
+    }
+
+    if (_active.size() + record_len > _options.buffer_size) {
+        if (!_pending.empty()) {
+            // The writer has not caught up yet, drop rather than grow or block.
+            ++_stats.records_dropped;
+            _stats.bytes_dropped += record_len;
+            return false;
+        }
+        std::swap(_active, _pending);
+        std::swap(_active_records, _pending_records);
+        _cv.notify_one();
+    }
+
+    _active.insert(_active.end(), header, header + header_len);
+    _active.insert(_active.end(), data, data + len);
+    ++_active_records;
+    return true;
+}
+
+BufferedFileWriter::Stats BufferedFileWriter::stats() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+void BufferedFileWriter::run()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    while (true) {
+        _cv.wait_for(
+            lock, _options.flush_interval, [this]() { return _should_exit || !_pending.empty(); });
+
+        if (_pending.empty()) {
+            // Flush interval passed (or exiting): take whatever has accumulated.
+            std::swap(_active, _pending);
+            std::swap(_active_records, _pending_records);
+        }
+
+        if (!_pending.empty()) {
+            // write_record() does not touch the pending buffer while it is not
+            // empty, so it can be written without holding the lock.
+            lock.unlock();
+            const bool success = write_to_disk(_pending);
+            lock.lock();
+
+            if (success) {
+                _stats.records_written += _pending_records;
+                _stats.bytes_written += _pending.size();
+            } else {
+                if (!_failed) {
+                    LogErr("Writing to file failed, stopping");
+                }
+                _failed = true;
+                _stats.records_dropped += _pending_records;
+                _stats.bytes_dropped += _pending.size();
+            }
+            _pending.clear();
+            _pending_records = 0;
+        }
+
+        if (_should_exit && _active.empty()) {
+            break;
+        }
+    }
+}
+
+bool BufferedFileWriter::write_to_disk(const std::vector<uint8_t>& buffer)
+{
+    if (_failed) {
+        return false;
+    }
+
+    _stream.write(
+        reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    _stream.flush();
+    return _stream.good();
+}
+
+} // namespace mavsdk
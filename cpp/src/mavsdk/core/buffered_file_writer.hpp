@@ -0,0 +1,87 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mavsdk_export.h"
+
+namespace mavsdk {
+
+/*
+ * Writes records to a file on a background thread.
+ *
+ * write_record() only copies the record (a header followed by the data, e.g.
+ * a timestamp and a MAVLink frame) into the active buffer. The writer thread
+ * swaps it with the second buffer and writes it to disk in one large write,
+ * either when it is full or when the flush interval has passed.
+ *
+ * Memory is bounded to the two buffers: if the active buffer is full while
+ * the writer is still busy with the other one (e.g. a slow SD card), the
+ * record is dropped and counted in the stats instead of blocking the caller.
+ *
+ * write_record() and stats() are thread-safe, start() and stop() must not be
+ * called concurrently with each other.
+ */
+class MAVSDK_TEST_EXPORT BufferedFileWriter {
+public:
+    struct Options {
+        std::chrono::milliseconds flush_interval{500};
+        std::size_t buffer_size{256 * 1024};
+    };
+
+    struct Stats {
+        uint64_t records_written{0};
+        uint64_t bytes_written{0};
+        uint64_t records_dropped{0};
+        uint64_t bytes_dropped{0};
+    };
+
+    explicit BufferedFileWriter(Options options);
+    ~BufferedFileWriter();
+
+    BufferedFileWriter(const BufferedFileWriter&) = delete;
+    BufferedFileWriter& operator=(const BufferedFileWriter&) = delete;
+
+    // Opens (truncates) the file, writes file_header, and starts the writer thread.
+    bool start(const std::string& path, const std::vector<uint8_t>& file_header = {});
+
+    // Writes everything still buffered, stops the writer thread and closes the file.
+    void stop();
+
+    // Returns false if the record was dropped (or the writer is not running).
+    bool write_record(
+        const uint8_t* header, std::size_t header_len, const uint8_t* data, std::size_t len);
+
+    Stats stats() const;
+
+private:
+    void run();
+    bool write_to_disk(const std::vector<uint8_t>& buffer);
+
+    Options _options;
+
+    std::ofstream _stream{};
+    std::thread _thread{};
+
+    mutable std::mutex _mutex{};
+    std::condition_variable _cv{};
+    // Filled by write_record().
+    std::vector<uint8_t> _active{};
+    // Owned by the writer thread while it is not empty.
+    std::vector<uint8_t> _pending{};
+    std::size_t _active_records{0};
+    std::size_t _pending_records{0};
+    bool _should_exit{false};
+    bool _running{false};
+    bool _failed{false};
+    Stats _stats{};
+};
+
+} // namespace mavsdk
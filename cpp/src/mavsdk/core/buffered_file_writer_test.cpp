@@ -0,0 +1,218 @@
+#include "buffered_file_writer.hpp"
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mavsdk;
+
+namespace {
+
+std::string temp_path(const std::string& name)
+{
+    return testing::TempDir() + name;
+}
+
+std::vector<uint8_t> read_file(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+constexpr std::size_t header_len = 8;
+
+// Header as in .tlog files: the timestamp as 8 bytes big-endian.
+std::array<uint8_t, header_len> header_for(uint64_t value)
+{
+    std::array<uint8_t, header_len> header{};
+    for (std::size_t i = 0; i < header_len; ++i) {
+        header[i] = static_cast<uint8_t>(value >> (8 * (header_len - 1 - i)));
+    }
+    return header;
+}
+
+bool write(BufferedFileWriter& writer, uint64_t header_value, const uint8_t* data, std::size_t len)
+{
+    const auto header = header_for(header_value);
+    return writer.write_record(header.data(), header.size(), data, len);
+}
+
+} // namespace
+
+TEST(BufferedFileWriter, WritesHeaderAndData)
+{
+    const auto path = temp_path("buffered_file_writer_record.bin");
+
+    BufferedFileWriter writer({});
+    ASSERT_TRUE(writer.start(path));
+
+    const std::array<uint8_t, 3> frame{0xFD, 0x01, 0x02};
+    EXPECT_TRUE(write(writer, 0x0102030405060708, frame.data(), frame.size()));
+    writer.stop();
+
+    const std::vector<uint8_t> expected{
+        0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0xFD, 0x01, 0x02};
+    EXPECT_EQ(read_file(path), expected);
+
+    const auto stats = writer.stats();
+    EXPECT_EQ(stats.records_written, 1u);
+    EXPECT_EQ(stats.bytes_written, expected.size());
+    EXPECT_EQ(stats.records_dropped, 0u);
+    EXPECT_EQ(stats.bytes_dropped, 0u);
+
+    std::remove(path.c_str());
+}
+
+TEST(BufferedFileWriter, FlushesAfterInterval)
+{
+    const auto path = temp_path("buffered_file_writer_interval.bin");
+
+    BufferedFileWriter::Options options;
+    options.flush_interval = std::chrono::milliseconds(10);
+    BufferedFileWriter writer(options);
+    ASSERT_TRUE(writer.start(path));
+
+    const std::array<uint8_t, 4> frame{1, 2, 3, 4};
+    write(writer, 1, frame.data(), frame.size());
+
+    // Without calling stop(), the record shows up once the interval passed.
+    for (int i = 0; i < 200 && writer.stats().records_written == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(writer.stats().records_written, 1u);
+    EXPECT_EQ(read_file(path).size(), header_len + frame.size());
+
+    writer.stop();
+    std::remove(path.c_str());
+}
+
+TEST(BufferedFileWriter, KeepsRecordsInOrder)
+{
+    const auto path = temp_path("buffered_file_writer_order.bin");
+
+    BufferedFileWriter::Options options;
+    options.buffer_size = 1024;
+    BufferedFileWriter writer(options);
+    ASSERT_TRUE(writer.start(path));
+
+    constexpr unsigned num_records = 1000;
+    std::array<uint8_t, 20> frame{};
+    for (unsigned i = 0; i < num_records; ++i) {
+        frame[0] = static_cast<uint8_t>(i >> 8);
+        frame[1] = static_cast<uint8_t>(i);
+        write(writer, i, frame.data(), frame.size());
+    }
+    writer.stop();
+
+    const auto stats = writer.stats();
+    EXPECT_EQ(stats.records_written + stats.records_dropped, num_records);
+
+    const auto content = read_file(path);
+    const size_t record_len = header_len + frame.size();
+    ASSERT_EQ(content.size(), stats.records_written * record_len);
+
+    // Some records might have been dropped, but the rest is in order.
+    int last_index = -1;
+    for (size_t offset = 0; offset < content.size(); offset += record_len) {
+        const uint8_t* record = &content[offset];
+        const int index =
+            (record[header_len] << 8) | record[header_len + 1];
+        EXPECT_EQ(index, (record[6] << 8) | record[7]);
+        EXPECT_GT(index, last_index);
+        last_index = index;
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST(BufferedFileWriter, DropsWhenBothBuffersAreFull)
+{
+    const auto path = temp_path("buffered_file_writer_drop.bin");
+
+    BufferedFileWriter::Options options;
+    // Long interval, so only a full buffer gets the writer going.
+    options.flush_interval = std::chrono::seconds(10);
+    options.buffer_size = 100;
+    BufferedFileWriter writer(options);
+    ASSERT_TRUE(writer.start(path));
+
+    const std::array<uint8_t, 42> frame{};
+    const size_t record_len = header_len + frame.size();
+    constexpr unsigned num_records = 1000;
+    for (unsigned i = 0; i < num_records; ++i) {
+        write(writer, i, frame.data(), frame.size());
+    }
+    writer.stop();
+
+    const auto stats = writer.stats();
+    EXPECT_GT(stats.records_dropped, 0u);
+    EXPECT_EQ(stats.records_written + stats.records_dropped, num_records);
+    EXPECT_EQ(stats.bytes_dropped, stats.records_dropped * record_len);
+    EXPECT_EQ(read_file(path).size(), stats.bytes_written);
+
+    std::remove(path.c_str());
+}
+
+TEST(BufferedFileWriter, DropsRecordLargerThanBuffer)
+{
+    const auto path = temp_path("buffered_file_writer_large.bin");
+
+    BufferedFileWriter::Options options;
+    options.buffer_size = 16;
+    BufferedFileWriter writer(options);
+    ASSERT_TRUE(writer.start(path));
+
+    const std::array<uint8_t, 32> frame{};
+    EXPECT_FALSE(write(writer, 0, frame.data(), frame.size()));
+    writer.stop();
+
+    const auto stats = writer.stats();
+    EXPECT_EQ(stats.records_written, 0u);
+    EXPECT_EQ(stats.records_dropped, 1u);
+    EXPECT_EQ(stats.bytes_dropped, header_len + frame.size());
+
+    std::remove(path.c_str());
+}
+
+TEST(BufferedFileWriter, WritesFileHeaderFirst)
+{
+    const auto path = temp_path("buffered_file_writer_file_header.bin");
+
+    BufferedFileWriter writer({});
+    ASSERT_TRUE(writer.start(path, {'H', 'D', 'R'}));
+
+    const std::array<uint8_t, 2> frame{0xAA, 0xBB};
+    EXPECT_TRUE(write(writer, 1, frame.data(), frame.size()));
+    writer.stop();
+
+    const std::vector<uint8_t> expected{'H', 'D', 'R', 0, 0, 0, 0, 0, 0, 0, 1, 0xAA, 0xBB};
+    EXPECT_EQ(read_file(path), expected);
+    // The file header is not counted as a record.
+    EXPECT_EQ(writer.stats().records_written, 1u);
+
+    std::remove(path.c_str());
+}
+
+TEST(BufferedFileWriter, IgnoresRecordsWhenNotStarted)
+{
+    BufferedFileWriter writer({});
+
+    const std::array<uint8_t, 4> frame{};
+    EXPECT_FALSE(write(writer, 0, frame.data(), frame.size()));
+    writer.stop();
+
+    const auto stats = writer.stats();
+    EXPECT_EQ(stats.records_written, 0u);
+    EXPECT_EQ(stats.records_dropped, 0u);
+}
+
+TEST(BufferedFileWriter, FailsToStartWithInvalidPath)
+{
+    BufferedFileWriter writer({});
+    EXPECT_FALSE(writer.start("/nonexistent-directory/file.bin"));
+}
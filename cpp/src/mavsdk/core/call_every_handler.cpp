@@ -1,11 +1,20 @@
 #include "call_every_handler.hpp"
 
 #include <utility>
-#include <algorithm>
 #include <vector>
 
 namespace mavsdk {
 
+namespace {
+
+SteadyTimePoint deadline_after(SteadyTimePoint last_time, double interval_s)
+{
+    Time::shift_steady_time_by(last_time, interval_s);
+    return last_time;
+}
+
+} // namespace
+
 CallEveryHandler::CallEveryHandler(Time& time) : _time(time) {}
 
 CallEveryHandler::Cookie CallEveryHandler::add(std::function<void()> callback, double interval_s)
@@ -18,44 +27,55 @@ CallEveryHandler::Cookie CallEveryHandler::add(std::function<void()> callback, d
     _time.shift_steady_time_by(before, -interval_s - 0.001);
     new_entry.last_time = before;
     new_entry.interval_s = interval_s;
-    std::lock_guard<std::recursive_mutex> lock(_mutex);
-    new_entry.cookie = _next_cookie++;
-    _entries.push_back(new_entry);
 
-    return new_entry.cookie;
+    Cookie cookie;
+    bool earliest;
+    {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        cookie = _next_cookie++;
+        const auto deadline = deadline_after(new_entry.last_time, interval_s);
+        earliest = is_earliest(deadline);
+        _entries.push(deadline, cookie, std::move(new_entry));
+    }
+
+    if (earliest && _earlier_deadline_callback) {
+        _earlier_deadline_callback();
+    }
+
+    return cookie;
 }
 
 void CallEveryHandler::change(double interval_s, Cookie cookie)
 {
-    std::lock_guard<std::recursive_mutex> lock(_mutex);
-    auto it = std::find_if(_entries.begin(), _entries.end(), [&](const Entry& entry) {
-        return entry.cookie == cookie;
-    });
-    if (it != _entries.end()) {
-        it->interval_s = interval_s;
+    bool earliest = false;
+    {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        if (auto* entry = _entries.find(cookie)) {
+            entry->interval_s = interval_s;
+            earliest = is_earliest(deadline_after(entry->last_time, interval_s));
+            update_deadline(cookie, *entry);
+        }
+    }
+
+    if (earliest && _earlier_deadline_callback) {
+        _earlier_deadline_callback();
     }
 }
 
 void CallEveryHandler::reset(Cookie cookie)
 {
+    // Resetting only ever moves a deadline later, so nobody needs to be woken up.
     std::lock_guard<std::recursive_mutex> lock(_mutex);
-    auto it = std::find_if(_entries.begin(), _entries.end(), [&](const Entry& entry) {
-        return entry.cookie == cookie;
-    });
-    if (it != _entries.end()) {
-        it->last_time = _time.steady_time();
+    if (auto* entry = _entries.find(cookie)) {
+        entry->last_time = _time.steady_time();
+        update_deadline(cookie, *entry);
     }
 }
 
 void CallEveryHandler::remove(Cookie cookie)
 {
     std::lock_guard<std::recursive_mutex> lock(_mutex);
-    auto it = std::find_if(
-        _entries.begin(), _entries.end(), [&](auto& timeout) { return timeout.cookie == cookie; });
-
-    if (it != _entries.end()) {
-        _entries.erase(it);
-    }
+    _entries.remove(cookie);
 }
 
 void CallEveryHandler::run_once()
@@ -66,17 +86,26 @@ void CallEveryHandler::run_once()
 
     {
         std::lock_guard<std::recursive_mutex> lock(_mutex);
+        const auto now = _time.steady_time();
+
+        while (!_entries.empty() && _entries.top().deadline < now) {
+            const Cookie cookie = _entries.top().cookie;
+            Entry& entry = *_entries.find(cookie);
 
-        for (auto& entry : _entries) {
-            if (_time.elapsed_since_s(entry.last_time) > double(entry.interval_s)) {
-                // Update the timestamp before potentially executing
-                _time.shift_steady_time_by(entry.last_time, double(entry.interval_s));
+            // Update the timestamp before potentially executing. If we fell
+            // behind by more than one interval, skip the missed calls instead
+            // of firing them back to back.
+            _time.shift_steady_time_by(entry.last_time, entry.interval_s);
+            if (!(now < deadline_after(entry.last_time, entry.interval_s))) {
+                entry.last_time = now;
+            }
 
-                // Store the callback for later execution
-                if (entry.callback) {
-                    callbacks_to_execute.push_back(entry.callback);
-                }
+            // Store the callback for later execution
+            if (entry.callback) {
+                callbacks_to_execute.push_back(entry.callback);
             }
+
+            update_deadline(cookie, entry);
         }
     }
 
@@ -86,4 +115,28 @@ void CallEveryHandler::run_once()
     }
 }
 
+std::optional<SteadyTimePoint> CallEveryHandler::next_deadline()
+{
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    if (_entries.empty()) {
+        return std::nullopt;
+    }
+    return _entries.top().deadline;
+}
+
+void CallEveryHandler::set_earlier_deadline_callback(std::function<void()> callback)
+{
+    _earlier_deadline_callback = std::move(callback);
+}
+
+void CallEveryHandler::update_deadline(Cookie cookie, Entry& entry)
+{
+    _entries.update(cookie, deadline_after(entry.last_time, entry.interval_s));
+}
+
+bool CallEveryHandler::is_earliest(SteadyTimePoint deadline) const
+{
+    return _entries.empty() || deadline < _entries.top().deadline;
+}
+
 } // namespace mavsdk
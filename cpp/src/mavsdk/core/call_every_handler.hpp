@@ -4,7 +4,8 @@
 #include <mutex>
 #include <memory>
 #include <functional>
-#include <list>
+#include <optional>
+#include "deadline_heap.hpp"
 #include "mavsdk_time.hpp"
 #include "mavsdk_export.h"
 
@@ -30,16 +31,29 @@ public:
 
     void run_once();
 
+    // When run_once() next has something to do, if anything is registered.
+    std::optional<SteadyTimePoint> next_deadline();
+
+    // Called whenever an entry becomes due before all others (e.g. when one is
+    // added, since it is called straightaway), so that whoever sleeps until
+    // next_deadline() can wake up earlier. It is called without holding any
+    // lock and must be set before the handler is shared between threads.
+    void set_earlier_deadline_callback(std::function<void()> callback);
+
 private:
     struct Entry {
         std::function<void()> callback{nullptr};
         SteadyTimePoint last_time{};
         double interval_s{0.0};
-        Cookie cookie{};
     };
 
+    // Must be called with _mutex held.
+    void update_deadline(Cookie cookie, Entry& entry);
+    bool is_earliest(SteadyTimePoint deadline) const;
+
     std::recursive_mutex _mutex{};
-    std::list<Entry> _entries{};
+    DeadlineHeap<Cookie, Entry> _entries{};
+    std::function<void()> _earlier_deadline_callback{};
 
     Time& _time;
 
@@ -188,3 +188,53 @@ TEST(CallEveryHandler, AllHandlersRemovedDuringCallback)
     time.sleep_for(std::chrono::milliseconds(200));
     ceh.run_once();
 }
+
+TEST(CallEveryHandler, NextDeadline)
+{
+    Time time{};
+    CallEveryHandler ceh(time);
+
+    int earlier_deadlines = 0;
+    ceh.set_earlier_deadline_callback([&earlier_deadlines]() { ++earlier_deadlines; });
+
+    EXPECT_FALSE(ceh.next_deadline());
+
+    // A new entry is due straightaway.
+    auto cookie = ceh.add([]() {}, 0.1);
+    EXPECT_EQ(earlier_deadlines, 1);
+    ASSERT_TRUE(ceh.next_deadline());
+    EXPECT_LT(*ceh.next_deadline(), time.steady_time());
+
+    ceh.run_once();
+    const auto deadline = ceh.next_deadline();
+    ASSERT_TRUE(deadline);
+    EXPECT_GT(*deadline, time.steady_time());
+
+    ceh.change(0.05, cookie);
+    EXPECT_EQ(earlier_deadlines, 2);
+    EXPECT_LT(*ceh.next_deadline(), *deadline);
+
+    ceh.remove(cookie);
+    EXPECT_FALSE(ceh.next_deadline());
+}
+
+TEST(CallEveryHandler, SkipsMissedCalls)
+{
+    Time time{};
+    CallEveryHandler ceh(time);
+
+    int num_called = 0;
+    auto cookie = ceh.add([&num_called]() { ++num_called; }, 0.1);
+
+    ceh.run_once();
+    EXPECT_EQ(num_called, 1);
+
+    // Fall behind by several intervals: only one call, not one per missed interval.
+    time.sleep_for(std::chrono::milliseconds(550));
+    ceh.run_once();
+    ceh.run_once();
+    EXPECT_EQ(num_called, 2);
+    EXPECT_GT(*ceh.next_deadline(), time.steady_time());
+
+    UNUSED(cookie);
+}
@@ -8,6 +8,7 @@
 #include <vector>
 #include "handle.hpp"
 #include "mavsdk_export.h"
+#include "user_callback.hpp"
 
 // Forward-declared so this header (the public face of the CallbackList pair) does not pull
 // asio in; the full include lives in callback_list_impl.hpp.
@@ -19,19 +20,31 @@ namespace mavsdk {
 
 template<typename... Args> class CallbackListImpl;
 
+// How updates are handed to one subscriber, for subscribers that don't need every update.
+// Both are applied on the io thread, before anything is queued to the user callback thread.
+struct CallbackPolicy {
+    // Updates within 1/max_rate_hz of the last one passed on are dropped. 0 for no limit.
+    double max_rate_hz{0.0};
+    // While a queued callback has not run yet, further updates only replace its arguments
+    // rather than queueing another one, so a slow subscriber only gets the latest update.
+    bool coalesce{false};
+};
+
 template<typename... Args> class MAVSDK_PUBLIC CallbackList {
 public:
     explicit CallbackList(asio::io_context& io_context);
     ~CallbackList();
 
     Handle<Args...> subscribe(const std::function<void(Args...)>& callback);
+    Handle<Args...>
+    subscribe(const std::function<void(Args...)>& callback, const CallbackPolicy& policy);
     void unsubscribe(Handle<Args...> handle);
     void unsubscribe_blocking(Handle<Args...> handle);
     void subscribe_conditional(const std::function<bool(Args...)>& callback);
     void operator()(Args... args);
     [[nodiscard]] bool empty();
     void clear();
-    void queue(Args... args, const std::function<void(const std::function<void()>&)>& queue_func);
+    void queue(Args... args, const std::function<void(const UserCallback&)>& queue_func);
 
 private:
     std::unique_ptr<CallbackListImpl<Args...>> _impl;
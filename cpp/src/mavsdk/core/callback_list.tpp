@@ -19,6 +19,13 @@ Handle<Args...> CallbackList<Args...>::subscribe(const std::function<void(Args..
     return _impl->subscribe(callback);
 }
 
+template<typename... Args>
+Handle<Args...> CallbackList<Args...>::subscribe(
+    const std::function<void(Args...)>& callback, const CallbackPolicy& policy)
+{
+    return _impl->subscribe(callback, policy);
+}
+
 template<typename... Args> void CallbackList<Args...>::unsubscribe(Handle<Args...> handle)
 {
     _impl->unsubscribe(handle);
@@ -52,7 +59,7 @@ template<typename... Args> void CallbackList<Args...>::clear()
 
 template<typename... Args>
 void CallbackList<Args...>::queue(
-    Args... args, const std::function<void(const std::function<void()>&)>& queue_func)
+    Args... args, const std::function<void(const UserCallback&)>& queue_func)
 {
     _impl->queue(args..., queue_func);
 }
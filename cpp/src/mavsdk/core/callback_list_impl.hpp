@@ -3,9 +3,15 @@
 #include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cstddef>
 #include <functional>
 #include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 #include <asio/io_context.hpp>
@@ -24,6 +30,9 @@ namespace mavsdk {
 //   synchronous), while exec() posts and waits (it invokes the callbacks directly, so the
 //   caller's arguments must stay alive until they have run). exec() must therefore not be
 //   called off the io thread while holding a lock that the io thread needs.
+// - Subscribers with a CallbackPolicy are rate limited and coalesced on the io thread too, so
+//   dropped updates never reach the user callback queue. The arguments of a coalesced
+//   callback are the only state shared with the callback thread, under their own mutex.
 // - subscribe()/subscribe_conditional()/unsubscribe()/clear() post their list mutation
 //   without waiting. Posting (rather than running inline) means they never mutate the list
 //   while exec() is iterating it, so it is safe to (un)subscribe from inside a callback; not
@@ -60,6 +69,32 @@ public:
         return handle;
     }
 
+    Handle<Args...>
+    subscribe(const std::function<void(Args...)>& callback, const CallbackPolicy& policy)
+    {
+        if (callback == nullptr || (policy.max_rate_hz <= 0.0 && !policy.coalesce)) {
+            return subscribe(callback);
+        }
+
+        PolicySubscription subscription;
+        subscription.handle = _handle_factory.create();
+        subscription.callback = callback;
+        if (policy.max_rate_hz > 0.0) {
+            subscription.min_interval = std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>(1.0 / policy.max_rate_hz));
+        }
+        if (policy.coalesce) {
+            subscription.pending = std::make_shared<Pending>();
+        }
+
+        post_mutation([this, subscription]() {
+            _policy_list.push_back(subscription);
+            update_size();
+        });
+
+        return subscription.handle;
+    }
+
     void subscribe_conditional(const std::function<bool(Args...)>& callback)
     {
         if (callback != nullptr) {
@@ -80,13 +115,7 @@ public:
             return;
         }
 
-        post_mutation([this, handle]() {
-            _list.erase(
-                std::remove_if(
-                    _list.begin(), _list.end(), [&](auto& pair) { return pair.first == handle; }),
-                _list.end());
-            update_size();
-        });
+        post_mutation([this, handle]() { remove(handle); });
     }
 
     // Blocking variant of unsubscribe(): does not return until the io thread has actually
@@ -103,13 +132,7 @@ public:
             return;
         }
 
-        auto erase = [this, handle]() {
-            _list.erase(
-                std::remove_if(
-                    _list.begin(), _list.end(), [&](auto& pair) { return pair.first == handle; }),
-                _list.end());
-            update_size();
-        };
+        auto erase = [this, handle]() { remove(handle); };
 
         // Same guards as read_on_io()/drain(): if the io thread is gone (stopped) or we are
         // already on it, apply inline -- posting and waiting would hang or self-deadlock.
@@ -133,6 +156,13 @@ public:
                 pair.second(args...);
             }
 
+            const auto now = Clock::now();
+            for (auto& subscription : _policy_list) {
+                if (passes_rate_limit(subscription, now)) {
+                    subscription.callback(args...);
+                }
+            }
+
             for (auto it = _cond_cb_list.begin(); it != _cond_cb_list.end();) {
                 if ((*it)(args...)) {
                     // If the callback returns true, remove it based on the iterator.
@@ -146,23 +176,18 @@ public:
         });
     }
 
-    void queue(Args... args, const std::function<void(const std::function<void()>&)>& queue_func)
+    void queue(Args... args, const std::function<void(const UserCallback&)>& queue_func)
     {
         // queue() only hands the callbacks to queue_func (which enqueues them to run later), so
         // unlike exec() it never needs to run synchronously. Posting it without waiting (rather
         // than blocking on the io thread) means it is safe to call while holding a lock that the
         // io thread also needs -- a blocking round-trip there would deadlock.
         if (_io_context.stopped() || on_io_thread()) {
-            for (const auto& pair : _list) {
-                queue_func([callback = pair.second, args...]() { callback(args...); });
-            }
+            queue_on_io(args..., queue_func);
             return;
         }
-        asio::post(_io_context, [this, args..., queue_func]() {
-            for (const auto& pair : _list) {
-                queue_func([callback = pair.second, args...]() { callback(args...); });
-            }
-        });
+        asio::post(
+            _io_context, [this, args..., queue_func]() { queue_on_io(args..., queue_func); });
     }
 
     bool empty() { return _size.load(std::memory_order_acquire) == 0; }
@@ -171,16 +196,107 @@ public:
     {
         post_mutation([this]() {
             _list.clear();
+            _policy_list.clear();
             _cond_cb_list.clear();
             update_size();
         });
     }
 
 private:
+    using Clock = std::chrono::steady_clock;
+
+    // The arguments of a coalesced callback that is queued but has not run yet.
+    struct Pending {
+        std::mutex mutex;
+        std::optional<std::tuple<std::decay_t<Args>...>> args;
+    };
+
+    struct PolicySubscription {
+        Handle<Args...> handle{};
+        std::function<void(Args...)> callback{};
+        Clock::duration min_interval{Clock::duration::zero()};
+        std::optional<Clock::time_point> last_passed{};
+        // Only set for coalesce, shared with the queued callback.
+        std::shared_ptr<Pending> pending{};
+    };
+
     // Always called on the io thread, where the list is mutated.
     void update_size()
     {
-        _size.store(_list.size() + _cond_cb_list.size(), std::memory_order_release);
+        _size.store(
+            _list.size() + _policy_list.size() + _cond_cb_list.size(), std::memory_order_release);
+    }
+
+    void remove(Handle<Args...> handle)
+    {
+        _list.erase(
+            std::remove_if(
+                _list.begin(), _list.end(), [&](auto& pair) { return pair.first == handle; }),
+            _list.end());
+        _policy_list.erase(
+            std::remove_if(
+                _policy_list.begin(),
+                _policy_list.end(),
+                [&](auto& subscription) { return subscription.handle == handle; }),
+            _policy_list.end());
+        update_size();
+    }
+
+    static bool passes_rate_limit(PolicySubscription& subscription, Clock::time_point now)
+    {
+        if (subscription.min_interval == Clock::duration::zero()) {
+            return true;
+        }
+        if (subscription.last_passed &&
+            now - subscription.last_passed.value() < subscription.min_interval) {
+            return false;
+        }
+        subscription.last_passed = now;
+        return true;
+    }
+
+    void queue_on_io(Args... args, const std::function<void(const UserCallback&)>& queue_func)
+    {
+        for (const auto& pair : _list) {
+            queue_func([callback = pair.second, args...]() { callback(args...); });
+        }
+
+        if (_policy_list.empty()) {
+            return;
+        }
+
+        const auto now = Clock::now();
+        for (auto& subscription : _policy_list) {
+            if (!passes_rate_limit(subscription, now)) {
+                continue;
+            }
+
+            if (!subscription.pending) {
+                queue_func([callback = subscription.callback, args...]() { callback(args...); });
+                continue;
+            }
+
+            bool already_queued;
+            {
+                std::lock_guard<std::mutex> lock(subscription.pending->mutex);
+                already_queued = subscription.pending->args.has_value();
+                subscription.pending->args.emplace(args...);
+            }
+            if (already_queued) {
+                continue;
+            }
+
+            queue_func([callback = subscription.callback, pending = subscription.pending]() {
+                std::optional<std::tuple<std::decay_t<Args>...>> latest;
+                {
+                    std::lock_guard<std::mutex> lock(pending->mutex);
+                    latest.swap(pending->args);
+                }
+                if (latest) {
+                    std::apply(callback, latest.value());
+                }
+            });
+        }
     }
 
     // INVARIANT: a CallbackList must be driven by a single dedicated io thread (the one that
@@ -263,6 +379,7 @@ private:
     asio::io_context& _io_context;
     HandleFactory<Args...> _handle_factory;
     std::vector<std::pair<Handle<Args...>, std::function<void(Args...)>>> _list{};
+    std::vector<PolicySubscription> _policy_list{};
     std::vector<std::function<bool(Args...)>> _cond_cb_list{};
     std::atomic<std::size_t> _size{0};
 };
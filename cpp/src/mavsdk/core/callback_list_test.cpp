@@ -329,3 +329,123 @@ TEST_F(CallbackListTest, SubscribeAndUnsubscribeWithinCallbacks2)
         thread.join();
     }
 }
+
+// Collects what CallbackList::queue() hands on, like the user callback queue would.
+class QueuedCallbacks {
+public:
+    std::function<void(const UserCallback&)> queue_func()
+    {
+        return [this](const UserCallback& callback) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _callbacks.push_back(callback);
+        };
+    }
+
+    size_t size()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _callbacks.size();
+    }
+
+    void run()
+    {
+        std::vector<UserCallback> callbacks;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            callbacks.swap(_callbacks);
+        }
+        for (const auto& callback : callbacks) {
+            callback();
+        }
+    }
+
+private:
+    std::mutex _mutex;
+    std::vector<UserCallback> _callbacks;
+};
+
+TEST_F(CallbackListTest, RateLimitedSubscription)
+{
+    QueuedCallbacks queued;
+    unsigned num_called = 0;
+    unsigned num_called_limited = 0;
+
+    CallbackList<int, double> cl{_io_context};
+    cl.subscribe([&](int, double) { ++num_called; });
+    CallbackPolicy policy;
+    policy.max_rate_hz = 5.0;
+    auto handle = cl.subscribe([&](int, double) { ++num_called_limited; }, policy);
+
+    for (int i = 0; i < 100; ++i) {
+        cl.queue(i, 0.0, queued.queue_func());
+    }
+    flush();
+    queued.run();
+
+    EXPECT_EQ(num_called, 100);
+    EXPECT_EQ(num_called_limited, 1);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    cl.queue(100, 0.0, queued.queue_func());
+    flush();
+    queued.run();
+    EXPECT_EQ(num_called_limited, 2);
+
+    cl.unsubscribe(handle);
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    cl.queue(101, 0.0, queued.queue_func());
+    flush();
+    queued.run();
+    EXPECT_EQ(num_called, 102);
+    EXPECT_EQ(num_called_limited, 2);
+}
+
+TEST_F(CallbackListTest, CoalescedSubscriptionGetsLatest)
+{
+    QueuedCallbacks queued;
+    std::vector<int> received;
+
+    CallbackList<int, double> cl{_io_context};
+    CallbackPolicy policy;
+    policy.coalesce = true;
+    cl.subscribe(
+        [&](int i, double d) {
+            received.push_back(i);
+            EXPECT_DOUBLE_EQ(d, i * 0.5);
+        },
+        policy);
+
+    // The callback thread is busy: only one callback is queued.
+    for (int i = 0; i < 100; ++i) {
+        cl.queue(i, i * 0.5, queued.queue_func());
+    }
+    flush();
+    EXPECT_EQ(queued.size(), 1u);
+
+    queued.run();
+    ASSERT_EQ(received.size(), 1u);
+    EXPECT_EQ(received.back(), 99);
+
+    // Once it ran, the next update is queued again.
+    cl.queue(100, 50.0, queued.queue_func());
+    flush();
+    EXPECT_EQ(queued.size(), 1u);
+    queued.run();
+    ASSERT_EQ(received.size(), 2u);
+    EXPECT_EQ(received.back(), 100);
+}
+
+TEST_F(CallbackListTest, PolicySubscriptionsAreCleared)
+{
+    CallbackList<> cl{_io_context};
+    CallbackPolicy policy;
+    policy.max_rate_hz = 10.0;
+    policy.coalesce = true;
+    cl.subscribe([]() {}, policy);
+    flush();
+    EXPECT_FALSE(cl.empty());
+
+    cl.clear();
+    flush();
+    EXPECT_TRUE(cl.empty());
+}
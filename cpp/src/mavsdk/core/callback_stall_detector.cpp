@@ -0,0 +1,73 @@
+#include "callback_stall_detector.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace mavsdk {
+
+CallbackStallDetector::CallbackStallDetector(Time& time) : _time(time) {}
+
+bool CallbackStallDetector::callback_queued()
+{
+    return _pending.fetch_add(1) == 0;
+}
+
+void CallbackStallDetector::callback_discarded()
+{
+    _pending.fetch_sub(1);
+}
+
+void CallbackStallDetector::callback_started(const char* filename, int linenumber)
+{
+    // The location is published before the start time, and check() re-reads
+    // the start time after the location, so it never pairs a start time with
+    // the location of the next callback.
+    _filename.store(filename, std::memory_order_release);
+    _linenumber.store(linenumber, std::memory_order_release);
+
+    _last_started_ns = std::max(now_ns(), _last_started_ns + 1);
+    _started_ns.store(_last_started_ns, std::memory_order_release);
+}
+
+void CallbackStallDetector::callback_finished()
+{
+    _started_ns.store(0, std::memory_order_release);
+    _pending.fetch_sub(1);
+}
+
+bool CallbackStallDetector::idle() const
+{
+    return _pending.load() == 0;
+}
+
+std::optional<CallbackStallDetector::Stall> CallbackStallDetector::check(double timeout_s)
+{
+    const int64_t started_ns = _started_ns.load(std::memory_order_acquire);
+    if (started_ns == 0 || started_ns == _reported_started_ns) {
+        return std::nullopt;
+    }
+
+    const double running_s = static_cast<double>(now_ns() - started_ns) * 1e-9;
+    if (running_s <= timeout_s) {
+        return std::nullopt;
+    }
+
+    const char* filename = _filename.load(std::memory_order_acquire);
+    const int linenumber = _linenumber.load(std::memory_order_acquire);
+    if (_started_ns.load(std::memory_order_acquire) != started_ns) {
+        // It finished meanwhile.
+        return std::nullopt;
+    }
+
+    _reported_started_ns = started_ns;
+    return Stall{filename, linenumber, running_s};
+}
+
+int64_t CallbackStallDetector::now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               _time.steady_time().time_since_epoch())
+        .count();
+}
+
+} // namespace mavsdk
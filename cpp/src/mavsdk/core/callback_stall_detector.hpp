@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+
+#include "mavsdk_export.h"
+#include "mavsdk_time.hpp"
+
+namespace mavsdk {
+
+/*
+ * Detects a user callback that runs for too long.
+ *
+ * The user callback thread marks the start and end of every callback, which
+ * only stores a few atomics. A periodic check on another thread compares the
+ * start time of the running callback against the timeout, so there is no
+ * per-callback timer to register and remove.
+ *
+ * It also counts the callbacks queued or running, so that the periodic check
+ * only needs to run while there are any.
+ *
+ * callback_started()/callback_finished() must only be called from one thread
+ * (the user callback thread), and check() only from one thread (the io thread).
+ * callback_queued()/callback_discarded() and idle() can be called from any thread.
+ */
+class MAVSDK_TEST_EXPORT CallbackStallDetector {
+public:
+    struct Stall {
+        const char* filename;
+        int linenumber;
+        double running_s;
+    };
+
+    explicit CallbackStallDetector(Time& time);
+
+    // Called before a callback is queued. Returns true if no other callback was
+    // queued or running, so the periodic check has to be started.
+    bool callback_queued();
+    // For a queued callback that is not going to be run after all.
+    void callback_discarded();
+
+    void callback_started(const char* filename, int linenumber);
+    void callback_finished();
+
+    // Whether no callback is queued or running, so there is nothing to check.
+    bool idle() const;
+
+    // Returns the running callback if it has been running for longer than
+    // timeout_s. Every stalled callback is only reported once.
+    std::optional<Stall> check(double timeout_s);
+
+private:
+    int64_t now_ns();
+
+    Time& _time;
+
+    // Start of the running callback, or 0 if idle. Every callback gets a
+    // distinct value, so check() can tell whether the location it read belongs
+    // to the same callback.
+    std::atomic<int64_t> _started_ns{0};
+    std::atomic<const char*> _filename{""};
+    std::atomic<int> _linenumber{0};
+
+    // Callbacks queued or running.
+    std::atomic<unsigned> _pending{0};
+
+    // Only used by callback_started().
+    int64_t _last_started_ns{0};
+    // Only used by check().
+    int64_t _reported_started_ns{0};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,99 @@
+#include "callback_stall_detector.hpp"
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+using namespace mavsdk;
+
+namespace {
+constexpr double timeout_s = 1.0;
+}
+
+TEST(CallbackStallDetector, IdleIsNotAStall)
+{
+    FakeTime time{};
+    CallbackStallDetector detector(time);
+
+    EXPECT_FALSE(detector.check(timeout_s));
+    time.sleep_for(std::chrono::seconds(5));
+    EXPECT_FALSE(detector.check(timeout_s));
+}
+
+TEST(CallbackStallDetector, FastCallbackIsNotAStall)
+{
+    FakeTime time{};
+    CallbackStallDetector detector(time);
+
+    detector.callback_started("fast.cpp", 1);
+    time.sleep_for(std::chrono::milliseconds(500));
+    EXPECT_FALSE(detector.check(timeout_s));
+    detector.callback_finished();
+
+    time.sleep_for(std::chrono::seconds(5));
+    EXPECT_FALSE(detector.check(timeout_s));
+}
+
+TEST(CallbackStallDetector, ReportsSlowCallbackOnce)
+{
+    FakeTime time{};
+    CallbackStallDetector detector(time);
+
+    detector.callback_started("slow.cpp", 42);
+    time.sleep_for(std::chrono::milliseconds(1500));
+
+    auto stall = detector.check(timeout_s);
+    ASSERT_TRUE(stall);
+    EXPECT_STREQ(stall->filename, "slow.cpp");
+    EXPECT_EQ(stall->linenumber, 42);
+    EXPECT_GT(stall->running_s, timeout_s);
+
+    time.sleep_for(std::chrono::seconds(5));
+    EXPECT_FALSE(detector.check(timeout_s));
+    detector.callback_finished();
+}
+
+TEST(CallbackStallDetector, NextSlowCallbackIsReportedAgain)
+{
+    FakeTime time{};
+    CallbackStallDetector detector(time);
+
+    detector.callback_started("first.cpp", 1);
+    time.sleep_for(std::chrono::seconds(2));
+    EXPECT_TRUE(detector.check(timeout_s));
+    detector.callback_finished();
+
+    detector.callback_started("second.cpp", 2);
+    EXPECT_FALSE(detector.check(timeout_s));
+    time.sleep_for(std::chrono::seconds(2));
+
+    auto stall = detector.check(timeout_s);
+    ASSERT_TRUE(stall);
+    EXPECT_STREQ(stall->filename, "second.cpp");
+    EXPECT_EQ(stall->linenumber, 2);
+}
+
+TEST(CallbackStallDetector, IdleUntilAllCallbacksRan)
+{
+    FakeTime time{};
+    CallbackStallDetector detector(time);
+    EXPECT_TRUE(detector.idle());
+
+    // Only the first one needs the check to be started.
+    EXPECT_TRUE(detector.callback_queued());
+    EXPECT_FALSE(detector.callback_queued());
+    EXPECT_FALSE(detector.callback_queued());
+    EXPECT_FALSE(detector.idle());
+
+    detector.callback_discarded();
+
+    detector.callback_started("first.cpp", 1);
+    detector.callback_finished();
+    EXPECT_FALSE(detector.idle());
+
+    detector.callback_started("second.cpp", 2);
+    EXPECT_FALSE(detector.idle());
+    detector.callback_finished();
+    EXPECT_TRUE(detector.idle());
+
+    EXPECT_TRUE(detector.callback_queued());
+}
@@ -0,0 +1,281 @@
+#include "capture_file.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+
+#include "log.hpp"
+
+namespace mavsdk {
+
+namespace {
+
+constexpr std::array<char, 8> file_magic{'M', 'A', 'V', 'C', 'A', 'P', '\0', '\0'};
+constexpr std::array<char, 8> trailer_magic{'M', 'A', 'V', 'C', 'A', 'P', 'I', 'X'};
+
+template<typename T> void put_le(uint8_t* dest, T value)
+{
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        dest[i] = static_cast<uint8_t>(static_cast<uint64_t>(value) >> (8 * i));
+    }
+}
+
+template<typename T> T get_le(const uint8_t* src)
+{
+    uint64_t value = 0;
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        value |= static_cast<uint64_t>(src[i]) << (8 * i);
+    }
+    return static_cast<T>(value);
+}
+
+} // namespace
+
+CaptureWriter::CaptureWriter(BufferedFileWriter::Options options) : _writer(options) {}
+
+CaptureWriter::~CaptureWriter()
+{
+    stop();
+}
+
+bool CaptureWriter::start(const std::string& path)
+{
+    std::vector<uint8_t> file_header(CAPTURE_FILE_HEADER_LEN, 0);
+    std::memcpy(file_header.data(), file_magic.data(), file_magic.size());
+    put_le<uint16_t>(&file_header[8], CAPTURE_VERSION);
+    put_le<uint16_t>(&file_header[10], CAPTURE_RECORD_HEADER_LEN);
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _offset = CAPTURE_FILE_HEADER_LEN;
+        _next_index_offset = _offset;
+        _index.clear();
+    }
+
+    if (!_writer.start(path, file_header)) {
+        return false;
+    }
+    _path = path;
+    return true;
+}
+
+void CaptureWriter::stop()
+{
+    _writer.stop();
+
+    if (!_path.empty()) {
+        write_index_and_trailer();
+        _path.clear();
+    }
+}
+
+void CaptureWriter::write_frame(
+    uint64_t timestamp_us,
+    uint32_t connection_id,
+    CaptureDirection direction,
+    uint8_t flags,
+    const uint8_t* frame,
+    std::size_t len)
+{
+    if (len > std::numeric_limits<uint16_t>::max()) {
+        return;
+    }
+
+    std::array<uint8_t, CAPTURE_RECORD_HEADER_LEN> header{};
+    put_le<uint64_t>(&header[0], timestamp_us);
+    put_le<uint32_t>(&header[8], connection_id);
+    header[12] = static_cast<uint8_t>(direction);
+    header[13] = flags;
+    put_le<uint16_t>(&header[14], static_cast<uint16_t>(len));
+
+    // Under the lock, so the offsets match the order of the records in the file.
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (!_writer.write_record(header.data(), header.size(), frame, len)) {
+        return;
+    }
+
+    if (_offset >= _next_index_offset) {
+        // Sent and received frames are timestamped on different threads, so
+        // they can be slightly out of order. Keep the index sorted anyway.
+        const uint64_t indexed_timestamp_us =
+            _index.empty() ? timestamp_us : std::max(_index.back().timestamp_us, timestamp_us);
+        _index.push_back(IndexEntry{indexed_timestamp_us, _offset});
+        _next_index_offset = _offset + CAPTURE_INDEX_INTERVAL;
+    }
+    _offset += CAPTURE_RECORD_HEADER_LEN + len;
+}
+
+BufferedFileWriter::Stats CaptureWriter::stats() const
+{
+    return _writer.stats();
+}
+
+void CaptureWriter::write_index_and_trailer()
+{
+    std::fstream file(_path, std::ios::binary | std::ios::in | std::ios::out | std::ios::ate);
+    if (!file.is_open()) {
+        LogErr("Capture: could not reopen {} to write index", _path);
+        return;
+    }
+
+    const auto index_offset = static_cast<uint64_t>(file.tellp());
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // If writing failed at some point, the file is shorter than expected.
+    const auto end = std::find_if(_index.begin(), _index.end(), [&](const IndexEntry& entry) {
+        return entry.offset >= index_offset;
+    });
+    const auto num_entries = static_cast<std::size_t>(std::distance(_index.begin(), end));
+
+    std::vector<uint8_t> buffer(num_entries * CAPTURE_INDEX_ENTRY_LEN + CAPTURE_TRAILER_LEN);
+    uint8_t* pos = buffer.data();
+    for (auto it = _index.begin(); it != end; ++it) {
+        put_le<uint64_t>(pos, it->timestamp_us);
+        put_le<uint64_t>(pos + 8, it->offset);
+        pos += CAPTURE_INDEX_ENTRY_LEN;
+    }
+    put_le<uint64_t>(pos, index_offset);
+    put_le<uint64_t>(pos + 8, num_entries);
+    std::memcpy(pos + 16, trailer_magic.data(), trailer_magic.size());
+
+    file.write(
+        reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    if (!file.good()) {
+        LogErr("Capture: writing index failed");
+    }
+}
+
+bool CaptureReader::open(const std::string& path)
+{
+    _stream.open(path, std::ios::binary);
+    if (!_stream.is_open()) {
+        return false;
+    }
+
+    std::array<uint8_t, CAPTURE_FILE_HEADER_LEN> file_header{};
+    if (!_stream.read(
+            reinterpret_cast<char*>(file_header.data()),
+            static_cast<std::streamsize>(file_header.size()))) {
+        LogErr("Capture: file too short");
+        return false;
+    }
+
+    if (std::memcmp(file_header.data(), file_magic.data(), file_magic.size()) != 0 ||
+        get_le<uint16_t>(&file_header[8]) != CAPTURE_VERSION ||
+        get_le<uint16_t>(&file_header[10]) != CAPTURE_RECORD_HEADER_LEN) {
+        LogErr("Capture: not a capture file or unsupported version");
+        return false;
+    }
+
+    _stream.seekg(0, std::ios::end);
+    const auto file_size = static_cast<uint64_t>(_stream.tellg());
+
+    _has_index = read_index(file_size);
+    if (!_has_index) {
+        _index.clear();
+        _records_end = file_size;
+    }
+
+    _stream.clear();
+    _stream.seekg(CAPTURE_FILE_HEADER_LEN);
+    return true;
+}
+
+bool CaptureReader::read_index(uint64_t file_size)
+{
+    if (file_size < CAPTURE_FILE_HEADER_LEN + CAPTURE_TRAILER_LEN) {
+        return false;
+    }
+
+    std::array<uint8_t, CAPTURE_TRAILER_LEN> trailer{};
+    _stream.seekg(static_cast<std::streamoff>(file_size - CAPTURE_TRAILER_LEN));
+    if (!_stream.read(
+            reinterpret_cast<char*>(trailer.data()),
+            static_cast<std::streamsize>(trailer.size())) ||
+        std::memcmp(&trailer[16], trailer_magic.data(), trailer_magic.size()) != 0) {
+        return false;
+    }
+
+    const auto index_offset = get_le<uint64_t>(&trailer[0]);
+    const auto num_entries = get_le<uint64_t>(&trailer[8]);
+    if (index_offset < CAPTURE_FILE_HEADER_LEN ||
+        index_offset + num_entries * CAPTURE_INDEX_ENTRY_LEN + CAPTURE_TRAILER_LEN != file_size) {
+        return false;
+    }
+
+    std::vector<uint8_t> buffer(num_entries * CAPTURE_INDEX_ENTRY_LEN);
+    _stream.seekg(static_cast<std::streamoff>(index_offset));
+    if (!_stream.read(
+            reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()))) {
+        return false;
+    }
+
+    _index.resize(num_entries);
+    for (std::size_t i = 0; i < num_entries; ++i) {
+        _index[i].timestamp_us = get_le<uint64_t>(&buffer[i * CAPTURE_INDEX_ENTRY_LEN]);
+        _index[i].offset = get_le<uint64_t>(&buffer[i * CAPTURE_INDEX_ENTRY_LEN + 8]);
+    }
+    _records_end = index_offset;
+    return true;
+}
+
+void CaptureReader::seek(uint64_t timestamp_us)
+{
+    uint64_t offset = CAPTURE_FILE_HEADER_LEN;
+
+    // Start from the last indexed record before the timestamp.
+    auto it = std::upper_bound(
+        _index.begin(), _index.end(), timestamp_us, [](uint64_t value, const IndexEntry& entry) {
+            return value < entry.timestamp_us;
+        });
+    if (it != _index.begin()) {
+        offset = std::prev(it)->offset;
+    }
+
+    _stream.clear();
+    _stream.seekg(static_cast<std::streamoff>(offset));
+
+    // And scan forward from there.
+    CaptureRecord record;
+    while (true) {
+        const auto record_offset = _stream.tellg();
+        if (!next(record) || record.timestamp_us >= timestamp_us) {
+            _stream.clear();
+            _stream.seekg(record_offset);
+            return;
+        }
+    }
+}
+
+bool CaptureReader::next(CaptureRecord& record)
+{
+    const auto offset = _stream.tellg();
+    if (offset < 0 || static_cast<uint64_t>(offset) + CAPTURE_RECORD_HEADER_LEN > _records_end) {
+        return false;
+    }
+
+    std::array<uint8_t, CAPTURE_RECORD_HEADER_LEN> header{};
+    if (!_stream.read(
+            reinterpret_cast<char*>(header.data()), static_cast<std::streamsize>(header.size()))) {
+        return false;
+    }
+
+    const auto len = get_le<uint16_t>(&header[14]);
+    if (static_cast<uint64_t>(offset) + CAPTURE_RECORD_HEADER_LEN + len > _records_end) {
+        // Truncated, e.g. because the recording did not end cleanly.
+        return false;
+    }
+
+    record.timestamp_us = get_le<uint64_t>(&header[0]);
+    record.connection_id = get_le<uint32_t>(&header[8]);
+    record.direction = static_cast<CaptureDirection>(header[12]);
+    record.flags = header[13];
+    record.frame.resize(len);
+    return static_cast<bool>(_stream.read(
+        reinterpret_cast<char*>(record.frame.data()), static_cast<std::streamsize>(len)));
+}
+
+} // namespace mavsdk
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "buffered_file_writer.hpp"
+#include "mavsdk_export.h"
+
+namespace mavsdk {
+
+/*
+ * MAVLink capture file.
+ *
+ * Unlike a .tlog, which only holds received messages that could be parsed, a
+ * capture holds the exact bytes of every frame sent or received on any
+ * connection, including frames with unknown message IDs or a CRC that could
+ * not be checked, tagged with direction and connection.
+ *
+ * Layout, all integers little-endian:
+ *
+ *   File header (16 bytes): "MAVCAP\0\0", u16 version, u16 record header
+ *                           length, u32 reserved
+ *   Records:                u64 timestamp (us since Unix epoch), u32 connection
+ *                           id, u8 direction, u8 flags, u16 frame length,
+ *                           followed by the frame bytes
+ *   Index:                  entries of u64 timestamp, u64 file offset of a
+ *                           record
+ *   Trailer (24 bytes):     u64 file offset of the index, u64 index entry
+ *                           count, "MAVCAPIX"
+ *
+ * A record is indexed about every CAPTURE_INDEX_INTERVAL bytes, so a reader
+ * can seek close to a timestamp without scanning the whole file. If the
+ * recording did not end cleanly, index and trailer are missing, but the
+ * records can still be read from the start.
+ */
+
+constexpr uint16_t CAPTURE_VERSION = 1;
+constexpr std::size_t CAPTURE_FILE_HEADER_LEN = 16;
+constexpr std::size_t CAPTURE_RECORD_HEADER_LEN = 16;
+constexpr std::size_t CAPTURE_INDEX_ENTRY_LEN = 16;
+constexpr std::size_t CAPTURE_TRAILER_LEN = 24;
+constexpr uint64_t CAPTURE_INDEX_INTERVAL = 64 * 1024;
+
+enum class CaptureDirection : uint8_t {
+    Incoming = 0,
+    Outgoing = 1,
+};
+
+struct CaptureRecord {
+    // The MAVLink C library could not check the CRC, e.g. because the message
+    // ID is unknown to it.
+    static constexpr uint8_t FLAG_UNCHECKED_CRC = 1u << 0;
+
+    uint64_t timestamp_us{0};
+    uint32_t connection_id{0};
+    CaptureDirection direction{CaptureDirection::Incoming};
+    uint8_t flags{0};
+    std::vector<uint8_t> frame{};
+};
+
+// Records frames using a BufferedFileWriter, so write_frame() never waits
+// for the disk. write_frame() and stats() are thread-safe.
+class MAVSDK_TEST_EXPORT CaptureWriter {
+public:
+    explicit CaptureWriter(BufferedFileWriter::Options options);
+    ~CaptureWriter();
+
+    CaptureWriter(const CaptureWriter&) = delete;
+    CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+    bool start(const std::string& path);
+
+    // Writes the remaining records, then index and trailer.
+    void stop();
+
+    void write_frame(
+        uint64_t timestamp_us,
+        uint32_t connection_id,
+        CaptureDirection direction,
+        uint8_t flags,
+        const uint8_t* frame,
+        std::size_t len);
+
+    BufferedFileWriter::Stats stats() const;
+
+private:
+    struct IndexEntry {
+        uint64_t timestamp_us;
+        uint64_t offset;
+    };
+
+    void write_index_and_trailer();
+
+    BufferedFileWriter _writer;
+    std::string _path{};
+
+    std::mutex _mutex{};
+    // File offset of the next record.
+    uint64_t _offset{0};
+    uint64_t _next_index_offset{0};
+    std::vector<IndexEntry> _index{};
+};
+
+// Reads a capture file, e.g. for replay tooling.
+class MAVSDK_TEST_EXPORT CaptureReader {
+public:
+    bool open(const std::string& path);
+
+    // False if the recording did not end cleanly.
+    bool has_index() const { return _has_index; }
+
+    // Positions the reader at the first record with a timestamp at or after
+    // timestamp_us, using the index if there is one.
+    void seek(uint64_t timestamp_us);
+
+    // Returns false at the end of the records.
+    bool next(CaptureRecord& record);
+
+private:
+    struct IndexEntry {
+        uint64_t timestamp_us;
+        uint64_t offset;
+    };
+
+    bool read_index(uint64_t file_size);
+
+    std::ifstream _stream{};
+    uint64_t _records_end{0};
+    bool _has_index{false};
+    std::vector<IndexEntry> _index{};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,179 @@
+#include "capture_file.hpp"
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace mavsdk;
+
+namespace {
+
+std::string temp_path(const std::string& name)
+{
+    return testing::TempDir() + name;
+}
+
+std::vector<uint8_t> frame_for(unsigned i)
+{
+    // Not necessarily valid MAVLink, the bytes are recorded as they are.
+    return {0xFD, static_cast<uint8_t>(i >> 8), static_cast<uint8_t>(i), 0x42};
+}
+
+} // namespace
+
+TEST(CaptureFile, RoundTrip)
+{
+    const auto path = temp_path("capture_file_round_trip.mavcap");
+
+    {
+        CaptureWriter writer({});
+        ASSERT_TRUE(writer.start(path));
+
+        const auto frame1 = frame_for(1);
+        writer.write_frame(1000, 1, CaptureDirection::Incoming, 0, frame1.data(), frame1.size());
+        const auto frame2 = frame_for(2);
+        writer.write_frame(
+            2000,
+            2,
+            CaptureDirection::Outgoing,
+            CaptureRecord::FLAG_UNCHECKED_CRC,
+            frame2.data(),
+            frame2.size());
+        writer.stop();
+
+        EXPECT_EQ(writer.stats().records_written, 2u);
+    }
+
+    CaptureReader reader;
+    ASSERT_TRUE(reader.open(path));
+    EXPECT_TRUE(reader.has_index());
+
+    CaptureRecord record;
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_EQ(record.timestamp_us, 1000u);
+    EXPECT_EQ(record.connection_id, 1u);
+    EXPECT_EQ(record.direction, CaptureDirection::Incoming);
+    EXPECT_EQ(record.flags, 0u);
+    EXPECT_EQ(record.frame, frame_for(1));
+
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_EQ(record.timestamp_us, 2000u);
+    EXPECT_EQ(record.connection_id, 2u);
+    EXPECT_EQ(record.direction, CaptureDirection::Outgoing);
+    EXPECT_EQ(record.flags, CaptureRecord::FLAG_UNCHECKED_CRC);
+    EXPECT_EQ(record.frame, frame_for(2));
+
+    EXPECT_FALSE(reader.next(record));
+
+    std::remove(path.c_str());
+}
+
+TEST(CaptureFile, SeekUsingIndex)
+{
+    const auto path = temp_path("capture_file_seek.mavcap");
+
+    // Enough records for several index entries.
+    constexpr unsigned num_records = 20000;
+    {
+        BufferedFileWriter::Options options;
+        options.buffer_size = 1024 * 1024;
+        CaptureWriter writer(options);
+        ASSERT_TRUE(writer.start(path));
+        for (unsigned i = 0; i < num_records; ++i) {
+            const auto frame = frame_for(i);
+            writer.write_frame(
+                i * 10, 1, CaptureDirection::Incoming, 0, frame.data(), frame.size());
+        }
+        writer.stop();
+        ASSERT_EQ(writer.stats().records_dropped, 0u);
+    }
+
+    CaptureReader reader;
+    ASSERT_TRUE(reader.open(path));
+    EXPECT_TRUE(reader.has_index());
+
+    CaptureRecord record;
+    for (unsigned i : {0u, 1u, 7777u, 12345u, num_records - 1}) {
+        reader.seek(i * 10);
+        ASSERT_TRUE(reader.next(record));
+        EXPECT_EQ(record.timestamp_us, i * 10);
+        EXPECT_EQ(record.frame, frame_for(i));
+    }
+
+    // Between two records, lands on the next one.
+    reader.seek(12345 * 10 + 5);
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_EQ(record.timestamp_us, 12346u * 10);
+
+    // After the last record.
+    reader.seek(num_records * 10);
+    EXPECT_FALSE(reader.next(record));
+
+    std::remove(path.c_str());
+}
+
+TEST(CaptureFile, ReadsWithoutIndex)
+{
+    const auto path = temp_path("capture_file_no_index.mavcap");
+
+    {
+        CaptureWriter writer({});
+        ASSERT_TRUE(writer.start(path));
+        for (unsigned i = 0; i < 10; ++i) {
+            const auto frame = frame_for(i);
+            writer.write_frame(i, 1, CaptureDirection::Incoming, 0, frame.data(), frame.size());
+        }
+        writer.stop();
+    }
+
+    // Cut off the index and trailer, and half of the last record, as if the
+    // recording did not end cleanly.
+    std::vector<char> content;
+    {
+        std::ifstream file(path, std::ios::binary);
+        content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    const std::size_t records_len = CAPTURE_FILE_HEADER_LEN +
+                                    10 * (CAPTURE_RECORD_HEADER_LEN + frame_for(0).size());
+    ASSERT_GT(content.size(), records_len);
+    content.resize(records_len - 2);
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(content.data(), static_cast<std::streamsize>(content.size()));
+    }
+
+    CaptureReader reader;
+    ASSERT_TRUE(reader.open(path));
+    EXPECT_FALSE(reader.has_index());
+
+    CaptureRecord record;
+    unsigned num_read = 0;
+    while (reader.next(record)) {
+        EXPECT_EQ(record.frame, frame_for(num_read));
+        ++num_read;
+    }
+    EXPECT_EQ(num_read, 9u);
+
+    reader.seek(5);
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_EQ(record.timestamp_us, 5u);
+
+    std::remove(path.c_str());
+}
+
+TEST(CaptureFile, RejectsOtherFiles)
+{
+    const auto path = temp_path("capture_file_other.tlog");
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << "this is not a capture file";
+    }
+
+    CaptureReader reader;
+    EXPECT_FALSE(reader.open(path));
+
+    std::remove(path.c_str());
+}
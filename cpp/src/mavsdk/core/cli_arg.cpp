@@ -6,6 +6,8 @@
 #include <cstdint>
 #include <string>
 #include <charconv>
+#include <cmath>
+#include <cstdlib>
 
 namespace mavsdk {
 
@@ -64,6 +66,38 @@ bool CliArg::parse(const std::string& uri)
         return parse_raw(std::string_view(uri).substr(raw.size() + delimiter.size()));
     }
 
+    const std::string replay = "replay";
+    if (uri.find(replay + delimiter) == 0) {
+        return parse_replay(std::string_view(uri).substr(replay.size() + delimiter.size()));
+    }
+
+    // Not called unix, which is a predefined macro on some compilers.
+    const std::string unix_socket = "unix";
+    const std::string unix_socket_in = "unixin";
+    const std::string unix_socket_out = "unixout";
+    if (uri.find(unix_socket + delimiter) == 0) {
+        return parse_unix(
+            std::string_view(uri).substr(unix_socket.size() + delimiter.size()),
+            Unix::Mode::Out);
+    }
+
+    if (uri.find(unix_socket_in + delimiter) == 0) {
+        return parse_unix(
+            std::string_view(uri).substr(unix_socket_in.size() + delimiter.size()),
+            Unix::Mode::In);
+    }
+
+    if (uri.find(unix_socket_out + delimiter) == 0) {
+        return parse_unix(
+            std::string_view(uri).substr(unix_socket_out.size() + delimiter.size()),
+            Unix::Mode::Out);
+    }
+
+    const std::string shm = "shm";
+    if (uri.find(shm + delimiter) == 0) {
+        return parse_shm(std::string_view(uri).substr(shm.size() + delimiter.size()));
+    }
+
     LogErr("Unknown protocol");
     return false;
 }
@@ -88,12 +122,7 @@ bool CliArg::parse_udp(const std::string_view rest)
         p.mode = Udp::Mode::Out;
     }
 
-    if (auto maybe_port = port_from_str(rest.substr(pos + 1))) {
-        p.port = maybe_port.value();
-        return true;
-    } else {
-        return false;
-    }
+    return parse_udp_port_and_options(rest.substr(pos + 1), p);
 }
 
 bool CliArg::parse_udpin(const std::string_view rest)
@@ -114,12 +143,7 @@ bool CliArg::parse_udpin(const std::string_view rest)
         return false;
     }
 
-    if (auto maybe_port = port_from_str(rest.substr(pos + 1))) {
-        p.port = maybe_port.value();
-        return true;
-    } else {
-        return false;
-    }
+    return parse_udp_port_and_options(rest.substr(pos + 1), p);
 }
 
 bool CliArg::parse_udpout(const std::string_view rest)
@@ -141,12 +165,7 @@ bool CliArg::parse_udpout(const std::string_view rest)
         return false;
     }
 
-    if (auto maybe_port = port_from_str(rest.substr(pos + 1))) {
-        p.port = maybe_port.value();
-        return true;
-    } else {
-        return false;
-    }
+    return parse_udp_port_and_options(rest.substr(pos + 1), p);
 }
 
 bool CliArg::parse_tcp(const std::string_view rest)
@@ -238,6 +257,18 @@ std::optional<int> CliArg::port_from_str(std::string_view str)
     return {value};
 }
 
+std::optional<double> CliArg::double_from_str(std::string_view str)
+{
+    // std::from_chars for floating point is not available everywhere yet.
+    const std::string copy{str};
+    char* end = nullptr;
+    const double value = std::strtod(copy.c_str(), &end);
+    if (copy.empty() || end != copy.c_str() + copy.size() || !std::isfinite(value)) {
+        return {};
+    }
+    return {value};
+}
+
 bool CliArg::parse_serial(const std::string_view rest, bool flow_control_enabled)
 {
     protocol = Serial{};
@@ -313,4 +344,97 @@ bool CliArg::parse_raw(const std::string_view rest)
     return true;
 }
 
+bool CliArg::parse_replay(const std::string_view rest)
+{
+    protocol = Replay{};
+    auto& p = std::get<Replay>(protocol);
+
+    const std::string speed_option = "?speed=";
+    const size_t pos = rest.find(speed_option);
+    p.path = rest.substr(0, pos);
+
+    if (p.path.empty()) {
+        LogErr("A replay:// connection needs a file path");
+        return false;
+    }
+
+    if (pos == std::string::npos) {
+        return true;
+    }
+
+    const std::string speed_str{rest.substr(pos + speed_option.size())};
+    if (speed_str == "max") {
+        p.speed = 0.0;
+        return true;
+    }
+
+    const auto value = double_from_str(speed_str);
+    if (!value || !(value.value() > 0.0)) {
+        LogErr("Replay speed needs to be a positive number or 'max'");
+        return false;
+    }
+
+    p.speed = value.value();
+    return true;
+}
+
+bool CliArg::parse_unix(const std::string_view rest, Unix::Mode mode)
+{
+    // The path follows the scheme, e.g. unix:///tmp/mavlink.sock.
+    if (rest.empty()) {
+        LogErr("A unix:// connection needs a socket path");
+        return false;
+    }
+
+    protocol = Unix{};
+    auto& p = std::get<Unix>(protocol);
+    p.mode = mode;
+    p.path = rest;
+    return true;
+}
+
+bool CliArg::parse_shm(const std::string_view rest)
+{
+    // The name of a POSIX shared memory object can't contain any slashes.
+    if (rest.empty() || rest.find('/') != std::string_view::npos) {
+        LogErr("A shm:// connection needs a name without slashes");
+        return false;
+    }
+
+    protocol = Shm{};
+    std::get<Shm>(protocol).name = rest;
+    return true;
+}
+
+bool CliArg::parse_udp_port_and_options(const std::string_view rest, Udp& udp)
+{
+    const size_t options_pos = rest.find('?');
+
+    if (auto maybe_port = port_from_str(rest.substr(0, options_pos))) {
+        udp.port = maybe_port.value();
+    } else {
+        return false;
+    }
+
+    if (options_pos == std::string::npos) {
+        return true;
+    }
+
+    const std::string aggregate_option = "aggregate_ms=";
+    const std::string_view option = rest.substr(options_pos + 1);
+    if (option.find(aggregate_option) != 0) {
+        LogErr("Unknown UDP option, only aggregate_ms is supported");
+        return false;
+    }
+
+    const auto value = double_from_str(option.substr(aggregate_option.size()));
+    if (!value || value.value() < 0.0) {
+        LogErr("UDP aggregate_ms needs to be 0 or a positive number");
+        return false;
+    }
+
+    udp.aggregation_window_ms = value.value();
+    return true;
+}
+
 } // namespace mavsdk
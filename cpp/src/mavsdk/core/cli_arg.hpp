@@ -19,6 +19,8 @@ public:
         Mode mode{Mode::Unknown};
         std::string host{};
         int port{};
+        // Frames sent within this window are packed into one datagram, 0 means off.
+        double aggregation_window_ms{0.0};
     };
 
     struct Tcp {
@@ -42,7 +44,27 @@ public:
         // No parameters needed for raw connection
     };
 
-    using Protocol = std::variant<std::monostate, Udp, Tcp, Serial, Raw>;
+    struct Replay {
+        std::string path{};
+        // Factor applied to the recorded timing, 0 means as fast as possible.
+        double speed{1.0};
+    };
+
+    struct Unix {
+        enum class Mode {
+            Unknown,
+            In,
+            Out,
+        };
+        Mode mode{Mode::Unknown};
+        std::string path{};
+    };
+
+    struct Shm {
+        std::string name{};
+    };
+
+    using Protocol = std::variant<std::monostate, Udp, Tcp, Serial, Raw, Replay, Unix, Shm>;
 
     bool parse(const std::string& uri);
 
@@ -50,10 +72,12 @@ public:
 
 private:
     static std::optional<int> port_from_str(std::string_view str);
+    static std::optional<double> double_from_str(std::string_view str);
 
     bool parse_udp(const std::string_view rest);
     bool parse_udpin(const std::string_view rest);
     bool parse_udpout(const std::string_view rest);
+    bool parse_udp_port_and_options(const std::string_view rest, Udp& udp);
 
     bool parse_tcp(const std::string_view rest);
     bool parse_tcpin(const std::string_view rest);
@@ -61,6 +85,9 @@ private:
 
     bool parse_serial(const std::string_view rest, bool flow_control_enabled);
     bool parse_raw(const std::string_view rest);
+    bool parse_replay(const std::string_view rest);
+    bool parse_unix(const std::string_view rest, Unix::Mode mode);
+    bool parse_shm(const std::string_view rest);
 };
 
 } // namespace mavsdk
@@ -401,6 +401,79 @@ TEST(CliArg, RawConnectionWrong)
     EXPECT_FALSE(ca.parse("raw://127.0.0.1"));
 }
 
+TEST(CliArg, ReplayConnection)
+{
+    CliArg ca;
+
+    EXPECT_TRUE(ca.parse("replay://flight.tlog"));
+    auto replay = std::get_if<CliArg::Replay>(&ca.protocol);
+    ASSERT_TRUE(replay);
+    EXPECT_EQ(replay->path, "flight.tlog");
+    EXPECT_DOUBLE_EQ(replay->speed, 1.0);
+
+    EXPECT_TRUE(ca.parse("replay:///home/user/logs/flight.tlog?speed=10"));
+    replay = std::get_if<CliArg::Replay>(&ca.protocol);
+    ASSERT_TRUE(replay);
+    EXPECT_EQ(replay->path, "/home/user/logs/flight.tlog");
+    EXPECT_DOUBLE_EQ(replay->speed, 10.0);
+
+    EXPECT_TRUE(ca.parse("replay://flight.tlog?speed=0.5"));
+    replay = std::get_if<CliArg::Replay>(&ca.protocol);
+    ASSERT_TRUE(replay);
+    EXPECT_DOUBLE_EQ(replay->speed, 0.5);
+
+    EXPECT_TRUE(ca.parse("replay://flight.tlog?speed=max"));
+    replay = std::get_if<CliArg::Replay>(&ca.protocol);
+    ASSERT_TRUE(replay);
+    EXPECT_EQ(replay->path, "flight.tlog");
+    EXPECT_DOUBLE_EQ(replay->speed, 0.0);
+}
+
+TEST(CliArg, ReplayConnectionWrong)
+{
+    CliArg ca;
+
+    EXPECT_FALSE(ca.parse("replay://"));
+    EXPECT_FALSE(ca.parse("replay://?speed=2"));
+    EXPECT_FALSE(ca.parse("replay://flight.tlog?speed="));
+    EXPECT_FALSE(ca.parse("replay://flight.tlog?speed=0"));
+    EXPECT_FALSE(ca.parse("replay://flight.tlog?speed=-1"));
+    EXPECT_FALSE(ca.parse("replay://flight.tlog?speed=fast"));
+    EXPECT_FALSE(ca.parse("replay://flight.tlog?speed=2x"));
+    EXPECT_FALSE(ca.parse("replay://flight.tlog?speed=inf"));
+    EXPECT_FALSE(ca.parse("replay://flight.tlog?speed=nan"));
+}
+
+TEST(CliArg, UdpAggregation)
+{
+    CliArg ca;
+
+    EXPECT_TRUE(ca.parse("udpout://127.0.0.1:14540"));
+    auto udp = std::get_if<CliArg::Udp>(&ca.protocol);
+    ASSERT_TRUE(udp);
+    EXPECT_DOUBLE_EQ(udp->aggregation_window_ms, 0.0);
+
+    EXPECT_TRUE(ca.parse("udpout://127.0.0.1:14540?aggregate_ms=1"));
+    udp = std::get_if<CliArg::Udp>(&ca.protocol);
+    ASSERT_TRUE(udp);
+    EXPECT_EQ(udp->host, "127.0.0.1");
+    EXPECT_EQ(udp->port, 14540);
+    EXPECT_DOUBLE_EQ(udp->aggregation_window_ms, 1.0);
+
+    EXPECT_TRUE(ca.parse("udpin://0.0.0.0:14550?aggregate_ms=0.5"));
+    udp = std::get_if<CliArg::Udp>(&ca.protocol);
+    ASSERT_TRUE(udp);
+    EXPECT_EQ(udp->mode, CliArg::Udp::Mode::In);
+    EXPECT_EQ(udp->port, 14550);
+    EXPECT_DOUBLE_EQ(udp->aggregation_window_ms, 0.5);
+
+    EXPECT_FALSE(ca.parse("udpout://127.0.0.1:14540?aggregate_ms="));
+    EXPECT_FALSE(ca.parse("udpout://127.0.0.1:14540?aggregate_ms=-1"));
+    EXPECT_FALSE(ca.parse("udpout://127.0.0.1:14540?aggregate_ms=1ms"));
+    EXPECT_FALSE(ca.parse("udpout://127.0.0.1:14540?batch=1"));
+    EXPECT_FALSE(ca.parse("udpout://127.0.0.1:?aggregate_ms=1"));
+}
+
 TEST(CliArg, PortTrailingGarbageRejected)
 {
     CliArg ca;
@@ -450,3 +523,44 @@ TEST(CliArg, TcpOutTrailingGarbageRejected)
     EXPECT_FALSE(ca.parse("tcpout://127.0.0.1:14550junk"));
     EXPECT_FALSE(ca.parse("tcpin://0.0.0.0:5760x"));
 }
+
+TEST(CliArg, UnixConnection)
+{
+    CliArg ca;
+
+    EXPECT_TRUE(ca.parse("unix:///tmp/mavlink.sock"));
+    auto unix_socket = std::get_if<CliArg::Unix>(&ca.protocol);
+    ASSERT_TRUE(unix_socket);
+    EXPECT_EQ(unix_socket->mode, CliArg::Unix::Mode::Out);
+    EXPECT_EQ(unix_socket->path, "/tmp/mavlink.sock");
+
+    EXPECT_TRUE(ca.parse("unixin:///run/px4/mavlink.sock"));
+    unix_socket = std::get_if<CliArg::Unix>(&ca.protocol);
+    ASSERT_TRUE(unix_socket);
+    EXPECT_EQ(unix_socket->mode, CliArg::Unix::Mode::In);
+    EXPECT_EQ(unix_socket->path, "/run/px4/mavlink.sock");
+
+    EXPECT_TRUE(ca.parse("unixout://mavlink.sock"));
+    unix_socket = std::get_if<CliArg::Unix>(&ca.protocol);
+    ASSERT_TRUE(unix_socket);
+    EXPECT_EQ(unix_socket->mode, CliArg::Unix::Mode::Out);
+    EXPECT_EQ(unix_socket->path, "mavlink.sock");
+
+    EXPECT_FALSE(ca.parse("unix://"));
+    EXPECT_FALSE(ca.parse("unixin://"));
+    EXPECT_FALSE(ca.parse("unixout://"));
+}
+
+TEST(CliArg, ShmConnection)
+{
+    CliArg ca;
+
+    EXPECT_TRUE(ca.parse("shm://px4_mavlink"));
+    auto shm = std::get_if<CliArg::Shm>(&ca.protocol);
+    ASSERT_TRUE(shm);
+    EXPECT_EQ(shm->name, "px4_mavlink");
+
+    EXPECT_FALSE(ca.parse("shm://"));
+    EXPECT_FALSE(ca.parse("shm:///px4_mavlink"));
+    EXPECT_FALSE(ca.parse("shm://px4/mavlink"));
+}
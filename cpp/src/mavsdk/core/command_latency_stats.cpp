@@ -0,0 +1,104 @@
+#include "command_latency_stats.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace mavsdk {
+
+void CommandLatencyStats::count_ack(uint16_t command, double latency_s)
+{
+    latency_s = std::max(latency_s, 0.0);
+
+    const auto bucket = static_cast<std::size_t>(
+        std::lower_bound(
+            BUCKET_MAX_LATENCIES_S.begin(), BUCKET_MAX_LATENCIES_S.end(), latency_s) -
+        BUCKET_MAX_LATENCIES_S.begin());
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto& entry = _commands[command];
+    if (entry.acks == 0 || latency_s < entry.min_latency_s) {
+        entry.min_latency_s = latency_s;
+    }
+    entry.max_latency_s = std::max(entry.max_latency_s, latency_s);
+    entry.sum_latency_s += latency_s;
+    ++entry.acks;
+    ++entry.buckets[bucket];
+}
+
+void CommandLatencyStats::count_timeout(uint16_t command)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    ++_commands[command].timeouts;
+}
+
+void CommandLatencyStats::add_to(CommandLatencyStats& other) const
+{
+    std::scoped_lock lock(_mutex, other._mutex);
+    for (const auto& [command, entry] : _commands) {
+        auto& other_entry = other._commands[command];
+        if (entry.acks > 0) {
+            if (other_entry.acks == 0 || entry.min_latency_s < other_entry.min_latency_s) {
+                other_entry.min_latency_s = entry.min_latency_s;
+            }
+            other_entry.max_latency_s = std::max(other_entry.max_latency_s, entry.max_latency_s);
+        }
+        other_entry.sum_latency_s += entry.sum_latency_s;
+        other_entry.acks += entry.acks;
+        other_entry.timeouts += entry.timeouts;
+        for (std::size_t i = 0; i < entry.buckets.size(); ++i) {
+            other_entry.buckets[i] += entry.buckets[i];
+        }
+    }
+}
+
+std::vector<Mavsdk::CommandStats> CommandLatencyStats::get() const
+{
+    std::vector<Mavsdk::CommandStats> result;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    result.reserve(_commands.size());
+    for (const auto& [command, entry] : _commands) {
+        Mavsdk::CommandStats stats;
+        stats.command = command;
+        stats.acks = entry.acks;
+        stats.timeouts = entry.timeouts;
+        if (entry.acks > 0) {
+            stats.min_latency_s = entry.min_latency_s;
+            stats.mean_latency_s = entry.sum_latency_s / static_cast<double>(entry.acks);
+            stats.max_latency_s = entry.max_latency_s;
+            stats.p50_latency_s = percentile(entry, 0.5);
+            stats.p90_latency_s = percentile(entry, 0.9);
+            stats.p99_latency_s = percentile(entry, 0.99);
+        }
+
+        stats.histogram.reserve(entry.buckets.size());
+        for (std::size_t i = 0; i < entry.buckets.size(); ++i) {
+            const double max_latency_s = i < BUCKET_MAX_LATENCIES_S.size() ?
+                                             BUCKET_MAX_LATENCIES_S[i] :
+                                             std::numeric_limits<double>::infinity();
+            stats.histogram.push_back({max_latency_s, entry.buckets[i]});
+        }
+
+        result.push_back(std::move(stats));
+    }
+
+    return result;
+}
+
+double CommandLatencyStats::percentile(const Command& command, double fraction)
+{
+    const auto rank =
+        static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(command.acks)));
+
+    uint64_t count = 0;
+    for (std::size_t i = 0; i < BUCKET_MAX_LATENCIES_S.size(); ++i) {
+        count += command.buckets[i];
+        if (count >= rank) {
+            return std::min(BUCKET_MAX_LATENCIES_S[i], command.max_latency_s);
+        }
+    }
+    return command.max_latency_s;
+}
+
+} // namespace mavsdk
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "mavsdk.hpp"
+#include "mavsdk_export.h"
+
+namespace mavsdk {
+
+/*
+ * Distribution of the time it takes for commands to be acked, per command ID,
+ * behind Mavsdk::command_stats().
+ *
+ * The latency of a command is counted from when it was first sent until its
+ * final ack, so it includes any retries. Latencies are counted in histogram
+ * buckets of 1-2-5 steps, the percentiles are the upper bound of the bucket
+ * they fall into, capped at the largest latency seen.
+ *
+ * All methods can be called from any thread.
+ */
+class MAVSDK_TEST_EXPORT CommandLatencyStats {
+public:
+    // Upper bounds of the buckets, latencies above the last one go into an extra bucket.
+    static constexpr std::array<double, 15> BUCKET_MAX_LATENCIES_S{
+        0.001, 0.002, 0.005, 0.01, 0.02, 0.05, 0.1, 0.2, 0.5, 1.0, 2.0, 5.0, 10.0, 20.0, 50.0};
+
+    CommandLatencyStats() = default;
+
+    CommandLatencyStats(const CommandLatencyStats&) = delete;
+    CommandLatencyStats& operator=(const CommandLatencyStats&) = delete;
+
+    void count_ack(uint16_t command, double latency_s);
+    void count_timeout(uint16_t command);
+
+    // Adds everything counted here to `other`, e.g. to sum up several systems.
+    void add_to(CommandLatencyStats& other) const;
+
+    // Sorted by command ID.
+    std::vector<Mavsdk::CommandStats> get() const;
+
+private:
+    struct Command {
+        uint64_t acks{0};
+        uint64_t timeouts{0};
+        double min_latency_s{0.0};
+        double max_latency_s{0.0};
+        double sum_latency_s{0.0};
+        std::array<uint64_t, BUCKET_MAX_LATENCIES_S.size() + 1> buckets{};
+    };
+
+    static double percentile(const Command& command, double fraction);
+
+    mutable std::mutex _mutex{};
+    std::map<uint16_t, Command> _commands{};
+};
+
+} // namespace mavsdk
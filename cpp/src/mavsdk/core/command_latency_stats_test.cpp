@@ -0,0 +1,124 @@
+#include "command_latency_stats.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+using namespace mavsdk;
+
+TEST(CommandLatencyStats, EmptyWithoutCommands)
+{
+    CommandLatencyStats stats;
+    EXPECT_TRUE(stats.get().empty());
+}
+
+TEST(CommandLatencyStats, CountsPerCommand)
+{
+    CommandLatencyStats stats;
+
+    stats.count_ack(400, 0.03);
+    stats.count_ack(400, 0.01);
+    stats.count_ack(400, 0.05);
+    stats.count_timeout(400);
+    stats.count_timeout(176);
+
+    const auto result = stats.get();
+    ASSERT_EQ(result.size(), 2u);
+
+    // Sorted by command ID.
+    EXPECT_EQ(result[0].command, 176);
+    EXPECT_EQ(result[0].acks, 0u);
+    EXPECT_EQ(result[0].timeouts, 1u);
+    EXPECT_DOUBLE_EQ(result[0].max_latency_s, 0.0);
+
+    EXPECT_EQ(result[1].command, 400);
+    EXPECT_EQ(result[1].acks, 3u);
+    EXPECT_EQ(result[1].timeouts, 1u);
+    EXPECT_DOUBLE_EQ(result[1].min_latency_s, 0.01);
+    EXPECT_DOUBLE_EQ(result[1].mean_latency_s, 0.03);
+    EXPECT_DOUBLE_EQ(result[1].max_latency_s, 0.05);
+}
+
+TEST(CommandLatencyStats, Histogram)
+{
+    CommandLatencyStats stats;
+
+    // 0.01 is the upper bound of a bucket and belongs to it.
+    stats.count_ack(400, 0.01);
+    stats.count_ack(400, 0.015);
+    stats.count_ack(400, 100.0);
+
+    const auto result = stats.get();
+    ASSERT_EQ(result.size(), 1u);
+
+    const auto& histogram = result[0].histogram;
+    ASSERT_EQ(histogram.size(), CommandLatencyStats::BUCKET_MAX_LATENCIES_S.size() + 1);
+    EXPECT_DOUBLE_EQ(histogram[3].max_latency_s, 0.01);
+    EXPECT_EQ(histogram[3].count, 1u);
+    EXPECT_DOUBLE_EQ(histogram[4].max_latency_s, 0.02);
+    EXPECT_EQ(histogram[4].count, 1u);
+    EXPECT_TRUE(std::isinf(histogram.back().max_latency_s));
+    EXPECT_EQ(histogram.back().count, 1u);
+
+    uint64_t total = 0;
+    for (const auto& bucket : histogram) {
+        total += bucket.count;
+    }
+    EXPECT_EQ(total, 3u);
+}
+
+TEST(CommandLatencyStats, Percentiles)
+{
+    CommandLatencyStats stats;
+
+    for (int i = 0; i < 98; ++i) {
+        stats.count_ack(400, 0.004);
+    }
+    stats.count_ack(400, 0.3);
+    stats.count_ack(400, 0.7);
+
+    const auto result = stats.get();
+    ASSERT_EQ(result.size(), 1u);
+    EXPECT_DOUBLE_EQ(result[0].p50_latency_s, 0.005);
+    EXPECT_DOUBLE_EQ(result[0].p90_latency_s, 0.005);
+    EXPECT_DOUBLE_EQ(result[0].p99_latency_s, 0.5);
+    EXPECT_DOUBLE_EQ(result[0].max_latency_s, 0.7);
+}
+
+TEST(CommandLatencyStats, PercentilesCappedAtMax)
+{
+    CommandLatencyStats stats;
+
+    stats.count_ack(400, 0.12);
+
+    const auto result = stats.get();
+    ASSERT_EQ(result.size(), 1u);
+    EXPECT_DOUBLE_EQ(result[0].p50_latency_s, 0.12);
+    EXPECT_DOUBLE_EQ(result[0].p99_latency_s, 0.12);
+}
+
+TEST(CommandLatencyStats, AddTo)
+{
+    CommandLatencyStats first;
+    CommandLatencyStats second;
+    CommandLatencyStats total;
+
+    first.count_ack(400, 0.02);
+    first.count_timeout(176);
+    second.count_ack(400, 0.01);
+    second.count_ack(400, 0.06);
+
+    first.add_to(total);
+    second.add_to(total);
+
+    const auto result = total.get();
+    ASSERT_EQ(result.size(), 2u);
+    EXPECT_EQ(result[0].command, 176);
+    EXPECT_EQ(result[0].timeouts, 1u);
+
+    EXPECT_EQ(result[1].command, 400);
+    EXPECT_EQ(result[1].acks, 3u);
+    EXPECT_DOUBLE_EQ(result[1].min_latency_s, 0.01);
+    EXPECT_DOUBLE_EQ(result[1].mean_latency_s, 0.03);
+    EXPECT_DOUBLE_EQ(result[1].max_latency_s, 0.06);
+}
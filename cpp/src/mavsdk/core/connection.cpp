@@ -12,6 +12,7 @@
 namespace mavsdk {
 
 std::atomic<unsigned> Connection::_forwarding_connections_count = 0;
+std::atomic<uint32_t> Connection::_next_id = 1;
 
 Connection::Connection(
     ReceiverCallback receiver_callback,
@@ -23,11 +24,9 @@ Connection::Connection(
     _mavsdk_impl(mavsdk_impl),
     _mavlink_receiver(),
     _libmav_receiver(),
-    _forwarding_option(forwarding_option)
+    _forwarding_option(forwarding_option),
+    _id(_next_id++)
 {
-    // Insert system ID 0 in all connections for broadcast.
-    _system_ids.insert(0);
-
     if (forwarding_option == ForwardingOption::ForwardingOn) {
         _forwarding_connections_count++;
     }
@@ -80,10 +79,7 @@ void Connection::receive_libmav_message(
     const Mavsdk::MavlinkMessage& message, Connection* connection)
 {
     // Register system ID when receiving a message from a new system.
-    {
-        std::lock_guard<std::mutex> lock(_system_ids_mutex);
-        _system_ids.insert(message.system_id);
-    }
+    _system_ids.insert(message.system_id, SystemIdSet::Clock::now());
 
     if (_debugging) {
         LogDebug(
@@ -107,13 +103,61 @@ void Connection::receive_message(
 {
     // Register system ID for valid messages
     if (result == MavlinkReceiver::ParseResult::MessageParsed) {
-        std::lock_guard<std::mutex> lock(_system_ids_mutex);
-        _system_ids.insert(message.sysid);
+        _system_ids.insert(message.sysid, SystemIdSet::Clock::now());
     }
     // Let MavsdkImpl handle the ParseResult (queue for processing or forward-only)
     _receiver_callback(result, message, connection);
 }
 
+void Connection::receive_frame(MavlinkReceiver::ParseResult result)
+{
+    const uint8_t* frame_data = _mavlink_receiver->get_last_frame_data();
+    const size_t frame_len = _mavlink_receiver->get_last_frame_len();
+    auto& message = _mavlink_receiver->get_last_message();
+
+    if (result == MavlinkReceiver::ParseResult::MessageParsed) {
+        _stats.count_received(frame_len);
+        _stats.count_sequence(message.sysid, message.compid, message.seq);
+    } else {
+        _stats.count_bad_crc(frame_len);
+    }
+
+    // Record the bytes as received, before any intercept/drop logic.
+    _mavsdk_impl.record_capture_frame(
+        _id,
+        CaptureDirection::Incoming,
+        result == MavlinkReceiver::ParseResult::BadCrc ? CaptureRecord::FLAG_UNCHECKED_CRC : 0,
+        frame_data,
+        frame_len);
+    if (result == MavlinkReceiver::ParseResult::MessageParsed) {
+        _mavsdk_impl.record_tlog_frame(frame_data, frame_len);
+    }
+
+    receive_message(result, message, this);
+
+    // BadCrc frames are included: they may be messages only libmav knows about from a
+    // custom XML, and libmav checks their CRC itself.
+    if (!_mavsdk_impl.libmav_subscriptions().contains(message.msgid)) {
+        return;
+    }
+
+    auto libmav_receiver = get_libmav_receiver();
+    if (libmav_receiver && libmav_receiver->parse_frame(frame_data, frame_len)) {
+        if (result == MavlinkReceiver::ParseResult::BadCrc) {
+            // Only libmav could make sense of it, so it was not recorded above.
+            _mavsdk_impl.record_tlog_frame(frame_data, frame_len);
+        }
+        receive_libmav_message(libmav_receiver->get_last_message(), this);
+    }
+}
+
+void Connection::capture_sent_bytes(const char* bytes, size_t length)
+{
+    _stats.count_sent(length);
+    _mavsdk_impl.record_capture_frame(
+        _id, CaptureDirection::Outgoing, 0, reinterpret_cast<const uint8_t*>(bytes), length);
+}
+
 bool Connection::should_forward_messages() const
 {
     return _forwarding_option == ForwardingOption::ForwardingOn;
@@ -124,10 +168,25 @@ unsigned Connection::forwarding_connections_count()
     return _forwarding_connections_count;
 }
 
-bool Connection::has_system_id(uint8_t system_id)
+bool Connection::has_system_id(uint8_t system_id) const
+{
+    return system_id == 0 || _system_ids.contains(system_id);
+}
+
+std::optional<SystemIdSet::Clock::time_point>
+Connection::system_id_last_seen(uint8_t system_id) const
+{
+    return _system_ids.last_seen(system_id);
+}
+
+void Connection::forget_system_ids_older_than(SystemIdSet::Clock::time_point cutoff)
+{
+    _system_ids.remove_older_than(cutoff);
+}
+
+bool Connection::has_any_system_id() const
 {
-    std::lock_guard<std::mutex> lock(_system_ids_mutex);
-    return _system_ids.find(system_id) != _system_ids.end();
+    return !_system_ids.empty();
 }
 
 #ifdef WINDOWS
@@ -3,11 +3,15 @@
 #include "mavsdk.hpp"
 #include "mavlink_receiver.hpp"
 #include "libmav_receiver.hpp"
+#include "link_stats.hpp"
+#include "routing_table.hpp"
+#include "send_queue.hpp"
+#include "system_id_set.hpp"
 #include <atomic>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
-#include <unordered_set>
 #include <utility>
 
 namespace mavsdk {
@@ -36,10 +40,33 @@ public:
     // Send raw bytes for forwarding unknown messages
     virtual std::pair<bool, std::string> send_raw_bytes(const char* bytes, size_t length) = 0;
 
-    bool has_system_id(uint8_t system_id);
+    // Identifies the connection in capture files.
+    uint32_t id() const { return _id; }
+
+    // This connection's link in the routing table of MavsdkImpl.
+    RoutingTable::Link routing_link() const
+    {
+        return _routing_link.load(std::memory_order_relaxed);
+    }
+    void set_routing_link(RoutingTable::Link link)
+    {
+        _routing_link.store(link, std::memory_order_relaxed);
+    }
+
+    // Whether messages from the system were received on this connection. System ID 0
+    // (broadcast) is on every connection.
+    bool has_system_id(uint8_t system_id) const;
+    std::optional<SystemIdSet::Clock::time_point> system_id_last_seen(uint8_t system_id) const;
+    void forget_system_ids_older_than(SystemIdSet::Clock::time_point cutoff);
+    bool has_any_system_id() const;
     bool should_forward_messages() const;
     static unsigned forwarding_connections_count();
 
+    LinkStats& stats() { return _stats; }
+    const LinkStats& stats() const { return _stats; }
+    // For connections that queue frames before writing them.
+    virtual std::optional<SendQueue::Stats> send_queue_stats() const { return std::nullopt; }
+
     // Access to libmav receiver for message creation.
     // Returns a shared_ptr so the caller can safely use the object even if
     // stop_libmav_receiver() is called concurrently on another thread.
@@ -59,6 +86,14 @@ protected:
     void receive_message(
         MavlinkReceiver::ParseResult result, mavlink_message_t& message, Connection* connection);
 
+    // Hand on the frame the MavlinkReceiver just parsed: as mavlink_message_t and, if anyone
+    // subscribed to its message ID, decoded from the same frame bytes with libmav.
+    void receive_frame(MavlinkReceiver::ParseResult result);
+
+    // To be called by send_raw_bytes() with the bytes to send, for capture recording and
+    // the statistics.
+    void capture_sent_bytes(const char* bytes, size_t length);
+
     bool start_libmav_receiver();
     void stop_libmav_receiver();
     void receive_libmav_message(const Mavsdk::MavlinkMessage& message, Connection* connection);
@@ -70,12 +105,17 @@ protected:
     std::shared_ptr<LibmavReceiver> _libmav_receiver; // guarded by _libmav_receiver_mutex
     mutable std::mutex _libmav_receiver_mutex;
     ForwardingOption _forwarding_option;
-    std::mutex _system_ids_mutex;
-    std::unordered_set<uint8_t> _system_ids;
+    SystemIdSet _system_ids{};
+    LinkStats _stats{};
 
     bool _debugging = false;
 
+    const uint32_t _id;
+
+    std::atomic<RoutingTable::Link> _routing_link{RoutingTable::NO_LINK};
+
     static std::atomic<unsigned> _forwarding_connections_count;
+    static std::atomic<uint32_t> _next_id;
 
     // void received_mavlink_message(mavlink_message_t &);
 };
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "mavsdk_time.hpp"
+
+namespace mavsdk {
+
+/*
+ * Binary min-heap of deadlines, indexed by cookie.
+ *
+ * Used by TimeoutHandler and CallEveryHandler: the earliest deadline is
+ * available in O(1), and adding, moving (refresh) and removing a deadline by
+ * its cookie is O(log n), so the cost of running timers scales with the due
+ * ones rather than with all of them.
+ *
+ * Not thread-safe, the owner has to lock.
+ */
+template<typename Cookie, typename Value> class DeadlineHeap {
+public:
+    struct Node {
+        SteadyTimePoint deadline{};
+        Cookie cookie{};
+        Value value{};
+    };
+
+    bool empty() const { return _nodes.empty(); }
+    std::size_t size() const { return _nodes.size(); }
+
+    // Must not be called when empty.
+    const Node& top() const
+    {
+        assert(!_nodes.empty());
+        return _nodes.front();
+    }
+
+    void push(SteadyTimePoint deadline, Cookie cookie, Value value)
+    {
+        _nodes.push_back(Node{deadline, cookie, std::move(value)});
+        _positions[cookie] = _nodes.size() - 1;
+        sift_up(_nodes.size() - 1);
+    }
+
+    // Must not be called when empty.
+    Node pop()
+    {
+        assert(!_nodes.empty());
+        Node node = std::move(_nodes.front());
+        remove_at(0);
+        return node;
+    }
+
+    // Returns nullptr if the cookie is unknown.
+    Value* find(Cookie cookie)
+    {
+        auto it = _positions.find(cookie);
+        return it != _positions.end() ? &_nodes[it->second].value : nullptr;
+    }
+
+    // Moves the deadline of an existing entry. Returns false if the cookie is unknown.
+    bool update(Cookie cookie, SteadyTimePoint deadline)
+    {
+        auto it = _positions.find(cookie);
+        if (it == _positions.end()) {
+            return false;
+        }
+        const std::size_t pos = it->second;
+        const bool earlier = deadline < _nodes[pos].deadline;
+        _nodes[pos].deadline = deadline;
+        if (earlier) {
+            sift_up(pos);
+        } else {
+            sift_down(pos);
+        }
+        return true;
+    }
+
+    // Returns false if the cookie is unknown.
+    bool remove(Cookie cookie)
+    {
+        auto it = _positions.find(cookie);
+        if (it == _positions.end()) {
+            return false;
+        }
+        remove_at(it->second);
+        return true;
+    }
+
+private:
+    void remove_at(std::size_t pos)
+    {
+        _positions.erase(_nodes[pos].cookie);
+
+        const std::size_t last = _nodes.size() - 1;
+        if (pos != last) {
+            _nodes[pos] = std::move(_nodes[last]);
+            _positions[_nodes[pos].cookie] = pos;
+        }
+        _nodes.pop_back();
+
+        if (pos < _nodes.size()) {
+            // The moved-in node can belong either above or below.
+            sift_up(pos);
+            sift_down(_positions[_nodes[pos].cookie]);
+        }
+    }
+
+    void sift_up(std::size_t pos)
+    {
+        while (pos > 0) {
+            const std::size_t parent = (pos - 1) / 2;
+            if (!(_nodes[pos].deadline < _nodes[parent].deadline)) {
+                break;
+            }
+            swap_nodes(pos, parent);
+            pos = parent;
+        }
+    }
+
+    void sift_down(std::size_t pos)
+    {
+        const std::size_t size = _nodes.size();
+        while (true) {
+            const std::size_t left = 2 * pos + 1;
+            const std::size_t right = left + 1;
+            std::size_t smallest = pos;
+            if (left < size && _nodes[left].deadline < _nodes[smallest].deadline) {
+                smallest = left;
+            }
+            if (right < size && _nodes[right].deadline < _nodes[smallest].deadline) {
+                smallest = right;
+            }
+            if (smallest == pos) {
+                break;
+            }
+            swap_nodes(pos, smallest);
+            pos = smallest;
+        }
+    }
+
+    void swap_nodes(std::size_t a, std::size_t b)
+    {
+        std::swap(_nodes[a], _nodes[b]);
+        _positions[_nodes[a].cookie] = a;
+        _positions[_nodes[b].cookie] = b;
+    }
+
+    std::vector<Node> _nodes{};
+    std::unordered_map<Cookie, std::size_t> _positions{};
+};
+
+} // namespace mavsdk
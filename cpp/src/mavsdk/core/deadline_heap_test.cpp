@@ -0,0 +1,111 @@
+#include "deadline_heap.hpp"
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <random>
+
+using namespace mavsdk;
+
+namespace {
+
+SteadyTimePoint at_ms(int64_t ms)
+{
+    return SteadyTimePoint{} + std::chrono::milliseconds(ms);
+}
+
+} // namespace
+
+TEST(DeadlineHeap, PopsInDeadlineOrder)
+{
+    DeadlineHeap<uint64_t, int> heap;
+    EXPECT_TRUE(heap.empty());
+
+    heap.push(at_ms(30), 1, 30);
+    heap.push(at_ms(10), 2, 10);
+    heap.push(at_ms(20), 3, 20);
+    EXPECT_EQ(heap.size(), 3u);
+    EXPECT_EQ(heap.top().cookie, 2u);
+
+    EXPECT_EQ(heap.pop().value, 10);
+    EXPECT_EQ(heap.pop().value, 20);
+    EXPECT_EQ(heap.pop().value, 30);
+    EXPECT_TRUE(heap.empty());
+}
+
+TEST(DeadlineHeap, UpdateAndRemoveByCookie)
+{
+    DeadlineHeap<uint64_t, int> heap;
+    heap.push(at_ms(10), 1, 1);
+    heap.push(at_ms(20), 2, 2);
+    heap.push(at_ms(30), 3, 3);
+
+    EXPECT_TRUE(heap.update(1, at_ms(40)));
+    EXPECT_EQ(heap.top().cookie, 2u);
+
+    EXPECT_TRUE(heap.update(3, at_ms(5)));
+    EXPECT_EQ(heap.top().cookie, 3u);
+
+    EXPECT_TRUE(heap.remove(3));
+    EXPECT_EQ(heap.top().cookie, 2u);
+
+    ASSERT_NE(heap.find(1), nullptr);
+    EXPECT_EQ(*heap.find(1), 1);
+    EXPECT_EQ(heap.find(3), nullptr);
+
+    EXPECT_FALSE(heap.update(3, at_ms(1)));
+    EXPECT_FALSE(heap.remove(3));
+    EXPECT_EQ(heap.size(), 2u);
+}
+
+TEST(DeadlineHeap, MatchesReferenceUnderRandomOperations)
+{
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int64_t> deadline_ms(0, 1000);
+    std::uniform_int_distribution<int> operation(0, 3);
+
+    DeadlineHeap<uint64_t, int> heap;
+    std::map<uint64_t, SteadyTimePoint> reference;
+    uint64_t next_cookie = 1;
+
+    for (int i = 0; i < 10000; ++i) {
+        const int op = reference.empty() ? 0 : operation(rng);
+        auto random_cookie = [&]() {
+            auto it = reference.begin();
+            std::advance(it, rng() % reference.size());
+            return it->first;
+        };
+
+        if (op == 0) {
+            const auto deadline = at_ms(deadline_ms(rng));
+            heap.push(deadline, next_cookie, 0);
+            reference[next_cookie++] = deadline;
+        } else if (op == 1) {
+            const auto cookie = random_cookie();
+            const auto deadline = at_ms(deadline_ms(rng));
+            EXPECT_TRUE(heap.update(cookie, deadline));
+            reference[cookie] = deadline;
+        } else if (op == 2) {
+            const auto cookie = random_cookie();
+            EXPECT_TRUE(heap.remove(cookie));
+            reference.erase(cookie);
+        } else {
+            const auto node = heap.pop();
+            EXPECT_EQ(reference.at(node.cookie), node.deadline);
+            for (const auto& entry : reference) {
+                EXPECT_FALSE(entry.second < node.deadline);
+            }
+            reference.erase(node.cookie);
+        }
+
+        ASSERT_EQ(heap.size(), reference.size());
+        if (!reference.empty()) {
+            auto earliest = reference.begin()->second;
+            for (const auto& entry : reference) {
+                earliest = std::min(earliest, entry.second);
+            }
+            EXPECT_EQ(heap.top().deadline, earliest);
+        }
+    }
+}
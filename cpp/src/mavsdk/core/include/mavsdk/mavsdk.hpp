@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cmath>
+#include <cstdint>
 #include <string>
 #include <memory>
 #include <optional>
@@ -59,12 +61,28 @@ public:
      * - UDP in  (server): udpin://our_ip:port
      * - UDP out (client): udpout://remote_ip:port
      *
+     * - UDP with send aggregation: udpin://our_ip:port?aggregate_ms=1 or
+     *   udpout://remote_ip:port?aggregate_ms=1 where messages sent within
+     *   the given window are packed into one datagram (or fewer if the
+     *   datagram is full), reducing the packet rate of high-rate streams.
+     *
      * - TCP in  (server):  tcpin://our_ip:port
      * - TCP out (client): tcpout://remote_ip:port
      *
      * - Serial: serial://dev_node:baudrate
      * - Serial with flow control: serial_flowcontrol://dev_node:baudrate
      *
+     * - Replay of a recorded .tlog: replay://path/to/file.tlog?speed=1.0
+     *   where speed scales the recorded timing, or is "max" to replay as
+     *   fast as possible. Messages sent on this connection are discarded.
+     *
+     * - Unix domain socket (not on Windows), to another process on the same
+     *   machine: unixin:///path/to/socket creates the socket and waits for a
+     *   client, unix:///path/to/socket or unixout:///path/to/socket connects
+     *   to it.
+     * - Shared memory (Linux and macOS), to another process using MAVSDK on
+     *   the same machine: shm://name where both processes use the same name.
+     *
      * For UDP in and TCP in (as server), our IP can be set to:
      *   - 0.0.0.0: listen on all interfaces
      *   - 127.0.0.1: listen on loopback (local) interface only
@@ -97,12 +115,28 @@ public:
      * - UDP in  (server): udpin://our_ip:port
      * - UDP out (client): udpout://remote_ip:port
      *
+     * - UDP with send aggregation: udpin://our_ip:port?aggregate_ms=1 or
+     *   udpout://remote_ip:port?aggregate_ms=1 where messages sent within
+     *   the given window are packed into one datagram (or fewer if the
+     *   datagram is full), reducing the packet rate of high-rate streams.
+     *
      * - TCP in  (server):  tcpin://our_ip:port
      * - TCP out (client): tcpout://remote_ip:port
      *
      * - Serial: serial://dev_node:baudrate
      * - Serial with flow control: serial_flowcontrol://dev_node:baudrate
      *
+     * - Replay of a recorded .tlog: replay://path/to/file.tlog?speed=1.0
+     *   where speed scales the recorded timing, or is "max" to replay as
+     *   fast as possible. Messages sent on this connection are discarded.
+     *
+     * - Unix domain socket (not on Windows), to another process on the same
+     *   machine: unixin:///path/to/socket creates the socket and waits for a
+     *   client, unix:///path/to/socket or unixout:///path/to/socket connects
+     *   to it.
+     * - Shared memory (Linux and macOS), to another process using MAVSDK on
+     *   the same machine: shm://name where both processes use the same name.
+     *
      * For UDP in and TCP in (as server), our IP can be set to:
      *   - 0.0.0.0: listen on all interfaces
      *   - 127.0.0.1: listen on loopback (local) interface only
@@ -166,6 +200,177 @@ public:
      */
     void unsubscribe_connection_errors(ConnectionErrorHandle handle);
 
+    /**
+     * @brief Statistics of a connection, e.g. to detect a degraded link.
+     *
+     * The counters start when the connection is added. Bytes are counted for
+     * MAVLink frames only. Messages sent are all the ones handed to the
+     * connection to send, including the ones that failed.
+     */
+    struct ConnectionStats {
+        /**
+         * @brief Statistics of the messages received from one component.
+         */
+        struct Sender {
+            uint8_t system_id{}; /**< @brief System ID of the component */
+            uint8_t component_id{}; /**< @brief Component ID of the component */
+            uint64_t messages_received{}; /**< @brief Messages received with a valid CRC */
+            uint64_t messages_lost{}; /**< @brief Messages missing according to the sequence
+                                         numbers */
+        };
+
+        uint64_t bytes_received{}; /**< @brief Bytes received, including bad frames */
+        uint64_t messages_received{}; /**< @brief Messages received with a valid CRC */
+        uint64_t crc_errors{}; /**< @brief Frames received with a bad CRC (or unknown to
+                                  MAVSDK) */
+        uint64_t messages_lost{}; /**< @brief Messages lost, summed over all senders */
+        uint64_t bytes_sent{}; /**< @brief Bytes sent */
+        uint64_t messages_sent{}; /**< @brief Messages sent */
+        uint64_t send_failures{}; /**< @brief Messages that could not be sent or queued */
+
+        double bytes_received_per_s{}; /**< @brief Receive rate over the last second */
+        double messages_received_per_s{}; /**< @brief Receive rate over the last second */
+        double bytes_sent_per_s{}; /**< @brief Send rate over the last second */
+        double messages_sent_per_s{}; /**< @brief Send rate over the last second */
+
+        uint64_t send_queue_frames{}; /**< @brief Frames queued for sending right now, for
+                                         connections with a send queue (TCP, serial) */
+        uint64_t send_queue_max_frames{}; /**< @brief Most frames queued at any time */
+        uint64_t send_queue_frames_dropped{}; /**< @brief Frames dropped from the send queue
+                                                 because it was full or writing failed */
+
+        std::vector<Sender> senders{}; /**< @brief Statistics per component received from */
+    };
+
+    /**
+     * @brief Get statistics of a connection.
+     *
+     * This is cheap enough to be polled, e.g. once a second for a dashboard.
+     * The rates are only kept up to date while this is polled: after not
+     * being called for more than 10 seconds, the first call returns the
+     * rates averaged since it was last called.
+     *
+     * @param handle Handle returned when connection was added.
+     * @return The statistics, or nothing if there is no connection with this handle.
+     */
+    std::optional<ConnectionStats> connection_stats(ConnectionHandle handle) const;
+
+    /**
+     * @brief A route to a component, learned from the messages received from it.
+     *
+     * Messages targeted at a component are only sent and forwarded over the
+     * connections it was recently seen on.
+     */
+    struct Route {
+        uint8_t system_id{}; /**< @brief System ID of the component */
+        uint8_t component_id{}; /**< @brief Component ID of the component */
+        std::vector<ConnectionHandle> connections{}; /**< @brief Connections the component was
+                                                        recently seen on, empty once the route
+                                                        has aged out */
+        uint64_t messages_received{}; /**< @brief Messages received from the component */
+        uint64_t messages_routed{}; /**< @brief Messages sent or forwarded to the component
+                                       over the route */
+    };
+
+    /**
+     * @brief Get the routes learned from received messages, e.g. to debug routing.
+     *
+     * @return The routes, sorted by system ID and component ID.
+     */
+    std::vector<Route> routes() const;
+
+    /**
+     * @brief A command to send with send_commands_async(), as in MAVLink COMMAND_LONG.
+     */
+    struct Command {
+        std::shared_ptr<System> system{}; /**< @brief System to send the command to */
+        uint8_t component_id{MAV_COMP_ID_AUTOPILOT1}; /**< @brief Component to send it to */
+        uint16_t command{0}; /**< @brief Command ID (MAV_CMD) */
+        float param1{NAN}; /**< @brief param1, NAN if reserved */
+        float param2{NAN}; /**< @brief param2, NAN if reserved */
+        float param3{NAN}; /**< @brief param3, NAN if reserved */
+        float param4{NAN}; /**< @brief param4, NAN if reserved */
+        float param5{NAN}; /**< @brief param5, NAN if reserved */
+        float param6{NAN}; /**< @brief param6, NAN if reserved */
+        float param7{NAN}; /**< @brief param7, NAN if reserved */
+    };
+
+    /**
+     * @brief Possible results of a command sent with send_commands_async().
+     */
+    enum class CommandResult {
+        Success, /**< @brief Command accepted. */
+        NoSystem, /**< @brief No system connected. */
+        ConnectionError, /**< @brief Connection error. */
+        Busy, /**< @brief System is busy. */
+        Denied, /**< @brief Command denied. */
+        Unsupported, /**< @brief Command not supported. */
+        Timeout, /**< @brief No ack received, also not after retrying. */
+        TemporarilyRejected, /**< @brief Command temporarily rejected. */
+        Failed, /**< @brief Command failed. */
+        Cancelled, /**< @brief Command cancelled. */
+        Unknown, /**< @brief Unknown result. */
+    };
+
+    /**
+     * @brief Callback type for send_commands_async(), with the index of the command in the
+     * vector passed.
+     */
+    using CommandResultCallback = std::function<void(std::size_t, CommandResult)>;
+
+    /**
+     * @brief Send commands to any number of systems at once, e.g. to arm a swarm.
+     *
+     * The commands don't wait for each other, not even the ones with the same command ID to
+     * the same component. Only up to `max_in_flight_per_component` commands are sent to each
+     * component without having been acked, the rest follow as acks arrive.
+     *
+     * This function is non-blocking.
+     *
+     * @param commands Commands to send.
+     * @param callback Called once per command as soon as its result is known, so in the
+     *                 order the results arrive.
+     * @param max_in_flight_per_component Commands in flight per component, 0 for no limit.
+     */
+    void send_commands_async(
+        const std::vector<Command>& commands,
+        const CommandResultCallback& callback,
+        unsigned max_in_flight_per_component = 8);
+
+    /**
+     * @brief Statistics of the acks of one command ID, summed over all systems.
+     *
+     * Latencies are from when a command was first sent until its final ack, including
+     * retries. Percentiles are the upper bound of the histogram bucket they fall into.
+     */
+    struct CommandStats {
+        /**
+         * @brief Histogram bucket.
+         */
+        struct Bucket {
+            double max_latency_s{}; /**< @brief Upper bound, infinity for the last bucket */
+            uint64_t count{}; /**< @brief Acks with a latency in this bucket */
+        };
+
+        uint16_t command{}; /**< @brief Command ID (MAV_CMD) */
+        uint64_t acks{}; /**< @brief Final acks received, whatever their result */
+        uint64_t timeouts{}; /**< @brief Commands given up on after retrying */
+        double min_latency_s{}; /**< @brief Smallest latency */
+        double mean_latency_s{}; /**< @brief Mean latency */
+        double max_latency_s{}; /**< @brief Largest latency */
+        double p50_latency_s{}; /**< @brief Median latency */
+        double p90_latency_s{}; /**< @brief 90th percentile latency */
+        double p99_latency_s{}; /**< @brief 99th percentile latency */
+        std::vector<Bucket> histogram{}; /**< @brief Latency histogram */
+    };
+
+    /**
+     * @brief Get ack latency statistics per command ID, of all commands sent so far.
+     *
+     * @return The statistics, sorted by command ID.
+     */
+    std::vector<CommandStats> command_stats() const;
+
     /**
      * @brief Get a vector of systems which have been discovered or set-up.
      *
@@ -343,6 +548,56 @@ public:
          */
         void set_compatibility_mode(CompatibilityMode mode);
 
+        /**
+         * @brief Get the send queue size of TCP and serial connections.
+         * @return Maximum number of messages queued for sending per connection.
+         */
+        unsigned get_send_queue_size() const;
+
+        /**
+         * @brief Set the send queue size of TCP and serial connections.
+         *
+         * Messages are queued and written in the background, so a slow link
+         * (e.g. a 57600 baud radio) does not hold up MAVSDK. If the queue is
+         * full, the oldest queued message is dropped to make room. Commands
+         * and command acks are never dropped.
+         *
+         * This applies to connections added after setting it.
+         *
+         * Default: 256
+         *
+         * @param size Maximum number of messages queued per connection, at least 1.
+         */
+        void set_send_queue_size(unsigned size);
+
+        /**
+         * @brief Get the number of threads processing I/O and messages.
+         * @return Number of io threads.
+         */
+        unsigned get_io_thread_count() const;
+
+        /**
+         * @brief Set the number of threads processing I/O and messages.
+         *
+         * With one thread, all connections and all systems are handled by the
+         * same thread. With more, connections stay on the first thread while
+         * each discovered system is assigned to one of the others, round-robin.
+         * Messages of different systems are then processed in parallel, while
+         * the messages of one system are still processed one after the other,
+         * in the order they were received.
+         *
+         * This is useful when connected to many systems at once. User
+         * callbacks are still called one at a time.
+         *
+         * This only applies to the configuration passed to the Mavsdk
+         * constructor.
+         *
+         * Default: 1
+         *
+         * @param count Number of io threads, at least 1.
+         */
+        void set_io_thread_count(unsigned count);
+
     private:
         uint8_t _system_id;
         uint8_t _component_id;
@@ -352,6 +607,8 @@ public:
         MAV_TYPE _mav_type;
         Autopilot _autopilot{Autopilot::Unknown};
         CompatibilityMode _compatibility_mode{CompatibilityMode::Auto};
+        unsigned _send_queue_size{256};
+        unsigned _io_thread_count{1};
 
         static ComponentType component_type_for_component_id(uint8_t component_id);
     };
@@ -634,6 +891,33 @@ public:
      */
     [[nodiscard]] bool start_tlog_recording(const std::string& path);
 
+    /**
+     * @brief Options for .tlog and capture recording.
+     *
+     * Messages are copied into one of two buffers and written to the file by
+     * a background thread, so disk latency does not hold up message
+     * processing. If both buffers are full because the file can't keep up,
+     * new messages are dropped and counted in RecordingStats.
+     */
+    struct RecordingOptions {
+        double flush_interval_s{0.5}; /**< @brief Max time before buffered messages are written
+                                         to the file */
+        size_t buffer_size_bytes{256 * 1024}; /**< @brief Size of each of the two buffers */
+    };
+
+    /**
+     * @brief Start recording all incoming MAVLink traffic to a .tlog file.
+     *
+     * Same as start_tlog_recording(const std::string&) but with custom
+     * buffering options.
+     *
+     * @param path Output file path (e.g. "flight.tlog").
+     * @param options Buffering options.
+     * @return true if the file was opened successfully, false otherwise.
+     */
+    [[nodiscard]] bool
+    start_tlog_recording(const std::string& path, const RecordingOptions& options);
+
     /**
      * @brief Stop recording and close the .tlog file.
      *
@@ -642,6 +926,74 @@ public:
      */
     void stop_tlog_recording();
 
+    /**
+     * @brief Statistics of .tlog or capture recording.
+     */
+    struct RecordingStats {
+        uint64_t messages_written{}; /**< @brief Messages written to the file */
+        uint64_t bytes_written{}; /**< @brief Bytes written to the file */
+        uint64_t messages_dropped{}; /**< @brief Messages dropped because the buffers were full
+                                        or writing failed */
+        uint64_t bytes_dropped{}; /**< @brief Bytes dropped because the buffers were full or
+                                     writing failed */
+    };
+
+    /**
+     * @brief Get statistics of the current .tlog recording.
+     *
+     * After stop_tlog_recording() this returns the statistics of the last
+     * recording.
+     *
+     * @return Statistics of the current or last recording.
+     */
+    RecordingStats tlog_stats() const;
+
+    /**
+     * @brief Start capturing all MAVLink traffic to a capture file.
+     *
+     * Unlike a .tlog, a capture contains the exact bytes of every frame that
+     * is received or sent on any connection, including frames that MAVSDK
+     * does not know or could not check, and tags each frame with its
+     * direction and connection. The records are indexed by time, so tools
+     * can seek into large captures. The format is described in
+     * src/mavsdk/core/capture_file.hpp.
+     *
+     * If capturing is already active it is stopped and restarted with the
+     * new file. Capturing is stopped automatically when the Mavsdk instance
+     * is destroyed.
+     *
+     * @param path Output file path (e.g. "flight.mavcap").
+     * @param options Buffering options.
+     * @return true if the file was opened successfully, false otherwise.
+     */
+    [[nodiscard]] bool
+    start_capture_recording(const std::string& path, const RecordingOptions& options);
+
+    /**
+     * @brief Start capturing all MAVLink traffic with default buffering options.
+     *
+     * @param path Output file path (e.g. "flight.mavcap").
+     * @return true if the file was opened successfully, false otherwise.
+     */
+    [[nodiscard]] bool start_capture_recording(const std::string& path);
+
+    /**
+     * @brief Stop capturing and finish the capture file.
+     *
+     * Does nothing if capturing is not active.
+     */
+    void stop_capture_recording();
+
+    /**
+     * @brief Get statistics of the current capture.
+     *
+     * After stop_capture_recording() this returns the statistics of the last
+     * capture.
+     *
+     * @return Statistics of the current or last capture.
+     */
+    RecordingStats capture_stats() const;
+
     /**
      * @brief Intercept outgoing messages.
      *
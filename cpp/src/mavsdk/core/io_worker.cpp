@@ -0,0 +1,61 @@
+#include "io_worker.hpp"
+
+#include <asio/post.hpp>
+
+namespace mavsdk {
+
+IoWorker::IoWorker(Time& time) : timeout_handler(time), call_every_handler(time)
+{
+    timeout_handler.set_earlier_deadline_callback(
+        [this]() { asio::post(_io_context, [this]() { schedule_timers(); }); });
+    call_every_handler.set_earlier_deadline_callback(
+        [this]() { asio::post(_io_context, [this]() { schedule_timers(); }); });
+}
+
+IoWorker::~IoWorker()
+{
+    stop();
+}
+
+void IoWorker::start()
+{
+    asio::post(_io_context, [this]() { schedule_timers(); });
+    _thread = std::make_unique<std::thread>([this]() { _io_context.run(); });
+}
+
+void IoWorker::stop()
+{
+    _io_work_guard.reset();
+    _io_context.stop();
+    if (_thread) {
+        _thread->join();
+        _thread.reset();
+    }
+}
+
+void IoWorker::schedule_timers()
+{
+    // Same as MavsdkImpl::schedule_timers(): sleep until the earliest deadline, if any.
+    auto next = timeout_handler.next_deadline();
+    const auto next_call_every = call_every_handler.next_deadline();
+    if (!next || (next_call_every && *next_call_every < *next)) {
+        next = next_call_every;
+    }
+
+    if (!next) {
+        _timers_timer.cancel();
+        return;
+    }
+
+    _timers_timer.expires_at(*next);
+    _timers_timer.async_wait([this](const asio::error_code& ec) {
+        if (ec) {
+            return;
+        }
+        timeout_handler.run_once();
+        call_every_handler.run_once();
+        schedule_timers();
+    });
+}
+
+} // namespace mavsdk
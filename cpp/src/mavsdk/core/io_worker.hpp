@@ -0,0 +1,57 @@
+#pragma once
+
+#include <memory>
+#include <thread>
+
+#include <asio/io_context.hpp>
+#include <asio/steady_timer.hpp>
+
+#include "call_every_handler.hpp"
+#include "mavsdk_export.h"
+#include "mavsdk_time.hpp"
+#include "timeout_handler.hpp"
+
+namespace mavsdk {
+
+// An io_context run by a thread of its own, together with the TimeoutHandler and
+// CallEveryHandler whose callbacks run on that thread.
+//
+// MavsdkImpl pins each system to one worker when more than one io thread is
+// configured. Everything belonging to the system then runs on the worker thread: its
+// message handlers, CallbackLists, timeouts and do_work(). That keeps the invariant
+// that this state is only touched by one thread, while different systems are processed
+// in parallel.
+class MAVSDK_TEST_EXPORT IoWorker {
+public:
+    explicit IoWorker(Time& time);
+    ~IoWorker();
+
+    IoWorker(const IoWorker&) = delete;
+    IoWorker& operator=(const IoWorker&) = delete;
+
+    void start();
+
+    // Stops the io_context and joins the thread. Handlers that have not run by then
+    // are dropped without running.
+    void stop();
+
+    asio::io_context& io_context() { return _io_context; }
+
+    TimeoutHandler timeout_handler;
+    CallEveryHandler call_every_handler;
+
+private:
+    void schedule_timers();
+
+    // Declared first so it outlives everything that posts onto it.
+    asio::io_context _io_context{};
+    asio::executor_work_guard<asio::io_context::executor_type> _io_work_guard{
+        _io_context.get_executor()};
+
+    // Armed for the earliest deadline of timeout_handler and call_every_handler.
+    asio::steady_timer _timers_timer{_io_context};
+
+    std::unique_ptr<std::thread> _thread{};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,83 @@
+#include "io_worker.hpp"
+#include <gtest/gtest.h>
+
+#include <asio/post.hpp>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+using namespace mavsdk;
+
+TEST(IoWorker, RunsPostedHandlersInOrderOnItsThread)
+{
+    Time time;
+    IoWorker io_worker(time);
+    io_worker.start();
+
+    std::vector<int> order;
+    std::thread::id worker_thread_id;
+    std::promise<void> done;
+
+    for (int i = 0; i < 100; ++i) {
+        asio::post(io_worker.io_context(), [&, i]() {
+            worker_thread_id = std::this_thread::get_id();
+            order.push_back(i);
+        });
+    }
+    asio::post(io_worker.io_context(), [&]() { done.set_value(); });
+
+    ASSERT_EQ(done.get_future().wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    EXPECT_NE(worker_thread_id, std::this_thread::get_id());
+    ASSERT_EQ(order.size(), 100u);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(order[i], i);
+    }
+}
+
+TEST(IoWorker, RunsTimeoutsAndCallEveryOnItsThread)
+{
+    Time time;
+    IoWorker io_worker(time);
+    io_worker.start();
+
+    std::promise<std::thread::id> timeout_thread_id;
+    auto cookie = io_worker.timeout_handler.add(
+        [&]() { timeout_thread_id.set_value(std::this_thread::get_id()); }, 0.01);
+    (void)cookie;
+
+    std::promise<std::thread::id> call_every_thread_id;
+    bool called = false;
+    auto call_every_cookie = io_worker.call_every_handler.add(
+        [&]() {
+            if (!called) {
+                called = true;
+                call_every_thread_id.set_value(std::this_thread::get_id());
+            }
+        },
+        0.01);
+
+    auto timeout_future = timeout_thread_id.get_future();
+    auto call_every_future = call_every_thread_id.get_future();
+    ASSERT_EQ(timeout_future.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    ASSERT_EQ(call_every_future.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+
+    const auto worker_thread_id = timeout_future.get();
+    EXPECT_NE(worker_thread_id, std::this_thread::get_id());
+    EXPECT_EQ(call_every_future.get(), worker_thread_id);
+
+    io_worker.call_every_handler.remove(call_every_cookie);
+}
+
+TEST(IoWorker, CanBeStoppedMoreThanOnce)
+{
+    Time time;
+    IoWorker io_worker(time);
+    io_worker.start();
+
+    io_worker.stop();
+    EXPECT_TRUE(io_worker.io_context().stopped());
+
+    // Also done by the destructor.
+    io_worker.stop();
+}
@@ -0,0 +1,72 @@
+#include "latest_message_slot.hpp"
+
+#include <algorithm>
+
+namespace mavsdk {
+
+namespace {
+
+uint64_t pack_header(const mavlink_message_t& message)
+{
+    return static_cast<uint64_t>(message.msgid) | (static_cast<uint64_t>(message.len) << 24) |
+           (static_cast<uint64_t>(message.sysid) << 32) |
+           (static_cast<uint64_t>(message.compid) << 40) |
+           (static_cast<uint64_t>(message.seq) << 48) |
+           (static_cast<uint64_t>(message.incompat_flags) << 56);
+}
+
+void unpack_header(uint64_t header, mavlink_message_t& message)
+{
+    message.msgid = static_cast<uint32_t>(header & 0xffffff);
+    message.len = static_cast<uint8_t>(header >> 24);
+    message.sysid = static_cast<uint8_t>(header >> 32);
+    message.compid = static_cast<uint8_t>(header >> 40);
+    message.seq = static_cast<uint8_t>(header >> 48);
+    message.incompat_flags = static_cast<uint8_t>(header >> 56);
+}
+
+} // namespace
+
+void LatestMessageSlot::store(const mavlink_message_t& message)
+{
+    const auto sequence = _sequence.load(std::memory_order_relaxed);
+    _sequence.store(sequence + 1, std::memory_order_relaxed);
+
+    // Release stores, so a reader that sees any of them also sees the odd sequence.
+    _header.store(pack_header(message), std::memory_order_release);
+    const std::size_t words = std::min<std::size_t>((message.len + 7) / 8, PAYLOAD_WORDS);
+    for (std::size_t i = 0; i < words; ++i) {
+        _payload[i].store(message.payload64[i], std::memory_order_release);
+    }
+
+    _sequence.store(sequence + 2, std::memory_order_release);
+}
+
+bool LatestMessageSlot::load_if_newer(mavlink_message_t& message, uint32_t& version) const
+{
+    while (true) {
+        const auto before = _sequence.load(std::memory_order_acquire);
+        if (before == version) {
+            return false;
+        }
+        if (before % 2 != 0) {
+            continue;
+        }
+
+        // Acquire loads, so the sequence can't be checked again before they are done.
+        unpack_header(_header.load(std::memory_order_acquire), message);
+        const std::size_t words = std::min<std::size_t>((message.len + 7) / 8, PAYLOAD_WORDS);
+        for (std::size_t i = 0; i < words; ++i) {
+            message.payload64[i] = _payload[i].load(std::memory_order_acquire);
+        }
+
+        if (_sequence.load(std::memory_order_relaxed) == before) {
+            // Decoders may read past len for truncated MAVLink 2 payloads.
+            std::fill(message.payload64 + words, message.payload64 + PAYLOAD_WORDS, 0);
+            version = before;
+            return true;
+        }
+    }
+}
+
+} // namespace mavsdk
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "mavlink_include.hpp"
+#include "mavsdk_export.h"
+
+namespace mavsdk {
+
+/*
+ * Holds a copy of the latest message received with a message ID, so it only
+ * needs to be decoded once somebody asks for it.
+ *
+ * This is a seqlock: store() is called by one thread at a time (the thread
+ * receiving messages) and never waits, while load_if_newer() can be called
+ * from any thread and retries if it raced with a store(). Only the header
+ * fields and the payload bytes actually received are copied.
+ */
+class MAVSDK_TEST_EXPORT LatestMessageSlot {
+public:
+    LatestMessageSlot() = default;
+
+    LatestMessageSlot(const LatestMessageSlot&) = delete;
+    LatestMessageSlot& operator=(const LatestMessageSlot&) = delete;
+
+    void store(const mavlink_message_t& message);
+
+    // If a message was stored since `version` (0 for none yet), copies it
+    // into `message`, sets `version` to it, and returns true.
+    bool load_if_newer(mavlink_message_t& message, uint32_t& version) const;
+
+private:
+    static constexpr std::size_t PAYLOAD_WORDS =
+        sizeof(mavlink_message_t::payload64) / sizeof(mavlink_message_t::payload64[0]);
+
+    // Odd while a store() is in progress.
+    std::atomic<uint32_t> _sequence{0};
+    std::atomic<uint64_t> _header{0};
+    std::array<std::atomic<uint64_t>, PAYLOAD_WORDS> _payload{};
+};
+
+/*
+ * A value decoded from the latest message in a LatestMessageSlot. The message
+ * is only decoded again by get() if a newer one was stored.
+ *
+ * store() has the same rules as LatestMessageSlot::store(), calls to get()
+ * have to be serialized by the caller.
+ */
+template<typename T> class LazilyDecoded {
+public:
+    void store(const mavlink_message_t& message) { _slot.store(message); }
+
+    template<typename Decode> const T& get(Decode&& decode)
+    {
+        mavlink_message_t message;
+        if (_slot.load_if_newer(message, _version)) {
+            _value = decode(message);
+        }
+        return _value;
+    }
+
+private:
+    LatestMessageSlot _slot{};
+    uint32_t _version{0};
+    T _value{};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,131 @@
+#include "latest_message_slot.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+
+using namespace mavsdk;
+
+namespace {
+
+mavlink_message_t make_message(uint32_t msgid, uint8_t len, uint64_t fill)
+{
+    mavlink_message_t message{};
+    message.msgid = msgid;
+    message.len = len;
+    message.sysid = 1;
+    message.compid = 2;
+    message.seq = 3;
+    for (std::size_t i = 0; i < static_cast<std::size_t>((len + 7) / 8); ++i) {
+        message.payload64[i] = fill;
+    }
+    return message;
+}
+
+} // namespace
+
+TEST(LatestMessageSlot, EmptyUntilStored)
+{
+    LatestMessageSlot slot;
+    mavlink_message_t message{};
+    uint32_t version = 0;
+
+    EXPECT_FALSE(slot.load_if_newer(message, version));
+}
+
+TEST(LatestMessageSlot, LoadsLatestOnlyOnce)
+{
+    LatestMessageSlot slot;
+    mavlink_message_t message{};
+    uint32_t version = 0;
+
+    slot.store(make_message(105, 62, 0x1111));
+    slot.store(make_message(105, 62, 0x2222));
+
+    ASSERT_TRUE(slot.load_if_newer(message, version));
+    EXPECT_EQ(message.msgid, 105u);
+    EXPECT_EQ(message.len, 62);
+    EXPECT_EQ(message.sysid, 1);
+    EXPECT_EQ(message.compid, 2);
+    EXPECT_EQ(message.seq, 3);
+    EXPECT_EQ(message.payload64[0], 0x2222u);
+    EXPECT_EQ(message.payload64[7], 0x2222u);
+
+    EXPECT_FALSE(slot.load_if_newer(message, version));
+
+    slot.store(make_message(105, 62, 0x3333));
+    ASSERT_TRUE(slot.load_if_newer(message, version));
+    EXPECT_EQ(message.payload64[0], 0x3333u);
+}
+
+TEST(LatestMessageSlot, ZeroesBeyondTruncatedPayload)
+{
+    LatestMessageSlot slot;
+    mavlink_message_t message{};
+    uint32_t version = 0;
+
+    slot.store(make_message(105, 62, 0x1111));
+    // A MAVLink 2 message with trailing zeros cut off.
+    slot.store(make_message(105, 9, 0x2222));
+
+    ASSERT_TRUE(slot.load_if_newer(message, version));
+    EXPECT_EQ(message.payload64[0], 0x2222u);
+    EXPECT_EQ(message.payload64[1], 0x2222u);
+    EXPECT_EQ(message.payload64[2], 0u);
+    EXPECT_EQ(message.payload64[7], 0u);
+}
+
+TEST(LatestMessageSlot, ReadWhileStoring)
+{
+    LatestMessageSlot slot;
+    std::atomic<bool> done{false};
+
+    std::thread writer([&]() {
+        for (uint64_t i = 1; i <= 100000; ++i) {
+            slot.store(make_message(static_cast<uint32_t>(i & 0xffff), 255, i));
+        }
+        done = true;
+    });
+
+    mavlink_message_t message{};
+    uint32_t version = 0;
+    uint64_t last = 0;
+    while (!done) {
+        if (!slot.load_if_newer(message, version)) {
+            continue;
+        }
+        // Never a mix of two messages.
+        const uint64_t value = message.payload64[0];
+        EXPECT_EQ(message.msgid, value & 0xffff);
+        EXPECT_EQ(message.payload64[31], value);
+        EXPECT_GT(value, last);
+        last = value;
+    }
+
+    writer.join();
+
+    if (slot.load_if_newer(message, version)) {
+        last = message.payload64[0];
+    }
+    EXPECT_EQ(last, 100000u);
+}
+
+TEST(LazilyDecoded, DecodesOnlyNewMessages)
+{
+    LazilyDecoded<uint64_t> value;
+    unsigned decoded = 0;
+    const auto decode = [&decoded](const mavlink_message_t& message) {
+        ++decoded;
+        return message.payload64[0];
+    };
+
+    EXPECT_EQ(value.get(decode), 0u);
+    EXPECT_EQ(decoded, 0u);
+
+    value.store(make_message(2, 12, 42));
+    value.store(make_message(2, 12, 43));
+    EXPECT_EQ(value.get(decode), 43u);
+    EXPECT_EQ(value.get(decode), 43u);
+    EXPECT_EQ(decoded, 1u);
+}
@@ -65,50 +65,14 @@ LibmavReceiver::LibmavReceiver(MavsdkImpl& mavsdk_impl) : _mavsdk_impl(mavsdk_im
 
 LibmavReceiver::~LibmavReceiver() = default;
 
-void LibmavReceiver::set_new_datagram(char* datagram, unsigned datagram_len)
-{
-    // Append new data to accumulation buffer (for serial where messages can span multiple reads)
-    _accumulation_buffer.insert(
-        _accumulation_buffer.end(),
-        reinterpret_cast<uint8_t*>(datagram),
-        reinterpret_cast<uint8_t*>(datagram) + datagram_len);
-
-    // Prevent unbounded growth
-    if (_accumulation_buffer.size() > ACCUMULATION_BUFFER_SIZE) {
-        // Drop oldest bytes to make room
-        size_t bytes_to_drop = _accumulation_buffer.size() - ACCUMULATION_BUFFER_SIZE;
-        _accumulation_buffer.erase(
-            _accumulation_buffer.begin(),
-            _accumulation_buffer.begin() + static_cast<ptrdiff_t>(bytes_to_drop));
-    }
-}
-
-bool LibmavReceiver::parse_message()
-{
-    if (_accumulation_buffer.empty()) {
-        return false;
-    }
-
-    // Use libmav to parse messages from the accumulation buffer
-    return parse_libmav_message_from_buffer();
-}
-
-bool LibmavReceiver::parse_libmav_message_from_buffer()
+bool LibmavReceiver::parse_frame(const uint8_t* frame, size_t frame_len)
 {
     size_t bytes_consumed = 0;
 
     // Use thread-safe parsing from MavsdkImpl (handles MessageSet synchronization internally)
-    auto message_opt = _mavsdk_impl.parse_message_safe(
-        _accumulation_buffer.data(), _accumulation_buffer.size(), bytes_consumed);
+    auto message_opt = _mavsdk_impl.parse_message_safe(frame, frame_len, bytes_consumed);
 
     if (!message_opt) {
-        // No complete message found - consume bytes before the magic byte (if any)
-        // to avoid reprocessing garbage bytes on the next attempt
-        if (bytes_consumed > 0) {
-            _accumulation_buffer.erase(
-                _accumulation_buffer.begin(),
-                _accumulation_buffer.begin() + static_cast<ptrdiff_t>(bytes_consumed));
-        }
         return false;
     }
 
@@ -130,17 +94,8 @@ bool LibmavReceiver::parse_libmav_message_from_buffer()
     _last_message.system_id = header.systemId();
     _last_message.component_id = header.componentId();
 
-    if (_last_libmav_message) {
-        const uint32_t wire_len = _last_libmav_message->finalizedSize();
-        if (wire_len > 0) {
-            const uint8_t* wire_ptr = _last_libmav_message->data();
-            _last_message.raw_bytes.assign(wire_ptr, wire_ptr + wire_len);
-        } else {
-            _last_message.raw_bytes.clear();
-        }
-    } else {
-        _last_message.raw_bytes.clear();
-    }
+    // The frame is exactly what came in on the wire.
+    _last_message.raw_bytes.assign(frame, frame + frame_len);
 
     // Extract target_system and target_component if present in message fields
     uint8_t target_system_id = 0;
@@ -158,11 +113,6 @@ bool LibmavReceiver::parse_libmav_message_from_buffer()
 
     _last_message.fields_json = json;
 
-    // Remove the consumed bytes from the accumulation buffer
-    _accumulation_buffer.erase(
-        _accumulation_buffer.begin(),
-        _accumulation_buffer.begin() + static_cast<ptrdiff_t>(bytes_consumed));
-
     return true;
 }
 
@@ -36,9 +36,9 @@ public:
         return _last_libmav_message;
     }
 
-    void set_new_datagram(char* datagram, unsigned datagram_len);
-
-    bool parse_message();
+    // Decode one complete frame, as framed by MavlinkReceiver, with libmav. Returns false
+    // if libmav doesn't know the message or the CRC doesn't check out.
+    bool parse_frame(const uint8_t* frame, size_t frame_len);
 
     // Message creation for sending
     std::optional<mav::Message> create_message(const std::string& message_name) const;
@@ -59,22 +59,7 @@ private:
     Mavsdk::MavlinkMessage _last_message;
     std::optional<mav::Message> _last_libmav_message; // Separate libmav message for integration
 
-    // Accumulation buffer for connections where messages can span multiple reads.
-    //
-    // This bound is only a safety valve against unbounded growth; the parser normally
-    // drains the buffer (it consumes complete messages and skips garbage before the magic
-    // byte), so at most one partial message is ever pending. It must therefore be at least
-    // as large as a single read (the 2048-byte connection receive buffers) plus one full
-    // message, otherwise set_new_datagram() would drop the front of a large read *before*
-    // parsing and silently lose the messages in it.
-    static constexpr size_t ACCUMULATION_BUFFER_SIZE =
-        2048 + mav::MessageDefinition::MAX_MESSAGE_SIZE;
-    std::vector<uint8_t> _accumulation_buffer;
-
     bool _debugging = false;
-
-    // Helper methods
-    bool parse_libmav_message_from_buffer();
 };
 
 } // namespace mavsdk
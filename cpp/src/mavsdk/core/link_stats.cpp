@@ -0,0 +1,132 @@
+#include "link_stats.hpp"
+
+namespace mavsdk {
+
+LinkStats::LinkStats(Clock::time_point now) : _last_rates_update(now) {}
+
+void LinkStats::count_received(std::size_t frame_len)
+{
+    _bytes_received.fetch_add(frame_len, std::memory_order_relaxed);
+    _messages_received.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LinkStats::count_bad_crc(std::size_t frame_len)
+{
+    _bytes_received.fetch_add(frame_len, std::memory_order_relaxed);
+    _crc_errors.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LinkStats::count_sequence(uint8_t system_id, uint8_t component_id, uint8_t sequence)
+{
+    Sender* sender = find_or_add_sender(system_id, component_id);
+    if (sender == nullptr) {
+        return;
+    }
+
+    if (sender->messages_received.load(std::memory_order_relaxed) != 0) {
+        // The same sequence again is a duplicate rather than 255 lost messages.
+        const auto gap = static_cast<uint8_t>(sequence - sender->last_sequence - 1);
+        if (gap != 0 && sequence != sender->last_sequence) {
+            sender->messages_lost.fetch_add(gap, std::memory_order_relaxed);
+        }
+    }
+    sender->last_sequence = sequence;
+    sender->messages_received.fetch_add(1, std::memory_order_relaxed);
+}
+
+LinkStats::Sender* LinkStats::find_or_add_sender(uint8_t system_id, uint8_t component_id)
+{
+    // Mostly, the same component sends several messages in a row.
+    const auto num_senders = _num_senders.load(std::memory_order_relaxed);
+    if (_last_sender < num_senders && _senders[_last_sender].system_id == system_id &&
+        _senders[_last_sender].component_id == component_id) {
+        return &_senders[_last_sender];
+    }
+
+    for (std::size_t i = 0; i < num_senders; ++i) {
+        if (_senders[i].system_id == system_id && _senders[i].component_id == component_id) {
+            _last_sender = i;
+            return &_senders[i];
+        }
+    }
+
+    if (num_senders == MAX_SENDERS) {
+        return nullptr;
+    }
+
+    _senders[num_senders].system_id = system_id;
+    _senders[num_senders].component_id = component_id;
+    _num_senders.store(num_senders + 1, std::memory_order_release);
+    _last_sender = num_senders;
+    return &_senders[num_senders];
+}
+
+void LinkStats::count_sent(std::size_t frame_len)
+{
+    _bytes_sent.fetch_add(frame_len, std::memory_order_relaxed);
+    _messages_sent.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LinkStats::count_send_failure()
+{
+    _send_failures.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LinkStats::update_rates(Clock::time_point now)
+{
+    const double elapsed_s = std::chrono::duration<double>(now - _last_rates_update).count();
+    if (elapsed_s <= 0.0) {
+        return;
+    }
+    _last_rates_update = now;
+
+    const auto rate = [elapsed_s](uint64_t total, uint64_t& last) {
+        const double result = static_cast<double>(total - last) / elapsed_s;
+        last = total;
+        return result;
+    };
+
+    _bytes_received_per_s.store(
+        rate(_bytes_received.load(std::memory_order_relaxed), _last_bytes_received),
+        std::memory_order_relaxed);
+    _messages_received_per_s.store(
+        rate(_messages_received.load(std::memory_order_relaxed), _last_messages_received),
+        std::memory_order_relaxed);
+    _bytes_sent_per_s.store(
+        rate(_bytes_sent.load(std::memory_order_relaxed), _last_bytes_sent),
+        std::memory_order_relaxed);
+    _messages_sent_per_s.store(
+        rate(_messages_sent.load(std::memory_order_relaxed), _last_messages_sent),
+        std::memory_order_relaxed);
+}
+
+Mavsdk::ConnectionStats LinkStats::get() const
+{
+    Mavsdk::ConnectionStats stats;
+    stats.bytes_received = _bytes_received.load(std::memory_order_relaxed);
+    stats.messages_received = _messages_received.load(std::memory_order_relaxed);
+    stats.crc_errors = _crc_errors.load(std::memory_order_relaxed);
+    stats.bytes_sent = _bytes_sent.load(std::memory_order_relaxed);
+    stats.messages_sent = _messages_sent.load(std::memory_order_relaxed);
+    stats.send_failures = _send_failures.load(std::memory_order_relaxed);
+    stats.bytes_received_per_s = _bytes_received_per_s.load(std::memory_order_relaxed);
+    stats.messages_received_per_s = _messages_received_per_s.load(std::memory_order_relaxed);
+    stats.bytes_sent_per_s = _bytes_sent_per_s.load(std::memory_order_relaxed);
+    stats.messages_sent_per_s = _messages_sent_per_s.load(std::memory_order_relaxed);
+
+    const auto num_senders = _num_senders.load(std::memory_order_acquire);
+    stats.senders.reserve(num_senders);
+    for (std::size_t i = 0; i < num_senders; ++i) {
+        Mavsdk::ConnectionStats::Sender sender;
+        sender.system_id = _senders[i].system_id;
+        sender.component_id = _senders[i].component_id;
+        sender.messages_received = _senders[i].messages_received.load(std::memory_order_relaxed);
+        sender.messages_lost = _senders[i].messages_lost.load(std::memory_order_relaxed);
+        stats.messages_lost += sender.messages_lost;
+        stats.senders.push_back(sender);
+    }
+
+    return stats;
+}
+
+} // namespace mavsdk
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "mavsdk.hpp"
+#include "mavsdk_export.h"
+
+namespace mavsdk {
+
+/*
+ * Counters of what was received and sent on one connection, behind
+ * Mavsdk::connection_stats().
+ *
+ * Every received frame is counted by the thread receiving on the connection,
+ * so the receive side needs no locking. Lost messages are detected from gaps
+ * in the sequence numbers, which each component counts up for every message
+ * it sends. This is tracked for up to MAX_SENDERS components; messages of
+ * further components are counted, but losses are not detected for them.
+ *
+ * All counters are relaxed atomics and get() can be called from any thread,
+ * so the snapshot is not necessarily consistent across counters.
+ */
+class MAVSDK_TEST_EXPORT LinkStats {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::size_t MAX_SENDERS = 64;
+
+    explicit LinkStats(Clock::time_point now = Clock::now());
+
+    LinkStats(const LinkStats&) = delete;
+    LinkStats& operator=(const LinkStats&) = delete;
+
+    // Only called by the thread receiving on the connection. The sequence is
+    // only passed for frames with a valid CRC.
+    void count_received(std::size_t frame_len);
+    void count_bad_crc(std::size_t frame_len);
+    void count_sequence(uint8_t system_id, uint8_t component_id, uint8_t sequence);
+
+    // From any thread.
+    void count_sent(std::size_t frame_len);
+    void count_send_failure();
+
+    // Updates the rates with what was counted since the last call, meant to be
+    // called periodically from one thread.
+    void update_rates(Clock::time_point now);
+
+    // The send queue fields are left for the connection to fill in.
+    Mavsdk::ConnectionStats get() const;
+
+private:
+    struct Sender {
+        // Written by the receiving thread before the sender is published.
+        uint8_t system_id{0};
+        uint8_t component_id{0};
+        // Only used by the receiving thread.
+        uint8_t last_sequence{0};
+        std::atomic<uint64_t> messages_received{0};
+        std::atomic<uint64_t> messages_lost{0};
+    };
+
+    Sender* find_or_add_sender(uint8_t system_id, uint8_t component_id);
+
+    std::atomic<uint64_t> _bytes_received{0};
+    std::atomic<uint64_t> _messages_received{0};
+    std::atomic<uint64_t> _crc_errors{0};
+    std::atomic<uint64_t> _bytes_sent{0};
+    std::atomic<uint64_t> _messages_sent{0};
+    std::atomic<uint64_t> _send_failures{0};
+
+    std::array<Sender, MAX_SENDERS> _senders{};
+    std::atomic<std::size_t> _num_senders{0};
+    // Index of the sender of the previous message, only used by the receiving thread.
+    std::size_t _last_sender{0};
+
+    // Only used by update_rates().
+    Clock::time_point _last_rates_update;
+    uint64_t _last_bytes_received{0};
+    uint64_t _last_messages_received{0};
+    uint64_t _last_bytes_sent{0};
+    uint64_t _last_messages_sent{0};
+
+    std::atomic<double> _bytes_received_per_s{0.0};
+    std::atomic<double> _messages_received_per_s{0.0};
+    std::atomic<double> _bytes_sent_per_s{0.0};
+    std::atomic<double> _messages_sent_per_s{0.0};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,159 @@
+#include "link_stats.hpp"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+using namespace mavsdk;
+
+TEST(LinkStats, StartsEmpty)
+{
+    LinkStats link_stats;
+
+    const auto stats = link_stats.get();
+    EXPECT_EQ(stats.bytes_received, 0u);
+    EXPECT_EQ(stats.messages_received, 0u);
+    EXPECT_EQ(stats.messages_sent, 0u);
+    EXPECT_EQ(stats.messages_lost, 0u);
+    EXPECT_TRUE(stats.senders.empty());
+}
+
+TEST(LinkStats, CountsReceivedAndSent)
+{
+    LinkStats link_stats;
+
+    link_stats.count_received(21);
+    link_stats.count_received(30);
+    link_stats.count_bad_crc(12);
+    link_stats.count_sent(21);
+    link_stats.count_sent(40);
+    link_stats.count_send_failure();
+
+    const auto stats = link_stats.get();
+    EXPECT_EQ(stats.bytes_received, 63u);
+    EXPECT_EQ(stats.messages_received, 2u);
+    EXPECT_EQ(stats.crc_errors, 1u);
+    EXPECT_EQ(stats.bytes_sent, 61u);
+    EXPECT_EQ(stats.messages_sent, 2u);
+    EXPECT_EQ(stats.send_failures, 1u);
+}
+
+TEST(LinkStats, DetectsSequenceGapsPerSender)
+{
+    LinkStats link_stats;
+
+    // Autopilot: 10, 11, 14 (2 lost), 15.
+    link_stats.count_sequence(1, 1, 10);
+    link_stats.count_sequence(1, 1, 11);
+    // Camera interleaved, with its own sequence: 200, 201.
+    link_stats.count_sequence(1, 100, 200);
+    link_stats.count_sequence(1, 1, 14);
+    link_stats.count_sequence(1, 100, 201);
+    link_stats.count_sequence(1, 1, 15);
+
+    const auto stats = link_stats.get();
+    EXPECT_EQ(stats.messages_lost, 2u);
+    ASSERT_EQ(stats.senders.size(), 2u);
+
+    EXPECT_EQ(stats.senders[0].system_id, 1);
+    EXPECT_EQ(stats.senders[0].component_id, 1);
+    EXPECT_EQ(stats.senders[0].messages_received, 4u);
+    EXPECT_EQ(stats.senders[0].messages_lost, 2u);
+
+    EXPECT_EQ(stats.senders[1].system_id, 1);
+    EXPECT_EQ(stats.senders[1].component_id, 100);
+    EXPECT_EQ(stats.senders[1].messages_received, 2u);
+    EXPECT_EQ(stats.senders[1].messages_lost, 0u);
+}
+
+TEST(LinkStats, SequenceWrapsAround)
+{
+    LinkStats link_stats;
+
+    link_stats.count_sequence(1, 1, 254);
+    link_stats.count_sequence(1, 1, 255);
+    link_stats.count_sequence(1, 1, 0);
+    link_stats.count_sequence(1, 1, 3);
+
+    EXPECT_EQ(link_stats.get().messages_lost, 2u);
+}
+
+TEST(LinkStats, DuplicateIsNotCountedAsLost)
+{
+    LinkStats link_stats;
+
+    link_stats.count_sequence(1, 1, 7);
+    link_stats.count_sequence(1, 1, 7);
+    link_stats.count_sequence(1, 1, 8);
+
+    const auto stats = link_stats.get();
+    EXPECT_EQ(stats.messages_lost, 0u);
+    ASSERT_EQ(stats.senders.size(), 1u);
+    EXPECT_EQ(stats.senders[0].messages_received, 3u);
+}
+
+TEST(LinkStats, TracksLimitedNumberOfSenders)
+{
+    LinkStats link_stats;
+
+    for (unsigned i = 0; i < LinkStats::MAX_SENDERS + 10; ++i) {
+        link_stats.count_sequence(static_cast<uint8_t>(i + 1), 1, 0);
+    }
+
+    EXPECT_EQ(link_stats.get().senders.size(), LinkStats::MAX_SENDERS);
+}
+
+TEST(LinkStats, Rates)
+{
+    const auto start = LinkStats::Clock::time_point{};
+    LinkStats link_stats(start);
+
+    for (unsigned i = 0; i < 50; ++i) {
+        link_stats.count_received(20);
+    }
+    for (unsigned i = 0; i < 10; ++i) {
+        link_stats.count_sent(30);
+    }
+    link_stats.update_rates(start + std::chrono::milliseconds(500));
+
+    auto stats = link_stats.get();
+    EXPECT_DOUBLE_EQ(stats.messages_received_per_s, 100.0);
+    EXPECT_DOUBLE_EQ(stats.bytes_received_per_s, 2000.0);
+    EXPECT_DOUBLE_EQ(stats.messages_sent_per_s, 20.0);
+    EXPECT_DOUBLE_EQ(stats.bytes_sent_per_s, 600.0);
+
+    // Only what was counted since the last update.
+    link_stats.count_received(20);
+    link_stats.update_rates(start + std::chrono::milliseconds(1500));
+
+    stats = link_stats.get();
+    EXPECT_DOUBLE_EQ(stats.messages_received_per_s, 1.0);
+    EXPECT_DOUBLE_EQ(stats.messages_sent_per_s, 0.0);
+}
+
+TEST(LinkStats, ReadWhileReceiving)
+{
+    LinkStats link_stats;
+
+    std::thread receiver([&]() {
+        for (unsigned i = 0; i < 100000; ++i) {
+            link_stats.count_received(20);
+            link_stats.count_sequence(static_cast<uint8_t>(i % 8), 1, static_cast<uint8_t>(i / 8));
+        }
+    });
+
+    uint64_t last_received = 0;
+    for (unsigned i = 0; i < 1000; ++i) {
+        const auto stats = link_stats.get();
+        EXPECT_GE(stats.messages_received, last_received);
+        last_received = stats.messages_received;
+        EXPECT_LE(stats.senders.size(), 8u);
+    }
+
+    receiver.join();
+
+    const auto stats = link_stats.get();
+    EXPECT_EQ(stats.messages_received, 100000u);
+    EXPECT_EQ(stats.messages_lost, 0u);
+    EXPECT_EQ(stats.senders.size(), 8u);
+}
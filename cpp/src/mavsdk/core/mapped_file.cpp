@@ -0,0 +1,145 @@
+#include "mapped_file.hpp"
+#include "log.hpp"
+
+#ifdef WINDOWS
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mavsdk {
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+#ifdef WINDOWS
+
+bool MappedFile::open(const std::string& path)
+{
+    close();
+
+    HANDLE file = CreateFileA(
+        path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_FLAG_SEQUENTIAL_SCAN,
+        nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        LogErr("Could not open {}: error {}", path, GetLastError());
+        return false;
+    }
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size)) {
+        LogErr("Could not get size of {}: error {}", path, GetLastError());
+        CloseHandle(file);
+        return false;
+    }
+    _file_handle = file;
+
+    if (size.QuadPart == 0) {
+        // Mapping an empty file is not possible, nor needed.
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        LogErr("Could not map {}: error {}", path, GetLastError());
+        close();
+        return false;
+    }
+    _mapping_handle = mapping;
+
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (data == nullptr) {
+        LogErr("Could not map {}: error {}", path, GetLastError());
+        close();
+        return false;
+    }
+
+    _data = static_cast<const uint8_t*>(data);
+    _size = static_cast<std::size_t>(size.QuadPart);
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (_data != nullptr) {
+        UnmapViewOfFile(_data);
+    }
+    if (_mapping_handle != nullptr) {
+        CloseHandle(_mapping_handle);
+    }
+    if (_file_handle != nullptr) {
+        CloseHandle(_file_handle);
+    }
+    _data = nullptr;
+    _size = 0;
+    _mapping_handle = nullptr;
+    _file_handle = nullptr;
+}
+
+#else
+
+bool MappedFile::open(const std::string& path)
+{
+    close();
+
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        LogErr("Could not open {}: {}", path, strerror(errno));
+        return false;
+    }
+
+    struct stat file_stat {};
+    if (fstat(fd, &file_stat) != 0) {
+        LogErr("Could not get size of {}: {}", path, strerror(errno));
+        ::close(fd);
+        return false;
+    }
+
+    if (file_stat.st_size == 0) {
+        // Mapping an empty file is not possible, nor needed.
+        ::close(fd);
+        return true;
+    }
+
+    const auto size = static_cast<std::size_t>(file_stat.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping stays valid without the file descriptor.
+    ::close(fd);
+
+    if (data == MAP_FAILED) {
+        LogErr("Could not map {}: {}", path, strerror(errno));
+        return false;
+    }
+
+    // The file is read from start to end.
+    madvise(data, size, MADV_SEQUENTIAL);
+
+    _data = static_cast<const uint8_t*>(data);
+    _size = size;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (_data != nullptr) {
+        munmap(const_cast<uint8_t*>(_data), _size);
+    }
+    _data = nullptr;
+    _size = 0;
+}
+
+#endif
+
+} // namespace mavsdk
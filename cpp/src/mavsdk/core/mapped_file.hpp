@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "mavsdk_export.h"
+
+namespace mavsdk {
+
+// Read-only memory mapping of a whole file.
+class MAVSDK_TEST_EXPORT MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    // nullptr if not open or the file is empty.
+    const uint8_t* data() const { return _data; }
+    std::size_t size() const { return _size; }
+
+private:
+    const uint8_t* _data{nullptr};
+    std::size_t _size{0};
+
+#ifdef WINDOWS
+    void* _file_handle{nullptr};
+    void* _mapping_handle{nullptr};
+#endif
+};
+
+} // namespace mavsdk
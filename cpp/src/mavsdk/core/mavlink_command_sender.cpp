@@ -1,16 +1,32 @@
 #include "mavlink_command_sender.hpp"
+#include "log.hpp"
 #include "mavlink_address.hpp"
-#include "system_impl.hpp"
 #include "unused.hpp"
 #include <cmath>
+#include <cstdlib>
 #include <future>
 #include <memory>
+#include <mutex>
 
 namespace mavsdk {
 
-MavlinkCommandSender::MavlinkCommandSender(SystemImpl& system_impl) :
-    _system_impl(system_impl),
-    _io_context(system_impl.io_context())
+MavlinkCommandSender::MavlinkCommandSender(
+    Sender& sender,
+    MavlinkMessageHandler& message_handler,
+    TimeoutHandler& timeout_handler,
+    Time& time,
+    asio::io_context& io_context,
+    TimeoutSCallback timeout_s_callback,
+    AutopilotCallback autopilot_callback,
+    QueueUserCallback queue_user_callback) :
+    _sender(sender),
+    _message_handler(message_handler),
+    _timeout_handler(timeout_handler),
+    _time(time),
+    _io_context(io_context),
+    _timeout_s_callback(std::move(timeout_s_callback)),
+    _autopilot_callback(std::move(autopilot_callback)),
+    _queue_user_callback(std::move(queue_user_callback))
 {
     if (const char* env_p = std::getenv("MAVSDK_COMMAND_DEBUGGING")) {
         if (std::string(env_p) == "1") {
@@ -19,7 +35,7 @@ MavlinkCommandSender::MavlinkCommandSender(SystemImpl& system_impl) :
         }
     }
 
-    _system_impl.register_mavlink_message_handler(
+    _message_handler.register_one(
         MAVLINK_MSG_ID_COMMAND_ACK,
         [this](const mavlink_message_t& message) { receive_command_ack(message); },
         this);
@@ -30,10 +46,10 @@ MavlinkCommandSender::~MavlinkCommandSender()
     if (_command_debugging) {
         LogDebug("CommandSender destroyed");
     }
-    _system_impl.unregister_all_mavlink_message_handlers(this);
+    _message_handler.unregister_all(this);
 
     for (const auto& work : _work_queue) {
-        _system_impl.unregister_timeout_handler(work->timeout_cookie);
+        _timeout_handler.remove(work->timeout_cookie);
     }
 }
 
@@ -96,7 +112,8 @@ void MavlinkCommandSender::queue_command_async(
     }
 
     auto new_work = std::make_shared<Work>();
-    new_work->timeout_s = _system_impl.timeout_s();
+    new_work->id = _next_work_id++;
+    new_work->timeout_s = _timeout_s_callback();
     new_work->command = command;
     new_work->identification = identification_from_command(command);
     new_work->callback = callback;
@@ -132,11 +149,12 @@ void MavlinkCommandSender::queue_command_async(
     }
 
     auto new_work = std::make_shared<Work>();
-    new_work->timeout_s = _system_impl.timeout_s();
+    new_work->id = _next_work_id++;
+    new_work->timeout_s = _timeout_s_callback();
     new_work->command = command;
     new_work->identification = identification_from_command(command);
     new_work->callback = callback;
-    new_work->time_started = _system_impl.get_time().steady_time();
+    new_work->time_started = _time.steady_time();
     new_work->retries_to_do = retries;
     asio::post(_io_context, [this, new_work]() {
         for (const auto& work : _work_queue) {
@@ -157,15 +175,102 @@ void MavlinkCommandSender::queue_command_async(
     });
 }
 
+void MavlinkCommandSender::queue_command_batch_async(
+    const std::vector<CommandLong>& commands,
+    const BatchResultCallback& callback,
+    unsigned max_in_flight_per_target,
+    unsigned retries)
+{
+    std::vector<std::shared_ptr<Work>> new_works;
+    new_works.reserve(commands.size());
+
+    for (std::size_t i = 0; i < commands.size(); ++i) {
+        if (_command_debugging) {
+            LogDebug(
+                "COMMAND_LONG {} to send to {}, {} (pipelined)",
+                static_cast<int>(commands[i].command),
+                static_cast<int>(commands[i].target_system_id),
+                static_cast<int>(commands[i].target_component_id));
+        }
+
+        auto new_work = std::make_shared<Work>();
+        new_work->id = _next_work_id++;
+        new_work->timeout_s = _timeout_s_callback();
+        new_work->command = commands[i];
+        new_work->identification = identification_from_command(commands[i]);
+        new_work->callback = [callback, i](Result result, float) {
+            if (callback && result != Result::InProgress) {
+                callback(i, result);
+            }
+        };
+        new_work->retries_to_do = retries;
+        new_work->pipelined = true;
+        new_work->max_in_flight_per_target = max_in_flight_per_target;
+        new_works.push_back(new_work);
+    }
+
+    asio::post(_io_context, [this, new_works = std::move(new_works)]() {
+        for (const auto& new_work : new_works) {
+            _work_queue.push_back(new_work);
+        }
+        // Not waiting for the next scheduled do_work() saves up to one period for the batch.
+        do_work();
+    });
+}
+
+void MavlinkCommandSender::queue_commands_async(
+    const std::vector<CommandLong>& commands,
+    const CommandResultCallback& callback,
+    unsigned retries)
+{
+    if (commands.empty()) {
+        call_callback(callback, Result::Success, 1.0f);
+        return;
+    }
+
+    struct Batch {
+        std::mutex mutex{};
+        std::size_t remaining{0};
+        std::size_t first_failed_index{0};
+        Result result{Result::Success};
+    };
+
+    auto batch = std::make_shared<Batch>();
+    batch->remaining = commands.size();
+    batch->first_failed_index = commands.size();
+
+    queue_command_batch_async(
+        commands,
+        [batch, callback](std::size_t index, Result result) {
+            Result temp_result{Result::Success};
+            {
+                std::lock_guard<std::mutex> lock(batch->mutex);
+                if (result != Result::Success && index < batch->first_failed_index) {
+                    batch->first_failed_index = index;
+                    batch->result = result;
+                }
+                if (--batch->remaining > 0) {
+                    return;
+                }
+                temp_result = batch->result;
+            }
+
+            if (callback) {
+                callback(temp_result, temp_result == Result::Success ? 1.0f : NAN);
+            }
+        },
+        0,
+        retries);
+}
+
 void MavlinkCommandSender::receive_command_ack(const mavlink_message_t& message)
 {
     mavlink_command_ack_t command_ack;
     mavlink_msg_command_ack_decode(&message, &command_ack);
 
-    if ((command_ack.target_system &&
-         command_ack.target_system != _system_impl.get_own_system_id()) ||
+    if ((command_ack.target_system && command_ack.target_system != _sender.get_own_system_id()) ||
         (command_ack.target_component &&
-         command_ack.target_component != _system_impl.get_own_component_id())) {
+         command_ack.target_component != _sender.get_own_component_id())) {
         if (_command_debugging) {
             LogDebug(
                 "Ignoring command ack for command {} from {}{}{} to {}{}{}",
@@ -188,7 +293,9 @@ void MavlinkCommandSender::receive_command_ack(const mavlink_message_t& message)
             return;
         }
 
-        if (work->identification.command != command_ack.command ||
+        // Pipelined commands with the same ID are acked in the order they were sent, so an
+        // ack can only belong to the first of them that was actually sent.
+        if (!work->already_sent || work->identification.command != command_ack.command ||
             (work->identification.target_system_id != 0 &&
              work->identification.target_system_id != message.sysid) ||
             (work->identification.target_component_id != 0 &&
@@ -202,7 +309,7 @@ void MavlinkCommandSender::receive_command_ack(const mavlink_message_t& message)
                     work->identification.command,
                     work->identification.target_system_id,
                     work->identification.target_component_id,
-                    static_cast<int>(_system_impl.get_time().elapsed_since_s(work->time_started)));
+                    static_cast<int>(_time.elapsed_since_s(work->time_started)));
             }
             continue;
         }
@@ -212,15 +319,17 @@ void MavlinkCommandSender::receive_command_ack(const mavlink_message_t& message)
                 "Received command ack for {} with result {} after {} s",
                 command_ack.command,
                 static_cast<int>(command_ack.result),
-                static_cast<int>(_system_impl.get_time().elapsed_since_s(work->time_started)));
+                static_cast<int>(_time.elapsed_since_s(work->time_started)));
         }
 
         CommandResultCallback temp_callback = work->callback;
         std::pair<Result, float> temp_result{Result::UnknownError, NAN};
+        const uint16_t command = work->identification.command;
+        const double latency_s = _time.elapsed_since_s(work->time_started);
 
         switch (command_ack.result) {
             case MAV_RESULT_ACCEPTED:
-                _system_impl.unregister_timeout_handler(work->timeout_cookie);
+                _timeout_handler.remove(work->timeout_cookie);
                 temp_result = {Result::Success, 1.0f};
                 _work_queue.erase(it);
                 break;
@@ -232,7 +341,7 @@ void MavlinkCommandSender::receive_command_ack(const mavlink_message_t& message)
                         LogDebug("(message {})", work->identification.maybe_param1);
                     }
                 }
-                _system_impl.unregister_timeout_handler(work->timeout_cookie);
+                _timeout_handler.remove(work->timeout_cookie);
                 temp_result = {Result::Denied, NAN};
                 _work_queue.erase(it);
                 break;
@@ -241,7 +350,7 @@ void MavlinkCommandSender::receive_command_ack(const mavlink_message_t& message)
                 if (_command_debugging) {
                     LogDebug("Command unsupported ({}).", work->identification.command);
                 }
-                _system_impl.unregister_timeout_handler(work->timeout_cookie);
+                _timeout_handler.remove(work->timeout_cookie);
                 temp_result = {Result::Unsupported, NAN};
                 _work_queue.erase(it);
                 break;
@@ -250,7 +359,7 @@ void MavlinkCommandSender::receive_command_ack(const mavlink_message_t& message)
                 if (_command_debugging) {
                     LogDebug("Command temporarily rejected ({}).", work->identification.command);
                 }
-                _system_impl.unregister_timeout_handler(work->timeout_cookie);
+                _timeout_handler.remove(work->timeout_cookie);
                 temp_result = {Result::TemporarilyRejected, NAN};
                 _work_queue.erase(it);
                 break;
@@ -259,7 +368,7 @@ void MavlinkCommandSender::receive_command_ack(const mavlink_message_t& message)
                 if (_command_debugging) {
                     LogDebug("Command failed ({}).", work->identification.command);
                 }
-                _system_impl.unregister_timeout_handler(work->timeout_cookie);
+                _timeout_handler.remove(work->timeout_cookie);
                 temp_result = {Result::Failed, NAN};
                 _work_queue.erase(it);
                 break;
@@ -276,12 +385,9 @@ void MavlinkCommandSender::receive_command_ack(const mavlink_message_t& message)
                 // If we get a progress update, we can raise the timeout
                 // to something higher because we know the initial command
                 // has arrived.
-                _system_impl.unregister_timeout_handler(work->timeout_cookie);
-                work->timeout_cookie = _system_impl.register_timeout_handler(
-                    [this, identification = work->identification] {
-                        receive_timeout(identification);
-                    },
-                    3.0);
+                _timeout_handler.remove(work->timeout_cookie);
+                work->timeout_cookie =
+                    _timeout_handler.add([this, id = work->id] { receive_timeout(id); }, 3.0);
 
                 temp_result = {
                     Result::InProgress, static_cast<float>(command_ack.progress) / 100.0f};
@@ -291,7 +397,7 @@ void MavlinkCommandSender::receive_command_ack(const mavlink_message_t& message)
                 if (_command_debugging) {
                     LogDebug("Command cancelled ({}).", work->identification.command);
                 }
-                _system_impl.unregister_timeout_handler(work->timeout_cookie);
+                _timeout_handler.remove(work->timeout_cookie);
                 temp_result = {Result::Cancelled, NAN};
                 _work_queue.erase(it);
                 break;
@@ -305,6 +411,12 @@ void MavlinkCommandSender::receive_command_ack(const mavlink_message_t& message)
             call_callback(temp_callback, temp_result.first, temp_result.second);
         }
 
+        if (temp_result.first != Result::InProgress && temp_result.first != Result::UnknownError) {
+            _latency_stats.count_ack(command, latency_s);
+            // Commands waiting for this one to be done can go out now.
+            do_work();
+        }
+
         return;
     }
 
@@ -322,12 +434,13 @@ void MavlinkCommandSender::receive_command_ack(const mavlink_message_t& message)
     }
 }
 
-void MavlinkCommandSender::receive_timeout(const CommandIdentification& identification)
+void MavlinkCommandSender::receive_timeout(uint64_t id)
 {
     if (_command_debugging) {
         LogDebug("Got timeout!");
     }
     bool found_command = false;
+    bool work_done = false;
     CommandResultCallback temp_callback = nullptr;
     std::pair<Result, float> temp_result{Result::UnknownError, NAN};
 
@@ -339,7 +452,7 @@ void MavlinkCommandSender::receive_timeout(const CommandIdentification& identifi
             return;
         }
 
-        if (work->identification != identification) {
+        if (work->id != id) {
             continue;
         }
 
@@ -350,7 +463,7 @@ void MavlinkCommandSender::receive_timeout(const CommandIdentification& identifi
             if (_command_debugging) {
                 LogWarn(
                     "sending again after {} s, retries to do: {}  ({}).",
-                    static_cast<int>(_system_impl.get_time().elapsed_since_s(work->time_started)),
+                    static_cast<int>(_time.elapsed_since_s(work->time_started)),
                     work->retries_to_do,
                     work->identification.command);
 
@@ -364,14 +477,12 @@ void MavlinkCommandSender::receive_timeout(const CommandIdentification& identifi
                 temp_callback = work->callback;
                 temp_result = {Result::ConnectionError, NAN};
                 _work_queue.erase(it);
+                work_done = true;
                 break;
             } else {
                 --work->retries_to_do;
-                work->timeout_cookie = _system_impl.register_timeout_handler(
-                    [this, identification = work->identification] {
-                        receive_timeout(identification);
-                    },
-                    work->timeout_s);
+                work->timeout_cookie = _timeout_handler.add(
+                    [this, id = work->id] { receive_timeout(id); }, work->timeout_s);
             }
         } else {
             // We have tried retransmitting, giving up now.
@@ -401,9 +512,11 @@ void MavlinkCommandSender::receive_timeout(const CommandIdentification& identifi
                 }
             }
 
+            _latency_stats.count_timeout(work->identification.command);
             temp_callback = work->callback;
             temp_result = {Result::Timeout, NAN};
             _work_queue.erase(it);
+            work_done = true;
             break;
         }
     }
@@ -412,10 +525,12 @@ void MavlinkCommandSender::receive_timeout(const CommandIdentification& identifi
         call_callback(temp_callback, temp_result.first, temp_result.second);
     }
 
+    if (work_done) {
+        do_work();
+    }
+
     if (!found_command) {
-        LogWarn(
-            "Timeout for not-existing command: {}! Ignoring...",
-            static_cast<int>(identification.command));
+        LogWarn("Timeout for not-existing command work {}! Ignoring...", id);
     }
 }
 
@@ -434,7 +549,8 @@ void MavlinkCommandSender::do_work()
             }
 
             // Check if command with same command ID is already being sent.
-            if (other_work->already_sent &&
+            // Commands queued together as pipelined ones don't wait for each other.
+            if (other_work->already_sent && !(work->pipelined && other_work->pipelined) &&
                 other_work->identification.command == work->identification.command) {
                 if (_command_debugging) {
                     LogDebug(
@@ -446,12 +562,12 @@ void MavlinkCommandSender::do_work()
             }
         }
 
-        if (already_being_sent) {
+        if (already_being_sent || in_flight_window_full(*work)) {
             continue;
         }
 
         // LogDebug() << "sending it the first time (" << work->mavlink_command << ")";
-        work->time_started = _system_impl.get_time().steady_time();
+        work->time_started = _time.steady_time();
 
         {
             if (!send_mavlink_message(work->command)) {
@@ -467,10 +583,27 @@ void MavlinkCommandSender::do_work()
 
         work->already_sent = true;
 
-        work->timeout_cookie = _system_impl.register_timeout_handler(
-            [this, identification = work->identification] { receive_timeout(identification); },
-            work->timeout_s);
+        work->timeout_cookie =
+            _timeout_handler.add([this, id = work->id] { receive_timeout(id); }, work->timeout_s);
+    }
+}
+
+bool MavlinkCommandSender::in_flight_window_full(const Work& work) const
+{
+    if (work.max_in_flight_per_target == 0) {
+        return false;
+    }
+
+    unsigned in_flight = 0;
+    for (const auto& other_work : _work_queue) {
+        if (other_work->already_sent &&
+            other_work->identification.target_system_id == work.identification.target_system_id &&
+            other_work->identification.target_component_id ==
+                work.identification.target_component_id) {
+            ++in_flight;
+        }
     }
+    return in_flight >= work.max_in_flight_per_target;
 }
 
 void MavlinkCommandSender::call_callback(
@@ -483,14 +616,14 @@ void MavlinkCommandSender::call_callback(
     // It seems that we need to queue the callback on the thread pool otherwise
     // we lock ourselves out when we send a command in the callback receiving a command result.
     auto temp_callback = callback;
-    _system_impl.call_user_callback(
+    _queue_user_callback(
         [temp_callback, result, progress]() { temp_callback(result, progress); });
 }
 
 bool MavlinkCommandSender::send_mavlink_message(const Command& command) const
 {
     if (auto command_int = std::get_if<CommandInt>(&command)) {
-        return _system_impl.queue_message([&](MavlinkAddress mavlink_address, uint8_t channel) {
+        return _sender.queue_message([&](MavlinkAddress mavlink_address, uint8_t channel) {
             mavlink_message_t message;
             mavlink_msg_command_int_pack_chan(
                 mavlink_address.system_id,
@@ -514,7 +647,7 @@ bool MavlinkCommandSender::send_mavlink_message(const Command& command) const
         });
 
     } else if (auto command_long = std::get_if<CommandLong>(&command)) {
-        return _system_impl.queue_message([&](MavlinkAddress mavlink_address, uint8_t channel) {
+        return _sender.queue_message([&](MavlinkAddress mavlink_address, uint8_t channel) {
             mavlink_message_t message;
             mavlink_msg_command_long_pack_chan(
                 mavlink_address.system_id,
@@ -545,7 +678,7 @@ float MavlinkCommandSender::maybe_reserved(const std::optional<float>& maybe_par
         return maybe_param.value();
 
     } else {
-        if (_system_impl.effective_autopilot() == Autopilot::ArduPilot) {
+        if (_autopilot_callback() == Autopilot::ArduPilot) {
             return 0.0f;
         } else {
             return NAN;
@@ -1,10 +1,18 @@
 #pragma once
 
+#include "autopilot_callback.hpp"
+#include "command_latency_stats.hpp"
 #include "timeout_handler.hpp"
+#include "timeout_s_callback.hpp"
 #include "mavlink_include.hpp"
+#include "mavlink_message_handler.hpp"
+#include "mavsdk_export.h"
 #include "mavsdk_time.hpp"
+#include "sender.hpp"
+#include "user_callback.hpp"
 #include <asio/io_context.hpp>
 #include <asio/post.hpp>
+#include <atomic>
 #include <cmath>
 #include <cstdint>
 #include <deque>
@@ -13,14 +21,24 @@
 #include <mutex>
 #include <optional>
 #include <variant>
+#include <vector>
 
 namespace mavsdk {
 
-class SystemImpl;
-
-class MavlinkCommandSender {
+class MAVSDK_TEST_EXPORT MavlinkCommandSender {
 public:
-    explicit MavlinkCommandSender(SystemImpl& system_impl);
+    // Hands a callback to the user callback thread.
+    using QueueUserCallback = std::function<void(const UserCallback&)>;
+
+    MavlinkCommandSender(
+        Sender& sender,
+        MavlinkMessageHandler& message_handler,
+        TimeoutHandler& timeout_handler,
+        Time& time,
+        asio::io_context& io_context,
+        TimeoutSCallback timeout_s_callback,
+        AutopilotCallback autopilot_callback,
+        QueueUserCallback queue_user_callback);
     ~MavlinkCommandSender();
 
     static constexpr unsigned DEFAULT_RETRIES = 3;
@@ -89,6 +107,28 @@ public:
         const CommandResultCallback& callback,
         unsigned retries = DEFAULT_RETRIES);
 
+    using BatchResultCallback = std::function<void(std::size_t, Result)>;
+
+    // Sends all commands right away instead of waiting for the ack of one before sending
+    // the next, even if they share a command ID. Acks for the same command ID are then
+    // matched in the order the commands were sent. If max_in_flight_per_target is not 0,
+    // only that many of them are sent to each component before acks come back.
+    // The callback is called with the index of each command as soon as it is done.
+    void queue_command_batch_async(
+        const std::vector<CommandLong>& commands,
+        const BatchResultCallback& callback,
+        unsigned max_in_flight_per_target = 0,
+        unsigned retries = DEFAULT_RETRIES);
+
+    // Like queue_command_batch_async, but the callback is called once all are done, with
+    // the result of the first command that did not succeed, or Success.
+    void queue_commands_async(
+        const std::vector<CommandLong>& commands,
+        const CommandResultCallback& callback,
+        unsigned retries = DEFAULT_RETRIES);
+
+    const CommandLatencyStats& latency_stats() const { return _latency_stats; }
+
     void do_work();
 
     static const int DEFAULT_COMPONENT_ID_AUTOPILOT = MAV_COMP_ID_AUTOPILOT1;
@@ -120,6 +160,9 @@ private:
     };
 
     struct Work {
+        // Unique per work, unlike the identification: pipelined commands can be identical,
+        // e.g. the same command sent twice, and each needs its own timeout.
+        uint64_t id{0};
         Command command;
         CommandIdentification identification{};
         CommandResultCallback callback{};
@@ -128,6 +171,8 @@ private:
         double timeout_s{0.5};
         int retries_to_do;
         bool already_sent{false};
+        bool pipelined{false};
+        unsigned max_in_flight_per_target{0};
     };
 
     template<typename CommandType>
@@ -157,17 +202,29 @@ private:
     }
 
     void receive_command_ack(const mavlink_message_t& message);
-    void receive_timeout(const CommandIdentification& identification);
+    void receive_timeout(uint64_t id);
 
     void call_callback(const CommandResultCallback& callback, Result result, float progress) const;
 
+    bool in_flight_window_full(const Work& work) const;
+
     bool send_mavlink_message(const Command& command) const;
 
     float maybe_reserved(const std::optional<float>& maybe_param) const;
 
-    SystemImpl& _system_impl;
-    std::deque<std::shared_ptr<Work>> _work_queue{};
+    Sender& _sender;
+    MavlinkMessageHandler& _message_handler;
+    TimeoutHandler& _timeout_handler;
+    Time& _time;
     asio::io_context& _io_context;
+    TimeoutSCallback _timeout_s_callback;
+    AutopilotCallback _autopilot_callback;
+    QueueUserCallback _queue_user_callback;
+
+    std::deque<std::shared_ptr<Work>> _work_queue{};
+    // Works are created on the calling threads.
+    std::atomic<uint64_t> _next_work_id{1};
+    CommandLatencyStats _latency_stats{};
 
     bool _command_debugging{false};
 };
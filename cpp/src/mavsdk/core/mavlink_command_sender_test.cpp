@@ -0,0 +1,345 @@
+#include <chrono>
+#include <cmath>
+#include <gtest/gtest.h>
+#include <asio/io_context.hpp>
+
+#include "mavlink_command_sender.hpp"
+#include "mocks/sender_mock.hpp"
+
+using namespace mavsdk;
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+using ::testing::Return;
+using ::testing::ReturnRef;
+using MockSender = NiceMock<mavsdk::testing::MockSender>;
+
+using Result = MavlinkCommandSender::Result;
+using CommandLong = MavlinkCommandSender::CommandLong;
+
+static MavlinkAddress own_address{245, MAV_COMP_ID_MISSIONPLANNER};
+static uint8_t channel{0};
+static MavlinkAddress target_address{1, MAV_COMP_ID_AUTOPILOT1};
+static constexpr uint8_t other_target_component_id{MAV_COMP_ID_CAMERA};
+
+static constexpr double timeout_s = 0.5;
+
+class MavlinkCommandSenderTest : public ::testing::Test {
+protected:
+    MavlinkCommandSenderTest() :
+        ::testing::Test(),
+        timeout_handler(time),
+        command_sender(
+            mock_sender,
+            message_handler,
+            timeout_handler,
+            time,
+            io_context,
+            []() { return timeout_s; },
+            []() { return Autopilot::Px4; },
+            // Called right away, so the results can be checked after each step.
+            [](const UserCallback& func) { func(); })
+    {}
+
+    void SetUp() override
+    {
+        ON_CALL(mock_sender, get_own_system_id()).WillByDefault(Return(own_address.system_id));
+        ON_CALL(mock_sender, get_own_component_id())
+            .WillByDefault(Return(own_address.component_id));
+        ON_CALL(mock_sender, compatibility_mode()).WillByDefault(Return(CompatibilityMode::Auto));
+        ON_CALL(mock_sender, io_context()).WillByDefault(ReturnRef(io_context));
+        ON_CALL(mock_sender, queue_message(_))
+            .WillByDefault(Invoke(
+                [this](std::function<mavlink_message_t(MavlinkAddress, uint8_t)> fun) {
+                    sent.push_back(fun(own_address, channel));
+                    return true;
+                }));
+    }
+
+    void TearDown() override
+    {
+        io_context.restart();
+        while (io_context.poll()) {
+        }
+    }
+
+    // Runs what the command sender posted, as the io thread would.
+    void poll()
+    {
+        io_context.restart();
+        io_context.poll();
+    }
+
+    void receive_ack(
+        uint16_t command, MAV_RESULT result, uint8_t component_id = target_address.component_id)
+    {
+        mavlink_message_t message;
+        mavlink_msg_command_ack_pack(
+            target_address.system_id,
+            component_id,
+            &message,
+            command,
+            result,
+            0,
+            0,
+            own_address.system_id,
+            own_address.component_id);
+        poll();
+        message_handler.process_message(message);
+    }
+
+    // Lets the timeouts of everything sent so far pass.
+    void run_timeouts()
+    {
+        time.sleep_for(std::chrono::milliseconds(static_cast<int>(timeout_s * 1.1 * 1000.)));
+        timeout_handler.run_once();
+    }
+
+    // The param1 of each COMMAND_LONG sent so far, in order.
+    std::vector<float> sent_param1s() const
+    {
+        std::vector<float> param1s;
+        for (const auto& message : sent) {
+            EXPECT_EQ(message.msgid, MAVLINK_MSG_ID_COMMAND_LONG);
+            param1s.push_back(mavlink_msg_command_long_get_param1(&message));
+        }
+        return param1s;
+    }
+
+    asio::io_context io_context;
+    MockSender mock_sender;
+    MavlinkMessageHandler message_handler{io_context};
+    FakeTime time;
+    TimeoutHandler timeout_handler;
+    MavlinkCommandSender command_sender;
+    std::vector<mavlink_message_t> sent;
+};
+
+static CommandLong make_command(
+    uint16_t command, float param1, uint8_t target_component_id = target_address.component_id)
+{
+    CommandLong command_long{};
+    command_long.command = command;
+    command_long.target_system_id = target_address.system_id;
+    command_long.target_component_id = target_component_id;
+    command_long.params.maybe_param1 = param1;
+    return command_long;
+}
+
+TEST_F(MavlinkCommandSenderTest, EmptyBatchSucceedsRightAway)
+{
+    unsigned num_callbacks = 0;
+    command_sender.queue_commands_async({}, [&](Result result, float progress) {
+        EXPECT_EQ(result, Result::Success);
+        EXPECT_FLOAT_EQ(progress, 1.0f);
+        ++num_callbacks;
+    });
+    poll();
+
+    EXPECT_EQ(num_callbacks, 1u);
+    EXPECT_TRUE(sent.empty());
+}
+
+TEST_F(MavlinkCommandSenderTest, BatchWithSameCommandIdIsSentAtOnce)
+{
+    std::vector<Result> results;
+    command_sender.queue_commands_async(
+        {make_command(MAV_CMD_SET_MESSAGE_INTERVAL, MAVLINK_MSG_ID_ATTITUDE),
+         make_command(MAV_CMD_SET_MESSAGE_INTERVAL, MAVLINK_MSG_ID_GPS_RAW_INT),
+         make_command(MAV_CMD_SET_MESSAGE_INTERVAL, MAVLINK_MSG_ID_BATTERY_STATUS)},
+        [&](Result result, float) { results.push_back(result); });
+    poll();
+
+    // Not waiting for an ack before sending the next one.
+    EXPECT_EQ(
+        sent_param1s(),
+        (std::vector<float>{
+            MAVLINK_MSG_ID_ATTITUDE, MAVLINK_MSG_ID_GPS_RAW_INT, MAVLINK_MSG_ID_BATTERY_STATUS}));
+
+    receive_ack(MAV_CMD_SET_MESSAGE_INTERVAL, MAV_RESULT_ACCEPTED);
+    receive_ack(MAV_CMD_SET_MESSAGE_INTERVAL, MAV_RESULT_ACCEPTED);
+    EXPECT_TRUE(results.empty());
+
+    receive_ack(MAV_CMD_SET_MESSAGE_INTERVAL, MAV_RESULT_ACCEPTED);
+    EXPECT_EQ(results, std::vector<Result>{Result::Success});
+}
+
+TEST_F(MavlinkCommandSenderTest, BatchAcksAreMatchedInSendOrder)
+{
+    std::vector<std::pair<std::size_t, Result>> results;
+    command_sender.queue_command_batch_async(
+        {make_command(MAV_CMD_SET_MESSAGE_INTERVAL, MAVLINK_MSG_ID_ATTITUDE),
+         make_command(MAV_CMD_SET_MESSAGE_INTERVAL, MAVLINK_MSG_ID_GPS_RAW_INT),
+         make_command(MAV_CMD_SET_MESSAGE_INTERVAL, MAVLINK_MSG_ID_BATTERY_STATUS)},
+        [&](std::size_t index, Result result) { results.emplace_back(index, result); });
+    poll();
+    ASSERT_EQ(sent.size(), 3u);
+
+    receive_ack(MAV_CMD_SET_MESSAGE_INTERVAL, MAV_RESULT_DENIED);
+    receive_ack(MAV_CMD_SET_MESSAGE_INTERVAL, MAV_RESULT_ACCEPTED);
+    receive_ack(MAV_CMD_SET_MESSAGE_INTERVAL, MAV_RESULT_FAILED);
+
+    EXPECT_EQ(
+        results,
+        (std::vector<std::pair<std::size_t, Result>>{
+            {0, Result::Denied}, {1, Result::Success}, {2, Result::Failed}}));
+}
+
+TEST_F(MavlinkCommandSenderTest, AcksAreOnlyMatchedWithSentCommands)
+{
+    std::vector<Result> first_results;
+    command_sender.queue_commands_async(
+        {make_command(MAV_CMD_SET_MESSAGE_INTERVAL, MAVLINK_MSG_ID_ATTITUDE)},
+        [&](Result result, float) { first_results.push_back(result); });
+    poll();
+
+    // Not pipelined, so it waits for the one above. Sent to any component, it would match
+    // any ack if it was not still waiting.
+    auto waiting = make_command(MAV_CMD_SET_MESSAGE_INTERVAL, MAVLINK_MSG_ID_GPS_RAW_INT, 0);
+    std::vector<Result> waiting_results;
+    command_sender.queue_command_async(waiting, [&](Result result, float) {
+        waiting_results.push_back(result);
+    });
+    poll();
+
+    std::vector<Result> second_results;
+    command_sender.queue_commands_async(
+        {make_command(
+            MAV_CMD_SET_MESSAGE_INTERVAL,
+            MAVLINK_MSG_ID_BATTERY_STATUS,
+            other_target_component_id)},
+        [&](Result result, float) { second_results.push_back(result); });
+    poll();
+
+    EXPECT_EQ(
+        sent_param1s(),
+        (std::vector<float>{MAVLINK_MSG_ID_ATTITUDE, MAVLINK_MSG_ID_BATTERY_STATUS}));
+
+    receive_ack(MAV_CMD_SET_MESSAGE_INTERVAL, MAV_RESULT_DENIED, other_target_component_id);
+    EXPECT_EQ(second_results, std::vector<Result>{Result::Denied});
+    EXPECT_TRUE(waiting_results.empty());
+    EXPECT_TRUE(first_results.empty());
+
+    // Now the waiting one goes out.
+    receive_ack(MAV_CMD_SET_MESSAGE_INTERVAL, MAV_RESULT_ACCEPTED);
+    EXPECT_EQ(first_results, std::vector<Result>{Result::Success});
+    EXPECT_EQ(
+        sent_param1s(),
+        (std::vector<float>{
+            MAVLINK_MSG_ID_ATTITUDE, MAVLINK_MSG_ID_BATTERY_STATUS, MAVLINK_MSG_ID_GPS_RAW_INT}));
+
+    receive_ack(MAV_CMD_SET_MESSAGE_INTERVAL, MAV_RESULT_ACCEPTED);
+    EXPECT_EQ(waiting_results, std::vector<Result>{Result::Success});
+}
+
+TEST_F(MavlinkCommandSenderTest, BatchReportsFailureOfFirstCommand)
+{
+    std::vector<std::pair<Result, float>> results;
+    command_sender.queue_commands_async(
+        {make_command(MAV_CMD_COMPONENT_ARM_DISARM, 1.0f),
+         make_command(MAV_CMD_SET_MESSAGE_INTERVAL, MAVLINK_MSG_ID_ATTITUDE),
+         make_command(MAV_CMD_DO_SET_MODE, 1.0f)},
+        [&](Result result, float progress) { results.emplace_back(result, progress); });
+    poll();
+    ASSERT_EQ(sent.size(), 3u);
+
+    // The later command fails first, but the result is the one of the earlier command.
+    receive_ack(MAV_CMD_SET_MESSAGE_INTERVAL, MAV_RESULT_FAILED);
+    receive_ack(MAV_CMD_DO_SET_MODE, MAV_RESULT_ACCEPTED);
+    receive_ack(MAV_CMD_COMPONENT_ARM_DISARM, MAV_RESULT_DENIED);
+
+    ASSERT_EQ(results.size(), 1u);
+    EXPECT_EQ(results[0].first, Result::Denied);
+    EXPECT_TRUE(std::isnan(results[0].second));
+}
+
+TEST_F(MavlinkCommandSenderTest, InFlightWindowIsPerComponent)
+{
+    std::vector<std::pair<std::size_t, Result>> results;
+    command_sender.queue_command_batch_async(
+        {make_command(MAV_CMD_SET_MESSAGE_INTERVAL, MAVLINK_MSG_ID_ATTITUDE),
+         make_command(MAV_CMD_SET_MESSAGE_INTERVAL, MAVLINK_MSG_ID_GPS_RAW_INT),
+         make_command(MAV_CMD_SET_MESSAGE_INTERVAL, MAVLINK_MSG_ID_BATTERY_STATUS),
+         make_command(MAV_CMD_SET_MESSAGE_INTERVAL, MAVLINK_MSG_ID_ALTITUDE),
+         make_command(
+             MAV_CMD_SET_MESSAGE_INTERVAL,
+             MAVLINK_MSG_ID_CAMERA_SETTINGS,
+             other_target_component_id)},
+        [&](std::size_t index, Result result) { results.emplace_back(index, result); },
+        2);
+    poll();
+
+    // Two to the autopilot, the one to the other component is not held back by them.
+    EXPECT_EQ(
+        sent_param1s(),
+        (std::vector<float>{
+            MAVLINK_MSG_ID_ATTITUDE, MAVLINK_MSG_ID_GPS_RAW_INT, MAVLINK_MSG_ID_CAMERA_SETTINGS}));
+
+    // Acks from the other component don't make room for the autopilot.
+    receive_ack(MAV_CMD_SET_MESSAGE_INTERVAL, MAV_RESULT_ACCEPTED, other_target_component_id);
+    EXPECT_EQ(sent.size(), 3u);
+
+    // Sent as soon as the ack is in, without waiting for the next do_work().
+    receive_ack(MAV_CMD_SET_MESSAGE_INTERVAL, MAV_RESULT_ACCEPTED);
+    ASSERT_EQ(sent.size(), 4u);
+    EXPECT_FLOAT_EQ(sent_param1s().back(), MAVLINK_MSG_ID_BATTERY_STATUS);
+
+    receive_ack(MAV_CMD_SET_MESSAGE_INTERVAL, MAV_RESULT_ACCEPTED);
+    ASSERT_EQ(sent.size(), 5u);
+    EXPECT_FLOAT_EQ(sent_param1s().back(), MAVLINK_MSG_ID_ALTITUDE);
+
+    receive_ack(MAV_CMD_SET_MESSAGE_INTERVAL, MAV_RESULT_ACCEPTED);
+    receive_ack(MAV_CMD_SET_MESSAGE_INTERVAL, MAV_RESULT_ACCEPTED);
+    EXPECT_EQ(
+        results,
+        (std::vector<std::pair<std::size_t, Result>>{
+            {4, Result::Success},
+            {0, Result::Success},
+            {1, Result::Success},
+            {2, Result::Success},
+            {3, Result::Success}}));
+}
+
+TEST_F(MavlinkCommandSenderTest, NextCommandIsSentRightAfterTimeout)
+{
+    std::vector<std::pair<std::size_t, Result>> results;
+    command_sender.queue_command_batch_async(
+        {make_command(MAV_CMD_SET_MESSAGE_INTERVAL, MAVLINK_MSG_ID_ATTITUDE),
+         make_command(MAV_CMD_SET_MESSAGE_INTERVAL, MAVLINK_MSG_ID_GPS_RAW_INT)},
+        [&](std::size_t index, Result result) { results.emplace_back(index, result); },
+        1,
+        0);
+    poll();
+    EXPECT_EQ(sent_param1s(), std::vector<float>{MAVLINK_MSG_ID_ATTITUDE});
+
+    run_timeouts();
+    EXPECT_EQ(results, (std::vector<std::pair<std::size_t, Result>>{{0, Result::Timeout}}));
+    EXPECT_EQ(
+        sent_param1s(),
+        (std::vector<float>{MAVLINK_MSG_ID_ATTITUDE, MAVLINK_MSG_ID_GPS_RAW_INT}));
+}
+
+TEST_F(MavlinkCommandSenderTest, IdenticalPipelinedCommandsTimeOutSeparately)
+{
+    std::vector<std::pair<std::size_t, Result>> results;
+    command_sender.queue_command_batch_async(
+        {make_command(MAV_CMD_COMPONENT_ARM_DISARM, 1.0f),
+         make_command(MAV_CMD_COMPONENT_ARM_DISARM, 1.0f)},
+        [&](std::size_t index, Result result) { results.emplace_back(index, result); },
+        0,
+        1);
+    poll();
+    EXPECT_EQ(sent.size(), 2u);
+
+    // Each of them is retried once, instead of one being retried twice.
+    run_timeouts();
+    EXPECT_TRUE(results.empty());
+    EXPECT_EQ(sent.size(), 4u);
+
+    run_timeouts();
+    EXPECT_EQ(
+        results,
+        (std::vector<std::pair<std::size_t, Result>>{{0, Result::Timeout}, {1, Result::Timeout}}));
+    EXPECT_EQ(sent.size(), 4u);
+}
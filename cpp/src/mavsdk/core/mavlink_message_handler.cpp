@@ -39,7 +39,7 @@ void MavlinkMessageHandler::register_one_impl(
     Entry entry = {msg_id, maybe_component_id, callback, cookie};
     asio::post(_io_context, [this, entry = std::move(entry)]() mutable {
         note_table_thread();
-        _table.push_back(std::move(entry));
+        _table[entry.msg_id].push_back(std::move(entry));
     });
 }
 
@@ -110,33 +110,61 @@ void MavlinkMessageHandler::erase_from_table(
     std::optional<uint16_t> maybe_msg_id, const void* cookie)
 {
     note_table_thread();
-    _table.erase(
-        std::remove_if(
-            _table.begin(),
-            _table.end(),
-            [&](auto& entry) {
-                if (maybe_msg_id) {
-                    return (entry.msg_id == maybe_msg_id.value() && entry.cookie == cookie);
-                } else {
-                    return (entry.cookie == cookie);
-                }
-            }),
-        _table.end());
+
+    auto erase_cookie = [cookie](std::vector<Entry>& entries) {
+        entries.erase(
+            std::remove_if(
+                entries.begin(),
+                entries.end(),
+                [&](auto& entry) { return entry.cookie == cookie; }),
+            entries.end());
+    };
+
+    if (maybe_msg_id) {
+        auto it = _table.find(maybe_msg_id.value());
+        if (it != _table.end()) {
+            erase_cookie(it->second);
+            if (it->second.empty()) {
+                _table.erase(it);
+            }
+        }
+        return;
+    }
+
+    for (auto it = _table.begin(); it != _table.end();) {
+        erase_cookie(it->second);
+        if (it->second.empty()) {
+            it = _table.erase(it);
+        } else {
+            ++it;
+        }
+    }
 }
 
 void MavlinkMessageHandler::process_message(const mavlink_message_t& message)
 {
     // Runs on the io_context thread; _table is only touched there, so no lock is needed.
     note_table_thread();
+
+    auto it = _table.find(message.msgid);
+    if (it == _table.end()) {
+        if (_debugging) {
+            LogDebug("Ignoring msg {}", int(message.msgid));
+        }
+        return;
+    }
+
     _processing = true;
 
     bool forwarded = false;
 
     if (_debugging) {
-        LogDebug("Table entries: ");
+        LogDebug("Table entries for msg id {}: ", int(message.msgid));
     }
 
-    for (auto& entry : _table) {
+    // Callbacks can't modify the table underneath us: (un)registering is posted, and the
+    // direct removals assert on _processing.
+    for (auto& entry : it->second) {
         if (_debugging) {
             LogDebug(
                 "Msg id: {}, component id: {}",
@@ -145,8 +173,7 @@ void MavlinkMessageHandler::process_message(const mavlink_message_t& message)
                                                   "none"));
         }
 
-        if (entry.msg_id == message.msgid &&
-            (!entry.component_id.has_value() || entry.component_id.value() == message.compid)) {
+        if (!entry.component_id.has_value() || entry.component_id.value() == message.compid) {
             if (_debugging) {
                 LogDebug("Using msg {} to {}", int(message.msgid), size_t(entry.cookie));
             }
@@ -187,8 +214,12 @@ void MavlinkMessageHandler::update_component_id(
 {
     asio::post(_io_context, [this, msg_id, component_id, cookie]() {
         note_table_thread();
-        for (auto& entry : _table) {
-            if (entry.msg_id == msg_id && entry.cookie == cookie) {
+        auto it = _table.find(msg_id);
+        if (it == _table.end()) {
+            return;
+        }
+        for (auto& entry : it->second) {
+            if (entry.cookie == cookie) {
                 entry.component_id = component_id;
             }
         }
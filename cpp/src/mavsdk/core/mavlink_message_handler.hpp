@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <functional>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 #include <optional>
 #include <asio/io_context.hpp>
@@ -20,6 +21,10 @@ namespace mavsdk {
 // same io_context. That keeps everything single-threaded without locks, and post()
 // also makes it safe to (un)register from inside a callback (the mutation runs after
 // the current dispatch returns), with ordering preserved by post FIFO.
+//
+// The table is keyed by message ID, so dispatching a message only looks at the handlers
+// registered for it, no matter how many handlers other plugins have registered. Within
+// one message ID, handlers are called in registration order.
 class MAVSDK_TEST_EXPORT MavlinkMessageHandler {
 public:
     explicit MavlinkMessageHandler(asio::io_context& io_context);
@@ -72,7 +77,7 @@ private:
     void note_table_thread();
 
     asio::io_context& _io_context;
-    std::vector<Entry> _table{};
+    std::unordered_map<uint32_t, std::vector<Entry>> _table{};
 
     // The single thread that is allowed to touch _table: the io thread while the
     // io_context runs, the teardown thread once it is stopped. Only used by
@@ -1,11 +1,13 @@
 #include "mavlink_message_handler.hpp"
 #include "mavlink_include.hpp"
+#include "log.hpp"
 #include <gtest/gtest.h>
 #include <asio.hpp>
 #include <atomic>
 #include <chrono>
 #include <future>
 #include <thread>
+#include <vector>
 
 using namespace mavsdk;
 
@@ -163,3 +165,112 @@ TEST(MavlinkMessageHandler, UnregisterAllBlockingWhenStopped)
     handler.process_message(make_msg(kMsgId, 1));
     EXPECT_EQ(hits.load(), 1);
 }
+
+TEST(MavlinkMessageHandler, KeepsRegistrationOrderPerMessage)
+{
+    IoRunner runner;
+    MavlinkMessageHandler handler(runner.io());
+
+    std::vector<int> calls;
+    const int cookie_a_val = 1;
+    const int cookie_b_val = 2;
+    const void* cookie_a = &cookie_a_val;
+    const void* cookie_b = &cookie_b_val;
+    constexpr uint16_t kMsgId = 1503;
+    constexpr uint16_t kOtherMsgId = 1504;
+
+    handler.register_one(
+        kMsgId, [&calls](const mavlink_message_t&) { calls.push_back(1); }, cookie_a);
+    handler.register_one(
+        kOtherMsgId, [&calls](const mavlink_message_t&) { calls.push_back(100); }, cookie_a);
+    handler.register_one(
+        kMsgId, [&calls](const mavlink_message_t&) { calls.push_back(2); }, cookie_b);
+    handler.register_one(
+        kMsgId, [&calls](const mavlink_message_t&) { calls.push_back(3); }, cookie_a);
+    runner.sync();
+
+    runner.on_io([&]() { handler.process_message(make_msg(kMsgId, 1)); });
+    EXPECT_EQ(calls, (std::vector<int>{1, 2, 3}));
+
+    // Removing one message of a cookie leaves its other registrations alone.
+    calls.clear();
+    handler.unregister_one(kOtherMsgId, cookie_a);
+    runner.sync();
+    runner.on_io([&]() {
+        handler.process_message(make_msg(kMsgId, 1));
+        handler.process_message(make_msg(kOtherMsgId, 1));
+    });
+    EXPECT_EQ(calls, (std::vector<int>{1, 2, 3}));
+
+    calls.clear();
+    handler.unregister_all(cookie_a);
+    runner.sync();
+    runner.on_io([&]() { handler.process_message(make_msg(kMsgId, 1)); });
+    EXPECT_EQ(calls, (std::vector<int>{2}));
+}
+
+TEST(MavlinkMessageHandler, UpdateComponentId)
+{
+    IoRunner runner;
+    MavlinkMessageHandler handler(runner.io());
+
+    std::atomic<int> hits{0};
+    const int cookie_val = 5;
+    const void* cookie = &cookie_val;
+    constexpr uint16_t kMsgId = 1505;
+
+    handler.register_one_with_component_id(
+        kMsgId, 1, [&hits](const mavlink_message_t&) { hits.fetch_add(1); }, cookie);
+    handler.update_component_id(kMsgId, 2, cookie);
+    runner.sync();
+
+    runner.on_io([&]() { handler.process_message(make_msg(kMsgId, 1)); });
+    EXPECT_EQ(hits.load(), 0);
+
+    runner.on_io([&]() { handler.process_message(make_msg(kMsgId, 2)); });
+    EXPECT_EQ(hits.load(), 1);
+}
+
+// Micro-benchmark: the cost of dispatching one message should not grow with the number
+// of handlers registered for other messages. Only prints the numbers, as timing depends
+// on the machine.
+TEST(MavlinkMessageHandler, DispatchCostVsRegistrations)
+{
+    IoRunner runner;
+    MavlinkMessageHandler handler(runner.io());
+
+    const int cookie_val = 9;
+    const void* cookie = &cookie_val;
+    constexpr uint16_t kMsgId = 30; // ATTITUDE
+    constexpr int kDispatches = 100000;
+
+    unsigned hits = 0;
+    handler.register_one(kMsgId, [&hits](const mavlink_message_t&) { ++hits; }, cookie);
+
+    unsigned registered = 1;
+    for (unsigned target : {1u, 10u, 100u, 1000u}) {
+        for (; registered < target; ++registered) {
+            // Spread over many other message IDs, like the plugins of several systems do.
+            handler.register_one(
+                static_cast<uint16_t>(1000 + registered), [](const mavlink_message_t&) {}, cookie);
+        }
+        runner.sync();
+
+        const auto message = make_msg(kMsgId, 1);
+        hits = 0;
+        std::chrono::steady_clock::duration elapsed{};
+        runner.on_io([&]() {
+            const auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < kDispatches; ++i) {
+                handler.process_message(message);
+            }
+            elapsed = std::chrono::steady_clock::now() - start;
+        });
+        EXPECT_EQ(hits, static_cast<unsigned>(kDispatches));
+
+        LogInfo(
+            "{} registrations: {:.1f} ns per dispatch",
+            registered,
+            std::chrono::duration<double, std::nano>(elapsed).count() / kDispatches);
+    }
+}
@@ -44,6 +44,8 @@ MavlinkMissionTransferServer::receive_incoming_items_async(
         target_component,
         _debugging);
 
+    ptr->set_done_callback([this]() { asio::post(_io_context, [this] { do_work(); }); });
+
     asio::post(_io_context, [this, ptr]() {
         const bool was_empty = _work_queue.empty();
         _work_queue.push_back(ptr);
@@ -75,6 +77,8 @@ MavlinkMissionTransferServer::send_outgoing_items_async(
         target_component,
         _debugging);
 
+    ptr->set_done_callback([this]() { asio::post(_io_context, [this] { do_work(); }); });
+
     asio::post(_io_context, [this, ptr]() {
         const bool was_empty = _work_queue.empty();
         _work_queue.push_back(ptr);
@@ -139,6 +143,20 @@ bool MavlinkMissionTransferServer::WorkItem::is_done()
     return _done;
 }
 
+void MavlinkMissionTransferServer::WorkItem::set_done_callback(std::function<void()> done_callback)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _done_callback = std::move(done_callback);
+}
+
+void MavlinkMissionTransferServer::WorkItem::set_done()
+{
+    _done = true;
+    if (_done_callback) {
+        _done_callback();
+    }
+}
+
 MavlinkMissionTransferServer::ReceiveIncomingMission::ReceiveIncomingMission(
     Sender& sender,
     MavlinkMessageHandler& message_handler,
@@ -335,7 +353,7 @@ void MavlinkMissionTransferServer::ReceiveIncomingMission::callback_and_reset(Re
         _callback(result, _type, _items);
     }
     _callback = nullptr;
-    _done = true;
+    set_done();
 }
 
 MavlinkMissionTransferServer::SendOutgoingMission::SendOutgoingMission(
@@ -667,7 +685,7 @@ void MavlinkMissionTransferServer::SendOutgoingMission::callback_and_reset(Resul
         _callback(result);
     }
     _callback = nullptr;
-    _done = true;
+    set_done();
 }
 
 } // namespace mavsdk
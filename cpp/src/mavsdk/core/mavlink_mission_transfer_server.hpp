@@ -85,6 +85,10 @@ public:
         bool has_started();
         bool is_done();
 
+        // Called (with the item's mutex held) once the item is done, so the
+        // owner can move on to the next one without polling.
+        void set_done_callback(std::function<void()> done_callback);
+
         WorkItem(const WorkItem&) = delete;
         WorkItem(WorkItem&&) = delete;
         WorkItem& operator=(const WorkItem&) = delete;
@@ -98,8 +102,12 @@ public:
         double _timeout_s;
         bool _started{false};
         bool _done{false};
+        std::function<void()> _done_callback{};
         std::mutex _mutex{};
         bool _debugging;
+
+        // Must be called with _mutex held.
+        void set_done();
     };
 
     class ReceiveIncomingMission : public WorkItem {
@@ -1,6 +1,9 @@
 #include "mavlink_receiver.hpp"
 #include "log.hpp"
 
+#include <algorithm>
+#include <cstring>
+
 namespace mavsdk {
 
 MavlinkReceiver::MavlinkReceiver()
@@ -17,6 +20,8 @@ void MavlinkReceiver::set_new_datagram(char* datagram, unsigned datagram_len)
 {
     _datagram = datagram;
     _datagram_len = datagram_len;
+    _datagram_begin = reinterpret_cast<const uint8_t*>(datagram);
+    _datagram_end = _datagram_begin + datagram_len;
 
     if (_drop_debugging_on) {
         _drop_stats.bytes_received += _datagram_len;
@@ -27,8 +32,22 @@ MavlinkReceiver::ParseResult MavlinkReceiver::parse_message()
 {
     // Note that one datagram can contain multiple mavlink messages.
     for (unsigned i = 0; i < _datagram_len; ++i) {
+        const auto byte = static_cast<uint8_t>(_datagram[i]);
         uint8_t parse_result = mavlink_frame_char_buffer(
-            &_mavlink_message_buffer, &_mavlink_status, _datagram[i], &_last_message, &_status);
+            &_mavlink_message_buffer, &_mavlink_status, byte, &_last_message, &_status);
+
+        if (parse_result == MAVLINK_FRAMING_INCOMPLETE) {
+            if (_mavlink_status.parse_state == MAVLINK_PARSE_STATE_GOT_STX) {
+                // The parser only enters this state on the start byte, so a new frame
+                // begins; whatever came before was a frame the parser gave up on.
+                _frame_start = reinterpret_cast<const uint8_t*>(&_datagram[i]);
+                _frame_len = 0;
+                _in_frame = true;
+            }
+            continue;
+        }
+
+        finish_frame(reinterpret_cast<const uint8_t*>(&_datagram[i + 1]));
 
         if (parse_result == MAVLINK_FRAMING_OK) {
             // Successfully parsed message
@@ -57,11 +76,51 @@ MavlinkReceiver::ParseResult MavlinkReceiver::parse_message()
     }
 
     // No (more) messages, let's give up.
+    carry_partial_frame();
     _datagram = nullptr;
     _datagram_len = 0;
     return ParseResult::NoneAvailable;
 }
 
+void MavlinkReceiver::finish_frame(const uint8_t* frame_end)
+{
+    if (_frame_start != nullptr) {
+        // All in this datagram, no need to copy it.
+        _last_frame_data = _frame_start;
+        _last_frame_len = static_cast<size_t>(frame_end - _frame_start);
+    } else {
+        // Started in an earlier datagram, add the rest.
+        append_to_frame(_datagram_begin, frame_end);
+        _last_frame_data = _frame.data();
+        _last_frame_len = _frame_len;
+    }
+
+    _frame_start = nullptr;
+    _frame_len = 0;
+    _in_frame = false;
+}
+
+void MavlinkReceiver::carry_partial_frame()
+{
+    if (!_in_frame || _mavlink_status.parse_state == MAVLINK_PARSE_STATE_IDLE ||
+        _mavlink_status.parse_state == MAVLINK_PARSE_STATE_UNINIT) {
+        // Garbage between frames.
+        return;
+    }
+
+    // The frame continues in the next datagram, and this datagram is gone by then.
+    append_to_frame(_frame_start != nullptr ? _frame_start : _datagram_begin, _datagram_end);
+    _frame_start = nullptr;
+    _datagram_begin = _datagram_end;
+}
+
+void MavlinkReceiver::append_to_frame(const uint8_t* begin, const uint8_t* end)
+{
+    const auto len = std::min(static_cast<size_t>(end - begin), _frame.size() - _frame_len);
+    std::memcpy(_frame.data() + _frame_len, begin, len);
+    _frame_len += len;
+}
+
 void MavlinkReceiver::debug_drop_rate()
 {
     if (_last_message.msgid == MAVLINK_MSG_ID_SYS_STATUS) {
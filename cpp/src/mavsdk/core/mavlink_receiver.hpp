@@ -2,6 +2,8 @@
 
 #include "mavlink_include.hpp"
 #include "mavsdk_time.hpp"
+#include <array>
+#include <cstddef>
 #include <cstdint>
 
 namespace mavsdk {
@@ -18,6 +20,12 @@ public:
 
     mavlink_message_t& get_last_message() { return _last_message; }
 
+    // The exact bytes of the frame behind get_last_message(), as they came in on the wire
+    // (including signature, and also for BadCrc). Only valid until the next parse_message().
+    // This lets other decoders (libmav) work off the same framing pass.
+    const uint8_t* get_last_frame_data() const { return _last_frame_data; }
+    size_t get_last_frame_len() const { return _last_frame_len; }
+
     mavlink_status_t& get_status() { return _status; }
 
     void set_new_datagram(char* datagram, unsigned datagram_len);
@@ -36,11 +44,30 @@ private:
     mavlink_message_t _last_message{};
     mavlink_status_t _status{};
 
+    void finish_frame(const uint8_t* frame_end);
+    void carry_partial_frame();
+    void append_to_frame(const uint8_t* begin, const uint8_t* end);
+
     mavlink_message_t _mavlink_message_buffer{};
     mavlink_status_t _mavlink_status{};
     char* _datagram = nullptr;
     unsigned _datagram_len = 0;
 
+    // The whole datagram, _datagram only points to what is left to parse.
+    const uint8_t* _datagram_begin{nullptr};
+    const uint8_t* _datagram_end{nullptr};
+
+    // A frame is pointed to where it is in the datagram. Only a frame that spans
+    // datagrams (serial, TCP) is copied here: its first part once at the end of the
+    // datagram, the rest when it is complete.
+    const uint8_t* _frame_start{nullptr}; // In the datagram, or null if carried over.
+    bool _in_frame{false};
+    std::array<uint8_t, MAVLINK_MAX_PACKET_LEN> _frame{};
+    size_t _frame_len{0};
+
+    const uint8_t* _last_frame_data{nullptr};
+    size_t _last_frame_len{0};
+
     Time _time{};
 
     bool _drop_debugging_on{false};
@@ -0,0 +1,212 @@
+#include "mavlink_receiver.hpp"
+#include "mapped_file.hpp"
+#include "tlog_reader.hpp"
+#include "log.hpp"
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <initializer_list>
+#include <vector>
+
+using namespace mavsdk;
+
+namespace {
+
+std::vector<uint8_t> heartbeat_frame(uint8_t system_id)
+{
+    mavlink_message_t message;
+    mavlink_msg_heartbeat_pack(
+        system_id,
+        1,
+        &message,
+        MAV_TYPE_QUADROTOR,
+        MAV_AUTOPILOT_PX4,
+        0,
+        0,
+        MAV_STATE_ACTIVE);
+
+    std::vector<uint8_t> frame(MAVLINK_MAX_PACKET_LEN);
+    frame.resize(mavlink_msg_to_send_buffer(frame.data(), &message));
+    return frame;
+}
+
+std::vector<uint8_t> attitude_frame(uint32_t time_boot_ms)
+{
+    mavlink_message_t message;
+    mavlink_msg_attitude_pack(
+        1, 1, &message, time_boot_ms, 0.1f, -0.2f, 1.5f, 0.01f, 0.02f, -0.03f);
+
+    std::vector<uint8_t> frame(MAVLINK_MAX_PACKET_LEN);
+    frame.resize(mavlink_msg_to_send_buffer(frame.data(), &message));
+    return frame;
+}
+
+void append(std::vector<uint8_t>& stream, const std::vector<uint8_t>& frame)
+{
+    stream.insert(stream.end(), frame.begin(), frame.end());
+}
+
+struct ParsedFrame {
+    MavlinkReceiver::ParseResult result;
+    std::vector<uint8_t> bytes;
+    bool in_datagram;
+};
+
+// Feeds the stream in chunks of chunk_len bytes, like reads from a serial port.
+std::vector<ParsedFrame> parse_in_chunks(const std::vector<uint8_t>& stream, size_t chunk_len)
+{
+    MavlinkReceiver receiver;
+    std::vector<ParsedFrame> frames;
+
+    // The buffer is reused and cleared after each chunk, like a receive buffer, so it
+    // shows if a frame still refers to an earlier chunk.
+    std::vector<char> chunk;
+    for (size_t offset = 0; offset < stream.size(); offset += chunk_len) {
+        const size_t len = std::min(chunk_len, stream.size() - offset);
+        chunk.assign(stream.begin() + offset, stream.begin() + offset + len);
+        receiver.set_new_datagram(chunk.data(), static_cast<unsigned>(len));
+
+        auto result = receiver.parse_message();
+        while (result != MavlinkReceiver::ParseResult::NoneAvailable) {
+            const uint8_t* data = receiver.get_last_frame_data();
+            const auto* chunk_begin = reinterpret_cast<const uint8_t*>(chunk.data());
+            frames.push_back(ParsedFrame{
+                result,
+                std::vector<uint8_t>(data, data + receiver.get_last_frame_len()),
+                data >= chunk_begin && data < chunk_begin + len});
+            result = receiver.parse_message();
+        }
+        std::fill(chunk.begin(), chunk.end(), 0);
+    }
+    return frames;
+}
+
+} // namespace
+
+TEST(MavlinkReceiver, FramesInOneDatagramAreNotCopied)
+{
+    std::vector<uint8_t> stream;
+    append(stream, heartbeat_frame(1));
+    append(stream, attitude_frame(1000));
+
+    const auto frames = parse_in_chunks(stream, stream.size());
+    ASSERT_EQ(frames.size(), 2u);
+    EXPECT_EQ(frames[0].result, MavlinkReceiver::ParseResult::MessageParsed);
+    EXPECT_EQ(frames[0].bytes, heartbeat_frame(1));
+    EXPECT_TRUE(frames[0].in_datagram);
+    EXPECT_EQ(frames[1].bytes, attitude_frame(1000));
+    EXPECT_TRUE(frames[1].in_datagram);
+}
+
+TEST(MavlinkReceiver, FramesSpanningDatagrams)
+{
+    std::vector<uint8_t> stream;
+    for (uint32_t i = 0; i < 10; ++i) {
+        append(stream, attitude_frame(i));
+        append(stream, heartbeat_frame(static_cast<uint8_t>(i + 1)));
+    }
+
+    for (size_t chunk_len : {1, 2, 7, 13, 64, 100}) {
+        const auto frames = parse_in_chunks(stream, chunk_len);
+        ASSERT_EQ(frames.size(), 20u) << "chunk_len " << chunk_len;
+        for (uint32_t i = 0; i < 10; ++i) {
+            EXPECT_EQ(frames[2 * i].bytes, attitude_frame(i)) << "chunk_len " << chunk_len;
+            EXPECT_EQ(frames[2 * i + 1].bytes, heartbeat_frame(static_cast<uint8_t>(i + 1)))
+                << "chunk_len " << chunk_len;
+        }
+    }
+}
+
+TEST(MavlinkReceiver, GarbageBetweenFramesIsLeftOut)
+{
+    const std::vector<uint8_t> garbage{0x00, 0x42, 0xFF, 0x17};
+
+    std::vector<uint8_t> stream;
+    append(stream, garbage);
+    append(stream, heartbeat_frame(1));
+    append(stream, garbage);
+    append(stream, attitude_frame(5));
+
+    for (size_t chunk_len : std::initializer_list<size_t>{1, 5, stream.size()}) {
+        const auto frames = parse_in_chunks(stream, chunk_len);
+        ASSERT_EQ(frames.size(), 2u);
+        EXPECT_EQ(frames[0].bytes, heartbeat_frame(1));
+        EXPECT_EQ(frames[1].bytes, attitude_frame(5));
+    }
+}
+
+TEST(MavlinkReceiver, BadCrcFrameBytes)
+{
+    auto corrupted = attitude_frame(7);
+    corrupted.back() ^= 0xFF;
+
+    std::vector<uint8_t> stream;
+    append(stream, corrupted);
+    append(stream, heartbeat_frame(1));
+
+    for (size_t chunk_len : std::initializer_list<size_t>{3, stream.size()}) {
+        const auto frames = parse_in_chunks(stream, chunk_len);
+        ASSERT_EQ(frames.size(), 2u);
+        EXPECT_EQ(frames[0].result, MavlinkReceiver::ParseResult::BadCrc);
+        EXPECT_EQ(frames[0].bytes, corrupted);
+        EXPECT_EQ(frames[1].result, MavlinkReceiver::ParseResult::MessageParsed);
+        EXPECT_EQ(frames[1].bytes, heartbeat_frame(1));
+    }
+}
+
+// Benchmark of framing a recorded byte stream, in chunks like serial reads and UDP
+// datagrams. Uses the .tlog in MAVSDK_BENCHMARK_TLOG if set, a generated stream
+// otherwise. Only prints the numbers, as timing depends on the machine.
+TEST(MavlinkReceiver, ParseThroughput)
+{
+    std::vector<uint8_t> stream;
+
+    if (const char* path = std::getenv("MAVSDK_BENCHMARK_TLOG")) {
+        MappedFile file;
+        ASSERT_TRUE(file.open(path));
+        TlogReader reader(file.data(), file.size());
+        TlogReader::Record record;
+        while (reader.next(record)) {
+            stream.insert(stream.end(), record.frame, record.frame + record.frame_len);
+        }
+    } else {
+        for (uint32_t i = 0; stream.size() < 4 * 1024 * 1024; ++i) {
+            append(stream, attitude_frame(i));
+            if (i % 50 == 0) {
+                append(stream, heartbeat_frame(1));
+            }
+        }
+    }
+    ASSERT_FALSE(stream.empty());
+
+    for (size_t chunk_len : {64, 1024, 65536}) {
+        MavlinkReceiver receiver;
+        std::vector<char> buffer(stream.begin(), stream.end());
+        size_t num_frames = 0;
+        size_t frame_bytes = 0;
+
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t offset = 0; offset < buffer.size(); offset += chunk_len) {
+            const size_t len = std::min(chunk_len, buffer.size() - offset);
+            receiver.set_new_datagram(buffer.data() + offset, static_cast<unsigned>(len));
+            while (receiver.parse_message() != MavlinkReceiver::ParseResult::NoneAvailable) {
+                ++num_frames;
+                frame_bytes += receiver.get_last_frame_len();
+            }
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+
+        EXPECT_GT(num_frames, 0u);
+        EXPECT_LE(frame_bytes, stream.size());
+
+        const double seconds = std::chrono::duration<double>(elapsed).count();
+        LogInfo(
+            "{} byte chunks: {} frames, {:.1f} MiB/s, {:.1f} ns per frame",
+            chunk_len,
+            num_frames,
+            static_cast<double>(stream.size()) / seconds / (1024.0 * 1024.0),
+            seconds * 1e9 / static_cast<double>(num_frames));
+    }
+}
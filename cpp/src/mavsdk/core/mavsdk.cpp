@@ -1,5 +1,7 @@
 #include "mavsdk.hpp"
 
+#include <algorithm>
+
 #include "heartbeat_watchdog.hpp"
 #include "log.hpp"
 #include "mavsdk_impl.hpp"
@@ -269,6 +271,26 @@ void Mavsdk::Configuration::set_compatibility_mode(CompatibilityMode mode)
     _compatibility_mode = mode;
 }
 
+unsigned Mavsdk::Configuration::get_send_queue_size() const
+{
+    return _send_queue_size;
+}
+
+void Mavsdk::Configuration::set_send_queue_size(unsigned size)
+{
+    _send_queue_size = std::max(size, 1u);
+}
+
+unsigned Mavsdk::Configuration::get_io_thread_count() const
+{
+    return _io_thread_count;
+}
+
+void Mavsdk::Configuration::set_io_thread_count(unsigned count)
+{
+    _io_thread_count = std::max(count, 1u);
+}
+
 void Mavsdk::intercept_incoming_messages_async(std::function<bool(mavlink_message_t&)> callback)
 {
     _impl->intercept_incoming_messages_async(callback);
@@ -281,7 +303,12 @@ void Mavsdk::intercept_outgoing_messages_async(std::function<bool(mavlink_messag
 
 bool Mavsdk::start_tlog_recording(const std::string& path)
 {
-    return _impl->start_tlog_recording(path);
+    return _impl->start_tlog_recording(path, RecordingOptions{});
+}
+
+bool Mavsdk::start_tlog_recording(const std::string& path, const RecordingOptions& options)
+{
+    return _impl->start_tlog_recording(path, options);
 }
 
 void Mavsdk::stop_tlog_recording()
@@ -289,6 +316,31 @@ void Mavsdk::stop_tlog_recording()
     _impl->stop_tlog_recording();
 }
 
+Mavsdk::RecordingStats Mavsdk::tlog_stats() const
+{
+    return _impl->tlog_stats();
+}
+
+bool Mavsdk::start_capture_recording(const std::string& path)
+{
+    return _impl->start_capture_recording(path, RecordingOptions{});
+}
+
+bool Mavsdk::start_capture_recording(const std::string& path, const RecordingOptions& options)
+{
+    return _impl->start_capture_recording(path, options);
+}
+
+void Mavsdk::stop_capture_recording()
+{
+    _impl->stop_capture_recording();
+}
+
+Mavsdk::RecordingStats Mavsdk::capture_stats() const
+{
+    return _impl->capture_stats();
+}
+
 void Mavsdk::pass_received_raw_bytes(const char* bytes, size_t length)
 {
     _impl->pass_received_raw_bytes(bytes, length);
@@ -315,6 +367,29 @@ void Mavsdk::unsubscribe_connection_errors(ConnectionErrorHandle handle)
     return _impl->unsubscribe_connection_errors(handle);
 }
 
+std::optional<Mavsdk::ConnectionStats> Mavsdk::connection_stats(ConnectionHandle handle) const
+{
+    return _impl->connection_stats(handle);
+}
+
+std::vector<Mavsdk::Route> Mavsdk::routes() const
+{
+    return _impl->routes();
+}
+
+void Mavsdk::send_commands_async(
+    const std::vector<Command>& commands,
+    const CommandResultCallback& callback,
+    unsigned max_in_flight_per_component)
+{
+    _impl->send_commands_async(commands, callback, max_in_flight_per_component);
+}
+
+std::vector<Mavsdk::CommandStats> Mavsdk::command_stats() const
+{
+    return _impl->command_stats();
+}
+
 Mavsdk::InterceptJsonHandle
 Mavsdk::subscribe_incoming_messages_json(const InterceptJsonCallback& callback)
 {
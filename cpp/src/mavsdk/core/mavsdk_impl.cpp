@@ -5,7 +5,8 @@
 #include <algorithm>
 #include <array>
 #include <chrono>
-#include <fstream>
+#include <cmath>
+#include <map>
 #include <mutex>
 #include <thread>
 #include "connection.hpp"
@@ -14,9 +15,12 @@
 #include "tcp_server_connection.hpp"
 #include "udp_connection.hpp"
 #include "raw_connection.hpp"
+#include "replay_connection.hpp"
 #include "system.hpp"
 #include "system_impl.hpp"
 #include "serial_connection.hpp"
+#include "shm_connection.hpp"
+#include "unix_connection.hpp"
 #include "version.hpp"
 #include "server_component_impl.hpp"
 #include "overloaded.hpp"
@@ -34,19 +38,10 @@
 
 namespace mavsdk {
 
-struct TlogFile {
-    std::ofstream stream;
-    ~TlogFile()
-    {
-        if (stream.is_open()) {
-            stream.flush();
-            stream.close();
-        }
-    }
-};
-
 template class MAVSDK_TEMPL_INST CallbackList<>;
 
+thread_local unsigned MavsdkImpl::_locks_held_by_this_thread{0};
+
 MavsdkImpl::MavsdkImpl(const Mavsdk::Configuration& configuration) :
     timeout_handler(time),
     call_every_handler(time)
@@ -68,6 +63,13 @@ MavsdkImpl::MavsdkImpl(const Mavsdk::Configuration& configuration) :
         }
     }
 
+    if (const char* env_p = std::getenv("MAVSDK_TIMER_DEBUGGING")) {
+        if (std::string(env_p) == "1") {
+            LogDebug("Timer debugging is on.");
+            _timer_debugging = true;
+        }
+    }
+
     if (const char* env_p = std::getenv("MAVSDK_SYSTEM_DEBUGGING")) {
         if (std::string(env_p) == "1") {
             LogDebug("System debugging is on.");
@@ -103,16 +105,29 @@ MavsdkImpl::MavsdkImpl(const Mavsdk::Configuration& configuration) :
             [this]() { maybe_send_heartbeats(); }, HEARTBEAT_SEND_INTERVAL_S);
     }
 
-    // Start the recurring timer that drives TimeoutHandler and CallEveryHandler
-    // on the io_context thread every 5 ms.
-    schedule_timers_poll();
+    // Start the timer that drives TimeoutHandler and CallEveryHandler on the
+    // io_context thread. Whenever one of them gets a new earliest deadline, the
+    // timer is re-armed on the io thread.
+    timeout_handler.set_earlier_deadline_callback(
+        [this]() { asio::post(_io_context, [this]() { schedule_timers(); }); });
+    call_every_handler.set_earlier_deadline_callback(
+        [this]() { asio::post(_io_context, [this]() { schedule_timers(); }); });
+    schedule_timers();
 
-    // Start the recurring timer that drives ServerComponent::do_work() on the io_context thread.
-    schedule_do_work();
+    if (_timer_debugging) {
+        _timer_wakeups_stats_cookie = call_every_handler.add(
+            [this]() { print_timer_wakeups(); }, TIMER_WAKEUPS_STATS_INTERVAL_S);
+    }
 
     // Start the Asio io_context on its own thread.  All async I/O completions,
     // message dispatch, and timer callbacks are dispatched here.
     _io_thread = std::make_unique<std::thread>([this]() { _io_context.run(); });
+
+    // Any further io threads process the messages of the systems pinned to them.
+    for (unsigned i = 1; i < configuration.get_io_thread_count(); ++i) {
+        _io_workers.push_back(std::make_unique<IoWorker>(time));
+        _io_workers.back()->start();
+    }
 }
 
 MavsdkImpl::~MavsdkImpl()
@@ -125,6 +140,23 @@ MavsdkImpl::~MavsdkImpl()
         _heartbeat_send_cookie = 0;
     }
 
+    {
+        std::lock_guard<std::mutex> lock(_callback_stall_check_mutex);
+        call_every_handler.remove(_callback_stall_check_cookie);
+        _callback_stall_check_cookie = 0;
+    }
+    {
+        std::lock_guard<std::mutex> lock(_route_aging_mutex);
+        call_every_handler.remove(_route_aging_cookie);
+        _route_aging_cookie = 0;
+    }
+    {
+        std::lock_guard lock(_mutex);
+        call_every_handler.remove(_connection_stats_cookie);
+        _connection_stats_cookie = 0;
+    }
+    call_every_handler.remove(_timer_wakeups_stats_cookie);
+
     // Stop the Asio io_context so _io_thread exits io_context::run().
     // This also cancels any pending async_receive_from operations on UdpConnection sockets.
     _io_work_guard.reset();
@@ -133,9 +165,13 @@ MavsdkImpl::~MavsdkImpl()
         _io_thread->join();
         _io_thread.reset();
     }
+    for (auto& io_worker : _io_workers) {
+        io_worker->stop();
+    }
 
-    // Flush and close any open tlog file now that no more messages can arrive.
+    // Flush and close any open recordings now that no more messages can arrive.
     stop_tlog_recording();
+    stop_capture_recording();
 
     if (_process_user_callbacks_thread) {
         _user_callback_queue.stop();
@@ -398,18 +434,26 @@ void MavsdkImpl::forward_message(mavlink_message_t& message, Connection* connect
         (message.msgid != MAVLINK_MSG_ID_HEARTBEAT || forward_heartbeats_enabled);
 
     if (!targeted_only_at_us && heartbeat_check_ok) {
+        // A message for a known target only goes out where the target was seen. Broadcasts,
+        // and messages for targets we have not heard from, go out everywhere.
+        const auto route_links = target_system_id != 0 ?
+                                     _routing_table.links(target_system_id, target_component_id) :
+                                     RoutingTable::LinkMask{0};
+
         unsigned successful_emissions = 0;
         for (auto& entry : _connections) {
             // Check whether the connection is not the one from which we received the message.
             // And also check if the connection was set to forward messages.
             if (entry.connection.get() == connection ||
-                !entry.connection->should_forward_messages()) {
+                !entry.connection->should_forward_messages() ||
+                !is_on_route(*entry.connection, route_links)) {
                 continue;
             }
             auto result = (*entry.connection).send_message(message);
             if (result.first) {
                 successful_emissions++;
             } else {
+                entry.connection->stats().count_send_failure();
                 _connections_errors_subscriptions.queue(
                     Mavsdk::ConnectionError{result.second, entry.handle},
                     [this](const auto& func) { call_user_callback(func); });
@@ -419,13 +463,97 @@ void MavsdkImpl::forward_message(mavlink_message_t& message, Connection* connect
             if (_system_debugging) {
                 LogErr("Message forwarding failed");
             }
+        } else if (route_links != 0) {
+            _routing_table.count_routed(target_system_id, target_component_id);
         }
     }
 }
 
+void MavsdkImpl::update_connection_stats()
+{
+    const auto now = LinkStats::Clock::now();
+    std::lock_guard lock(_mutex);
+    if (_connection_stats_cookie == 0) {
+        // Stopped in the meantime.
+        return;
+    }
+
+    if (now - _connection_stats_last_polled >
+        std::chrono::duration<double>(CONNECTION_STATS_IDLE_S)) {
+        call_every_handler.remove(_connection_stats_cookie);
+        _connection_stats_cookie = 0;
+        return;
+    }
+
+    for (auto& entry : _connections) {
+        entry.connection->stats().update_rates(now);
+    }
+}
+
+void MavsdkImpl::start_route_aging()
+{
+    std::lock_guard<std::mutex> lock(_route_aging_mutex);
+    if (_route_aging_cookie == 0) {
+        _route_aging_cookie =
+            call_every_handler.add([this]() { age_routes(); }, ROUTE_AGING_INTERVAL_S);
+        // A full period from now rather than straightaway.
+        call_every_handler.reset(_route_aging_cookie);
+    }
+    _route_aging_running = true;
+}
+
+void MavsdkImpl::age_routes()
+{
+    std::lock_guard<std::mutex> aging_lock(_route_aging_mutex);
+    if (_route_aging_cookie == 0) {
+        return;
+    }
+
+    // Cleared before aging, so that receive_message() starts the timer again for
+    // a message that arrives after we looked.
+    _route_aging_running = false;
+
+    bool anything_left = _routing_table.age();
+
+    const auto cutoff = SystemIdSet::Clock::now() -
+                        std::chrono::duration_cast<SystemIdSet::Clock::duration>(
+                            std::chrono::duration<double>(SYSTEM_ID_TIMEOUT_S));
+    {
+        std::lock_guard lock(_mutex);
+        for (auto& entry : _connections) {
+            entry.connection->forget_system_ids_older_than(cutoff);
+            anything_left = anything_left || entry.connection->has_any_system_id();
+        }
+    }
+
+    if (anything_left) {
+        _route_aging_running = true;
+    } else {
+        call_every_handler.remove(_route_aging_cookie);
+        _route_aging_cookie = 0;
+    }
+}
+
+bool MavsdkImpl::is_on_route(const Connection& connection, RoutingTable::LinkMask route_links)
+{
+    // Without a route, or without a link number to check against, we can't rule it out.
+    return route_links == 0 || connection.routing_link() == RoutingTable::NO_LINK ||
+           (route_links & RoutingTable::mask(connection.routing_link())) != 0;
+}
+
 void MavsdkImpl::receive_message(
     MavlinkReceiver::ParseResult result, mavlink_message_t& message, Connection* connection)
 {
+    // Learn routes from everything received, before any intercept/drop logic.
+    if (result == MavlinkReceiver::ParseResult::MessageParsed ||
+        result == MavlinkReceiver::ParseResult::BadCrc) {
+        _routing_table.learn(message.sysid, message.compid, connection->routing_link());
+
+        if (!_route_aging_running) {
+            start_route_aging();
+        }
+    }
+
     if (result == MavlinkReceiver::ParseResult::MessageParsed) {
         // Post directly to the io_context — no intermediate queue needed.
         // The io_context thread already owns all connection callbacks, so this
@@ -467,38 +595,6 @@ void MavsdkImpl::process_message(mavlink_message_t& message, Connection* connect
         return;
     }
 
-    // Record to tlog before any intercept/drop logic so all received traffic is captured.
-    {
-        std::lock_guard<std::mutex> tlog_lock(_tlog_mutex);
-        if (_tlog_file && _tlog_file->stream.is_open()) {
-            constexpr size_t timestamp_bytes = 8;
-            // Big-endian microsecond Unix timestamp.
-            const auto now_us =
-                static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
-                                          std::chrono::system_clock::now().time_since_epoch())
-                                          .count());
-            std::array<uint8_t, timestamp_bytes> ts{};
-            uint64_t v = now_us;
-            for (int i = static_cast<int>(timestamp_bytes) - 1; i >= 0; --i) {
-                ts.at(static_cast<size_t>(i)) = static_cast<uint8_t>(v & 0xFFu);
-                v >>= 8u;
-            }
-            _tlog_file->stream.write(
-                reinterpret_cast<const char*>(ts.data()),
-                static_cast<std::streamsize>(timestamp_bytes));
-
-            std::array<uint8_t, MAVLINK_MAX_PACKET_LEN> wire{};
-            const uint16_t wire_len = mavlink_msg_to_send_buffer(wire.data(), &message);
-            _tlog_file->stream.write(reinterpret_cast<const char*>(wire.data()), wire_len);
-            _tlog_file->stream.flush();
-
-            if (!_tlog_file->stream.good()) {
-                LogErr("Tlog: write failed, stopping recording");
-                _tlog_file.reset();
-            }
-        }
-    }
-
     {
         std::lock_guard lock(_mutex);
 
@@ -508,7 +604,7 @@ void MavsdkImpl::process_message(mavlink_message_t& message, Connection* connect
         {
             bool keep = true;
             {
-                std::lock_guard<std::mutex> intercept_lock(_intercept_callbacks_mutex);
+                std::lock_guard intercept_lock(_intercept_callbacks_mutex);
                 if (_intercept_incoming_messages_callback != nullptr) {
                     keep = _intercept_incoming_messages_callback(message);
                 }
@@ -608,7 +704,8 @@ void MavsdkImpl::process_message(mavlink_message_t& message, Connection* connect
     // JSON message interception for incoming messages — runs after forwarding so that the
     // message is still relayed to connected peers, but before plugin delivery so that local
     // plugins only see messages the subscriber allows through.
-    {
+    // Serializing and decoding with libmav is costly, so skip it unless someone listens.
+    if (_incoming_json_subscriptions_count.load(std::memory_order_acquire) > 0) {
         uint8_t buf[MAVLINK_MAX_PACKET_LEN];
         uint16_t len = mavlink_msg_to_send_buffer(buf, &message);
         size_t bytes_consumed = 0;
@@ -692,37 +789,6 @@ void MavsdkImpl::process_libmav_message(
         return;
     }
 
-    // Record to tlog before any processing so all received traffic is captured.
-    if (!message.raw_bytes.empty()) {
-        std::lock_guard<std::mutex> tlog_lock(_tlog_mutex);
-        if (_tlog_file && _tlog_file->stream.is_open()) {
-            constexpr size_t timestamp_bytes = 8;
-            // Big-endian microsecond Unix timestamp.
-            const auto now_us =
-                static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
-                                          std::chrono::system_clock::now().time_since_epoch())
-                                          .count());
-            std::array<uint8_t, timestamp_bytes> ts{};
-            uint64_t v = now_us;
-            for (int i = static_cast<int>(timestamp_bytes) - 1; i >= 0; --i) {
-                ts.at(static_cast<size_t>(i)) = static_cast<uint8_t>(v & 0xFFu);
-                v >>= 8u;
-            }
-            _tlog_file->stream.write(
-                reinterpret_cast<const char*>(ts.data()),
-                static_cast<std::streamsize>(timestamp_bytes));
-            _tlog_file->stream.write(
-                reinterpret_cast<const char*>(message.raw_bytes.data()),
-                static_cast<std::streamsize>(message.raw_bytes.size()));
-            _tlog_file->stream.flush();
-
-            if (!_tlog_file->stream.good()) {
-                LogErr("Tlog: write failed, stopping recording");
-                _tlog_file.reset();
-            }
-        }
-    }
-
     {
         std::lock_guard lock(_mutex);
 
@@ -807,14 +873,65 @@ void MavsdkImpl::process_libmav_message(
 
 bool MavsdkImpl::send_message(mavlink_message_t& message)
 {
-    // Post directly to the io_context — no intermediate queue needed.
-    // deliver_message() always runs on the io_context thread, so ordering
-    // is preserved (posts are executed FIFO) and no mutex is required.
-    asio::post(_io_context, [this, msg = message]() mutable { deliver_message(msg); });
+    // Most messages are sent from the io thread itself, by timers or in reply to
+    // received messages. These are delivered straightaway instead of copying them into
+    // a posted handler, as long as that does not overtake anything still queued.
+    if (can_deliver_inline()) {
+        _delivering = true;
+        deliver_message(message);
+        _delivering = false;
+        return true;
+    }
+
+    // deliver_queued_messages() runs on the io thread, so ordering is preserved and
+    // deliver_message() needs no extra locking. It only needs to be posted for the first
+    // message queued, it takes all of them.
+    bool post_delivery;
+    {
+        std::lock_guard<std::mutex> lock(_queued_messages_mutex);
+        post_delivery = _queued_messages.empty();
+        _queued_messages.push_back(message);
+    }
+    if (post_delivery) {
+        asio::post(_io_context, [this]() { deliver_queued_messages(); });
+    }
 
     return true;
 }
 
+bool MavsdkImpl::can_deliver_inline()
+{
+    // The callbacks intercepting outgoing messages, the JSON subscriptions and the raw
+    // bytes subscriptions are user code, which must not be called while the sender might
+    // still hold locks of its own. And if this thread holds any of our locks, delivering
+    // could take them again or in the wrong order.
+    if (_delivering || !_io_context.get_executor().running_in_this_thread() ||
+        _locks_held_by_this_thread > 0 || _intercepting_outgoing_messages ||
+        _outgoing_json_subscriptions_count > 0 || !_raw_bytes_subscriptions.empty()) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_queued_messages_mutex);
+    return _queued_messages.empty();
+}
+
+void MavsdkImpl::deliver_queued_messages()
+{
+    {
+        std::lock_guard<std::mutex> lock(_queued_messages_mutex);
+        std::swap(_queued_messages, _delivering_messages);
+    }
+
+    _delivering = true;
+    for (auto& message : _delivering_messages) {
+        deliver_message(message);
+    }
+    _delivering = false;
+
+    // Keeps the capacity for next time.
+    _delivering_messages.clear();
+}
+
 void MavsdkImpl::deliver_message(mavlink_message_t& message)
 {
     if (_message_logging_on) {
@@ -831,7 +948,7 @@ void MavsdkImpl::deliver_message(mavlink_message_t& message)
     // with or even dropped.
     bool keep = true;
     {
-        std::lock_guard<std::mutex> lock(_intercept_callbacks_mutex);
+        std::lock_guard lock(_intercept_callbacks_mutex);
         if (_intercept_outgoing_messages_callback != nullptr) {
             keep = _intercept_outgoing_messages_callback(message);
         }
@@ -847,59 +964,64 @@ void MavsdkImpl::deliver_message(mavlink_message_t& message)
 
     // JSON message interception for outgoing messages
     // Convert mavlink_message_t to Mavsdk::MavlinkMessage for JSON interception
-    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
-    uint16_t len = mavlink_msg_to_send_buffer(buffer, &message);
-
-    size_t bytes_consumed = 0;
-    auto libmav_msg_opt = parse_message_safe(buffer, len, bytes_consumed);
-
-    if (libmav_msg_opt) {
-        // Create Mavsdk::MavlinkMessage directly for JSON interception
-        Mavsdk::MavlinkMessage json_message;
-        json_message.message_name = libmav_msg_opt.value().name();
-        json_message.system_id = message.sysid;
-        json_message.component_id = message.compid;
-
-        // Extract target_system and target_component if present
-        uint8_t target_system_id = 0;
-        uint8_t target_component_id = 0;
-        if (libmav_msg_opt.value().get("target_system", target_system_id) ==
-            mav::MessageResult::Success) {
-            json_message.target_system_id = target_system_id;
-        } else {
-            json_message.target_system_id = 0;
-        }
-        if (libmav_msg_opt.value().get("target_component", target_component_id) ==
-            mav::MessageResult::Success) {
-            json_message.target_component_id = target_component_id;
-        } else {
-            json_message.target_component_id = 0;
-        }
+    // Serializing and decoding with libmav is costly, so skip it unless someone listens.
+    if (_outgoing_json_subscriptions_count.load(std::memory_order_acquire) > 0) {
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        uint16_t len = mavlink_msg_to_send_buffer(buffer, &message);
 
-        // Generate JSON using LibmavReceiver's public method.
-        // Access _connections under _mutex so remove_connection() cannot destroy
-        // the Connection object (and its _libmav_receiver) while we're using it.
-        {
-            std::lock_guard lock(_mutex);
-            if (!_connections.empty() && _connections[0].connection->get_libmav_receiver()) {
-                json_message.fields_json =
-                    _connections[0].connection->get_libmav_receiver()->libmav_message_to_json(
-                        libmav_msg_opt.value());
+        size_t bytes_consumed = 0;
+        auto libmav_msg_opt = parse_message_safe(buffer, len, bytes_consumed);
+
+        if (libmav_msg_opt) {
+            // Create Mavsdk::MavlinkMessage directly for JSON interception
+            Mavsdk::MavlinkMessage json_message;
+            json_message.message_name = libmav_msg_opt.value().name();
+            json_message.system_id = message.sysid;
+            json_message.component_id = message.compid;
+
+            // Extract target_system and target_component if present
+            uint8_t target_system_id = 0;
+            uint8_t target_component_id = 0;
+            if (libmav_msg_opt.value().get("target_system", target_system_id) ==
+                mav::MessageResult::Success) {
+                json_message.target_system_id = target_system_id;
             } else {
-                // Fallback: create minimal JSON if no receiver available
-                json_message.fields_json =
-                    "{\"message_id\":" + std::to_string(libmav_msg_opt.value().id()) +
-                    ",\"message_name\":\"" + libmav_msg_opt.value().name() + "\"}";
+                json_message.target_system_id = 0;
+            }
+            if (libmav_msg_opt.value().get("target_component", target_component_id) ==
+                mav::MessageResult::Success) {
+                json_message.target_component_id = target_component_id;
+            } else {
+                json_message.target_component_id = 0;
             }
-        }
 
-        if (!call_json_interception_callbacks(json_message, _outgoing_json_message_subscriptions)) {
-            // Message was dropped by JSON interception callback
-            if (_message_logging_on) {
-                LogDebug(
-                    "Outgoing JSON message {} dropped by interceptio", json_message.message_name);
+            // Generate JSON using LibmavReceiver's public method.
+            // Access _connections under _mutex so remove_connection() cannot destroy
+            // the Connection object (and its _libmav_receiver) while we're using it.
+            {
+                std::lock_guard lock(_mutex);
+                if (!_connections.empty() && _connections[0].connection->get_libmav_receiver()) {
+                    json_message.fields_json =
+                        _connections[0].connection->get_libmav_receiver()->libmav_message_to_json(
+                            libmav_msg_opt.value());
+                } else {
+                    // Fallback: create minimal JSON if no receiver available
+                    json_message.fields_json =
+                        "{\"message_id\":" + std::to_string(libmav_msg_opt.value().id()) +
+                        ",\"message_name\":\"" + libmav_msg_opt.value().name() + "\"}";
+                }
+            }
+
+            if (!call_json_interception_callbacks(
+                    json_message, _outgoing_json_message_subscriptions)) {
+                // Message was dropped by JSON interception callback
+                if (_message_logging_on) {
+                    LogDebug(
+                        "Outgoing JSON message {} dropped by interceptio",
+                        json_message.message_name);
+                }
+                return;
             }
-            return;
         }
     }
 
@@ -911,17 +1033,29 @@ void MavsdkImpl::deliver_message(mavlink_message_t& message)
         return;
     }
 
+    const uint8_t target_system_id = get_target_system_id(message);
+    const uint8_t target_component_id = get_target_component_id(message);
+    const auto route_links = target_system_id != 0 ?
+                                 _routing_table.links(target_system_id, target_component_id) :
+                                 RoutingTable::LinkMask{0};
+
     uint8_t successful_emissions = 0;
     for (auto& _connection : _connections) {
-        const uint8_t target_system_id = get_target_system_id(message);
-
-        if (target_system_id != 0 && !(*_connection.connection).has_system_id(target_system_id)) {
-            continue;
+        if (target_system_id != 0) {
+            // Once the route has aged out, e.g. because the target went quiet, fall back
+            // to the systems ever seen on the connection.
+            const bool reachable = route_links != 0 ?
+                                       is_on_route(*_connection.connection, route_links) :
+                                       (*_connection.connection).has_system_id(target_system_id);
+            if (!reachable) {
+                continue;
+            }
         }
         const auto result = (*_connection.connection).send_message(message);
         if (result.first) {
             successful_emissions++;
         } else {
+            _connection.connection->stats().count_send_failure();
             _connections_errors_subscriptions.queue(
                 Mavsdk::ConnectionError{result.second, _connection.handle},
                 [this](const auto& func) { call_user_callback(func); });
@@ -930,6 +1064,8 @@ void MavsdkImpl::deliver_message(mavlink_message_t& message)
 
     if (successful_emissions == 0) {
         LogErr("Sending message failed");
+    } else if (route_links != 0) {
+        _routing_table.count_routed(target_system_id, target_component_id);
     }
 }
 
@@ -960,6 +1096,15 @@ std::pair<ConnectionResult, Mavsdk::ConnectionHandle> MavsdkImpl::add_any_connec
             },
             [this, forwarding_option](const CliArg::Raw&) {
                 return add_raw_connection(forwarding_option);
+            },
+            [this, forwarding_option](const CliArg::Replay& replay) {
+                return add_replay_connection(replay, forwarding_option);
+            },
+            [this, forwarding_option](const CliArg::Unix& unix_socket) {
+                return add_unix_connection(unix_socket, forwarding_option);
+            },
+            [this, forwarding_option](const CliArg::Shm& shm) {
+                return add_shm_connection(shm, forwarding_option);
             }},
         cli_arg.protocol);
 }
@@ -984,6 +1129,12 @@ MavsdkImpl::add_udp_connection(const CliArg::Udp& udp, ForwardingOption forwardi
         return {ConnectionResult::ConnectionError, Mavsdk::ConnectionHandle{}};
     }
 
+    if (udp.aggregation_window_ms > 0.0) {
+        new_conn->enable_send_aggregation(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::duration<double, std::milli>(udp.aggregation_window_ms)));
+    }
+
     ConnectionResult ret = new_conn->start();
 
     if (ret != ConnectionResult::Success) {
@@ -1141,10 +1292,98 @@ MavsdkImpl::add_raw_connection(ForwardingOption forwarding_option)
     return {ConnectionResult::Success, handle};
 }
 
+std::pair<ConnectionResult, Mavsdk::ConnectionHandle>
+MavsdkImpl::add_replay_connection(const CliArg::Replay& replay, ForwardingOption forwarding_option)
+{
+    auto new_conn = std::make_unique<ReplayConnection>(
+        [this](
+            MavlinkReceiver::ParseResult result,
+            mavlink_message_t& message,
+            Connection* connection) { receive_message(result, message, connection); },
+        [this](const Mavsdk::MavlinkMessage& message, Connection* connection) {
+            receive_libmav_message(message, connection);
+        },
+        *this,
+        replay.path,
+        replay.speed,
+        forwarding_option);
+
+    if (!new_conn) {
+        return {ConnectionResult::ConnectionError, Mavsdk::ConnectionHandle{}};
+    }
+
+    ConnectionResult ret = new_conn->start();
+    if (ret != ConnectionResult::Success) {
+        return {ret, Mavsdk::ConnectionHandle{}};
+    }
+
+    auto handle = add_connection(std::move(new_conn));
+    return {ConnectionResult::Success, handle};
+}
+
+std::pair<ConnectionResult, Mavsdk::ConnectionHandle>
+MavsdkImpl::add_unix_connection(const CliArg::Unix& unix_socket, ForwardingOption forwarding_option)
+{
+    auto new_conn = std::make_unique<UnixConnection>(
+        [this](
+            MavlinkReceiver::ParseResult result,
+            mavlink_message_t& message,
+            Connection* connection) { receive_message(result, message, connection); },
+        [this](const Mavsdk::MavlinkMessage& message, Connection* connection) {
+            receive_libmav_message(message, connection);
+        },
+        *this,
+        unix_socket.path,
+        unix_socket.mode == CliArg::Unix::Mode::In ? UnixConnection::Mode::Listen :
+                                                     UnixConnection::Mode::Connect,
+        forwarding_option);
+
+    if (!new_conn) {
+        return {ConnectionResult::ConnectionError, Mavsdk::ConnectionHandle{}};
+    }
+
+    ConnectionResult ret = new_conn->start();
+    if (ret != ConnectionResult::Success) {
+        return {ret, Mavsdk::ConnectionHandle{}};
+    }
+
+    auto handle = add_connection(std::move(new_conn));
+    return {ConnectionResult::Success, handle};
+}
+
+std::pair<ConnectionResult, Mavsdk::ConnectionHandle>
+MavsdkImpl::add_shm_connection(const CliArg::Shm& shm, ForwardingOption forwarding_option)
+{
+    auto new_conn = std::make_unique<ShmConnection>(
+        [this](
+            MavlinkReceiver::ParseResult result,
+            mavlink_message_t& message,
+            Connection* connection) { receive_message(result, message, connection); },
+        [this](const Mavsdk::MavlinkMessage& message, Connection* connection) {
+            receive_libmav_message(message, connection);
+        },
+        *this,
+        shm.name,
+        forwarding_option);
+
+    if (!new_conn) {
+        return {ConnectionResult::ConnectionError, Mavsdk::ConnectionHandle{}};
+    }
+
+    ConnectionResult ret = new_conn->start();
+    if (ret != ConnectionResult::Success) {
+        return {ret, Mavsdk::ConnectionHandle{}};
+    }
+
+    auto handle = add_connection(std::move(new_conn));
+    return {ConnectionResult::Success, handle};
+}
+
 Mavsdk::ConnectionHandle MavsdkImpl::add_connection(std::unique_ptr<Connection>&& new_connection)
 {
     std::lock_guard lock(_mutex);
     auto handle = _connections_handle_factory.create();
+    new_connection->set_routing_link(_routing_table.add_link());
     _connections.emplace_back(ConnectionEntry{std::move(new_connection), handle});
 
     return handle;
@@ -1171,6 +1410,12 @@ void MavsdkImpl::remove_connection(Mavsdk::ConnectionHandle handle)
     }
     // conn_to_stop is destroyed here, outside _mutex, so stop() / the
     // io_context fence can complete without hitting the lock.
+    if (conn_to_stop) {
+        const auto routing_link = conn_to_stop->routing_link();
+        conn_to_stop.reset();
+        // Only now that it can't learn anymore.
+        _routing_table.remove_link(routing_link);
+    }
 }
 
 Mavsdk::Configuration MavsdkImpl::get_configuration() const
@@ -1345,6 +1590,19 @@ void MavsdkImpl::make_system_with_component(uint8_t system_id, uint8_t comp_id)
     _systems.emplace_back(system_id, new_system);
 }
 
+IoWorker* MavsdkImpl::io_worker_for_new_system()
+{
+    // Needs _mutex
+
+    if (_io_workers.empty()) {
+        return nullptr;
+    }
+
+    auto* io_worker = _io_workers[_next_io_worker].get();
+    _next_io_worker = (_next_io_worker + 1) % _io_workers.size();
+    return io_worker;
+}
+
 void MavsdkImpl::notify_on_discover()
 {
     // Queue the callbacks without holding the mutex to avoid deadlocks
@@ -1384,43 +1642,32 @@ bool MavsdkImpl::is_any_system_connected() const
     });
 }
 
-void MavsdkImpl::schedule_do_work()
+void MavsdkImpl::schedule_timers()
 {
-    // Drive ServerComponent protocol-handler state machines (command sender, parameter client,
-    // mission transfer, FTP client, …) on the io_context thread every 10 ms.
-    // Using dispatch() would execute immediately on first call but we want a timer-driven cadence,
-    // so async_wait is correct here — same pattern as schedule_timers_poll().
-    _do_work_timer.expires_after(std::chrono::milliseconds(10));
-    _do_work_timer.async_wait([this](const asio::error_code& ec) {
-        if (ec) {
-            // Cancelled (e.g. during shutdown) — do not reschedule.
-            return;
-        }
-        {
-            std::lock_guard lock(_server_components_mutex);
-            for (auto& it : _server_components) {
-                if (it.second != nullptr) {
-                    it.second->_impl->do_work();
-                }
-            }
-        }
-        schedule_do_work();
-    });
-}
+    // Sleep until the earliest deadline of TimeoutHandler and CallEveryHandler. If
+    // nothing is pending there is nothing to wait for: adding a timeout or entry
+    // calls us again. Re-arming cancels the previous wait.
+    auto next = timeout_handler.next_deadline();
+    const auto next_call_every = call_every_handler.next_deadline();
+    if (!next || (next_call_every && *next_call_every < *next)) {
+        next = next_call_every;
+    }
 
-void MavsdkImpl::schedule_timers_poll()
-{
-    // Run TimeoutHandler and CallEveryHandler on the io_context thread every 5 ms.
-    // This gives ~5 ms timer resolution without a separate polling thread.
-    _timers_poll_timer.expires_after(std::chrono::milliseconds(5));
-    _timers_poll_timer.async_wait([this](const asio::error_code& ec) {
+    if (!next) {
+        _timers_timer.cancel();
+        return;
+    }
+
+    _timers_timer.expires_at(*next);
+    _timers_timer.async_wait([this](const asio::error_code& ec) {
         if (ec) {
-            // Cancelled (e.g. during shutdown) — do not reschedule.
+            // Cancelled (re-armed, or during shutdown) — a newer wait took over.
             return;
         }
+        _timer_wakeups.fetch_add(1, std::memory_order_relaxed);
         timeout_handler.run_once();
         call_every_handler.run_once();
-        schedule_timers_poll();
+        schedule_timers();
     });
 }
 
@@ -1445,10 +1692,10 @@ void MavsdkImpl::set_callback_executor(std::function<void(std::function<void()>)
         {
             std::lock_guard<std::mutex> lock(_callback_executor_mutex);
             if (_callback_executor) {
-                LockedQueue<UserCallback>::Guard guard(_user_callback_queue);
-                while (auto ptr = guard.get_front()) {
-                    _callback_executor(ptr->func);
-                    guard.pop_front();
+                UserCallbackQueue::Item item;
+                while (_user_callback_queue.try_pop(item)) {
+                    _callback_stall_detector.callback_discarded();
+                    _callback_executor(std::move(item.func));
                 }
             }
         }
@@ -1463,7 +1710,7 @@ void MavsdkImpl::set_callback_executor(std::function<void(std::function<void()>)
 }
 
 void MavsdkImpl::call_user_callback_located(
-    const std::string& filename, const int linenumber, const std::function<void()>& func)
+    const char* filename, const int linenumber, UserCallback func)
 {
     // Don't enqueue callbacks if we're shutting down
     if (_should_exit) {
@@ -1473,7 +1720,7 @@ void MavsdkImpl::call_user_callback_located(
     {
         std::lock_guard<std::mutex> lock(_callback_executor_mutex);
         if (_callback_executor) {
-            _callback_executor(func);
+            _callback_executor(std::move(func));
             return;
         }
     }
@@ -1499,59 +1746,39 @@ void MavsdkImpl::call_user_callback_located(
             callback_size);
     }
 
-    // We only need to keep track of filename and linenumber if we're actually debugging this.
-    UserCallback user_callback =
-        _callback_debugging ? UserCallback{func, filename, linenumber} : UserCallback{func};
+    if (_callback_stall_detector.callback_queued()) {
+        start_callback_stall_check();
+    }
 
-    _user_callback_queue.push_back(std::make_shared<UserCallback>(user_callback));
+    // Filename and line come from the call_user_callback() site as string literal and
+    // integer, so they are kept for every callback at no cost.
+    if (!_user_callback_queue.try_push(std::move(func), filename, linenumber)) {
+        _callback_stall_detector.callback_discarded();
+        // Only possible if concurrent callers all got past the size check above.
+        LogErr(
+            "User callback queue overflown\nSee: https://mavsdk.mavlink.io/main/en/cpp/troubleshooting.html#user_callbacks");
+    }
 }
 
 void MavsdkImpl::process_user_callbacks_thread()
 {
+    UserCallbackQueue::Item callback;
     while (!_should_exit) {
-        UserCallback callback;
-        {
-            LockedQueue<UserCallback>::Guard guard(_user_callback_queue);
-            auto ptr = guard.wait_and_pop_front();
-            if (!ptr) {
-                break;
-            }
-            // We need to get a copy instead of just a shared_ptr because the queue might
-            // be invalidated when the lock is released.
-            callback = *ptr;
+        if (!_user_callback_queue.wait_and_pop(callback)) {
+            break;
         }
 
         // Check if we're in the process of shutting down before executing the callback
         if (_should_exit) {
+            _callback_stall_detector.callback_discarded();
             continue;
         }
 
-        const double timeout_s = 1.0;
-        // Capture the fields we need by value: this watchdog runs on the io thread and
-        // can fire while (or just after) callback.func() runs here, so referencing the
-        // loop-local 'callback' would race with its destruction at the next iteration.
-        auto cookie = timeout_handler.add(
-            [this, timeout_s, filename = callback.filename, linenumber = callback.linenumber]() {
-                if (_callback_debugging) {
-                    LogWarn(
-                        "Callback called from {}:{} took more than {} second to run.",
-                        filename,
-                        linenumber,
-                        static_cast<int>(timeout_s));
-                    fflush(stdout);
-                    fflush(stderr);
-                    abort();
-                } else {
-                    LogWarn(
-                        "Callback took more than {} second to run.\nSee: https://mavsdk.mavlink.io/main/en/cpp/troubleshooting.html#user_callbacks",
-                        static_cast<int>(timeout_s));
-                }
-            },
-            timeout_s);
+        _callback_stall_detector.callback_started(callback.filename, callback.linenumber);
         auto callback_start = std::chrono::steady_clock::now();
         callback.func();
         auto callback_end = std::chrono::steady_clock::now();
-        timeout_handler.remove(cookie);
+        _callback_stall_detector.callback_finished();
 
         if (_callback_tracker) {
             auto callback_duration_us =
@@ -1560,6 +1787,58 @@ void MavsdkImpl::process_user_callbacks_thread()
             _callback_tracker->record_executed(
                 callback.filename, callback.linenumber, callback_duration_us);
         }
+
+        // Don't keep whatever the callback captured alive until the next one comes in.
+        callback.func.reset();
+    }
+}
+
+void MavsdkImpl::print_timer_wakeups()
+{
+    const auto wakeups = _timer_wakeups.exchange(0, std::memory_order_relaxed);
+    LogDebug(
+        "Timer wakeups: {:.1f}/s", static_cast<double>(wakeups) / TIMER_WAKEUPS_STATS_INTERVAL_S);
+}
+
+void MavsdkImpl::start_callback_stall_check()
+{
+    std::lock_guard<std::mutex> lock(_callback_stall_check_mutex);
+    if (_callback_stall_check_cookie == 0) {
+        _callback_stall_check_cookie = call_every_handler.add(
+            [this]() { check_for_callback_stall(); }, CALLBACK_STALL_CHECK_INTERVAL_S);
+    }
+}
+
+void MavsdkImpl::check_for_callback_stall()
+{
+    {
+        // A callback queued meanwhile restarts the check once we let go of the lock.
+        std::lock_guard<std::mutex> lock(_callback_stall_check_mutex);
+        if (_callback_stall_detector.idle()) {
+            call_every_handler.remove(_callback_stall_check_cookie);
+            _callback_stall_check_cookie = 0;
+            return;
+        }
+    }
+
+    auto stall = _callback_stall_detector.check(CALLBACK_STALL_TIMEOUT_S);
+    if (!stall) {
+        return;
+    }
+
+    if (_callback_debugging) {
+        LogWarn(
+            "Callback called from {}:{} took more than {} second to run.",
+            stall->filename,
+            stall->linenumber,
+            static_cast<int>(CALLBACK_STALL_TIMEOUT_S));
+        fflush(stdout);
+        fflush(stderr);
+        abort();
+    } else {
+        LogWarn(
+            "Callback took more than {} second to run.\nSee: https://mavsdk.mavlink.io/main/en/cpp/troubleshooting.html#user_callbacks",
+            static_cast<int>(CALLBACK_STALL_TIMEOUT_S));
     }
 }
 
@@ -1637,36 +1916,167 @@ void MavsdkImpl::send_heartbeats()
 
 void MavsdkImpl::intercept_incoming_messages_async(std::function<bool(mavlink_message_t&)> callback)
 {
-    std::lock_guard<std::mutex> lock(_intercept_callbacks_mutex);
+    std::lock_guard lock(_intercept_callbacks_mutex);
     _intercept_incoming_messages_callback = callback;
 }
 
 void MavsdkImpl::intercept_outgoing_messages_async(std::function<bool(mavlink_message_t&)> callback)
 {
-    std::lock_guard<std::mutex> lock(_intercept_callbacks_mutex);
+    std::lock_guard lock(_intercept_callbacks_mutex);
     _intercept_outgoing_messages_callback = callback;
+    _intercepting_outgoing_messages = (callback != nullptr);
 }
 
-bool MavsdkImpl::start_tlog_recording(const std::string& path)
+namespace {
+
+BufferedFileWriter::Options to_writer_options(const Mavsdk::RecordingOptions& options)
 {
-    std::lock_guard<std::mutex> lock(_tlog_mutex);
-    if (_tlog_file && _tlog_file->stream.is_open()) {
-        _tlog_file->stream.flush();
-        _tlog_file->stream.close();
+    BufferedFileWriter::Options writer_options;
+    writer_options.flush_interval =
+        std::chrono::milliseconds(static_cast<int64_t>(options.flush_interval_s * 1e3));
+    writer_options.buffer_size = options.buffer_size_bytes;
+    return writer_options;
+}
+
+Mavsdk::RecordingStats to_recording_stats(const BufferedFileWriter::Stats& stats)
+{
+    return {stats.records_written, stats.bytes_written, stats.records_dropped, stats.bytes_dropped};
+}
+
+uint64_t unix_time_us()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                     std::chrono::system_clock::now().time_since_epoch())
+                                     .count());
+}
+
+} // namespace
+
+bool MavsdkImpl::start_tlog_recording(
+    const std::string& path, const Mavsdk::RecordingOptions& options)
+{
+    stop_tlog_recording();
+
+    auto writer = std::make_unique<BufferedFileWriter>(to_writer_options(options));
+    if (!writer->start(path)) {
+        return false;
     }
-    _tlog_file = std::make_unique<TlogFile>();
-    _tlog_file->stream.open(path, std::ios::binary | std::ios::trunc);
-    return _tlog_file->stream.is_open();
+
+    std::lock_guard<std::mutex> lock(_tlog_mutex);
+    _tlog_writer = std::move(writer);
+    _last_tlog_stats = {};
+    _tlog_recording.store(true, std::memory_order_release);
+    return true;
 }
 
 void MavsdkImpl::stop_tlog_recording()
 {
+    std::unique_ptr<BufferedFileWriter> writer;
+    {
+        std::lock_guard<std::mutex> lock(_tlog_mutex);
+        _tlog_recording.store(false, std::memory_order_release);
+        writer = std::move(_tlog_writer);
+    }
+
+    if (!writer) {
+        return;
+    }
+
+    // Writing out what is still buffered can take a while, so do it without
+    // holding the lock that the io thread takes for every frame.
+    writer->stop();
+
+    std::lock_guard<std::mutex> lock(_tlog_mutex);
+    _last_tlog_stats = to_recording_stats(writer->stats());
+}
+
+Mavsdk::RecordingStats MavsdkImpl::tlog_stats() const
+{
+    std::lock_guard<std::mutex> lock(_tlog_mutex);
+    return _tlog_writer ? to_recording_stats(_tlog_writer->stats()) : _last_tlog_stats;
+}
+
+void MavsdkImpl::record_tlog_frame(const uint8_t* frame, size_t len)
+{
+    if (!_tlog_recording.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    // The timestamp is taken on receipt, the writer thread does the rest.
+    const uint64_t now_us = unix_time_us();
+
+    // Big-endian microsecond Unix timestamp.
+    std::array<uint8_t, 8> header{};
+    for (size_t i = 0; i < header.size(); ++i) {
+        header[i] = static_cast<uint8_t>(now_us >> (8 * (header.size() - 1 - i)));
+    }
+
     std::lock_guard<std::mutex> lock(_tlog_mutex);
-    if (_tlog_file && _tlog_file->stream.is_open()) {
-        _tlog_file->stream.flush();
-        _tlog_file->stream.close();
+    if (_tlog_writer) {
+        _tlog_writer->write_record(header.data(), header.size(), frame, len);
+    }
+}
+
+bool MavsdkImpl::start_capture_recording(
+    const std::string& path, const Mavsdk::RecordingOptions& options)
+{
+    stop_capture_recording();
+
+    auto writer = std::make_unique<CaptureWriter>(to_writer_options(options));
+    if (!writer->start(path)) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_capture_mutex);
+    _capture_writer = std::move(writer);
+    _last_capture_stats = {};
+    _capture_recording.store(true, std::memory_order_release);
+    return true;
+}
+
+void MavsdkImpl::stop_capture_recording()
+{
+    std::unique_ptr<CaptureWriter> writer;
+    {
+        std::lock_guard<std::mutex> lock(_capture_mutex);
+        _capture_recording.store(false, std::memory_order_release);
+        writer = std::move(_capture_writer);
+    }
+
+    if (!writer) {
+        return;
+    }
+
+    // Same as for the tlog, don't hold the lock while the rest is written.
+    writer->stop();
+
+    std::lock_guard<std::mutex> lock(_capture_mutex);
+    _last_capture_stats = to_recording_stats(writer->stats());
+}
+
+Mavsdk::RecordingStats MavsdkImpl::capture_stats() const
+{
+    std::lock_guard<std::mutex> lock(_capture_mutex);
+    return _capture_writer ? to_recording_stats(_capture_writer->stats()) : _last_capture_stats;
+}
+
+void MavsdkImpl::record_capture_frame(
+    uint32_t connection_id,
+    CaptureDirection direction,
+    uint8_t flags,
+    const uint8_t* frame,
+    size_t len)
+{
+    if (!_capture_recording.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    const uint64_t now_us = unix_time_us();
+
+    std::lock_guard<std::mutex> lock(_capture_mutex);
+    if (_capture_writer) {
+        _capture_writer->write_frame(now_us, connection_id, direction, flags, frame, len);
     }
-    _tlog_file.reset();
 }
 
 bool MavsdkImpl::call_json_interception_callbacks(
@@ -1676,7 +2086,7 @@ bool MavsdkImpl::call_json_interception_callbacks(
 {
     bool keep_message = true;
 
-    std::lock_guard<std::mutex> lock(_json_subscriptions_mutex);
+    std::lock_guard lock(_json_subscriptions_mutex);
     for (const auto& subscription : callback_list) {
         if (!subscription.second(json_message)) {
             keep_message = false;
@@ -1689,15 +2099,17 @@ bool MavsdkImpl::call_json_interception_callbacks(
 Mavsdk::InterceptJsonHandle
 MavsdkImpl::subscribe_incoming_messages_json(const Mavsdk::InterceptJsonCallback& callback)
 {
-    std::lock_guard<std::mutex> lock(_json_subscriptions_mutex);
+    std::lock_guard lock(_json_subscriptions_mutex);
     auto handle = _json_handle_factory.create();
     _incoming_json_message_subscriptions.push_back(std::make_pair(handle, callback));
+    _incoming_json_subscriptions_count.store(
+        _incoming_json_message_subscriptions.size(), std::memory_order_release);
     return handle;
 }
 
 void MavsdkImpl::unsubscribe_incoming_messages_json(Mavsdk::InterceptJsonHandle handle)
 {
-    std::lock_guard<std::mutex> lock(_json_subscriptions_mutex);
+    std::lock_guard lock(_json_subscriptions_mutex);
     auto it = std::find_if(
         _incoming_json_message_subscriptions.begin(),
         _incoming_json_message_subscriptions.end(),
@@ -1705,20 +2117,24 @@ void MavsdkImpl::unsubscribe_incoming_messages_json(Mavsdk::InterceptJsonHandle
     if (it != _incoming_json_message_subscriptions.end()) {
         _incoming_json_message_subscriptions.erase(it);
     }
+    _incoming_json_subscriptions_count.store(
+        _incoming_json_message_subscriptions.size(), std::memory_order_release);
 }
 
 Mavsdk::InterceptJsonHandle
 MavsdkImpl::subscribe_outgoing_messages_json(const Mavsdk::InterceptJsonCallback& callback)
 {
-    std::lock_guard<std::mutex> lock(_json_subscriptions_mutex);
+    std::lock_guard lock(_json_subscriptions_mutex);
     auto handle = _json_handle_factory.create();
     _outgoing_json_message_subscriptions.push_back(std::make_pair(handle, callback));
+    _outgoing_json_subscriptions_count.store(
+        _outgoing_json_message_subscriptions.size(), std::memory_order_release);
     return handle;
 }
 
 void MavsdkImpl::unsubscribe_outgoing_messages_json(Mavsdk::InterceptJsonHandle handle)
 {
-    std::lock_guard<std::mutex> lock(_json_subscriptions_mutex);
+    std::lock_guard lock(_json_subscriptions_mutex);
     auto it = std::find_if(
         _outgoing_json_message_subscriptions.begin(),
         _outgoing_json_message_subscriptions.end(),
@@ -1726,6 +2142,8 @@ void MavsdkImpl::unsubscribe_outgoing_messages_json(Mavsdk::InterceptJsonHandle
     if (it != _outgoing_json_message_subscriptions.end()) {
         _outgoing_json_message_subscriptions.erase(it);
     }
+    _outgoing_json_subscriptions_count.store(
+        _outgoing_json_message_subscriptions.size(), std::memory_order_release);
 }
 
 RawConnection* MavsdkImpl::find_raw_connection()
@@ -1794,6 +2212,163 @@ void MavsdkImpl::unsubscribe_connection_errors(Mavsdk::ConnectionErrorHandle han
     _connections_errors_subscriptions.unsubscribe(handle);
 }
 
+std::optional<Mavsdk::ConnectionStats>
+MavsdkImpl::connection_stats(Mavsdk::ConnectionHandle handle)
+{
+    std::lock_guard lock(_mutex);
+
+    _connection_stats_last_polled = LinkStats::Clock::now();
+    if (_connection_stats_cookie == 0) {
+        // Not polled recently, so the rates are averaged over the time since they
+        // were last updated, until the timer has run.
+        for (auto& entry : _connections) {
+            entry.connection->stats().update_rates(_connection_stats_last_polled);
+        }
+        _connection_stats_cookie = call_every_handler.add(
+            [this]() { update_connection_stats(); }, CONNECTION_STATS_INTERVAL_S);
+        call_every_handler.reset(_connection_stats_cookie);
+    }
+
+    for (const auto& entry : _connections) {
+        if (entry.handle == handle) {
+            auto stats = entry.connection->stats().get();
+            if (const auto queue_stats = entry.connection->send_queue_stats()) {
+                stats.send_queue_frames = queue_stats->queued;
+                stats.send_queue_max_frames = queue_stats->max_queued;
+                stats.send_queue_frames_dropped = queue_stats->frames_dropped;
+            }
+            return stats;
+        }
+    }
+    return std::nullopt;
+}
+
+std::vector<Mavsdk::Route> MavsdkImpl::routes() const
+{
+    const auto table_routes = _routing_table.routes();
+
+    std::vector<Mavsdk::Route> result;
+    result.reserve(table_routes.size());
+
+    std::lock_guard lock(_mutex);
+    for (const auto& table_route : table_routes) {
+        Mavsdk::Route route;
+        route.system_id = table_route.system_id;
+        route.component_id = table_route.component_id;
+        route.messages_received = table_route.messages_received;
+        route.messages_routed = table_route.messages_routed;
+        for (const auto& entry : _connections) {
+            if ((table_route.links & RoutingTable::mask(entry.connection->routing_link())) != 0) {
+                route.connections.push_back(entry.handle);
+            }
+        }
+        result.push_back(std::move(route));
+    }
+    return result;
+}
+
+namespace {
+
+Mavsdk::CommandResult
+command_result_from_command_sender_result(MavlinkCommandSender::Result result)
+{
+    switch (result) {
+        case MavlinkCommandSender::Result::Success:
+            return Mavsdk::CommandResult::Success;
+        case MavlinkCommandSender::Result::NoSystem:
+            return Mavsdk::CommandResult::NoSystem;
+        case MavlinkCommandSender::Result::ConnectionError:
+            return Mavsdk::CommandResult::ConnectionError;
+        case MavlinkCommandSender::Result::Busy:
+            return Mavsdk::CommandResult::Busy;
+        case MavlinkCommandSender::Result::Denied:
+            return Mavsdk::CommandResult::Denied;
+        case MavlinkCommandSender::Result::Unsupported:
+            return Mavsdk::CommandResult::Unsupported;
+        case MavlinkCommandSender::Result::Timeout:
+            return Mavsdk::CommandResult::Timeout;
+        case MavlinkCommandSender::Result::TemporarilyRejected:
+            return Mavsdk::CommandResult::TemporarilyRejected;
+        case MavlinkCommandSender::Result::Failed:
+            return Mavsdk::CommandResult::Failed;
+        case MavlinkCommandSender::Result::Cancelled:
+            return Mavsdk::CommandResult::Cancelled;
+        default:
+            return Mavsdk::CommandResult::Unknown;
+    }
+}
+
+} // namespace
+
+void MavsdkImpl::send_commands_async(
+    const std::vector<Mavsdk::Command>& commands,
+    const Mavsdk::CommandResultCallback& callback,
+    unsigned max_in_flight_per_component)
+{
+    // One batch per system, each system has its own command sender.
+    struct Batch {
+        std::vector<MavlinkCommandSender::CommandLong> commands{};
+        std::vector<std::size_t> indices{};
+    };
+    std::map<std::shared_ptr<SystemImpl>, Batch> batches;
+
+    const auto maybe_param = [](float param) -> std::optional<float> {
+        if (std::isnan(param)) {
+            return std::nullopt;
+        }
+        return param;
+    };
+
+    for (std::size_t i = 0; i < commands.size(); ++i) {
+        const auto& command = commands[i];
+        if (!command.system) {
+            if (callback) {
+                callback(i, Mavsdk::CommandResult::NoSystem);
+            }
+            continue;
+        }
+
+        MavlinkCommandSender::CommandLong command_long{};
+        command_long.target_component_id = command.component_id;
+        command_long.command = command.command;
+        command_long.params.maybe_param1 = maybe_param(command.param1);
+        command_long.params.maybe_param2 = maybe_param(command.param2);
+        command_long.params.maybe_param3 = maybe_param(command.param3);
+        command_long.params.maybe_param4 = maybe_param(command.param4);
+        command_long.params.maybe_param5 = maybe_param(command.param5);
+        command_long.params.maybe_param6 = maybe_param(command.param6);
+        command_long.params.maybe_param7 = maybe_param(command.param7);
+
+        auto& batch = batches[command.system->_system_impl];
+        batch.commands.push_back(command_long);
+        batch.indices.push_back(i);
+    }
+
+    for (auto& [system_impl, batch] : batches) {
+        system_impl->send_command_batch_async(
+            std::move(batch.commands),
+            [callback, indices = std::move(batch.indices)](
+                std::size_t index, MavlinkCommandSender::Result result) {
+                if (callback) {
+                    callback(indices[index], command_result_from_command_sender_result(result));
+                }
+            },
+            max_in_flight_per_component);
+    }
+}
+
+std::vector<Mavsdk::CommandStats> MavsdkImpl::command_stats() const
+{
+    CommandLatencyStats total;
+    {
+        std::lock_guard lock(_mutex);
+        for (const auto& [system_id, system] : _systems) {
+            system->_system_impl->command_latency_stats().add_to(total);
+        }
+    }
+    return total.get();
+}
+
 uint8_t MavsdkImpl::get_target_system_id(const mavlink_message_t& message)
 {
     // Checks whether connection knows target system ID by extracting target system if set.
@@ -1901,4 +2476,26 @@ MavsdkImpl::get_message_definition_safe(int message_id) const
     return _message_set->getMessageDefinition(message_id);
 }
 
+MessageSubscriptionIndex::Key MavsdkImpl::add_libmav_subscription(const std::string& message_name)
+{
+    MessageSubscriptionIndex::Key key{};
+    if (!message_name.empty()) {
+        if (auto id = message_name_to_id_safe(message_name)) {
+            key = static_cast<uint32_t>(id.value());
+        } else {
+            // The definition might only arrive later with a custom XML, so we can't
+            // narrow this down to one ID and have to decode everything instead.
+            LogDebug("Unknown message {}, decoding all messages for it", message_name);
+        }
+    }
+
+    _libmav_subscriptions.add(key);
+    return key;
+}
+
+void MavsdkImpl::remove_libmav_subscription(MessageSubscriptionIndex::Key key)
+{
+    _libmav_subscriptions.remove(key);
+}
+
 } // namespace mavsdk
@@ -15,22 +15,27 @@
 #include "autopilot.hpp"
 #include "compatibility_mode.hpp"
 #include "call_every_handler.hpp"
+#include "capture_file.hpp"
 #include "component_type.hpp"
 #include "connection.hpp"
 #include "cli_arg.hpp"
 #include "handle_factory.hpp"
 #include "handle.hpp"
 #include "heartbeat_watchdog.hpp"
+#include "io_worker.hpp"
 #include "mavsdk.hpp"
 #include "mavlink_include.hpp"
 #include "mavlink_message_handler.hpp"
-#include "locked_queue.hpp"
+#include "message_subscription_index.hpp"
+#include "routing_table.hpp"
 #include "server_component.hpp"
 #include "system.hpp"
 #include "sender.hpp"
 #include "timeout_handler.hpp"
+#include "user_callback_queue.hpp"
 #include "callback_list.hpp"
 #include "callback_tracker.hpp"
+#include "callback_stall_detector.hpp"
 
 namespace mav {
 class MessageSet;
@@ -43,8 +48,6 @@ namespace mavsdk {
 
 class RawConnection;
 
-struct TlogFile;
-
 class MavsdkImpl {
     // The Asio io_context must outlive every member that posts onto it during teardown
     // (the message handler, parameter subscriptions, connections, systems, and server
@@ -55,6 +58,12 @@ class MavsdkImpl {
     // Keep io_context::run() from returning when there are momentarily no async ops pending.
     asio::executor_work_guard<asio::io_context::executor_type> _io_work_guard{
         _io_context.get_executor()};
+    // Only used with more than one io thread configured: each system is then pinned to
+    // one of these workers (see io_worker_for_new_system()), while connections, server
+    // components and everything else stay on _io_context. Declared up here for the same
+    // reason as _io_context: systems post onto them during teardown.
+    std::vector<std::unique_ptr<IoWorker>> _io_workers{};
+    size_t _next_io_worker{0};
 
 public:
     MavsdkImpl(const Mavsdk::Configuration& configuration);
@@ -116,8 +125,24 @@ public:
     void intercept_incoming_messages_async(std::function<bool(mavlink_message_t&)> callback);
     void intercept_outgoing_messages_async(std::function<bool(mavlink_message_t&)> callback);
 
-    bool start_tlog_recording(const std::string& path);
+    bool start_tlog_recording(const std::string& path, const Mavsdk::RecordingOptions& options);
     void stop_tlog_recording();
+    Mavsdk::RecordingStats tlog_stats() const;
+
+    // Called by the connections with the raw bytes of every received frame.
+    void record_tlog_frame(const uint8_t* frame, size_t len);
+
+    bool start_capture_recording(const std::string& path, const Mavsdk::RecordingOptions& options);
+    void stop_capture_recording();
+    Mavsdk::RecordingStats capture_stats() const;
+
+    // Called by the connections with the bytes of every frame received or sent.
+    void record_capture_frame(
+        uint32_t connection_id,
+        CaptureDirection direction,
+        uint8_t flags,
+        const uint8_t* frame,
+        size_t len);
 
     // JSON message interception
     Mavsdk::InterceptJsonHandle
@@ -130,6 +155,14 @@ public:
     Mavsdk::ConnectionErrorHandle
     subscribe_connection_errors(Mavsdk::ConnectionErrorCallback callback);
     void unsubscribe_connection_errors(Mavsdk::ConnectionErrorHandle handle);
+    std::optional<Mavsdk::ConnectionStats> connection_stats(Mavsdk::ConnectionHandle handle);
+    std::vector<Mavsdk::Route> routes() const;
+
+    void send_commands_async(
+        const std::vector<Mavsdk::Command>& commands,
+        const Mavsdk::CommandResultCallback& callback,
+        unsigned max_in_flight_per_component);
+    std::vector<Mavsdk::CommandStats> command_stats() const;
 
     // Raw bytes API
     void pass_received_raw_bytes(const char* bytes, size_t length);
@@ -147,8 +180,7 @@ public:
     TimeoutHandler timeout_handler;
     CallEveryHandler call_every_handler;
 
-    void call_user_callback_located(
-        const std::string& filename, int linenumber, const std::function<void()>& func);
+    void call_user_callback_located(const char* filename, int linenumber, UserCallback func);
 
     void set_timeout_s(double timeout_s) { _timeout_s = timeout_s; }
     double timeout_s() const { return _timeout_s; }
@@ -166,6 +198,10 @@ public:
     // Asio io_context shared by all connections for async I/O
     asio::io_context& io_context() { return _io_context; }
 
+    // The worker a new system is pinned to, round-robin, or nullptr if systems run on
+    // io_context() as well. Needs _mutex.
+    IoWorker* io_worker_for_new_system();
+
     // Get MessageSet for message creation and parsing
     mav::MessageSet& get_message_set() const;
 
@@ -181,6 +217,13 @@ public:
     mav::OptionalReference<const mav::MessageDefinition>
     get_message_definition_safe(int message_id) const;
 
+    // Messages that need to be decoded with libmav (e.g. for MavlinkDirect subscribers).
+    // An empty message name means all messages. The returned key must be handed back to
+    // remove_libmav_subscription() once the subscriber goes away.
+    MessageSubscriptionIndex::Key add_libmav_subscription(const std::string& message_name);
+    void remove_libmav_subscription(MessageSubscriptionIndex::Key key);
+    const MessageSubscriptionIndex& libmav_subscriptions() const { return _libmav_subscriptions; }
+
 private:
     static constexpr float DEFAULT_TIMEOUT_S = 0.5f;
     static constexpr double DEFAULT_HEARTBEAT_TIMEOUT_S = 3.0;
@@ -197,6 +240,12 @@ private:
         ForwardingOption forwarding_option);
     std::pair<ConnectionResult, Mavsdk::ConnectionHandle>
     add_raw_connection(ForwardingOption forwarding_option);
+    std::pair<ConnectionResult, Mavsdk::ConnectionHandle>
+    add_replay_connection(const CliArg::Replay& replay, ForwardingOption forwarding_option);
+    std::pair<ConnectionResult, Mavsdk::ConnectionHandle>
+    add_unix_connection(const CliArg::Unix& unix_socket, ForwardingOption forwarding_option);
+    std::pair<ConnectionResult, Mavsdk::ConnectionHandle>
+    add_shm_connection(const CliArg::Shm& shm, ForwardingOption forwarding_option);
 
     Mavsdk::ConnectionHandle add_connection(std::unique_ptr<Connection>&& connection);
     void make_system_with_component(uint8_t system_id, uint8_t component_id);
@@ -221,6 +270,8 @@ private:
     void process_libmav_message(const Mavsdk::MavlinkMessage& message, Connection* connection);
 
     void deliver_message(mavlink_message_t& message);
+    void deliver_queued_messages();
+    bool can_deliver_inline();
 
     bool is_any_system_connected() const;
 
@@ -240,12 +291,72 @@ private:
     // Find the raw connection in the connections list
     RawConnection* find_raw_connection();
 
-    mutable std::recursive_mutex _mutex{};
+    // The locks that deliver_message() takes as well, or that are held while calling into
+    // code that might send. Each lock and unlock is counted for the locking thread, so
+    // send_message() can tell that delivering inline could deadlock or break the lock
+    // order, and queues instead. No call site needs to opt in.
+    template<typename Mutex> class HolderCountingMutex {
+    public:
+        void lock()
+        {
+            _mutex.lock();
+            ++_locks_held_by_this_thread;
+        }
+
+        bool try_lock()
+        {
+            if (!_mutex.try_lock()) {
+                return false;
+            }
+            ++_locks_held_by_this_thread;
+            return true;
+        }
+
+        void unlock()
+        {
+            --_locks_held_by_this_thread;
+            _mutex.unlock();
+        }
+
+    private:
+        Mutex _mutex{};
+    };
+    // Summed over all MavsdkImpl instances, which only makes sending queue more often.
+    static thread_local unsigned _locks_held_by_this_thread;
+
+    mutable HolderCountingMutex<std::recursive_mutex> _mutex{};
 
     // Message set for libmav message handling (shared across all connections)
     std::unique_ptr<mav::MessageSet> _message_set;
     std::unique_ptr<mav::BufferParser> _buffer_parser; // Thread-safe parser
     mutable std::mutex _message_set_mutex;
+    // Declared before the systems and server components, which release their
+    // subscriptions when they are destroyed.
+    MessageSubscriptionIndex _libmav_subscriptions{};
+
+    // Which connection leads to which system/component, so that targeted messages are
+    // only sent and forwarded where they can reach their target. Declared before
+    // _connections, which learn into it until they are stopped.
+    RoutingTable _routing_table{};
+    // Routes and system IDs are aged while there are any. The timer is started by
+    // receive_message() and stops itself once everything has aged out.
+    static constexpr double ROUTE_AGING_INTERVAL_S = 5.0;
+    std::mutex _route_aging_mutex{};
+    std::atomic<bool> _route_aging_running{false};
+    CallEveryHandler::Cookie _route_aging_cookie{0};
+    // Connections forget systems not heard from for this long. Much longer than the
+    // routes, as deliver_message() falls back to them for quiet systems.
+    static constexpr double SYSTEM_ID_TIMEOUT_S = 60.0;
+    void start_route_aging();
+    void age_routes();
+    // The rates of the connection stats are only updated while connection_stats()
+    // is polled, and stop once it has not been called for CONNECTION_STATS_IDLE_S.
+    static constexpr double CONNECTION_STATS_INTERVAL_S = 1.0;
+    static constexpr double CONNECTION_STATS_IDLE_S = 10.0;
+    CallEveryHandler::Cookie _connection_stats_cookie{0};
+    LinkStats::Clock::time_point _connection_stats_last_polled{};
+    void update_connection_stats();
+    static bool is_on_route(const Connection& connection, RoutingTable::LinkMask route_links);
 
     HandleFactory<> _connections_handle_factory;
     struct ConnectionEntry {
@@ -257,7 +368,7 @@ private:
 
     std::vector<std::pair<uint8_t, std::shared_ptr<System>>> _systems{};
 
-    std::recursive_mutex _server_components_mutex;
+    HolderCountingMutex<std::recursive_mutex> _server_components_mutex;
     std::vector<std::pair<uint8_t, std::shared_ptr<ServerComponent>>> _server_components{};
     std::shared_ptr<ServerComponent> _default_server_component{nullptr};
 
@@ -292,42 +403,65 @@ private:
     std::atomic<Autopilot> _our_autopilot{Autopilot::Unknown};
     std::atomic<CompatibilityMode> _our_compatibility_mode{CompatibilityMode::Auto};
 
-    struct UserCallback {
-        UserCallback() = default;
-        explicit UserCallback(std::function<void()> func_) : func(std::move(func_)) {}
-        UserCallback(std::function<void()> func_, std::string filename_, const int linenumber_) :
-            func(std::move(func_)),
-            filename(std::move(filename_)),
-            linenumber(linenumber_)
-        {}
-
-        std::function<void()> func{};
-        std::string filename{};
-        int linenumber{};
-    };
-
     std::unique_ptr<std::thread> _process_user_callbacks_thread{};
-    LockedQueue<UserCallback> _user_callback_queue{};
+    UserCallbackQueue _user_callback_queue{};
+
+    // Warns about (or, when debugging callbacks, aborts on) a user callback
+    // that blocks the user callback thread, checked a few times per second
+    // while any callbacks are queued or running.
+    static constexpr double CALLBACK_STALL_TIMEOUT_S = 1.0;
+    static constexpr double CALLBACK_STALL_CHECK_INTERVAL_S = 0.25;
+    CallbackStallDetector _callback_stall_detector{time};
+    std::mutex _callback_stall_check_mutex{};
+    CallEveryHandler::Cookie _callback_stall_check_cookie{0};
+    void start_callback_stall_check();
+    void check_for_callback_stall();
 
     bool _message_logging_on{false};
     bool _callback_debugging{false};
     bool _system_debugging{false};
+    bool _timer_debugging{false};
     std::unique_ptr<CallbackTracker> _callback_tracker;
 
-    mutable std::mutex _intercept_callbacks_mutex{};
+    mutable HolderCountingMutex<std::mutex> _intercept_callbacks_mutex{};
     std::function<bool(mavlink_message_t&)> _intercept_incoming_messages_callback{nullptr};
     std::function<bool(mavlink_message_t&)> _intercept_outgoing_messages_callback{nullptr};
-
-    std::mutex _tlog_mutex{};
-    std::unique_ptr<TlogFile> _tlog_file{};
+    // Set along with the callback, so send_message() can check it without the mutex.
+    std::atomic<bool> _intercepting_outgoing_messages{false};
+
+    // Messages sent from other threads than the io thread, delivered in order by
+    // deliver_queued_messages(). The two buffers are swapped rather than reallocated, so
+    // once they have grown, sending does not allocate.
+    std::mutex _queued_messages_mutex{};
+    std::vector<mavlink_message_t> _queued_messages{};
+    std::vector<mavlink_message_t> _delivering_messages{};
+    // Only used on the io thread, set while deliver_message() runs so that anything sent
+    // from within it is queued behind instead of overtaking.
+    bool _delivering{false};
+
+
+    // Checked for every received frame, so the mutex is only taken while recording.
+    std::atomic<bool> _tlog_recording{false};
+    mutable std::mutex _tlog_mutex{};
+    std::unique_ptr<BufferedFileWriter> _tlog_writer{};
+    Mavsdk::RecordingStats _last_tlog_stats{};
+
+    std::atomic<bool> _capture_recording{false};
+    mutable std::mutex _capture_mutex{};
+    std::unique_ptr<CaptureWriter> _capture_writer{};
+    Mavsdk::RecordingStats _last_capture_stats{};
 
     // JSON message interception
     std::vector<std::pair<Mavsdk::InterceptJsonHandle, Mavsdk::InterceptJsonCallback>>
         _incoming_json_message_subscriptions{};
     std::vector<std::pair<Mavsdk::InterceptJsonHandle, Mavsdk::InterceptJsonCallback>>
         _outgoing_json_message_subscriptions{};
-    mutable std::mutex _json_subscriptions_mutex{};
+    mutable HolderCountingMutex<std::mutex> _json_subscriptions_mutex{};
     HandleFactory<bool(Mavsdk::MavlinkMessage)> _json_handle_factory{};
+    // Mirror the sizes of the lists above so the message paths can skip building the
+    // JSON representation without taking _json_subscriptions_mutex when nobody listens.
+    std::atomic<size_t> _incoming_json_subscriptions_count{0};
+    std::atomic<size_t> _outgoing_json_subscriptions_count{0};
 
     // Raw bytes subscriptions
     CallbackList<const char*, size_t> _raw_bytes_subscriptions{_io_context};
@@ -360,14 +494,18 @@ private:
 
     // _io_context and _io_work_guard are declared at the very top of the class so that the
     // io_context outlives every member that posts onto it during teardown.
-    // Recurring timer that drives TimeoutHandler::run_once() and
-    // CallEveryHandler::run_once() on the io_context thread.
-    asio::steady_timer _timers_poll_timer{_io_context};
-    void schedule_timers_poll();
-
-    // Recurring timer that drives ServerComponent::do_work() on the io_context thread.
-    asio::steady_timer _do_work_timer{_io_context};
-    void schedule_do_work();
+    // Timer that drives TimeoutHandler::run_once() and CallEveryHandler::run_once()
+    // on the io_context thread. It is armed for the earliest deadline of the two, so
+    // it only wakes up when something is due.
+    asio::steady_timer _timers_timer{_io_context};
+    void schedule_timers();
+
+    // Number of times _timers_timer woke up the io thread, printed and reset
+    // periodically with MAVSDK_TIMER_DEBUGGING=1.
+    static constexpr double TIMER_WAKEUPS_STATS_INTERVAL_S = 5.0;
+    std::atomic<uint64_t> _timer_wakeups{0};
+    CallEveryHandler::Cookie _timer_wakeups_stats_cookie{0};
+    void print_timer_wakeups();
 
     std::unique_ptr<std::thread> _io_thread{};
 };
@@ -0,0 +1,367 @@
+#include "mavsdk_impl.hpp"
+#include "mavlink_include.hpp"
+
+#include <asio/buffer.hpp>
+#include <asio/io_context.hpp>
+#include <asio/ip/udp.hpp>
+#include <asio/post.hpp>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mavsdk;
+
+namespace {
+
+// Collects the messages with one message ID sent over a raw connection, in the order they
+// went out.
+class SentMessages {
+public:
+    SentMessages(MavsdkImpl& mavsdk_impl, uint32_t msgid) :
+        _mavsdk_impl(mavsdk_impl),
+        _msgid(msgid)
+    {
+        _handle = _mavsdk_impl.subscribe_raw_bytes_to_be_sent(
+            [this](const char* bytes, size_t length) { parse(bytes, length); });
+    }
+
+    ~SentMessages() { _mavsdk_impl.unsubscribe_raw_bytes_to_be_sent(_handle); }
+
+    std::vector<mavlink_message_t> wait_for(std::size_t count, std::chrono::milliseconds timeout)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _cv.wait_for(lock, timeout, [&]() { return _messages.size() >= count; });
+        return _messages;
+    }
+
+private:
+    void parse(const char* bytes, size_t length)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (size_t i = 0; i < length; ++i) {
+            if (mavlink_frame_char_buffer(
+                    &_buffer,
+                    &_buffer_status,
+                    static_cast<uint8_t>(bytes[i]),
+                    &_message,
+                    &_status) == MAVLINK_FRAMING_OK &&
+                _message.msgid == _msgid) {
+                _messages.push_back(_message);
+            }
+        }
+        _cv.notify_all();
+    }
+
+    MavsdkImpl& _mavsdk_impl;
+    const uint32_t _msgid;
+    Mavsdk::RawBytesHandle _handle{};
+    std::mutex _mutex{};
+    std::condition_variable _cv{};
+    std::vector<mavlink_message_t> _messages{};
+    mavlink_message_t _buffer{};
+    mavlink_status_t _buffer_status{};
+    mavlink_message_t _message{};
+    mavlink_status_t _status{};
+};
+
+// A plain socket the messages are sent to over udpout://. Unlike subscribing to the raw
+// bytes, this does not keep send_message() from delivering inline.
+class UdpSink {
+public:
+    explicit UdpSink(uint32_t msgid) : _msgid(msgid), _socket(_io_context)
+    {
+        asio::error_code ec;
+        _socket.open(asio::ip::udp::v4(), ec);
+        EXPECT_FALSE(ec);
+        _socket.bind({asio::ip::make_address("127.0.0.1", ec), 0}, ec);
+        EXPECT_FALSE(ec);
+        _socket.non_blocking(true, ec);
+        EXPECT_FALSE(ec);
+    }
+
+    std::string url()
+    {
+        asio::error_code ec;
+        return "udpout://127.0.0.1:" + std::to_string(_socket.local_endpoint(ec).port());
+    }
+
+    std::vector<mavlink_message_t> wait_for(std::size_t count, std::chrono::milliseconds timeout)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        std::vector<char> datagram(2048);
+        while (_messages.size() < count && std::chrono::steady_clock::now() < deadline) {
+            asio::error_code ec;
+            const auto len = _socket.receive(asio::buffer(datagram), 0, ec);
+            if (ec) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+            for (size_t i = 0; i < len; ++i) {
+                if (mavlink_frame_char_buffer(
+                        &_buffer,
+                        &_buffer_status,
+                        static_cast<uint8_t>(datagram[i]),
+                        &_message,
+                        &_status) == MAVLINK_FRAMING_OK &&
+                    _message.msgid == _msgid) {
+                    _messages.push_back(_message);
+                }
+            }
+        }
+        return _messages;
+    }
+
+private:
+    const uint32_t _msgid;
+    asio::io_context _io_context{};
+    asio::ip::udp::socket _socket;
+    std::vector<mavlink_message_t> _messages{};
+    mavlink_message_t _buffer{};
+    mavlink_status_t _buffer_status{};
+    mavlink_message_t _message{};
+    mavlink_status_t _status{};
+};
+
+std::vector<std::string> status_texts(const std::vector<mavlink_message_t>& messages)
+{
+    std::vector<std::string> texts;
+    for (const auto& message : messages) {
+        char text[51]{};
+        mavlink_msg_statustext_get_text(&message, text);
+        texts.emplace_back(text);
+    }
+    return texts;
+}
+
+void send_status_text(MavsdkImpl& mavsdk_impl, const std::string& text)
+{
+    mavlink_message_t message;
+    mavlink_msg_statustext_pack(
+        mavsdk_impl.get_own_system_id(),
+        mavsdk_impl.get_own_component_id(),
+        &message,
+        MAV_SEVERITY_INFO,
+        text.c_str(),
+        0,
+        0);
+    EXPECT_TRUE(mavsdk_impl.send_message(message));
+}
+
+void receive(MavsdkImpl& mavsdk_impl, const mavlink_message_t& message)
+{
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    const auto length = mavlink_msg_to_send_buffer(buffer, &message);
+    mavsdk_impl.pass_received_raw_bytes(reinterpret_cast<const char*>(buffer), length);
+}
+
+void receive_heartbeat(MavsdkImpl& mavsdk_impl, uint8_t system_id = 1)
+{
+    mavlink_message_t message;
+    mavlink_msg_heartbeat_pack(
+        system_id,
+        MAV_COMP_ID_AUTOPILOT1,
+        &message,
+        MAV_TYPE_QUADROTOR,
+        MAV_AUTOPILOT_PX4,
+        0,
+        0,
+        MAV_STATE_STANDBY);
+    receive(mavsdk_impl, message);
+}
+
+void receive_command_ack(
+    MavsdkImpl& mavsdk_impl, uint8_t system_id, uint16_t command, MAV_RESULT result)
+{
+    mavlink_message_t message;
+    mavlink_msg_command_ack_pack(
+        system_id,
+        MAV_COMP_ID_AUTOPILOT1,
+        &message,
+        command,
+        result,
+        0,
+        0,
+        mavsdk_impl.get_own_system_id(),
+        mavsdk_impl.get_own_component_id());
+    receive(mavsdk_impl, message);
+}
+
+} // namespace
+
+TEST(MavsdkImpl, SendFromIncomingInterceptCallback)
+{
+    UdpSink sent{MAVLINK_MSG_ID_STATUSTEXT};
+    MavsdkImpl mavsdk_impl{Mavsdk::Configuration{ComponentType::GroundStation}};
+    // The raw connection is only used to receive the heartbeat.
+    ASSERT_EQ(
+        mavsdk_impl.add_any_connection("raw://", ForwardingOption::ForwardingOff).first,
+        ConnectionResult::Success);
+    ASSERT_EQ(
+        mavsdk_impl.add_any_connection(sent.url(), ForwardingOption::ForwardingOff).first,
+        ConnectionResult::Success);
+
+    // Called on the io thread with the MavsdkImpl locks held, which must not be taken again
+    // to deliver the reply.
+    bool replied = false;
+    mavsdk_impl.intercept_incoming_messages_async([&](mavlink_message_t& message) {
+        if (message.msgid == MAVLINK_MSG_ID_HEARTBEAT && !replied) {
+            replied = true;
+            send_status_text(mavsdk_impl, "reply");
+        }
+        return true;
+    });
+
+    receive_heartbeat(mavsdk_impl);
+
+    const auto texts = status_texts(sent.wait_for(1, std::chrono::seconds(2)));
+    ASSERT_EQ(texts.size(), 1u);
+    EXPECT_EQ(texts[0], "reply");
+
+    mavsdk_impl.intercept_incoming_messages_async(nullptr);
+}
+
+TEST(MavsdkImpl, InlineSendsDoNotOvertakeQueuedOnes)
+{
+    UdpSink sent{MAVLINK_MSG_ID_STATUSTEXT};
+    MavsdkImpl mavsdk_impl{Mavsdk::Configuration{ComponentType::GroundStation}};
+    ASSERT_EQ(
+        mavsdk_impl.add_any_connection(sent.url(), ForwardingOption::ForwardingOff).first,
+        ConnectionResult::Success);
+
+    asio::post(mavsdk_impl.io_context(), [&]() {
+        // Nothing queued, so delivered inline.
+        send_status_text(mavsdk_impl, "1");
+
+        // Queued from another thread, delivered once this handler returns.
+        std::thread([&]() { send_status_text(mavsdk_impl, "2"); }).join();
+
+        // Sent on the io thread, but must wait behind the queued one.
+        send_status_text(mavsdk_impl, "3");
+    });
+
+    asio::post(mavsdk_impl.io_context(), [&]() {
+        // Queue drained, so delivered inline again.
+        send_status_text(mavsdk_impl, "4");
+    });
+
+    const auto texts = status_texts(sent.wait_for(4, std::chrono::seconds(2)));
+    EXPECT_EQ(texts, (std::vector<std::string>{"1", "2", "3", "4"}));
+}
+
+TEST(MavsdkImpl, RawBytesCallbacksDoNotRunInsideSend)
+{
+    MavsdkImpl mavsdk_impl{Mavsdk::Configuration{ComponentType::GroundStation}};
+    ASSERT_EQ(
+        mavsdk_impl.add_any_connection("raw://", ForwardingOption::ForwardingOff).first,
+        ConnectionResult::Success);
+
+    // Set while send_message() runs on the io thread, where it could otherwise deliver
+    // inline and call the raw bytes callbacks with the sender's locks still held.
+    std::atomic<bool> sending{false};
+    std::atomic<bool> called_inside_send{false};
+    const auto handle = mavsdk_impl.subscribe_raw_bytes_to_be_sent([&](const char*, size_t) {
+        if (sending) {
+            called_inside_send = true;
+        }
+    });
+    SentMessages sent{mavsdk_impl, MAVLINK_MSG_ID_STATUSTEXT};
+
+    asio::post(mavsdk_impl.io_context(), [&]() {
+        sending = true;
+        send_status_text(mavsdk_impl, "1");
+        sending = false;
+    });
+
+    const auto texts = status_texts(sent.wait_for(1, std::chrono::seconds(2)));
+    EXPECT_EQ(texts, (std::vector<std::string>{"1"}));
+    EXPECT_FALSE(called_inside_send);
+
+    mavsdk_impl.unsubscribe_raw_bytes_to_be_sent(handle);
+}
+
+TEST(MavsdkImpl, SendCommandsReportsCallerIndices)
+{
+    MavsdkImpl mavsdk_impl{Mavsdk::Configuration{ComponentType::GroundStation}};
+    ASSERT_EQ(
+        mavsdk_impl.add_any_connection("raw://", ForwardingOption::ForwardingOff).first,
+        ConnectionResult::Success);
+    SentMessages sent{mavsdk_impl, MAVLINK_MSG_ID_COMMAND_LONG};
+
+    receive_heartbeat(mavsdk_impl, 1);
+    receive_heartbeat(mavsdk_impl, 2);
+
+    std::map<uint8_t, std::shared_ptr<System>> systems;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (systems.size() < 2 && std::chrono::steady_clock::now() < deadline) {
+        for (const auto& system : mavsdk_impl.systems()) {
+            systems[system->get_system_id()] = system;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(systems.size(), 2u);
+
+    // Interleaved, so that the indices within the batch of each system differ from the ones
+    // passed.
+    std::vector<Mavsdk::Command> commands(5);
+    commands[0].system = systems[1];
+    commands[0].command = MAV_CMD_COMPONENT_ARM_DISARM;
+    commands[1].system = systems[2];
+    commands[1].command = MAV_CMD_COMPONENT_ARM_DISARM;
+    commands[2].system = systems[1];
+    commands[2].command = MAV_CMD_DO_SET_MODE;
+    commands[4].system = systems[2];
+    commands[4].command = MAV_CMD_DO_SET_MODE;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::map<std::size_t, Mavsdk::CommandResult> results;
+    mavsdk_impl.send_commands_async(
+        commands,
+        [&](std::size_t index, Mavsdk::CommandResult result) {
+            std::lock_guard<std::mutex> lock(mutex);
+            EXPECT_EQ(results.count(index), 0u);
+            results[index] = result;
+            cv.notify_all();
+        },
+        8);
+
+    // Systems discovered also request messages, those are not ours.
+    const auto is_ours = [](const mavlink_message_t& message) {
+        const auto command = mavlink_msg_command_long_get_command(&message);
+        return command == MAV_CMD_COMPONENT_ARM_DISARM || command == MAV_CMD_DO_SET_MODE;
+    };
+    const auto sent_deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    std::size_t num_sent = 0;
+    std::size_t num_ours = 0;
+    while (num_ours < 4 && std::chrono::steady_clock::now() < sent_deadline) {
+        const auto messages = sent.wait_for(num_sent + 1, std::chrono::milliseconds(100));
+        num_sent = messages.size();
+        num_ours = static_cast<std::size_t>(
+            std::count_if(messages.begin(), messages.end(), is_ours));
+    }
+    ASSERT_EQ(num_ours, 4u);
+
+    receive_command_ack(mavsdk_impl, 2, MAV_CMD_DO_SET_MODE, MAV_RESULT_UNSUPPORTED);
+    receive_command_ack(mavsdk_impl, 1, MAV_CMD_COMPONENT_ARM_DISARM, MAV_RESULT_ACCEPTED);
+    receive_command_ack(mavsdk_impl, 2, MAV_CMD_COMPONENT_ARM_DISARM, MAV_RESULT_DENIED);
+    receive_command_ack(mavsdk_impl, 1, MAV_CMD_DO_SET_MODE, MAV_RESULT_FAILED);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait_for(lock, std::chrono::seconds(2), [&]() { return results.size() >= 5; });
+    EXPECT_EQ(
+        results,
+        (std::map<std::size_t, Mavsdk::CommandResult>{
+            {0, Mavsdk::CommandResult::Success},
+            {1, Mavsdk::CommandResult::Denied},
+            {2, Mavsdk::CommandResult::Failed},
+            {3, Mavsdk::CommandResult::NoSystem},
+            {4, Mavsdk::CommandResult::Unsupported}}));
+}
@@ -16,4 +16,25 @@ TEST(Mavsdk, Configuration)
     ASSERT_EQ(configuration.get_mav_type(), MAV_TYPE::MAV_TYPE_GENERIC); // Default
     configuration.set_mav_type(MAV_TYPE::MAV_TYPE_FIXED_WING);
     ASSERT_EQ(configuration.get_mav_type(), MAV_TYPE::MAV_TYPE_FIXED_WING);
-}
\ No newline at end of file
+}
+
+TEST(Mavsdk, IoThreadCount)
+{
+    Mavsdk::Configuration configuration{ComponentType::GroundStation};
+
+    EXPECT_EQ(configuration.get_io_thread_count(), 1u); // Default
+    configuration.set_io_thread_count(0);
+    EXPECT_EQ(configuration.get_io_thread_count(), 1u);
+    configuration.set_io_thread_count(4);
+    EXPECT_EQ(configuration.get_io_thread_count(), 4u);
+
+    // Starting and stopping the additional io threads.
+    Mavsdk mavsdk{configuration};
+    EXPECT_TRUE(mavsdk.systems().empty());
+}
+
+TEST(Mavsdk, NoRoutesWithoutConnections)
+{
+    Mavsdk mavsdk{Mavsdk::Configuration{ComponentType::GroundStation}};
+    EXPECT_TRUE(mavsdk.routes().empty());
+}
@@ -0,0 +1,78 @@
+#include "message_subscription_index.hpp"
+#include "log.hpp"
+
+namespace mavsdk {
+
+void MessageSubscriptionIndex::add(Key key)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (!key) {
+        ++_wildcards;
+    } else if (++_refcounts[key.value()] == 1) {
+        if (key.value() < BITMAP_IDS) {
+            set_bit(key.value(), true);
+        } else {
+            ++_high_ids;
+        }
+    }
+
+    _total.fetch_add(1, std::memory_order_release);
+}
+
+void MessageSubscriptionIndex::remove(Key key)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (!key) {
+        if (_wildcards == 0) {
+            LogErr("Removing a wildcard message subscription that was never added");
+            return;
+        }
+        --_wildcards;
+    } else {
+        auto it = _refcounts.find(key.value());
+        if (it == _refcounts.end()) {
+            LogErr("Removing subscription for message {} that was never added", key.value());
+            return;
+        }
+
+        if (--it->second == 0) {
+            if (key.value() < BITMAP_IDS) {
+                set_bit(key.value(), false);
+            } else {
+                --_high_ids;
+            }
+            _refcounts.erase(it);
+        }
+    }
+
+    _total.fetch_sub(1, std::memory_order_release);
+}
+
+bool MessageSubscriptionIndex::contains(uint32_t message_id) const
+{
+    if (_wildcards.load(std::memory_order_acquire) > 0) {
+        return true;
+    }
+
+    if (message_id >= BITMAP_IDS) {
+        return _high_ids.load(std::memory_order_acquire) > 0;
+    }
+
+    const uint64_t mask = uint64_t{1} << (message_id % BITS_PER_WORD);
+    return (_bitmap[message_id / BITS_PER_WORD].load(std::memory_order_acquire) & mask) != 0;
+}
+
+void MessageSubscriptionIndex::set_bit(uint32_t message_id, bool value)
+{
+    const uint64_t mask = uint64_t{1} << (message_id % BITS_PER_WORD);
+    auto& word = _bitmap[message_id / BITS_PER_WORD];
+    if (value) {
+        word.fetch_or(mask, std::memory_order_release);
+    } else {
+        word.fetch_and(~mask, std::memory_order_release);
+    }
+}
+
+} // namespace mavsdk
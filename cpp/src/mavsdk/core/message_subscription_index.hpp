@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+#include "mavsdk_export.h"
+
+namespace mavsdk {
+
+/*
+ * Reference-counted set of message IDs that somebody subscribed to.
+ *
+ * Decoding a frame into a libmav message and rendering it as JSON is far more
+ * expensive than the C MAVLink parsing, so the receive path asks this index
+ * whether a message ID is wanted at all before paying for it.
+ *
+ * Subscriptions are rare and may come from any thread, so add() and remove()
+ * take a mutex. contains() and empty() are on the per-message hot path and are
+ * lock-free: IDs below 2^16 (all of common.xml and the ArduPilot dialect) are
+ * kept in an atomic bitmap, anything above is answered conservatively.
+ */
+class MAVSDK_TEST_EXPORT MessageSubscriptionIndex {
+public:
+    // A message ID, or std::nullopt to subscribe to all messages.
+    using Key = std::optional<uint32_t>;
+
+    void add(Key key);
+    void remove(Key key);
+
+    bool empty() const { return _total.load(std::memory_order_acquire) == 0; }
+
+    // Whether a message with this ID has at least one subscriber. May report
+    // true for unsubscribed IDs at or above 2^16 if any such ID is subscribed.
+    bool contains(uint32_t message_id) const;
+
+private:
+    static constexpr uint32_t BITMAP_IDS = 1u << 16;
+    static constexpr uint32_t BITS_PER_WORD = 64;
+
+    void set_bit(uint32_t message_id, bool value);
+
+    std::mutex _mutex{};
+    std::unordered_map<uint32_t, unsigned> _refcounts{};
+
+    std::array<std::atomic<uint64_t>, BITMAP_IDS / BITS_PER_WORD> _bitmap{};
+    std::atomic<unsigned> _wildcards{0};
+    std::atomic<unsigned> _high_ids{0};
+    std::atomic<unsigned> _total{0};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,95 @@
+#include "message_subscription_index.hpp"
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+TEST(MessageSubscriptionIndex, EmptyByDefault)
+{
+    MessageSubscriptionIndex index;
+
+    EXPECT_TRUE(index.empty());
+    EXPECT_FALSE(index.contains(0));
+    EXPECT_FALSE(index.contains(33));
+    EXPECT_FALSE(index.contains(300000));
+}
+
+TEST(MessageSubscriptionIndex, SingleId)
+{
+    MessageSubscriptionIndex index;
+
+    index.add(33);
+    EXPECT_FALSE(index.empty());
+    EXPECT_TRUE(index.contains(33));
+    EXPECT_FALSE(index.contains(32));
+    EXPECT_FALSE(index.contains(34));
+    EXPECT_FALSE(index.contains(33 + 64));
+
+    index.remove(33);
+    EXPECT_TRUE(index.empty());
+    EXPECT_FALSE(index.contains(33));
+}
+
+TEST(MessageSubscriptionIndex, RefCounted)
+{
+    MessageSubscriptionIndex index;
+
+    index.add(245);
+    index.add(245);
+    index.add(246);
+
+    index.remove(245);
+    EXPECT_TRUE(index.contains(245));
+    EXPECT_TRUE(index.contains(246));
+
+    index.remove(245);
+    EXPECT_FALSE(index.contains(245));
+    EXPECT_TRUE(index.contains(246));
+
+    index.remove(246);
+    EXPECT_TRUE(index.empty());
+}
+
+TEST(MessageSubscriptionIndex, Wildcard)
+{
+    MessageSubscriptionIndex index;
+
+    index.add(0);
+    index.add(std::nullopt);
+    EXPECT_TRUE(index.contains(0));
+    EXPECT_TRUE(index.contains(12345));
+    EXPECT_TRUE(index.contains(300000));
+
+    index.remove(std::nullopt);
+    EXPECT_TRUE(index.contains(0));
+    EXPECT_FALSE(index.contains(12345));
+    EXPECT_FALSE(index.empty());
+
+    index.remove(0);
+    EXPECT_TRUE(index.empty());
+}
+
+TEST(MessageSubscriptionIndex, HighIdsAreConservative)
+{
+    MessageSubscriptionIndex index;
+
+    index.add(300000);
+    EXPECT_TRUE(index.contains(300000));
+    // Not tracked precisely above the bitmap, but never a false negative.
+    EXPECT_TRUE(index.contains(300001));
+    EXPECT_FALSE(index.contains(1));
+
+    index.remove(300000);
+    EXPECT_FALSE(index.contains(300000));
+    EXPECT_TRUE(index.empty());
+}
+
+TEST(MessageSubscriptionIndex, RemovingUnknownIsIgnored)
+{
+    MessageSubscriptionIndex index;
+
+    index.add(1);
+    index.remove(2);
+    index.remove(std::nullopt);
+    EXPECT_TRUE(index.contains(1));
+    EXPECT_FALSE(index.empty());
+}
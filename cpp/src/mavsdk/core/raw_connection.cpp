@@ -44,6 +44,8 @@ std::pair<bool, std::string> RawConnection::send_message(const mavlink_message_t
 
 std::pair<bool, std::string> RawConnection::send_raw_bytes(const char* bytes, size_t length)
 {
+    capture_sent_bytes(bytes, length);
+
     if (_mavsdk_impl.notify_raw_bytes_sent(bytes, length)) {
         return {true, ""};
     } else {
@@ -60,18 +62,9 @@ void RawConnection::receive(const char* bytes, size_t length)
     // Parse all mavlink messages in one datagram. Once exhausted, we'll exit loop.
     auto parse_result = _mavlink_receiver->parse_message();
     while (parse_result != MavlinkReceiver::ParseResult::NoneAvailable) {
-        receive_message(parse_result, _mavlink_receiver->get_last_message(), this);
+        receive_frame(parse_result);
         parse_result = _mavlink_receiver->parse_message();
     }
-
-    // Also parse with libmav if available
-    if (_libmav_receiver) {
-        _libmav_receiver->set_new_datagram(const_cast<char*>(bytes), static_cast<int>(length));
-
-        while (_libmav_receiver->parse_message()) {
-            receive_libmav_message(_libmav_receiver->get_last_message(), this);
-        }
-    }
 }
 
 } // namespace mavsdk
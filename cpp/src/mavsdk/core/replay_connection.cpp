@@ -0,0 +1,184 @@
+#include "replay_connection.hpp"
+#include "mavsdk_impl.hpp"
+#include "log.hpp"
+#include "unused.hpp"
+
+#include <asio/post.hpp>
+
+#include <future>
+#include <utility>
+
+namespace mavsdk {
+
+ReplayConnection::ReplayConnection(
+    Connection::ReceiverCallback receiver_callback,
+    Connection::LibmavReceiverCallback libmav_receiver_callback,
+    MavsdkImpl& mavsdk_impl,
+    std::string path,
+    double speed,
+    ForwardingOption forwarding_option) :
+    Connection(
+        std::move(receiver_callback),
+        std::move(libmav_receiver_callback),
+        mavsdk_impl,
+        forwarding_option),
+    _path(std::move(path)),
+    _speed(speed),
+    _timer(mavsdk_impl.io_context())
+{}
+
+ReplayConnection::~ReplayConnection()
+{
+    // If no one explicitly called stop before, we should at least do it.
+    stop();
+}
+
+ConnectionResult ReplayConnection::start()
+{
+    if (!start_mavlink_receiver()) {
+        return ConnectionResult::ConnectionsExhausted;
+    }
+
+    if (!start_libmav_receiver()) {
+        return ConnectionResult::ConnectionsExhausted;
+    }
+
+    if (!_file.open(_path)) {
+        return ConnectionResult::ConnectionError;
+    }
+
+    _reader = TlogReader{_file.data(), _file.size()};
+    _has_next_record = _reader.next(_next_record);
+    if (!_has_next_record) {
+        LogErr("Replay: no valid records in {}", _path);
+        return ConnectionResult::ConnectionError;
+    }
+
+    _first_timestamp_us = _next_record.timestamp_us;
+    _start_time = std::chrono::steady_clock::now();
+
+    LogInfo(
+        "Replaying {} {}",
+        _path,
+        _speed > 0.0 ? "at " + std::to_string(_speed) + "x speed" : "as fast as possible");
+
+    // Start on the io thread, like received data.
+    schedule_replay(_start_time);
+
+    return ConnectionResult::Success;
+}
+
+ConnectionResult ReplayConnection::stop()
+{
+    // Signal the timer handler to stop re-arming before cancelling it. A
+    // handler that is already queued would otherwise still run.
+    _stopping = true;
+
+    auto& io_ctx = static_cast<asio::io_context&>(_timer.get_executor().context());
+    if (!io_ctx.stopped()) {
+        // Cancel from the io_context thread, serialised with the handler.
+        std::promise<void> cancel_done;
+        asio::post(io_ctx, [this, &cancel_done]() {
+            _timer.cancel();
+            cancel_done.set_value();
+        });
+        cancel_done.get_future().wait();
+
+        // Drain any operation_aborted handler queued by the cancel.
+        std::promise<void> fence;
+        asio::post(io_ctx, [&fence]() { fence.set_value(); });
+        fence.get_future().wait();
+    } else {
+        // io_context already stopped — no handler can be running.
+        _timer.cancel();
+    }
+
+    stop_mavlink_receiver();
+    stop_libmav_receiver();
+
+    _file.close();
+    _has_next_record = false;
+
+    return ConnectionResult::Success;
+}
+
+std::pair<bool, std::string> ReplayConnection::send_message(const mavlink_message_t& message)
+{
+    UNUSED(message);
+    // There is no one to send to, and failing would only produce errors.
+    return {true, {}};
+}
+
+std::pair<bool, std::string> ReplayConnection::send_raw_bytes(const char* bytes, size_t length)
+{
+    UNUSED(bytes);
+    UNUSED(length);
+    return {true, {}};
+}
+
+void ReplayConnection::schedule_replay(std::chrono::steady_clock::time_point time)
+{
+    _timer.expires_at(time);
+    _timer.async_wait([this](const asio::error_code& ec) {
+        if (ec == asio::error::operation_aborted || _stopping) {
+            return;
+        }
+        replay_due_frames();
+    });
+}
+
+void ReplayConnection::replay_due_frames()
+{
+    const auto now = std::chrono::steady_clock::now();
+
+    for (unsigned frames = 0; _has_next_record; ++frames) {
+        if (_speed > 0.0) {
+            const auto due = due_time(_next_record.timestamp_us);
+            if (due > now) {
+                schedule_replay(due);
+                return;
+            }
+        }
+
+        if (frames == MAX_FRAMES_PER_TURN) {
+            schedule_replay(now);
+            return;
+        }
+
+        // The receivers only read from the buffer.
+        _mavlink_receiver->set_new_datagram(
+            const_cast<char*>(reinterpret_cast<const char*>(_next_record.frame)),
+            static_cast<unsigned>(_next_record.frame_len));
+
+        auto parse_result = _mavlink_receiver->parse_message();
+        while (parse_result != MavlinkReceiver::ParseResult::NoneAvailable) {
+            receive_frame(parse_result);
+            parse_result = _mavlink_receiver->parse_message();
+        }
+
+        ++_frames_replayed;
+        _has_next_record = _reader.next(_next_record);
+    }
+
+    if (_reader.failed()) {
+        LogWarn(
+            "Replay of {} stopped at invalid record at offset {} after {} frames",
+            _path,
+            _reader.offset(),
+            _frames_replayed);
+    } else {
+        LogInfo("Replay of {} finished after {} frames", _path, _frames_replayed);
+    }
+}
+
+std::chrono::steady_clock::time_point ReplayConnection::due_time(uint64_t timestamp_us) const
+{
+    // Clocks can jump backwards during a recording, such frames are due right away.
+    const uint64_t elapsed_us =
+        timestamp_us > _first_timestamp_us ? timestamp_us - _first_timestamp_us : 0;
+
+    return _start_time + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                             std::chrono::duration<double, std::micro>(elapsed_us / _speed));
+}
+
+} // namespace mavsdk
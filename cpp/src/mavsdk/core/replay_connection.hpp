@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include <asio/steady_timer.hpp>
+
+#include "connection.hpp"
+#include "mapped_file.hpp"
+#include "tlog_reader.hpp"
+
+namespace mavsdk {
+
+/**
+ * @brief Connection that feeds the frames of a recorded .tlog back in.
+ *
+ * The file is memory-mapped and the frames are handed on as if they had just
+ * been received, with the recorded timing, the timing scaled by a speed
+ * factor, or as fast as possible (speed 0). Everything sent is discarded.
+ */
+class ReplayConnection : public Connection {
+public:
+    explicit ReplayConnection(
+        Connection::ReceiverCallback receiver_callback,
+        Connection::LibmavReceiverCallback libmav_receiver_callback,
+        MavsdkImpl& mavsdk_impl,
+        std::string path,
+        double speed,
+        ForwardingOption forwarding_option = ForwardingOption::ForwardingOff);
+    ~ReplayConnection() override;
+
+    ConnectionResult start() override;
+    ConnectionResult stop() override;
+
+    std::pair<bool, std::string> send_message(const mavlink_message_t& message) override;
+    std::pair<bool, std::string> send_raw_bytes(const char* bytes, size_t length) override;
+
+    // Non-copyable
+    ReplayConnection(const ReplayConnection&) = delete;
+    const ReplayConnection& operator=(const ReplayConnection&) = delete;
+
+private:
+    // Frames handed on in one go before giving other io work a turn.
+    static constexpr unsigned MAX_FRAMES_PER_TURN = 1000;
+
+    void replay_due_frames();
+    void schedule_replay(std::chrono::steady_clock::time_point time);
+    std::chrono::steady_clock::time_point due_time(uint64_t timestamp_us) const;
+
+    const std::string _path;
+    const double _speed;
+
+    MappedFile _file{};
+    TlogReader _reader{nullptr, 0};
+    TlogReader::Record _next_record{};
+    bool _has_next_record{false};
+    uint64_t _frames_replayed{0};
+
+    // Recorded time of the first frame and when it was replayed.
+    uint64_t _first_timestamp_us{0};
+    std::chrono::steady_clock::time_point _start_time{};
+
+    asio::steady_timer _timer;
+    std::atomic<bool> _stopping{false};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,139 @@
+#include "routing_table.hpp"
+
+namespace mavsdk {
+
+RoutingTable::RoutingTable() = default;
+
+RoutingTable::~RoutingTable()
+{
+    for (auto& system : _systems) {
+        delete system.load(std::memory_order_acquire);
+    }
+}
+
+RoutingTable::Link RoutingTable::add_link()
+{
+    std::lock_guard<std::mutex> lock(_links_mutex);
+    for (Link link = 0; link < MAX_LINKS; ++link) {
+        if ((_used_links & mask(link)) == 0) {
+            _used_links |= mask(link);
+            return link;
+        }
+    }
+    return NO_LINK;
+}
+
+void RoutingTable::remove_link(Link link)
+{
+    if (link >= MAX_LINKS) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_links_mutex);
+    const auto link_mask = mask(link);
+    for (auto& system : _systems) {
+        auto* routes = system.load(std::memory_order_acquire);
+        if (routes == nullptr) {
+            continue;
+        }
+        routes->links.remove(link_mask);
+        for (auto& component : routes->components) {
+            component.links.remove(link_mask);
+        }
+    }
+    _used_links &= ~link_mask;
+}
+
+void RoutingTable::learn(uint8_t system_id, uint8_t component_id, Link link)
+{
+    if (link >= MAX_LINKS) {
+        return;
+    }
+
+    auto* routes = _systems[system_id].load(std::memory_order_acquire);
+    if (routes == nullptr) {
+        // First message from this system. If another thread just added it as
+        // well, use theirs.
+        auto* new_routes = new SystemRoutes();
+        if (_systems[system_id].compare_exchange_strong(
+                routes, new_routes, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            routes = new_routes;
+        } else {
+            delete new_routes;
+        }
+    }
+
+    const auto link_mask = mask(link);
+    routes->links.add(link_mask);
+    auto& component = routes->components[component_id];
+    component.links.add(link_mask);
+    component.messages_received.fetch_add(1, std::memory_order_relaxed);
+}
+
+RoutingTable::LinkMask RoutingTable::links(uint8_t system_id, uint8_t component_id) const
+{
+    const auto* routes = _systems[system_id].load(std::memory_order_acquire);
+    if (routes == nullptr) {
+        return 0;
+    }
+
+    if (component_id != 0) {
+        const auto component_links = routes->components[component_id].links.load();
+        if (component_links != 0) {
+            return component_links;
+        }
+    }
+    return routes->links.load();
+}
+
+void RoutingTable::count_routed(uint8_t system_id, uint8_t component_id)
+{
+    auto* routes = _systems[system_id].load(std::memory_order_acquire);
+    if (routes == nullptr) {
+        return;
+    }
+    routes->components[component_id].messages_routed.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool RoutingTable::age()
+{
+    bool any_left = false;
+    for (auto& system : _systems) {
+        auto* routes = system.load(std::memory_order_acquire);
+        if (routes == nullptr) {
+            continue;
+        }
+        any_left = routes->links.age() || any_left;
+        for (auto& component : routes->components) {
+            component.links.age();
+        }
+    }
+    return any_left;
+}
+
+std::vector<RoutingTable::Route> RoutingTable::routes() const
+{
+    std::vector<Route> result;
+    for (unsigned system_id = 0; system_id < _systems.size(); ++system_id) {
+        const auto* routes = _systems[system_id].load(std::memory_order_acquire);
+        if (routes == nullptr) {
+            continue;
+        }
+        for (unsigned component_id = 0; component_id < routes->components.size();
+             ++component_id) {
+            const auto& component = routes->components[component_id];
+            const Route route{
+                static_cast<uint8_t>(system_id),
+                static_cast<uint8_t>(component_id),
+                component.links.load(),
+                component.messages_received.load(std::memory_order_relaxed),
+                component.messages_routed.load(std::memory_order_relaxed)};
+            if (route.links != 0 || route.messages_received != 0 || route.messages_routed != 0) {
+                result.push_back(route);
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace mavsdk
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "mavsdk_export.h"
+
+namespace mavsdk {
+
+/*
+ * Which links (connections) lead to which system and component, learned from
+ * the messages received on them, as described in
+ * https://mavlink.io/en/guide/routing.html.
+ *
+ * Each connection gets a link number, so the links a route was seen on are a
+ * bitmask. Routes age out: a route is kept for between one and two aging
+ * periods after the last message over it, so a component that moved to
+ * another link or went away stops being routed to.
+ *
+ * learn() and links() are on the per-message hot path and lock-free. Adding
+ * and removing links is rare and takes a mutex.
+ */
+class MAVSDK_TEST_EXPORT RoutingTable {
+public:
+    using Link = unsigned;
+    using LinkMask = uint64_t;
+
+    static constexpr unsigned MAX_LINKS = 64;
+    static constexpr Link NO_LINK = MAX_LINKS;
+
+    RoutingTable();
+    ~RoutingTable();
+
+    RoutingTable(const RoutingTable&) = delete;
+    RoutingTable& operator=(const RoutingTable&) = delete;
+
+    // Returns NO_LINK if all link numbers are taken. Messages from such a
+    // connection are not learned from.
+    Link add_link();
+    // Forgets all routes over the link, so the number can be used again.
+    void remove_link(Link link);
+
+    // Note that a message from system_id/component_id arrived over link.
+    void learn(uint8_t system_id, uint8_t component_id, Link link);
+
+    // The links over which system_id/component_id can be reached, or 0 if
+    // the route is unknown. A component ID of 0 means any component of the
+    // system. An unknown component of a known system is reached over the
+    // links of the system, as the component might just not have sent
+    // anything yet.
+    LinkMask links(uint8_t system_id, uint8_t component_id) const;
+
+    // Count a message sent to system_id/component_id using the table.
+    void count_routed(uint8_t system_id, uint8_t component_id);
+
+    // Starts a new aging period: routes not seen in the previous one are
+    // dropped. Returns whether any routes are left.
+    //
+    // A learn() that is not included in the result is sequentially consistent
+    // with it, so a caller that clears a flag before age() and checks it after
+    // learn() sees at least one of the two.
+    bool age();
+
+    struct Route {
+        uint8_t system_id;
+        uint8_t component_id;
+        LinkMask links;
+        uint64_t messages_received;
+        uint64_t messages_routed;
+    };
+
+    // Snapshot of all known routes, behind Mavsdk::routes().
+    std::vector<Route> routes() const;
+
+    static LinkMask mask(Link link) { return link < MAX_LINKS ? LinkMask{1} << link : 0; }
+
+private:
+    // Links seen in the current and in the previous aging period.
+    struct Links {
+        std::atomic<LinkMask> current{0};
+        std::atomic<LinkMask> previous{0};
+
+        LinkMask load() const
+        {
+            return current.load(std::memory_order_relaxed) |
+                   previous.load(std::memory_order_relaxed);
+        }
+        void add(LinkMask link_mask)
+        {
+            // Most messages come over a link already known, so avoid the write.
+            if ((current.load(std::memory_order_relaxed) & link_mask) == 0) {
+                current.fetch_or(link_mask);
+            }
+        }
+        // Returns whether any links are left.
+        bool age()
+        {
+            const auto links = current.exchange(0);
+            previous.store(links, std::memory_order_relaxed);
+            return links != 0;
+        }
+        void remove(LinkMask link_mask)
+        {
+            current.fetch_and(~link_mask, std::memory_order_relaxed);
+            previous.fetch_and(~link_mask, std::memory_order_relaxed);
+        }
+    };
+
+    struct ComponentRoute {
+        Links links{};
+        std::atomic<uint64_t> messages_received{0};
+        std::atomic<uint64_t> messages_routed{0};
+    };
+
+    struct SystemRoutes {
+        Links links{};
+        std::array<ComponentRoute, 256> components{};
+    };
+
+    // Allocated when a system is first seen and kept until the table is
+    // destroyed, so the hot path never has to synchronize with a free.
+    std::array<std::atomic<SystemRoutes*>, 256> _systems{};
+
+    std::mutex _links_mutex{};
+    LinkMask _used_links{0};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,182 @@
+#include "routing_table.hpp"
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+using namespace mavsdk;
+
+TEST(RoutingTable, UnknownRoutes)
+{
+    RoutingTable table;
+    EXPECT_EQ(table.links(1, 1), 0u);
+    EXPECT_EQ(table.links(1, 0), 0u);
+    EXPECT_TRUE(table.routes().empty());
+}
+
+TEST(RoutingTable, LearnsFromReceivedMessages)
+{
+    RoutingTable table;
+    const auto radio = table.add_link();
+    const auto gcs = table.add_link();
+    ASSERT_NE(radio, gcs);
+
+    table.learn(1, 1, radio);
+    table.learn(1, 100, radio);
+    table.learn(255, 190, gcs);
+
+    EXPECT_EQ(table.links(1, 1), RoutingTable::mask(radio));
+    EXPECT_EQ(table.links(1, 100), RoutingTable::mask(radio));
+    EXPECT_EQ(table.links(255, 190), RoutingTable::mask(gcs));
+
+    // Any component of a system.
+    EXPECT_EQ(table.links(1, 0), RoutingTable::mask(radio));
+    // A component not heard from yet is reached over the links of its system.
+    EXPECT_EQ(table.links(1, 154), RoutingTable::mask(radio));
+    // An unknown system.
+    EXPECT_EQ(table.links(2, 1), 0u);
+}
+
+TEST(RoutingTable, SystemSeenOnSeveralLinks)
+{
+    RoutingTable table;
+    const auto link1 = table.add_link();
+    const auto link2 = table.add_link();
+
+    table.learn(1, 1, link1);
+    table.learn(1, 100, link2);
+
+    EXPECT_EQ(table.links(1, 1), RoutingTable::mask(link1));
+    EXPECT_EQ(table.links(1, 100), RoutingTable::mask(link2));
+    EXPECT_EQ(table.links(1, 0), RoutingTable::mask(link1) | RoutingTable::mask(link2));
+}
+
+TEST(RoutingTable, RoutesAgeOut)
+{
+    RoutingTable table;
+    const auto link1 = table.add_link();
+    const auto link2 = table.add_link();
+
+    table.learn(1, 1, link1);
+
+    // Kept for the next aging period.
+    table.age();
+    EXPECT_EQ(table.links(1, 1), RoutingTable::mask(link1));
+
+    // The system moved to another link.
+    table.learn(1, 1, link2);
+    EXPECT_EQ(table.links(1, 1), RoutingTable::mask(link1) | RoutingTable::mask(link2));
+
+    table.age();
+    EXPECT_EQ(table.links(1, 1), RoutingTable::mask(link2));
+
+    table.age();
+    table.age();
+    EXPECT_EQ(table.links(1, 1), 0u);
+    EXPECT_EQ(table.links(1, 0), 0u);
+}
+
+TEST(RoutingTable, AgeReportsRoutesLeft)
+{
+    RoutingTable table;
+    const auto link = table.add_link();
+
+    EXPECT_FALSE(table.age());
+
+    table.learn(1, 1, link);
+    EXPECT_TRUE(table.age());
+    // Still kept from the previous period, but not seen in this one.
+    EXPECT_FALSE(table.age());
+    EXPECT_EQ(table.links(1, 1), 0u);
+
+    table.learn(1, 1, link);
+    EXPECT_TRUE(table.age());
+}
+
+TEST(RoutingTable, RemovedLinkIsForgotten)
+{
+    RoutingTable table;
+    const auto link1 = table.add_link();
+    const auto link2 = table.add_link();
+
+    table.learn(1, 1, link1);
+    table.learn(2, 1, link2);
+    table.remove_link(link1);
+
+    EXPECT_EQ(table.links(1, 1), 0u);
+    EXPECT_EQ(table.links(2, 1), RoutingTable::mask(link2));
+
+    // The number is free again.
+    EXPECT_EQ(table.add_link(), link1);
+}
+
+TEST(RoutingTable, RunsOutOfLinks)
+{
+    RoutingTable table;
+    for (unsigned i = 0; i < RoutingTable::MAX_LINKS; ++i) {
+        EXPECT_NE(table.add_link(), RoutingTable::NO_LINK);
+    }
+    const auto link = table.add_link();
+    EXPECT_EQ(link, RoutingTable::NO_LINK);
+    EXPECT_EQ(RoutingTable::mask(link), 0u);
+
+    // Not learned from.
+    table.learn(1, 1, link);
+    EXPECT_EQ(table.links(1, 1), 0u);
+}
+
+TEST(RoutingTable, CountsPerRoute)
+{
+    RoutingTable table;
+    const auto link = table.add_link();
+
+    for (int i = 0; i < 3; ++i) {
+        table.learn(1, 1, link);
+    }
+    table.count_routed(1, 1);
+    table.count_routed(1, 1);
+    // Unknown systems are not counted.
+    table.count_routed(2, 1);
+
+    const auto routes = table.routes();
+    ASSERT_EQ(routes.size(), 1u);
+    EXPECT_EQ(routes[0].system_id, 1);
+    EXPECT_EQ(routes[0].component_id, 1);
+    EXPECT_EQ(routes[0].links, RoutingTable::mask(link));
+    EXPECT_EQ(routes[0].messages_received, 3u);
+    EXPECT_EQ(routes[0].messages_routed, 2u);
+}
+
+TEST(RoutingTable, ConcurrentLearnAndLookup)
+{
+    RoutingTable table;
+    const auto link1 = table.add_link();
+    const auto link2 = table.add_link();
+
+    std::vector<std::thread> threads;
+    for (const auto link : {link1, link2}) {
+        threads.emplace_back([&table, link]() {
+            for (unsigned i = 0; i < 10000; ++i) {
+                table.learn(static_cast<uint8_t>(i % 8 + 1), 1, link);
+            }
+        });
+    }
+    threads.emplace_back([&table]() {
+        for (unsigned i = 0; i < 10000; ++i) {
+            (void)table.links(static_cast<uint8_t>(i % 8 + 1), 1);
+        }
+    });
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (uint8_t system_id = 1; system_id <= 8; ++system_id) {
+        EXPECT_EQ(
+            table.links(system_id, 1), RoutingTable::mask(link1) | RoutingTable::mask(link2));
+    }
+    uint64_t messages_received = 0;
+    for (const auto& route : table.routes()) {
+        messages_received += route.messages_received;
+    }
+    EXPECT_EQ(messages_received, 20000u);
+}
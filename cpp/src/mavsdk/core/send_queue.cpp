@@ -0,0 +1,145 @@
+#include "send_queue.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "log.hpp"
+
+namespace mavsdk {
+
+SendQueue::SendQueue(Options options) : _slots(std::max<std::size_t>(options.max_frames, 1))
+{
+    _free_slots.reserve(_slots.size());
+    for (std::size_t i = _slots.size(); i > 0; --i) {
+        _free_slots.push_back(i - 1);
+    }
+    _queued.reserve(_slots.size());
+    _buffers.reserve(MAX_FRAMES_PER_WRITE);
+}
+
+SendQueue::PushResult SendQueue::push(const char* frame, std::size_t len)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (len == 0 || len > MAVLINK_MAX_PACKET_LEN) {
+        ++_stats.frames_rejected;
+        return PushResult::Rejected;
+    }
+
+    if (_free_slots.empty()) {
+        // Make room by dropping the oldest frame that is not being written.
+        const auto it = std::find_if(
+            _queued.begin() + static_cast<std::ptrdiff_t>(_in_flight),
+            _queued.end(),
+            [this](std::size_t index) { return _slots[index].droppable; });
+
+        if (it == _queued.end()) {
+            ++_stats.frames_rejected;
+            return PushResult::Rejected;
+        }
+
+        if (!_overloaded) {
+            _overloaded = true;
+            LogWarn("Send queue full, dropping oldest messages");
+        }
+        release_slot(*it);
+        _queued.erase(it);
+        ++_stats.frames_dropped;
+    }
+
+    const std::size_t index = _free_slots.back();
+    _free_slots.pop_back();
+
+    auto& slot = _slots[index];
+    std::memcpy(slot.data.data(), frame, len);
+    slot.len = len;
+    slot.droppable = is_droppable(frame, len);
+    _queued.push_back(index);
+
+    _stats.max_queued = std::max(_stats.max_queued, _queued.size());
+
+    if (_writing) {
+        return PushResult::Queued;
+    }
+    _writing = true;
+    return PushResult::StartWriting;
+}
+
+const std::vector<asio::const_buffer>& SendQueue::begin_write()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    _buffers.clear();
+    _in_flight = std::min(_queued.size(), MAX_FRAMES_PER_WRITE);
+    for (std::size_t i = 0; i < _in_flight; ++i) {
+        const auto& slot = _slots[_queued[i]];
+        _buffers.emplace_back(slot.data.data(), slot.len);
+    }
+
+    if (_buffers.empty()) {
+        _writing = false;
+        _overloaded = false;
+    }
+    return _buffers;
+}
+
+void SendQueue::complete_write()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    for (std::size_t i = 0; i < _in_flight; ++i) {
+        ++_stats.frames_sent;
+        _stats.bytes_sent += _slots[_queued[i]].len;
+        release_slot(_queued[i]);
+    }
+    _queued.erase(_queued.begin(), _queued.begin() + static_cast<std::ptrdiff_t>(_in_flight));
+    _in_flight = 0;
+    ++_stats.writes;
+}
+
+void SendQueue::fail_write()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    _stats.frames_dropped += _queued.size();
+    for (const auto index : _queued) {
+        release_slot(index);
+    }
+    _queued.clear();
+    _in_flight = 0;
+    _writing = false;
+    _overloaded = false;
+}
+
+SendQueue::Stats SendQueue::stats() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto stats = _stats;
+    stats.queued = _queued.size();
+    return stats;
+}
+
+bool SendQueue::is_droppable(const char* frame, std::size_t len)
+{
+    const auto* bytes = reinterpret_cast<const uint8_t*>(frame);
+
+    uint32_t message_id;
+    if (bytes[0] == MAVLINK_STX && len >= 10) {
+        message_id = bytes[7] | (bytes[8] << 8) | (static_cast<uint32_t>(bytes[9]) << 16);
+    } else if (bytes[0] == MAVLINK_STX_MAVLINK1 && len >= 6) {
+        message_id = bytes[5];
+    } else {
+        return true;
+    }
+
+    return message_id != MAVLINK_MSG_ID_COMMAND_INT &&
+           message_id != MAVLINK_MSG_ID_COMMAND_LONG && message_id != MAVLINK_MSG_ID_COMMAND_ACK;
+}
+
+void SendQueue::release_slot(std::size_t index)
+{
+    _free_slots.push_back(index);
+}
+
+} // namespace mavsdk
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include <asio/buffer.hpp>
+
+#include "mavlink_include.hpp"
+#include "mavsdk_export.h"
+
+namespace mavsdk {
+
+/*
+ * Queue of outgoing frames for a stream connection (TCP or serial).
+ *
+ * Frames are copied into preallocated slots, so queueing does not allocate,
+ * and whatever is queued when the previous write has finished is written in
+ * one scatter/gather write.
+ *
+ * When max_frames are queued, e.g. because a radio link cannot keep up, the
+ * oldest queued frame is dropped to make room. Commands and command acks are
+ * never dropped: if only those are queued, the new frame is rejected instead.
+ *
+ * Only one write is in flight at a time: push() returns StartWriting when the
+ * caller needs to start writing, and the writer then keeps going with
+ * begin_write() and complete_write() until begin_write() returns nothing.
+ * push() and stats() are thread-safe, the rest is called by the writer.
+ */
+class MAVSDK_TEST_EXPORT SendQueue {
+public:
+    struct Options {
+        std::size_t max_frames{256};
+    };
+
+    struct Stats {
+        std::size_t queued{0}; // Frames queued right now, including the ones being written.
+        std::size_t max_queued{0};
+        uint64_t frames_sent{0};
+        uint64_t bytes_sent{0};
+        uint64_t writes{0};
+        uint64_t frames_dropped{0}; // To make room, or because the write failed.
+        uint64_t frames_rejected{0};
+    };
+
+    enum class PushResult {
+        Queued,
+        StartWriting,
+        Rejected,
+    };
+
+    explicit SendQueue(Options options);
+
+    SendQueue(const SendQueue&) = delete;
+    SendQueue& operator=(const SendQueue&) = delete;
+
+    PushResult push(const char* frame, std::size_t len);
+
+    // The buffers to write next, empty if there is nothing left to write. The
+    // buffers stay valid until complete_write() or fail_write().
+    const std::vector<asio::const_buffer>& begin_write();
+
+    void complete_write();
+
+    // Drops everything queued, e.g. after the connection was lost.
+    void fail_write();
+
+    Stats stats() const;
+
+private:
+    // Frames per write, to stay well below the IOV_MAX limit of writev.
+    static constexpr std::size_t MAX_FRAMES_PER_WRITE = 64;
+
+    struct Slot {
+        std::array<char, MAVLINK_MAX_PACKET_LEN> data;
+        std::size_t len;
+        bool droppable;
+    };
+
+    static bool is_droppable(const char* frame, std::size_t len);
+    void release_slot(std::size_t index);
+
+    mutable std::mutex _mutex{};
+
+    std::vector<Slot> _slots;
+    std::vector<std::size_t> _free_slots{};
+    // Slot indices in the order the frames were queued, the first _in_flight
+    // of them are being written.
+    std::vector<std::size_t> _queued{};
+    std::size_t _in_flight{0};
+    bool _writing{false};
+    bool _overloaded{false};
+
+    std::vector<asio::const_buffer> _buffers{};
+
+    Stats _stats{};
+};
+
+} // namespace mavsdk
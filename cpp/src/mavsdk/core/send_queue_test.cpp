@@ -0,0 +1,153 @@
+#include "send_queue.hpp"
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+using namespace mavsdk;
+
+namespace {
+
+std::vector<char> frame_v2(uint32_t message_id, char marker)
+{
+    std::vector<char> frame(12 + 2, marker);
+    frame[0] = static_cast<char>(MAVLINK_STX);
+    frame[1] = 2;
+    frame[7] = static_cast<char>(message_id & 0xFF);
+    frame[8] = static_cast<char>((message_id >> 8) & 0xFF);
+    frame[9] = static_cast<char>((message_id >> 16) & 0xFF);
+    return frame;
+}
+
+std::vector<char> frame_v1(uint8_t message_id, char marker)
+{
+    std::vector<char> frame(8 + 2, marker);
+    frame[0] = static_cast<char>(MAVLINK_STX_MAVLINK1);
+    frame[1] = 2;
+    frame[5] = static_cast<char>(message_id);
+    return frame;
+}
+
+SendQueue::PushResult push(SendQueue& queue, const std::vector<char>& frame)
+{
+    return queue.push(frame.data(), frame.size());
+}
+
+// The marker byte of each frame about to be written.
+std::string markers(const std::vector<asio::const_buffer>& buffers)
+{
+    std::string result;
+    for (const auto& buffer : buffers) {
+        result += static_cast<const char*>(buffer.data())[buffer.size() - 1];
+    }
+    return result;
+}
+
+constexpr uint32_t attitude_id = 30;
+
+} // namespace
+
+TEST(SendQueue, CoalescesQueuedFrames)
+{
+    SendQueue queue({});
+
+    EXPECT_EQ(push(queue, frame_v2(attitude_id, 'a')), SendQueue::PushResult::StartWriting);
+    EXPECT_EQ(push(queue, frame_v2(attitude_id, 'b')), SendQueue::PushResult::Queued);
+
+    EXPECT_EQ(markers(queue.begin_write()), "ab");
+
+    // Queued while writing, goes out with the next write.
+    EXPECT_EQ(push(queue, frame_v2(attitude_id, 'c')), SendQueue::PushResult::Queued);
+    EXPECT_EQ(push(queue, frame_v2(attitude_id, 'd')), SendQueue::PushResult::Queued);
+    queue.complete_write();
+
+    EXPECT_EQ(markers(queue.begin_write()), "cd");
+    queue.complete_write();
+
+    EXPECT_TRUE(queue.begin_write().empty());
+
+    // Nothing was being written anymore, so the next frame starts writing again.
+    EXPECT_EQ(push(queue, frame_v2(attitude_id, 'e')), SendQueue::PushResult::StartWriting);
+
+    const auto stats = queue.stats();
+    EXPECT_EQ(stats.queued, 1u);
+    EXPECT_EQ(stats.max_queued, 4u);
+    EXPECT_EQ(stats.frames_sent, 4u);
+    EXPECT_EQ(stats.bytes_sent, 4u * 14);
+    EXPECT_EQ(stats.writes, 2u);
+    EXPECT_EQ(stats.frames_dropped, 0u);
+}
+
+TEST(SendQueue, DropsOldestWhenFull)
+{
+    SendQueue::Options options;
+    options.max_frames = 3;
+    SendQueue queue(options);
+
+    push(queue, frame_v2(attitude_id, 'a'));
+    EXPECT_EQ(markers(queue.begin_write()), "a");
+
+    push(queue, frame_v2(attitude_id, 'b'));
+    push(queue, frame_v2(attitude_id, 'c'));
+
+    // 'a' is being written and must stay, 'b' is the oldest one after it.
+    EXPECT_EQ(push(queue, frame_v2(attitude_id, 'd')), SendQueue::PushResult::Queued);
+    queue.complete_write();
+    EXPECT_EQ(markers(queue.begin_write()), "cd");
+    queue.complete_write();
+
+    EXPECT_EQ(queue.stats().frames_dropped, 1u);
+    EXPECT_EQ(queue.stats().frames_sent, 3u);
+}
+
+TEST(SendQueue, NeverDropsCommands)
+{
+    SendQueue::Options options;
+    options.max_frames = 3;
+    SendQueue queue(options);
+
+    push(queue, frame_v2(MAVLINK_MSG_ID_COMMAND_LONG, 'a'));
+    push(queue, frame_v2(attitude_id, 'b'));
+    push(queue, frame_v1(MAVLINK_MSG_ID_COMMAND_ACK, 'c'));
+
+    // Only the telemetry can go.
+    EXPECT_EQ(
+        push(queue, frame_v2(MAVLINK_MSG_ID_COMMAND_INT, 'd')), SendQueue::PushResult::Queued);
+
+    // Now there is nothing left to drop.
+    EXPECT_EQ(push(queue, frame_v2(attitude_id, 'e')), SendQueue::PushResult::Rejected);
+    EXPECT_EQ(
+        push(queue, frame_v2(MAVLINK_MSG_ID_COMMAND_LONG, 'f')), SendQueue::PushResult::Rejected);
+
+    EXPECT_EQ(markers(queue.begin_write()), "acd");
+    queue.complete_write();
+
+    const auto stats = queue.stats();
+    EXPECT_EQ(stats.frames_dropped, 1u);
+    EXPECT_EQ(stats.frames_rejected, 2u);
+}
+
+TEST(SendQueue, FailedWriteDropsEverything)
+{
+    SendQueue queue({});
+
+    push(queue, frame_v2(attitude_id, 'a'));
+    EXPECT_EQ(markers(queue.begin_write()), "a");
+    push(queue, frame_v2(attitude_id, 'b'));
+
+    queue.fail_write();
+    EXPECT_EQ(queue.stats().queued, 0u);
+    EXPECT_EQ(queue.stats().frames_dropped, 2u);
+
+    EXPECT_EQ(push(queue, frame_v2(attitude_id, 'c')), SendQueue::PushResult::StartWriting);
+    EXPECT_EQ(markers(queue.begin_write()), "c");
+}
+
+TEST(SendQueue, RejectsOversizedFrames)
+{
+    SendQueue queue({});
+
+    std::vector<char> frame(MAVLINK_MAX_PACKET_LEN + 1, 'x');
+    EXPECT_EQ(push(queue, frame), SendQueue::PushResult::Rejected);
+    EXPECT_TRUE(queue.begin_write().empty());
+}
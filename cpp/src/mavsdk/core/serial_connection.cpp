@@ -76,6 +76,7 @@ SerialConnection::SerialConnection(
     _serial_node(std::move(path)),
     _baudrate(baudrate),
     _flow_control(flow_control),
+    _send_queue(SendQueue::Options{mavsdk_impl.get_configuration().get_send_queue_size()}),
     _serial_port(mavsdk_impl.io_context())
 {}
 
@@ -271,6 +272,8 @@ std::pair<bool, std::string> SerialConnection::send_message(const mavlink_messag
 
 std::pair<bool, std::string> SerialConnection::send_raw_bytes(const char* bytes, size_t length)
 {
+    capture_sent_bytes(bytes, length);
+
     if (_serial_node.empty()) {
         return {false, "Dev Path unknown"};
     }
@@ -279,22 +282,54 @@ std::pair<bool, std::string> SerialConnection::send_raw_bytes(const char* bytes,
         return {false, "Baudrate unknown"};
     }
 
-    std::lock_guard<std::mutex> lock(_send_mutex);
+    {
+        std::lock_guard<std::mutex> lock(_send_mutex);
+        if (!_serial_port.is_open()) {
+            return {false, "Port not open"};
+        }
+    }
 
-    if (!_serial_port.is_open()) {
-        return {false, "Port not open"};
+    // Only queue the bytes here. The io_context thread writes them in the
+    // background, so a slow link does not hold up the caller or the io_context
+    // thread.
+    switch (_send_queue.push(bytes, length)) {
+        case SendQueue::PushResult::Rejected:
+            return {false, "Send queue full"};
+        case SendQueue::PushResult::StartWriting:
+            asio::post(_serial_port.get_executor(), [this]() { do_send(); });
+            break;
+        case SendQueue::PushResult::Queued:
+            break;
     }
 
-    asio::error_code ec;
-    asio::write(_serial_port, asio::buffer(bytes, length), ec);
+    return {true, {}};
+}
 
-    if (ec) {
-        std::string msg = "write failure: " + ec.message();
-        LogErr("{}", msg);
-        return {false, std::move(msg)};
+void SerialConnection::do_send()
+{
+    // Everything queued so far goes out in one write.
+    const auto& buffers = _send_queue.begin_write();
+    if (buffers.empty()) {
+        return;
     }
 
-    return {true, {}};
+    std::lock_guard<std::mutex> lock(_send_mutex);
+    if (!_serial_port.is_open()) {
+        _send_queue.fail_write();
+        return;
+    }
+
+    asio::async_write(_serial_port, buffers, [this](const asio::error_code& ec, std::size_t) {
+        if (ec) {
+            if (ec != asio::error::operation_aborted) {
+                LogErr("write failure: {}", ec.message());
+            }
+            _send_queue.fail_write();
+            return;
+        }
+        _send_queue.complete_write();
+        do_send();
+    });
 }
 
 void SerialConnection::do_receive()
@@ -333,17 +368,10 @@ void SerialConnection::do_receive()
 
             auto parse_result = _mavlink_receiver->parse_message();
             while (parse_result != MavlinkReceiver::ParseResult::NoneAvailable) {
-                receive_message(parse_result, _mavlink_receiver->get_last_message(), this);
+                receive_frame(parse_result);
                 parse_result = _mavlink_receiver->parse_message();
             }
 
-            if (_libmav_receiver) {
-                _libmav_receiver->set_new_datagram(_recv_buffer.data(), static_cast<int>(recv_len));
-                while (_libmav_receiver->parse_message()) {
-                    receive_libmav_message(_libmav_receiver->get_last_message(), this);
-                }
-            }
-
             // Re-arm for the next chunk.
             do_receive();
         });
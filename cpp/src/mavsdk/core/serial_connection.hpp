@@ -7,6 +7,7 @@
 #include <asio/serial_port.hpp>
 
 #include "connection.hpp"
+#include "send_queue.hpp"
 
 namespace mavsdk {
 
@@ -26,6 +27,10 @@ public:
 
     std::pair<bool, std::string> send_message(const mavlink_message_t& message) override;
     std::pair<bool, std::string> send_raw_bytes(const char* bytes, size_t length) override;
+    std::optional<SendQueue::Stats> send_queue_stats() const override
+    {
+        return _send_queue.stats();
+    }
 
     // Non-copyable
     SerialConnection(const SerialConnection&) = delete;
@@ -34,6 +39,7 @@ public:
 private:
     ConnectionResult setup_port();
     void do_receive();
+    void do_send();
 
 #if defined(LINUX)
     static int define_from_baudrate(int baudrate);
@@ -43,9 +49,12 @@ private:
     const int _baudrate;
     const bool _flow_control;
 
-    // Protects synchronous writes against concurrent close on the io_thread.
+    // Protects port access in sends against concurrent close on the io_thread.
     std::mutex _send_mutex{};
 
+    // Written in the background by do_send() on the io_context thread.
+    SendQueue _send_queue;
+
     // Asio serial port — driven by MavsdkImpl::_io_context.
     asio::serial_port _serial_port;
     std::array<char, 2048> _recv_buffer{};
@@ -69,6 +69,14 @@ ServerComponentImpl::~ServerComponentImpl()
     unregister_all_mavlink_command_handlers(this);
     _mavlink_request_message_handler.unregister_all_handlers(this);
 
+    {
+        std::lock_guard<std::mutex> lock(_libmav_subscription_keys_mutex);
+        for (const auto& entry : _libmav_subscription_keys) {
+            _mavsdk_impl.remove_libmav_subscription(entry.second);
+        }
+        _libmav_subscription_keys.clear();
+    }
+
     MavlinkChannels::Instance().checkin_used_channel(_channel);
 }
 
@@ -143,7 +151,12 @@ Handle<Mavsdk::MavlinkMessage> ServerComponentImpl::register_libmav_message_hand
         callback(message);
     };
 
-    return _libmav_message_callbacks.subscribe(filtering_callback);
+    auto handle = _libmav_message_callbacks.subscribe(filtering_callback);
+    {
+        std::lock_guard<std::mutex> lock(_libmav_subscription_keys_mutex);
+        _libmav_subscription_keys[handle] = _mavsdk_impl.add_libmav_subscription(message_name);
+    }
+    return handle;
 }
 
 void ServerComponentImpl::unregister_libmav_message_handler(Handle<Mavsdk::MavlinkMessage> handle)
@@ -152,19 +165,20 @@ void ServerComponentImpl::unregister_libmav_message_handler(Handle<Mavsdk::Mavli
     // deinit() relies on that to destroy the object that owns the callback (which captures
     // its 'this') without a use-after-free on the io thread.
     _libmav_message_callbacks.unsubscribe_blocking(handle);
+
+    std::lock_guard<std::mutex> lock(_libmav_subscription_keys_mutex);
+    auto it = _libmav_subscription_keys.find(handle);
+    if (it != _libmav_subscription_keys.end()) {
+        _mavsdk_impl.remove_libmav_subscription(it->second);
+        _libmav_subscription_keys.erase(it);
+    }
 }
 
 void ServerComponentImpl::process_libmav_message(const Mavsdk::MavlinkMessage& message)
 {
     // CallbackList handles thread safety; registered handlers filter by name themselves.
     _libmav_message_callbacks.queue(
-        message, [this](const std::function<void()>& callback) { callback(); });
-}
-
-void ServerComponentImpl::do_work()
-{
-    _mavlink_parameter_server.do_work();
-    _mission_transfer_server.do_work();
+        message, [](const UserCallback& callback) { callback(); });
 }
 
 Sender& ServerComponentImpl::sender()
@@ -330,9 +344,9 @@ uint32_t ServerComponentImpl::get_custom_mode() const
 }
 
 void ServerComponentImpl::call_user_callback_located(
-    const std::string& filename, const int linenumber, const std::function<void()>& func)
+    const char* filename, const int linenumber, UserCallback func)
 {
-    _mavsdk_impl.call_user_callback_located(filename, linenumber, func);
+    _mavsdk_impl.call_user_callback_located(filename, linenumber, std::move(func));
 }
 
 TimeoutHandler::Cookie ServerComponentImpl::register_timeout_handler(
@@ -9,6 +9,7 @@
 #include "mavlink_parameter_server.hpp"
 #include "mavlink_request_message_handler.hpp"
 #include "mavlink_ftp_server.hpp"
+#include "message_subscription_index.hpp"
 #include "mavsdk_time.hpp"
 #include "flight_mode.hpp"
 #include "call_every_handler.hpp"
@@ -16,8 +17,10 @@
 #include "log.hpp"
 #include "sender.hpp"
 #include "mavsdk.hpp"
+#include "user_callback.hpp"
 
 #include <atomic>
+#include <map>
 #include <mutex>
 #include <cstdint>
 
@@ -158,8 +161,7 @@ public:
     void set_custom_mode(uint32_t custom_mode);
     [[nodiscard]] uint32_t get_custom_mode() const;
 
-    void call_user_callback_located(
-        const std::string& filename, const int linenumber, const std::function<void()>& func);
+    void call_user_callback_located(const char* filename, int linenumber, UserCallback func);
 
     // Autopilot version data
     void add_capabilities(uint64_t capabilities);
@@ -181,8 +183,6 @@ public:
     }
     MavlinkFtpServer& mavlink_ftp_server() { return _mavlink_ftp_server; }
 
-    void do_work();
-
     Sender& sender();
 
     asio::io_context& io_context();
@@ -197,6 +197,10 @@ private:
 
     // Incoming libmav (JSON) message handling, used by the MavlinkDirectServer plugin.
     CallbackList<Mavsdk::MavlinkMessage> _libmav_message_callbacks{io_context()};
+    // Which message each handler asked for, so the decode interest can be released again.
+    std::mutex _libmav_subscription_keys_mutex{};
+    std::map<Handle<Mavsdk::MavlinkMessage>, MessageSubscriptionIndex::Key>
+        _libmav_subscription_keys{};
 
     std::atomic<MAV_STATE> _system_status{MAV_STATE_UNINIT};
     std::atomic<uint8_t> _base_mode{0};
@@ -0,0 +1,314 @@
+#include "shm_connection.hpp"
+#include "mavsdk_impl.hpp"
+#include "log.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <utility>
+
+#if !defined(WINDOWS) && !defined(ANDROID)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mavsdk {
+
+struct ShmConnection::SegmentHeader {
+    static constexpr uint64_t MAGIC = 0x4d415653484d3031; // "MAVSHM01"
+    static constexpr uint32_t VERSION = 1;
+    // The rings start after this, page-aligned.
+    static constexpr std::size_t SIZE = 4096;
+
+    // Written last by the creator, once everything else is set up.
+    std::atomic<uint64_t> magic;
+    uint32_t version;
+    uint32_t ring_capacity;
+    // Bit n is set while side n is taken.
+    std::atomic<uint32_t> attached;
+};
+
+namespace {
+
+// Waits for a process that is just creating the segment.
+template<typename Predicate> bool wait_for(Predicate predicate)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+} // namespace
+
+ShmConnection::ShmConnection(
+    Connection::ReceiverCallback receiver_callback,
+    Connection::LibmavReceiverCallback libmav_receiver_callback,
+    MavsdkImpl& mavsdk_impl,
+    std::string name,
+    ForwardingOption forwarding_option) :
+    Connection(
+        std::move(receiver_callback),
+        std::move(libmav_receiver_callback),
+        mavsdk_impl,
+        forwarding_option),
+    _name(std::move(name))
+{}
+
+ShmConnection::~ShmConnection()
+{
+    // If no one explicitly called stop before, we should at least do it.
+    stop();
+}
+
+ConnectionResult ShmConnection::start()
+{
+#if defined(WINDOWS) || defined(ANDROID)
+    LogErr("shm:// connections are not supported on this platform");
+    return ConnectionResult::NotImplemented;
+#else
+    if (!start_mavlink_receiver()) {
+        return ConnectionResult::ConnectionsExhausted;
+    }
+
+    if (!start_libmav_receiver()) {
+        return ConnectionResult::ConnectionsExhausted;
+    }
+
+    if (!open_segment()) {
+        return ConnectionResult::ConnectionError;
+    }
+
+    _receive_thread = std::make_unique<std::thread>(&ShmConnection::receive_loop, this);
+
+    return ConnectionResult::Success;
+#endif
+}
+
+ConnectionResult ShmConnection::stop()
+{
+    _stopping = true;
+
+    if (_receive_thread) {
+        _receive_ring->wake();
+        _receive_thread->join();
+        _receive_thread.reset();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_send_mutex);
+        close_segment();
+    }
+
+    // Stop this after the receive thread so we don't interfere with message parsing.
+    stop_mavlink_receiver();
+
+    return ConnectionResult::Success;
+}
+
+bool ShmConnection::open_segment()
+{
+#if defined(WINDOWS) || defined(ANDROID)
+    return false;
+#else
+    const std::string shm_name = "/" + _name;
+    _segment_size = SegmentHeader::SIZE + 2 * ShmRing::region_size(RING_CAPACITY);
+
+    bool created = true;
+    int fd = shm_open(shm_name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0 && errno == EEXIST) {
+        created = false;
+        fd = shm_open(shm_name.c_str(), O_RDWR, 0);
+    }
+    if (fd < 0) {
+        LogErr("Could not open shared memory {}: {}", shm_name, std::strerror(errno));
+        return false;
+    }
+
+    if (created) {
+        if (ftruncate(fd, static_cast<off_t>(_segment_size)) != 0) {
+            LogErr("Could not size shared memory {}: {}", shm_name, std::strerror(errno));
+            close(fd);
+            shm_unlink(shm_name.c_str());
+            return false;
+        }
+    } else if (!wait_for([&]() {
+                   struct stat st {};
+                   return fstat(fd, &st) == 0 &&
+                          static_cast<std::size_t>(st.st_size) >= _segment_size;
+               })) {
+        LogErr("Shared memory {} is too small, not created by MAVSDK?", shm_name);
+        close(fd);
+        return false;
+    }
+
+    void* segment = mmap(nullptr, _segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (segment == MAP_FAILED) {
+        LogErr("Could not map shared memory {}: {}", shm_name, std::strerror(errno));
+        if (created) {
+            shm_unlink(shm_name.c_str());
+        }
+        return false;
+    }
+
+    _segment = segment;
+    auto* rings = static_cast<uint8_t*>(segment) + SegmentHeader::SIZE;
+    void* ring_regions[2] = {rings, rings + ShmRing::region_size(RING_CAPACITY)};
+
+    if (created) {
+        _segment_header = new (segment) SegmentHeader();
+        _segment_header->version = SegmentHeader::VERSION;
+        _segment_header->ring_capacity = RING_CAPACITY;
+        _segment_header->attached.store(1u << 0);
+        ShmRing::initialize(ring_regions[0], RING_CAPACITY);
+        ShmRing::initialize(ring_regions[1], RING_CAPACITY);
+        _segment_header->magic.store(SegmentHeader::MAGIC, std::memory_order_release);
+        _side = 0;
+
+    } else {
+        _segment_header = std::launder(reinterpret_cast<SegmentHeader*>(segment));
+        if (!wait_for([&]() {
+                return _segment_header->magic.load(std::memory_order_acquire) ==
+                       SegmentHeader::MAGIC;
+            }) ||
+            _segment_header->version != SegmentHeader::VERSION ||
+            _segment_header->ring_capacity != RING_CAPACITY) {
+            LogErr("Shared memory {} not set up by a compatible MAVSDK", shm_name);
+            munmap(_segment, _segment_size);
+            _segment = nullptr;
+            _segment_header = nullptr;
+            return false;
+        }
+
+        // Take whichever side is free, normally 1.
+        bool taken = false;
+        auto attached = _segment_header->attached.load();
+        while (!taken) {
+            if ((attached & (1u << 1)) == 0) {
+                _side = 1;
+            } else if ((attached & (1u << 0)) == 0) {
+                _side = 0;
+            } else {
+                break;
+            }
+            taken = _segment_header->attached.compare_exchange_weak(
+                attached, attached | (1u << _side));
+        }
+        if (!taken) {
+            LogErr("Shared memory {} is already used by two processes", shm_name);
+            munmap(_segment, _segment_size);
+            _segment = nullptr;
+            _segment_header = nullptr;
+            return false;
+        }
+    }
+
+    _send_ring = std::make_unique<ShmRing>(ring_regions[_side], RING_CAPACITY);
+    _receive_ring = std::make_unique<ShmRing>(ring_regions[1 - _side], RING_CAPACITY);
+
+    // Whatever is left over was meant for a previous process on our side.
+    _receive_ring->skip_all();
+
+    LogInfo("Using shared memory {} (side {})", shm_name, _side);
+    return true;
+#endif
+}
+
+void ShmConnection::close_segment()
+{
+#if !defined(WINDOWS) && !defined(ANDROID)
+    if (_segment == nullptr) {
+        return;
+    }
+
+    _send_ring.reset();
+    _receive_ring.reset();
+
+    // The last one out removes the segment.
+    const auto attached = _segment_header->attached.fetch_and(~(1u << _side));
+    if ((attached & ~(1u << _side)) == 0) {
+        shm_unlink(("/" + _name).c_str());
+    }
+
+    munmap(_segment, _segment_size);
+    _segment = nullptr;
+    _segment_header = nullptr;
+#endif
+}
+
+bool ShmConnection::peer_attached() const
+{
+    return (_segment_header->attached.load(std::memory_order_relaxed) & (1u << (1 - _side))) != 0;
+}
+
+std::pair<bool, std::string> ShmConnection::send_message(const mavlink_message_t& message)
+{
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    uint16_t buffer_len = mavlink_msg_to_send_buffer(buffer, &message);
+    return send_raw_bytes(reinterpret_cast<const char*>(buffer), buffer_len);
+}
+
+std::pair<bool, std::string> ShmConnection::send_raw_bytes(const char* bytes, size_t length)
+{
+    capture_sent_bytes(bytes, length);
+
+    std::lock_guard<std::mutex> lock(_send_mutex);
+
+    if (!_send_ring) {
+        return {false, "Not connected"};
+    }
+
+    // Otherwise the frames would pile up for whoever attaches next.
+    if (!peer_attached()) {
+        return {false, "No peer attached"};
+    }
+
+    if (!_send_ring->push(bytes, length)) {
+        return {false, "Shared memory ring full"};
+    }
+
+    return {true, {}};
+}
+
+void ShmConnection::receive_loop()
+{
+    while (!_stopping) {
+        // Wake up regularly, so stop() is noticed even if the wake-up is missed.
+        if (!_receive_ring->wait(std::chrono::milliseconds(100))) {
+            continue;
+        }
+
+        // Handle everything there is before waiting again.
+        while (!_stopping) {
+            const auto record = _receive_ring->peek();
+            if (!record) {
+                break;
+            }
+
+            // Parsed in place: the record is only popped once all frames in it are
+            // handled, the receiver copies what it needs of a partial frame. It does not
+            // write to the datagram.
+            _mavlink_receiver->set_new_datagram(
+                const_cast<char*>(reinterpret_cast<const char*>(record->data)),
+                static_cast<unsigned>(record->len));
+
+            auto parse_result = _mavlink_receiver->parse_message();
+            while (parse_result != MavlinkReceiver::ParseResult::NoneAvailable) {
+                receive_frame(parse_result);
+                parse_result = _mavlink_receiver->parse_message();
+            }
+
+            _receive_ring->pop();
+        }
+    }
+}
+
+} // namespace mavsdk
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "connection.hpp"
+#include "shm_ring.hpp"
+
+namespace mavsdk {
+
+// Connection to another process on the same machine through a POSIX shared
+// memory segment, for shm://name.
+//
+// The segment holds two ShmRings, one per direction. Whoever opens it first
+// creates it and takes side 0, the other process takes side 1. Frames are
+// copied into the ring by send_raw_bytes() directly, and parsed in place by a
+// receive thread, so no socket and, while both sides keep up, no syscalls are
+// involved.
+//
+// If a process dies without stopping the connection, its side stays taken. In
+// that case remove the segment (e.g. /dev/shm/name on Linux).
+class ShmConnection : public Connection {
+public:
+    ShmConnection(
+        Connection::ReceiverCallback receiver_callback,
+        Connection::LibmavReceiverCallback libmav_receiver_callback,
+        MavsdkImpl& mavsdk_impl,
+        std::string name,
+        ForwardingOption forwarding_option = ForwardingOption::ForwardingOff);
+    ~ShmConnection() override;
+
+    ConnectionResult start() override;
+    ConnectionResult stop() override;
+
+    std::pair<bool, std::string> send_message(const mavlink_message_t& message) override;
+    std::pair<bool, std::string> send_raw_bytes(const char* bytes, size_t length) override;
+
+    // Non-copyable
+    ShmConnection(const ShmConnection&) = delete;
+    const ShmConnection& operator=(const ShmConnection&) = delete;
+
+private:
+    static constexpr std::size_t RING_CAPACITY = 256 * 1024;
+
+    struct SegmentHeader;
+
+    bool open_segment();
+    void close_segment();
+    bool peer_attached() const;
+    void receive_loop();
+
+    const std::string _name;
+
+    void* _segment{nullptr};
+    std::size_t _segment_size{0};
+    SegmentHeader* _segment_header{nullptr};
+    unsigned _side{0};
+
+    std::unique_ptr<ShmRing> _send_ring{};
+    std::unique_ptr<ShmRing> _receive_ring{};
+
+    // There can be several threads sending, but the ring has a single producer.
+    std::mutex _send_mutex{};
+
+    std::atomic<bool> _stopping{false};
+    std::unique_ptr<std::thread> _receive_thread{};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,162 @@
+#include "mavsdk_impl.hpp"
+#include "mavlink_include.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace mavsdk;
+
+namespace {
+
+// Collects the texts of the STATUSTEXT messages a MavsdkImpl receives.
+class ReceivedStatusTexts {
+public:
+    explicit ReceivedStatusTexts(MavsdkImpl& mavsdk_impl) : _mavsdk_impl(mavsdk_impl)
+    {
+        _mavsdk_impl.intercept_incoming_messages_async([this](mavlink_message_t& message) {
+            if (message.msgid == MAVLINK_MSG_ID_STATUSTEXT) {
+                char text[51]{};
+                mavlink_msg_statustext_get_text(&message, text);
+                std::lock_guard<std::mutex> lock(_mutex);
+                _texts.emplace_back(text);
+                _cv.notify_all();
+            }
+            return true;
+        });
+    }
+
+    ~ReceivedStatusTexts() { _mavsdk_impl.intercept_incoming_messages_async(nullptr); }
+
+    bool wait_for(const std::string& text, std::chrono::milliseconds timeout)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        return _cv.wait_for(lock, timeout, [&]() {
+            return std::find(_texts.begin(), _texts.end(), text) != _texts.end();
+        });
+    }
+
+private:
+    MavsdkImpl& _mavsdk_impl;
+    std::mutex _mutex{};
+    std::condition_variable _cv{};
+    std::vector<std::string> _texts{};
+};
+
+void send_status_text(MavsdkImpl& mavsdk_impl, const std::string& text)
+{
+    mavlink_message_t message;
+    mavlink_msg_statustext_pack(
+        mavsdk_impl.get_own_system_id(),
+        mavsdk_impl.get_own_component_id(),
+        &message,
+        MAV_SEVERITY_INFO,
+        text.c_str(),
+        0,
+        0);
+    EXPECT_TRUE(mavsdk_impl.send_message(message));
+}
+
+std::string segment_name(const std::string& name)
+{
+    return "mavsdk_" + name + "_" + std::to_string(getpid());
+}
+
+bool segment_exists(const std::string& name)
+{
+    const int fd = shm_open(("/" + name).c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        EXPECT_EQ(errno, ENOENT);
+        return false;
+    }
+    close(fd);
+    return true;
+}
+
+} // namespace
+
+TEST(ShmConnection, SendAndReceiveBothWays)
+{
+    const auto name = segment_name("both_ways");
+    MavsdkImpl first{Mavsdk::Configuration{ComponentType::GroundStation}};
+    MavsdkImpl second{Mavsdk::Configuration{ComponentType::GroundStation}};
+    ReceivedStatusTexts received_by_first{first};
+    ReceivedStatusTexts received_by_second{second};
+
+    ASSERT_EQ(
+        first.add_any_connection("shm://" + name, ForwardingOption::ForwardingOff).first,
+        ConnectionResult::Success);
+    ASSERT_EQ(
+        second.add_any_connection("shm://" + name, ForwardingOption::ForwardingOff).first,
+        ConnectionResult::Success);
+
+    // Both sides are attached once added, so nothing needs to be sent again.
+    send_status_text(first, "to second");
+    EXPECT_TRUE(received_by_second.wait_for("to second", std::chrono::seconds(2)));
+    send_status_text(second, "to first");
+    EXPECT_TRUE(received_by_first.wait_for("to first", std::chrono::seconds(2)));
+}
+
+TEST(ShmConnection, SideIsFreedOnStop)
+{
+    const auto name = segment_name("side_freed");
+    MavsdkImpl second{Mavsdk::Configuration{ComponentType::GroundStation}};
+    ReceivedStatusTexts received_by_second{second};
+
+    {
+        MavsdkImpl first{Mavsdk::Configuration{ComponentType::GroundStation}};
+        const auto [result, handle] =
+            first.add_any_connection("shm://" + name, ForwardingOption::ForwardingOff);
+        ASSERT_EQ(result, ConnectionResult::Success);
+        ASSERT_EQ(
+            second.add_any_connection("shm://" + name, ForwardingOption::ForwardingOff).first,
+            ConnectionResult::Success);
+
+        send_status_text(first, "first");
+        EXPECT_TRUE(received_by_second.wait_for("first", std::chrono::seconds(2)));
+
+        // Still used by the second one.
+        first.remove_connection(handle);
+        EXPECT_TRUE(segment_exists(name));
+    }
+
+    // Takes the side that was freed.
+    MavsdkImpl third{Mavsdk::Configuration{ComponentType::GroundStation}};
+    ASSERT_EQ(
+        third.add_any_connection("shm://" + name, ForwardingOption::ForwardingOff).first,
+        ConnectionResult::Success);
+
+    send_status_text(third, "third");
+    EXPECT_TRUE(received_by_second.wait_for("third", std::chrono::seconds(2)));
+}
+
+TEST(ShmConnection, LastOneOutRemovesSegment)
+{
+    const auto name = segment_name("last_out");
+    MavsdkImpl first{Mavsdk::Configuration{ComponentType::GroundStation}};
+    MavsdkImpl second{Mavsdk::Configuration{ComponentType::GroundStation}};
+
+    const auto [first_result, first_handle] =
+        first.add_any_connection("shm://" + name, ForwardingOption::ForwardingOff);
+    ASSERT_EQ(first_result, ConnectionResult::Success);
+    const auto [second_result, second_handle] =
+        second.add_any_connection("shm://" + name, ForwardingOption::ForwardingOff);
+    ASSERT_EQ(second_result, ConnectionResult::Success);
+    EXPECT_TRUE(segment_exists(name));
+
+    first.remove_connection(first_handle);
+    EXPECT_TRUE(segment_exists(name));
+
+    second.remove_connection(second_handle);
+    EXPECT_FALSE(segment_exists(name));
+}
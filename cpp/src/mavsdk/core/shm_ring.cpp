@@ -0,0 +1,198 @@
+#include "shm_ring.hpp"
+
+#include <cassert>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#if defined(LINUX)
+#include <climits>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace mavsdk {
+
+namespace {
+
+#if defined(LINUX)
+// Not FUTEX_PRIVATE_FLAG: the word is shared with another process.
+void futex_wait(std::atomic<uint32_t>& word, uint32_t expected, std::chrono::milliseconds timeout)
+{
+    timespec ts{};
+    ts.tv_sec = static_cast<time_t>(timeout.count() / 1000);
+    ts.tv_nsec = static_cast<long>((timeout.count() % 1000) * 1000000);
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected, &ts, nullptr, 0);
+}
+
+void futex_wake(std::atomic<uint32_t>& word)
+{
+    syscall(
+        SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+#endif
+
+} // namespace
+
+void ShmRing::initialize(void* region, std::size_t capacity)
+{
+    assert(capacity >= MIN_CAPACITY && (capacity & (capacity - 1)) == 0);
+    (void)capacity;
+
+    auto* header = new (region) Header();
+    header->head.store(0);
+    header->tail.store(0);
+    header->wake_seq.store(0);
+    header->consumer_waiting.store(0);
+}
+
+ShmRing::ShmRing(void* region, std::size_t capacity) :
+    _header(*std::launder(reinterpret_cast<Header*>(region))),
+    _data(static_cast<uint8_t*>(region) + HEADER_SIZE),
+    _capacity(capacity)
+{}
+
+uint32_t ShmRing::read_len(uint64_t position) const
+{
+    uint32_t len;
+    std::memcpy(&len, _data + (position & (_capacity - 1)), LEN_SIZE);
+    return len;
+}
+
+void ShmRing::write_len(uint64_t position, uint32_t len)
+{
+    std::memcpy(_data + (position & (_capacity - 1)), &len, LEN_SIZE);
+}
+
+bool ShmRing::push(const void* data, std::size_t len)
+{
+    const auto size = record_size(len);
+    if (size > _capacity / 4) {
+        return false;
+    }
+
+    auto head = _header.head.load(std::memory_order_relaxed);
+    const auto tail = _header.tail.load(std::memory_order_acquire);
+
+    // Records don't wrap around the end, skip the rest instead.
+    const auto until_end = _capacity - (head & (_capacity - 1));
+    const auto skipped = until_end < size ? until_end : 0;
+    if (head + skipped + size - tail > _capacity) {
+        return false;
+    }
+
+    if (skipped != 0) {
+        write_len(head, WRAP_MARKER);
+        head += skipped;
+    }
+
+    write_len(head, static_cast<uint32_t>(len));
+    std::memcpy(_data + (head & (_capacity - 1)) + LEN_SIZE, data, len);
+
+    // Sequentially consistent, paired with wait(): either the consumer sees the new head,
+    // or we see that it is waiting.
+    _header.head.store(head + size);
+    notify_consumer();
+    return true;
+}
+
+std::optional<ShmRing::Record> ShmRing::peek()
+{
+    auto tail = _header.tail.load(std::memory_order_relaxed);
+    const auto head = _header.head.load(std::memory_order_acquire);
+    if (tail == head) {
+        return std::nullopt;
+    }
+    if (head - tail > _capacity) {
+        skip_all();
+        return std::nullopt;
+    }
+
+    auto len = read_len(tail);
+    if (len == WRAP_MARKER) {
+        tail += _capacity - (tail & (_capacity - 1));
+        if (head - tail > _capacity) {
+            // The marker is past the head.
+            skip_all();
+            return std::nullopt;
+        }
+        _header.tail.store(tail, std::memory_order_release);
+        if (tail == head) {
+            return std::nullopt;
+        }
+        len = read_len(tail);
+    }
+
+    // Records are never bigger than push() allows, don't wrap around the end and
+    // don't extend past the head.
+    const auto offset = tail & (_capacity - 1);
+    if (len > _capacity / 4 || offset + record_size(len) > _capacity ||
+        record_size(len) > head - tail) {
+        skip_all();
+        return std::nullopt;
+    }
+
+    _peeked_size = record_size(len);
+    return Record{_data + offset + LEN_SIZE, len};
+}
+
+void ShmRing::pop()
+{
+    // Only after peek(), which skipped any wrap marker.
+    const auto tail = _header.tail.load(std::memory_order_relaxed);
+    _header.tail.store(tail + _peeked_size, std::memory_order_release);
+    _peeked_size = 0;
+}
+
+bool ShmRing::empty() const
+{
+    return _header.tail.load(std::memory_order_relaxed) == _header.head.load();
+}
+
+void ShmRing::skip_all()
+{
+    _header.tail.store(_header.head.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+bool ShmRing::wait(std::chrono::milliseconds timeout)
+{
+    if (!empty()) {
+        return true;
+    }
+
+#if defined(LINUX)
+    const auto wake_seq = _header.wake_seq.load();
+    _header.consumer_waiting.store(1);
+    if (empty()) {
+        futex_wait(_header.wake_seq, wake_seq, timeout);
+    }
+    _header.consumer_waiting.store(0);
+#else
+    // No futex to sleep on, poll instead.
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (empty() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+#endif
+
+    return !empty();
+}
+
+void ShmRing::wake()
+{
+    _header.wake_seq.fetch_add(1);
+#if defined(LINUX)
+    futex_wake(_header.wake_seq);
+#endif
+}
+
+void ShmRing::notify_consumer()
+{
+    if (_header.consumer_waiting.load() != 0) {
+        wake();
+    }
+}
+
+} // namespace mavsdk
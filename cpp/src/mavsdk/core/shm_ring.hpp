@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "mavsdk_export.h"
+
+namespace mavsdk {
+
+/*
+ * Single-producer, single-consumer ring of variable-length records, in memory
+ * that can be shared between two processes. Used by ShmConnection.
+ *
+ * The ring does not own its memory: producer and consumer each construct a
+ * ShmRing on the same region, after one of them called initialize() on it.
+ * Positions are 64-bit counters that never wrap; the offset into the data is
+ * the position modulo the capacity, which is a power of two.
+ *
+ * A record is a 32-bit length followed by the bytes, padded to 8 bytes. A
+ * record never wraps around the end: if it does not fit, a wrap marker is
+ * written and the record starts at the beginning of the data again. That way
+ * the consumer can hand out a record in place, without copying it.
+ *
+ * The consumer can sleep in wait() until the producer pushed something. On
+ * Linux this is a futex in the shared memory, so neither side makes a syscall
+ * while the consumer keeps up, and an idle consumer wakes up straightaway.
+ * Elsewhere, wait() polls.
+ */
+class MAVSDK_TEST_EXPORT ShmRing {
+public:
+    static constexpr std::size_t HEADER_SIZE = 256;
+    static constexpr std::size_t MIN_CAPACITY = 4096;
+
+    struct Record {
+        const uint8_t* data;
+        std::size_t len;
+    };
+
+    static std::size_t region_size(std::size_t capacity) { return HEADER_SIZE + capacity; }
+
+    // Sets up an empty ring. The capacity must be a power of two, and at
+    // least MIN_CAPACITY.
+    static void initialize(void* region, std::size_t capacity);
+
+    ShmRing(void* region, std::size_t capacity);
+
+    // Producer side. Returns false if the ring is full.
+    bool push(const void* data, std::size_t len);
+
+    // Consumer side. The record returned by peek() stays valid until pop().
+    //
+    // The other process must not be able to make us read outside of the ring, so
+    // peek() checks the positions and the record length. If they don't add up, the
+    // ring is corrupt, and everything in it is dropped.
+    std::optional<Record> peek();
+    void pop();
+    bool empty() const;
+
+    // Drops everything pushed so far, e.g. when a new consumer takes over.
+    void skip_all();
+
+    // Waits until there is something to peek() at, for at most timeout.
+    // Returns false if there is still nothing.
+    bool wait(std::chrono::milliseconds timeout);
+
+    // Wakes up the consumer in wait(), e.g. to stop it.
+    void wake();
+
+private:
+    struct Header {
+        // Next position to write, only written by the producer.
+        alignas(64) std::atomic<uint64_t> head;
+        // Next position to read, only written by the consumer.
+        alignas(64) std::atomic<uint64_t> tail;
+        // Futex word: bumped to wake the consumer.
+        alignas(64) std::atomic<uint32_t> wake_seq;
+        std::atomic<uint32_t> consumer_waiting;
+    };
+    static_assert(sizeof(Header) <= HEADER_SIZE, "ShmRing header too big");
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "Needs lock-free atomics");
+    static_assert(std::atomic<uint32_t>::is_always_lock_free, "Needs lock-free atomics");
+
+    static constexpr uint32_t WRAP_MARKER = 0xFFFFFFFF;
+    static constexpr std::size_t LEN_SIZE = sizeof(uint32_t);
+
+    static std::size_t record_size(std::size_t len)
+    {
+        return (LEN_SIZE + len + 7) & ~std::size_t{7};
+    }
+
+    uint32_t read_len(uint64_t position) const;
+    void write_len(uint64_t position, uint32_t len);
+    void notify_consumer();
+
+    Header& _header;
+    uint8_t* const _data;
+    const std::size_t _capacity;
+
+    // Size of the record returned by peek(), so that pop() does not read its length
+    // from the shared memory again.
+    std::size_t _peeked_size{0};
+};
+
+} // namespace mavsdk
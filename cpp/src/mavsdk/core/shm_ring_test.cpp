@@ -0,0 +1,210 @@
+#include "shm_ring.hpp"
+#include <gtest/gtest.h>
+
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace mavsdk;
+
+namespace {
+
+constexpr std::size_t capacity = ShmRing::MIN_CAPACITY;
+
+struct Region {
+    Region() { ShmRing::initialize(memory.data(), capacity); }
+
+    // Like a mapping, page-aligned and zeroed.
+    alignas(4096) std::array<uint8_t, ShmRing::HEADER_SIZE + capacity> memory{};
+};
+
+std::vector<uint8_t> record_for(unsigned i, std::size_t len)
+{
+    std::vector<uint8_t> record(len);
+    for (std::size_t j = 0; j < len; ++j) {
+        record[j] = static_cast<uint8_t>(i + j);
+    }
+    return record;
+}
+
+std::vector<uint8_t> to_vector(const ShmRing::Record& record)
+{
+    return {record.data, record.data + record.len};
+}
+
+} // namespace
+
+TEST(ShmRing, PushPeekPop)
+{
+    Region region;
+    ShmRing producer(region.memory.data(), capacity);
+    ShmRing consumer(region.memory.data(), capacity);
+
+    EXPECT_TRUE(consumer.empty());
+    EXPECT_FALSE(consumer.peek().has_value());
+
+    const auto record1 = record_for(1, 17);
+    const auto record2 = record_for(2, 280);
+    ASSERT_TRUE(producer.push(record1.data(), record1.size()));
+    ASSERT_TRUE(producer.push(record2.data(), record2.size()));
+
+    auto record = consumer.peek();
+    ASSERT_TRUE(record.has_value());
+    EXPECT_EQ(to_vector(*record), record1);
+    // Until popped, the same one.
+    EXPECT_EQ(to_vector(*consumer.peek()), record1);
+    consumer.pop();
+
+    record = consumer.peek();
+    ASSERT_TRUE(record.has_value());
+    EXPECT_EQ(to_vector(*record), record2);
+    consumer.pop();
+
+    EXPECT_TRUE(consumer.empty());
+}
+
+TEST(ShmRing, WrapsAround)
+{
+    Region region;
+    ShmRing producer(region.memory.data(), capacity);
+    ShmRing consumer(region.memory.data(), capacity);
+
+    // Sizes that don't divide the capacity, so records end up at the end.
+    for (unsigned i = 0; i < 1000; ++i) {
+        const auto sent = record_for(i, 100 + i % 200);
+        ASSERT_TRUE(producer.push(sent.data(), sent.size())) << i;
+        auto received = consumer.peek();
+        ASSERT_TRUE(received.has_value()) << i;
+        EXPECT_EQ(to_vector(*received), sent) << i;
+        consumer.pop();
+    }
+    EXPECT_TRUE(consumer.empty());
+}
+
+TEST(ShmRing, Full)
+{
+    Region region;
+    ShmRing producer(region.memory.data(), capacity);
+    ShmRing consumer(region.memory.data(), capacity);
+
+    const auto record = record_for(0, 280);
+    unsigned pushed = 0;
+    while (producer.push(record.data(), record.size())) {
+        ++pushed;
+    }
+    EXPECT_EQ(pushed, capacity / 288);
+
+    // Room again after popping one.
+    ASSERT_TRUE(consumer.peek().has_value());
+    consumer.pop();
+    EXPECT_TRUE(producer.push(record.data(), record.size()));
+
+    // Too big, no matter how empty.
+    const auto too_big = record_for(0, capacity / 2);
+    consumer.skip_all();
+    EXPECT_TRUE(consumer.empty());
+    EXPECT_FALSE(producer.push(too_big.data(), too_big.size()));
+}
+
+TEST(ShmRing, DropsRecordWithBadLength)
+{
+    Region region;
+    ShmRing producer(region.memory.data(), capacity);
+    ShmRing consumer(region.memory.data(), capacity);
+
+    const auto record = record_for(0, 20);
+    // A length beyond the end of the ring, one bigger than push() allows, and
+    // one that runs past what was pushed.
+    for (const uint32_t bad_len : {uint32_t{0x7FFFFFFF}, uint32_t{capacity / 2}, uint32_t{100}}) {
+        // The head is the first field of the header.
+        uint64_t position;
+        std::memcpy(&position, region.memory.data(), sizeof(position));
+        ASSERT_TRUE(producer.push(record.data(), record.size()));
+
+        std::memcpy(
+            region.memory.data() + ShmRing::HEADER_SIZE + position % capacity,
+            &bad_len,
+            sizeof(bad_len));
+        EXPECT_FALSE(consumer.peek().has_value()) << bad_len;
+        EXPECT_TRUE(consumer.empty()) << bad_len;
+    }
+}
+
+TEST(ShmRing, DropsEverythingWithBadHead)
+{
+    Region region;
+    ShmRing producer(region.memory.data(), capacity);
+    ShmRing consumer(region.memory.data(), capacity);
+
+    const auto record = record_for(0, 20);
+    ASSERT_TRUE(producer.push(record.data(), record.size()));
+
+    // More than the capacity ahead of the tail. The head is the first field of the header.
+    const uint64_t bad_head = 2 * capacity;
+    std::memcpy(region.memory.data(), &bad_head, sizeof(bad_head));
+    EXPECT_FALSE(consumer.peek().has_value());
+    EXPECT_TRUE(consumer.empty());
+
+    // Still usable afterwards.
+    ASSERT_TRUE(producer.push(record.data(), record.size()));
+    const auto received = consumer.peek();
+    ASSERT_TRUE(received.has_value());
+    EXPECT_EQ(to_vector(*received), record);
+    consumer.pop();
+    EXPECT_TRUE(consumer.empty());
+}
+
+TEST(ShmRing, ProducerAndConsumerThreads)
+{
+    Region region;
+    ShmRing producer(region.memory.data(), capacity);
+    ShmRing consumer(region.memory.data(), capacity);
+
+    constexpr unsigned num_records = 100000;
+
+    std::thread producer_thread([&]() {
+        for (unsigned i = 0; i < num_records; ++i) {
+            const auto record = record_for(i, 10 + i % 270);
+            while (!producer.push(record.data(), record.size())) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    unsigned received = 0;
+    while (received < num_records) {
+        if (!consumer.wait(std::chrono::milliseconds(1000))) {
+            break;
+        }
+        auto record = consumer.peek();
+        ASSERT_TRUE(record.has_value());
+        ASSERT_EQ(to_vector(*record), record_for(received, 10 + received % 270));
+        consumer.pop();
+        ++received;
+    }
+
+    producer_thread.join();
+    EXPECT_EQ(received, num_records);
+}
+
+#if defined(LINUX)
+// Elsewhere, wait() polls until the timeout.
+TEST(ShmRing, WakeInterruptsWait)
+{
+    Region region;
+    ShmRing consumer(region.memory.data(), capacity);
+
+    std::thread waker([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        consumer.wake();
+    });
+
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(consumer.wait(std::chrono::milliseconds(5000)));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(4));
+
+    waker.join();
+}
+#endif
@@ -0,0 +1,66 @@
+#include "system_id_set.hpp"
+
+namespace mavsdk {
+
+void SystemIdSet::insert(uint8_t system_id, Clock::time_point now)
+{
+    // The timestamp is written before the bit is checked, and remove_older_than() clears
+    // the bit before checking the timestamp again. With both sequentially consistent, at
+    // least one of them sees the other, so a system ID seen during aging is not lost.
+    auto& last_seen = _last_seen[system_id];
+    const auto now_count = now.time_since_epoch().count();
+    const auto resolution = std::chrono::duration_cast<Clock::duration>(LAST_SEEN_RESOLUTION);
+    if (now_count - last_seen.load(std::memory_order_relaxed) >= resolution.count()) {
+        last_seen.store(now_count);
+    }
+
+    auto& bitmap_word = word(system_id);
+    if ((bitmap_word.load() & bit(system_id)) == 0) {
+        bitmap_word.fetch_or(bit(system_id));
+    }
+}
+
+bool SystemIdSet::contains(uint8_t system_id) const
+{
+    return (word(system_id).load(std::memory_order_relaxed) & bit(system_id)) != 0;
+}
+
+std::optional<SystemIdSet::Clock::time_point> SystemIdSet::last_seen(uint8_t system_id) const
+{
+    if (!contains(system_id)) {
+        return std::nullopt;
+    }
+    return Clock::time_point(Clock::duration(_last_seen[system_id].load()));
+}
+
+void SystemIdSet::remove_older_than(Clock::time_point cutoff)
+{
+    const auto cutoff_count = cutoff.time_since_epoch().count();
+
+    for (unsigned i = 0; i < _last_seen.size(); ++i) {
+        const auto system_id = static_cast<uint8_t>(i);
+        if (!contains(system_id) || _last_seen[i].load() >= cutoff_count) {
+            continue;
+        }
+
+        auto& bitmap_word = word(system_id);
+        bitmap_word.fetch_and(~bit(system_id));
+
+        // Seen again in the meantime, see insert().
+        if (_last_seen[i].load() >= cutoff_count) {
+            bitmap_word.fetch_or(bit(system_id));
+        }
+    }
+}
+
+bool SystemIdSet::empty() const
+{
+    for (const auto& bitmap_word : _bitmap) {
+        if (bitmap_word.load() != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace mavsdk
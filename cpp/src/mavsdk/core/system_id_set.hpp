@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+#include "mavsdk_export.h"
+
+namespace mavsdk {
+
+/*
+ * The system IDs seen on a connection, and when each was last seen.
+ *
+ * insert() is called for every received message and contains() for every
+ * message sent, on every connection, so both are wait-free: membership is a
+ * 256-bit atomic bitmap, and the timestamps are atomics next to it.
+ */
+class MAVSDK_TEST_EXPORT SystemIdSet {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    void insert(uint8_t system_id, Clock::time_point now);
+    bool contains(uint8_t system_id) const;
+
+    std::optional<Clock::time_point> last_seen(uint8_t system_id) const;
+
+    // Removes the system IDs not seen since cutoff.
+    void remove_older_than(Clock::time_point cutoff);
+
+    bool empty() const;
+
+private:
+    static constexpr unsigned BITS_PER_WORD = 64;
+
+    // Timestamps are only updated once they are older than this, so that a
+    // stream of messages does not write them all the time.
+    static constexpr auto LAST_SEEN_RESOLUTION = std::chrono::milliseconds(100);
+
+    static uint64_t bit(uint8_t system_id) { return uint64_t{1} << (system_id % BITS_PER_WORD); }
+    std::atomic<uint64_t>& word(uint8_t system_id) { return _bitmap[system_id / BITS_PER_WORD]; }
+    const std::atomic<uint64_t>& word(uint8_t system_id) const
+    {
+        return _bitmap[system_id / BITS_PER_WORD];
+    }
+
+    std::array<std::atomic<uint64_t>, 256 / BITS_PER_WORD> _bitmap{};
+    std::array<std::atomic<Clock::rep>, 256> _last_seen{};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,104 @@
+#include "system_id_set.hpp"
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+using namespace mavsdk;
+
+TEST(SystemIdSet, InsertAndContains)
+{
+    SystemIdSet set;
+    const auto now = SystemIdSet::Clock::now();
+
+    for (unsigned i = 0; i < 256; ++i) {
+        EXPECT_FALSE(set.contains(static_cast<uint8_t>(i)));
+    }
+
+    for (uint8_t system_id : {1, 63, 64, 127, 128, 255}) {
+        set.insert(system_id, now);
+    }
+
+    for (unsigned i = 0; i < 256; ++i) {
+        const bool expected = i == 1 || i == 63 || i == 64 || i == 127 || i == 128 || i == 255;
+        EXPECT_EQ(set.contains(static_cast<uint8_t>(i)), expected) << i;
+    }
+}
+
+TEST(SystemIdSet, LastSeen)
+{
+    SystemIdSet set;
+    const auto start = SystemIdSet::Clock::now();
+
+    EXPECT_FALSE(set.last_seen(1).has_value());
+
+    set.insert(1, start);
+    ASSERT_TRUE(set.last_seen(1).has_value());
+    EXPECT_EQ(set.last_seen(1).value(), start);
+
+    // Updated, but not for every message.
+    set.insert(1, start + std::chrono::milliseconds(10));
+    EXPECT_EQ(set.last_seen(1).value(), start);
+    set.insert(1, start + std::chrono::seconds(1));
+    EXPECT_EQ(set.last_seen(1).value(), start + std::chrono::seconds(1));
+}
+
+TEST(SystemIdSet, RemoveOlderThan)
+{
+    SystemIdSet set;
+    const auto start = SystemIdSet::Clock::now();
+
+    set.insert(1, start);
+    set.insert(2, start + std::chrono::seconds(10));
+
+    set.remove_older_than(start + std::chrono::seconds(5));
+    EXPECT_FALSE(set.contains(1));
+    EXPECT_FALSE(set.last_seen(1).has_value());
+    EXPECT_TRUE(set.contains(2));
+
+    // Seen again.
+    set.insert(1, start + std::chrono::seconds(20));
+    EXPECT_TRUE(set.contains(1));
+}
+
+TEST(SystemIdSet, Empty)
+{
+    SystemIdSet set;
+    const auto start = SystemIdSet::Clock::now();
+    EXPECT_TRUE(set.empty());
+
+    set.insert(200, start);
+    EXPECT_FALSE(set.empty());
+
+    set.remove_older_than(start + std::chrono::seconds(1));
+    EXPECT_TRUE(set.empty());
+}
+
+TEST(SystemIdSet, ConcurrentInsertAndAging)
+{
+    SystemIdSet set;
+    const auto start = SystemIdSet::Clock::now();
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < 2; ++t) {
+        threads.emplace_back([&set, start, t]() {
+            for (unsigned i = 0; i < 10000; ++i) {
+                set.insert(
+                    static_cast<uint8_t>(i % 128 + t * 128), start + std::chrono::seconds(10));
+            }
+        });
+    }
+    threads.emplace_back([&set, start]() {
+        for (unsigned i = 0; i < 100; ++i) {
+            set.remove_older_than(start + std::chrono::seconds(5));
+        }
+    });
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // All of them were seen after the cutoff, so none may be lost.
+    for (unsigned i = 0; i < 256; ++i) {
+        EXPECT_TRUE(set.contains(static_cast<uint8_t>(i))) << i;
+    }
+}
@@ -24,22 +24,31 @@ template class MAVSDK_TEMPL_INST CallbackList<ComponentType>;
 template class MAVSDK_TEMPL_INST CallbackList<ComponentType, uint8_t>;
 
 SystemImpl::SystemImpl(MavsdkImpl& mavsdk_impl) :
-    // Declared before _mavsdk_impl, so init it first (in declaration order) using the
+    // Declared before _mavsdk_impl, so init them first (in declaration order) using the
     // ctor parameter rather than the not-yet-bound _mavsdk_impl reference.
-    _mavlink_message_handler(mavsdk_impl.io_context()),
+    _io_worker(mavsdk_impl.io_worker_for_new_system()),
+    _mavlink_message_handler(_io_worker ? _io_worker->io_context() : mavsdk_impl.io_context()),
     _mavsdk_impl(mavsdk_impl),
-    _system_work_timer(mavsdk_impl.io_context()),
-    _command_sender(*this),
+    _system_work_timer(io_context()),
+    _command_sender(
+        _mavsdk_impl.default_server_component_impl().sender(),
+        _mavlink_message_handler,
+        timeout_handler(),
+        get_time(),
+        io_context(),
+        [this]() { return timeout_s(); },
+        [this]() { return effective_autopilot(); },
+        [this](const auto& func) { call_user_callback(func); }),
     _timesync(*this),
     _ping(*this),
     _mission_transfer_client(
         _mavsdk_impl.default_server_component_impl().sender(),
         _mavlink_message_handler,
-        _mavsdk_impl.timeout_handler,
+        timeout_handler(),
         [this]() { return timeout_s(); },
         [this]() { return effective_autopilot(); }),
     _mavlink_request_message(
-        *this, _command_sender, _mavlink_message_handler, _mavsdk_impl.timeout_handler),
+        *this, _command_sender, _mavlink_message_handler, timeout_handler()),
     _mavlink_ftp_client(*this),
     _mavlink_component_metadata(*this)
 {
@@ -60,6 +69,13 @@ SystemImpl::~SystemImpl()
     _mavlink_message_handler.unregister_all_blocking(this);
     // Clear all libmav message callbacks
     _libmav_message_callbacks.clear();
+    {
+        std::lock_guard<std::mutex> lock(_libmav_subscription_keys_mutex);
+        for (const auto& entry : _libmav_subscription_keys) {
+            _mavsdk_impl.remove_libmav_subscription(entry.second);
+        }
+        _libmav_subscription_keys.clear();
+    }
 
     unregister_timeout_handler(_heartbeat_timeout_cookie);
 }
@@ -137,7 +153,7 @@ void SystemImpl::process_libmav_message(const Mavsdk::MavlinkMessage& message)
 
     // CallbackList handles thread safety - just call all callbacks and let them filter internally
     _libmav_message_callbacks.queue(
-        message, [this](const std::function<void()>& callback_wrapper) { callback_wrapper(); });
+        message, [](const UserCallback& callback_wrapper) { callback_wrapper(); });
 }
 
 Handle<Mavsdk::MavlinkMessage> SystemImpl::register_libmav_message_handler(
@@ -169,6 +185,10 @@ Handle<Mavsdk::MavlinkMessage> SystemImpl::register_libmav_message_handler(
         };
 
     auto handle = _libmav_message_callbacks.subscribe(filtering_callback);
+    {
+        std::lock_guard<std::mutex> lock(_libmav_subscription_keys_mutex);
+        _libmav_subscription_keys[handle] = _mavsdk_impl.add_libmav_subscription(message_name);
+    }
 
     if (_message_debugging) {
         LogDebug("Registering libmav handler for message: '{}'", message_name);
@@ -215,6 +235,10 @@ Handle<Mavsdk::MavlinkMessage> SystemImpl::register_libmav_message_handler_with_
         };
 
     auto handle = _libmav_message_callbacks.subscribe(filtering_callback);
+    {
+        std::lock_guard<std::mutex> lock(_libmav_subscription_keys_mutex);
+        _libmav_subscription_keys[handle] = _mavsdk_impl.add_libmav_subscription(message_name);
+    }
 
     if (_message_debugging) {
         LogDebug(
@@ -232,6 +256,14 @@ void SystemImpl::unregister_libmav_message_handler(Handle<Mavsdk::MavlinkMessage
     // deinit() relies on that to destroy the object that owns the callback (which captures
     // its 'this') without a use-after-free on the io thread.
     _libmav_message_callbacks.unsubscribe_blocking(handle);
+    {
+        std::lock_guard<std::mutex> lock(_libmav_subscription_keys_mutex);
+        auto it = _libmav_subscription_keys.find(handle);
+        if (it != _libmav_subscription_keys.end()) {
+            _mavsdk_impl.remove_libmav_subscription(it->second);
+            _libmav_subscription_keys.erase(it);
+        }
+    }
 
     if (_message_debugging) {
         LogDebug("Unregistered libmav handler");
@@ -241,17 +273,17 @@ void SystemImpl::unregister_libmav_message_handler(Handle<Mavsdk::MavlinkMessage
 TimeoutHandler::Cookie
 SystemImpl::register_timeout_handler(const std::function<void()>& callback, double duration_s)
 {
-    return _mavsdk_impl.timeout_handler.add(callback, duration_s);
+    return timeout_handler().add(callback, duration_s);
 }
 
 void SystemImpl::refresh_timeout_handler(TimeoutHandler::Cookie cookie)
 {
-    _mavsdk_impl.timeout_handler.refresh(cookie);
+    timeout_handler().refresh(cookie);
 }
 
 void SystemImpl::unregister_timeout_handler(TimeoutHandler::Cookie cookie)
 {
-    _mavsdk_impl.timeout_handler.remove(cookie);
+    timeout_handler().remove(cookie);
 }
 
 double SystemImpl::timeout_s() const
@@ -277,29 +309,39 @@ void SystemImpl::unsubscribe_is_connected(System::IsConnectedHandle handle)
 
 void SystemImpl::process_mavlink_message(mavlink_message_t& message)
 {
+    if (_io_worker) {
+        // Hand it over to our worker. Anything else queued for this system from the io
+        // thread of MavsdkImpl (e.g. libmav messages) is posted after it, so the order
+        // is kept.
+        asio::post(_io_worker->io_context(), [this, message]() {
+            _mavlink_message_handler.process_message(message);
+        });
+        return;
+    }
+
     _mavlink_message_handler.process_message(message);
 }
 
 CallEveryHandler::Cookie
 SystemImpl::add_call_every(std::function<void()> callback, float interval_s)
 {
-    return _mavsdk_impl.call_every_handler.add(
+    return call_every_handler().add(
         std::move(callback), static_cast<double>(interval_s));
 }
 
 void SystemImpl::change_call_every(float interval_s, CallEveryHandler::Cookie cookie)
 {
-    _mavsdk_impl.call_every_handler.change(static_cast<double>(interval_s), cookie);
+    call_every_handler().change(static_cast<double>(interval_s), cookie);
 }
 
 void SystemImpl::reset_call_every(CallEveryHandler::Cookie cookie)
 {
-    _mavsdk_impl.call_every_handler.reset(cookie);
+    call_every_handler().reset(cookie);
 }
 
 void SystemImpl::remove_call_every(CallEveryHandler::Cookie cookie)
 {
-    _mavsdk_impl.call_every_handler.remove(cookie);
+    call_every_handler().remove(cookie);
 }
 
 void SystemImpl::register_statustext_handler(
@@ -740,7 +782,17 @@ uint8_t SystemImpl::get_own_component_id() const
 
 asio::io_context& SystemImpl::io_context()
 {
-    return _mavsdk_impl.io_context();
+    return _io_worker ? _io_worker->io_context() : _mavsdk_impl.io_context();
+}
+
+TimeoutHandler& SystemImpl::timeout_handler()
+{
+    return _io_worker ? _io_worker->timeout_handler : _mavsdk_impl.timeout_handler;
+}
+
+CallEveryHandler& SystemImpl::call_every_handler()
+{
+    return _io_worker ? _io_worker->call_every_handler : _mavsdk_impl.call_every_handler;
 }
 
 MAV_TYPE SystemImpl::get_vehicle_type() const
@@ -1315,6 +1367,30 @@ void SystemImpl::set_msg_rate_async(
     send_command_async(command, callback);
 }
 
+void SystemImpl::send_command_batch_async(
+    std::vector<MavlinkCommandSender::CommandLong> commands,
+    const MavlinkCommandSender::BatchResultCallback& callback,
+    unsigned max_in_flight_per_target)
+{
+    {
+        std::lock_guard<std::mutex> lock(_components_mutex);
+        if (_target_address.system_id == 0 && _components.empty()) {
+            if (callback) {
+                for (std::size_t i = 0; i < commands.size(); ++i) {
+                    callback(i, MavlinkCommandSender::Result::NoSystem);
+                }
+            }
+            return;
+        }
+    }
+
+    for (auto& command : commands) {
+        command.target_system_id = get_system_id();
+    }
+
+    _command_sender.queue_command_batch_async(commands, callback, max_in_flight_per_target);
+}
+
 MavlinkCommandSender::CommandLong
 SystemImpl::make_command_msg_rate(uint16_t message_id, double rate_hz, uint8_t component_id)
 {
@@ -1373,9 +1449,9 @@ void SystemImpl::unregister_plugin(PluginImplBase* plugin_impl)
 }
 
 void SystemImpl::call_user_callback_located(
-    const std::string& filename, const int linenumber, const std::function<void()>& func)
+    const char* filename, const int linenumber, UserCallback func)
 {
-    _mavsdk_impl.call_user_callback_located(filename, linenumber, func);
+    _mavsdk_impl.call_user_callback_located(filename, linenumber, std::move(func));
 }
 
 void SystemImpl::param_changed(const std::string& name)
@@ -1465,7 +1541,7 @@ MavlinkParameterClient* SystemImpl::param_sender(uint8_t component_id, bool exte
         {std::make_unique<MavlinkParameterClient>(
              _mavsdk_impl.default_server_component_impl().sender(),
              _mavlink_message_handler,
-             _mavsdk_impl.timeout_handler,
+             timeout_handler(),
              [this]() { return timeout_s(); },
              [this]() { return effective_autopilot(); },
              get_system_id(),
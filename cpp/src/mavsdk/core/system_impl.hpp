@@ -5,6 +5,7 @@
 #include "mavlink_component_metadata.hpp"
 #include "call_every_handler.hpp"
 #include "flight_mode.hpp"
+#include "io_worker.hpp"
 #include "mavlink_address.hpp"
 #include "mavlink_include.hpp"
 #include "mavlink_parameter_client.hpp"
@@ -14,10 +15,12 @@
 #include "mavlink_mission_transfer_client.hpp"
 #include "mavlink_request_message.hpp"
 #include "mavlink_statustext_handler.hpp"
+#include "message_subscription_index.hpp"
 #include "ardupilot_custom_mode.hpp"
 #include "ping.hpp"
 #include "timeout_handler.hpp"
 #include "timesync.hpp"
+#include "user_callback.hpp"
 #include "system.hpp"
 #include "vehicle.hpp"
 #include "libmav_receiver.hpp"
@@ -25,6 +28,7 @@
 #include <asio/steady_timer.hpp>
 #include <cstdint>
 #include <functional>
+#include <map>
 #include <atomic>
 #include <vector>
 #include <unordered_set>
@@ -138,6 +142,17 @@ public:
         const CommandResultCallback& callback,
         uint8_t maybe_component_id = MAV_COMP_ID_AUTOPILOT1);
 
+    // Sends several commands at once, see MavlinkCommandSender::queue_command_batch_async.
+    void send_command_batch_async(
+        std::vector<MavlinkCommandSender::CommandLong> commands,
+        const MavlinkCommandSender::BatchResultCallback& callback,
+        unsigned max_in_flight_per_target);
+
+    const CommandLatencyStats& command_latency_stats() const
+    {
+        return _command_sender.latency_stats();
+    }
+
     // Adds unique component ids
     void add_new_component(uint8_t component_id);
     size_t total_components() const;
@@ -315,8 +330,7 @@ public:
     void register_plugin(PluginImplBase* plugin_impl);
     void unregister_plugin(PluginImplBase* plugin_impl);
 
-    void call_user_callback_located(
-        const std::string& filename, int linenumber, const std::function<void()>& func);
+    void call_user_callback_located(const char* filename, int linenumber, UserCallback func);
 
     void send_autopilot_version_request();
 
@@ -341,6 +355,9 @@ public:
     }
 
 private:
+    TimeoutHandler& timeout_handler();
+    CallEveryHandler& call_every_handler();
+
     static bool is_autopilot(uint8_t comp_id);
     static bool is_camera(uint8_t comp_id);
 
@@ -386,6 +403,11 @@ private:
 
     AutopilotTime _autopilot_time{};
 
+    // The worker this system is pinned to, or nullptr if it runs on the io_context of
+    // MavsdkImpl. Declared before everything that uses io_context() or the timeout and
+    // call-every handlers.
+    IoWorker* _io_worker;
+
     MavlinkMessageHandler _mavlink_message_handler;
 
     bool _message_debugging = false;
@@ -411,6 +433,10 @@ private:
     CallbackList<ComponentType, uint8_t> _component_discovered_id_callbacks{io_context()};
     // Libmav message handling using CallbackList for thread safety
     CallbackList<Mavsdk::MavlinkMessage> _libmav_message_callbacks{io_context()};
+    // Which message each handler asked for, so the decode interest can be released again.
+    std::mutex _libmav_subscription_keys_mutex{};
+    std::map<Handle<Mavsdk::MavlinkMessage>, MessageSubscriptionIndex::Key>
+        _libmav_subscription_keys{};
 
     asio::steady_timer _system_work_timer;
     SteadyTimePoint _last_ping_time{};
@@ -5,12 +5,10 @@
 #include <asio/buffer.hpp>
 #include <asio/connect.hpp>
 #include <asio/error.hpp>
-#include <asio/dispatch.hpp>
 #include <asio/post.hpp>
 #include <asio/write.hpp>
 
 #include <future>
-#include <memory>
 #include <sstream>
 #include <utility>
 
@@ -30,6 +28,7 @@ TcpClientConnection::TcpClientConnection(
         forwarding_option),
     _remote_ip(std::move(remote_ip)),
     _remote_port_number(remote_port),
+    _send_queue(SendQueue::Options{mavsdk_impl.get_configuration().get_send_queue_size()}),
     _socket(mavsdk_impl.io_context()),
     _reconnect_timer(mavsdk_impl.io_context())
 {}
@@ -111,36 +110,61 @@ std::pair<bool, std::string> TcpClientConnection::send_message(const mavlink_mes
 
 std::pair<bool, std::string> TcpClientConnection::send_raw_bytes(const char* bytes, size_t length)
 {
-    // Copy bytes into a heap buffer that outlives this stack frame while the
-    // posted work runs on the io_context thread.
-    auto buf = std::make_shared<std::vector<char>>(bytes, bytes + length);
-
-    std::promise<std::pair<bool, std::string>> promise;
-    auto future = promise.get_future();
-
-    // Dispatch to the io_context so the synchronous write runs on the same thread as
-    // async_connect / async_read_some — eliminating data races on socket internals.
-    // dispatch() (rather than post()) executes immediately when called from the io_context
-    // thread itself (e.g. from do_work() protocol handlers), preventing a future.get() deadlock.
-    asio::dispatch(
-        _socket.get_executor(), [this, buf = std::move(buf), p = std::move(promise)]() mutable {
-            std::lock_guard<std::mutex> lock(_send_mutex);
-            if (!_socket.is_open()) {
-                p.set_value({false, "Not connected"});
-                return;
-            }
-            asio::error_code ec;
-            asio::write(_socket, asio::buffer(*buf), ec);
-            if (ec) {
-                std::string msg = "Send failure: " + ec.message();
-                LogErr("{}", msg);
-                p.set_value({false, std::move(msg)});
-            } else {
-                p.set_value({true, {}});
-            }
-        });
+    capture_sent_bytes(bytes, length);
+
+    if (!_connected) {
+        return {false, "Not connected"};
+    }
+
+    // Only queue the bytes here. The io_context thread writes them in the
+    // background, so neither the caller nor the io_context thread has to wait
+    // for a slow peer.
+    switch (_send_queue.push(bytes, length)) {
+        case SendQueue::PushResult::Rejected:
+            return {false, "Send queue full"};
+        case SendQueue::PushResult::StartWriting:
+            asio::post(_socket.get_executor(), [this]() { do_send(); });
+            break;
+        case SendQueue::PushResult::Queued:
+            break;
+    }
+
+    return {true, {}};
+}
+
+void TcpClientConnection::do_send()
+{
+    if (_stopping) {
+        return;
+    }
 
-    return future.get();
+    // Everything queued so far goes out in one write.
+    const auto& buffers = _send_queue.begin_write();
+    if (buffers.empty()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_send_mutex);
+    if (!_socket.is_open()) {
+        _send_queue.fail_write();
+        return;
+    }
+
+    asio::async_write(_socket, buffers, [this](const asio::error_code& ec, std::size_t) {
+        if (_stopping) {
+            return;
+        }
+        if (ec) {
+            // The receive side notices the lost connection and reconnects.
+            if (ec != asio::error::operation_aborted) {
+                LogErr("Send failure: {}", ec.message());
+            }
+            _send_queue.fail_write();
+            return;
+        }
+        _send_queue.complete_write();
+        do_send();
+    });
 }
 
 void TcpClientConnection::do_connect()
@@ -161,8 +185,10 @@ void TcpClientConnection::do_connect()
         return;
     }
 
+    _connected = false;
+
     // Ensure the socket is in a clean state before connecting.
-    // Hold _send_mutex so this close() is serialised with send_raw_bytes.
+    // Hold _send_mutex so this close() is serialised with do_send().
     {
         std::lock_guard<std::mutex> lock(_send_mutex);
         if (_socket.is_open()) {
@@ -186,6 +212,7 @@ void TcpClientConnection::do_connect()
                 }
                 return;
             }
+            _connected = true;
             do_receive();
         });
 }
@@ -205,6 +232,7 @@ void TcpClientConnection::do_receive()
                 } else {
                     LogErr("TCP receive error: {}, trying to reconnect...", ec.message());
                 }
+                _connected = false;
                 {
                     std::lock_guard<std::mutex> lock(_send_mutex);
                     asio::error_code close_ec;
@@ -220,17 +248,10 @@ void TcpClientConnection::do_receive()
 
             auto parse_result = _mavlink_receiver->parse_message();
             while (parse_result != MavlinkReceiver::ParseResult::NoneAvailable) {
-                receive_message(parse_result, _mavlink_receiver->get_last_message(), this);
+                receive_frame(parse_result);
                 parse_result = _mavlink_receiver->parse_message();
             }
 
-            if (_libmav_receiver) {
-                _libmav_receiver->set_new_datagram(_recv_buffer.data(), static_cast<int>(recv_len));
-                while (_libmav_receiver->parse_message()) {
-                    receive_libmav_message(_libmav_receiver->get_last_message(), this);
-                }
-            }
-
             // Re-arm for the next chunk.
             do_receive();
         });
@@ -9,6 +9,7 @@
 #include <asio/steady_timer.hpp>
 
 #include "connection.hpp"
+#include "send_queue.hpp"
 
 namespace mavsdk {
 
@@ -27,6 +28,10 @@ public:
 
     std::pair<bool, std::string> send_message(const mavlink_message_t& message) override;
     std::pair<bool, std::string> send_raw_bytes(const char* bytes, size_t length) override;
+    std::optional<SendQueue::Stats> send_queue_stats() const override
+    {
+        return _send_queue.stats();
+    }
 
     // Non-copyable
     TcpClientConnection(const TcpClientConnection&) = delete;
@@ -36,6 +41,7 @@ private:
     void do_connect();
     void do_receive();
     void start_reconnect();
+    void do_send();
 
     std::string _remote_ip;
     int _remote_port_number;
@@ -43,9 +49,15 @@ private:
     // Set to true by stop() before cancelling/closing; prevents handlers from re-arming.
     std::atomic<bool> _stopping{false};
 
-    // Protects synchronous sends against concurrent close/reconnect on the io_thread.
+    // Set once connected, so send_raw_bytes() can refuse to queue while reconnecting.
+    std::atomic<bool> _connected{false};
+
+    // Protects starting a write against concurrent close/reconnect.
     std::mutex _send_mutex{};
 
+    // Written in the background by do_send() on the io_context thread.
+    SendQueue _send_queue;
+
     // Asio objects — driven by MavsdkImpl::_io_context.
     asio::ip::tcp::socket _socket;
     asio::steady_timer _reconnect_timer;
@@ -5,13 +5,11 @@
 #include <asio/buffer.hpp>
 #include <asio/error.hpp>
 #include <asio/ip/address.hpp>
-#include <asio/dispatch.hpp>
 #include <asio/post.hpp>
 #include <asio/socket_base.hpp>
 #include <asio/write.hpp>
 
 #include <future>
-#include <memory>
 #include <sstream>
 #include <utility>
 
@@ -31,6 +29,7 @@ TcpServerConnection::TcpServerConnection(
         forwarding_option),
     _local_ip(std::move(local_ip)),
     _local_port(local_port),
+    _send_queue(SendQueue::Options{mavsdk_impl.get_configuration().get_send_queue_size()}),
     _acceptor(mavsdk_impl.io_context()),
     _client_socket(mavsdk_impl.io_context())
 {}
@@ -150,45 +149,70 @@ std::pair<bool, std::string> TcpServerConnection::send_message(const mavlink_mes
 
 std::pair<bool, std::string> TcpServerConnection::send_raw_bytes(const char* bytes, size_t length)
 {
-    // Copy bytes into a heap buffer that outlives this stack frame while the
-    // posted work runs on the io_context thread.
-    auto buf = std::make_shared<std::vector<char>>(bytes, bytes + length);
-
-    std::promise<std::pair<bool, std::string>> promise;
-    auto future = promise.get_future();
-
-    // Dispatch to the io_context so the synchronous write runs on the same thread as
-    // async_accept / async_read_some — eliminating data races on socket internals.
-    // dispatch() (rather than post()) executes immediately when called from the io_context
-    // thread itself (e.g. from do_work() protocol handlers), preventing a future.get() deadlock.
-    asio::dispatch(
-        _acceptor.get_executor(), [this, buf = std::move(buf), p = std::move(promise)]() mutable {
-            std::lock_guard<std::mutex> lock(_send_mutex);
-            if (!_client_socket.is_open()) {
-                p.set_value({false, "Not connected"});
-                return;
-            }
-            asio::error_code ec;
-            asio::write(_client_socket, asio::buffer(*buf), ec);
-            if (ec) {
-                // Broken pipe / connection reset during shutdown are expected.
-                if (ec != asio::error::broken_pipe && ec != asio::error::connection_reset) {
-                    LogErr("Send failure: {}", ec.message());
-                }
-                p.set_value({false, "Send failure: " + ec.message()});
-            } else {
-                p.set_value({true, {}});
-            }
-        });
+    capture_sent_bytes(bytes, length);
+
+    if (!_client_connected) {
+        return {false, "Not connected"};
+    }
+
+    // Only queue the bytes here. The io_context thread writes them in the
+    // background, so neither the caller nor the io_context thread has to wait
+    // for a slow client.
+    switch (_send_queue.push(bytes, length)) {
+        case SendQueue::PushResult::Rejected:
+            return {false, "Send queue full"};
+        case SendQueue::PushResult::StartWriting:
+            asio::post(_acceptor.get_executor(), [this]() { do_send(); });
+            break;
+        case SendQueue::PushResult::Queued:
+            break;
+    }
+
+    return {true, {}};
+}
+
+void TcpServerConnection::do_send()
+{
+    if (_stopping) {
+        return;
+    }
+
+    // Everything queued so far goes out in one write.
+    const auto& buffers = _send_queue.begin_write();
+    if (buffers.empty()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_send_mutex);
+    if (!_client_socket.is_open()) {
+        _send_queue.fail_write();
+        return;
+    }
 
-    return future.get();
+    asio::async_write(_client_socket, buffers, [this](const asio::error_code& ec, std::size_t) {
+        if (_stopping) {
+            return;
+        }
+        if (ec) {
+            // Broken pipe / connection reset are expected when the client goes away,
+            // the receive side then waits for a new client.
+            if (ec != asio::error::operation_aborted && ec != asio::error::broken_pipe &&
+                ec != asio::error::connection_reset) {
+                LogErr("Send failure: {}", ec.message());
+            }
+            _send_queue.fail_write();
+            return;
+        }
+        _send_queue.complete_write();
+        do_send();
+    });
 }
 
 void TcpServerConnection::do_accept()
 {
     // Use the overload that delivers the new socket in the callback rather than
     // writing directly into _client_socket from asio internals (which would race
-    // with send_raw_bytes reading the socket's state on the work thread).
+    // with do_send() starting a write).
     _acceptor.async_accept([this](const asio::error_code& ec, asio::ip::tcp::socket peer) {
         if (ec == asio::error::operation_aborted || _stopping) {
             // stop() closed the acceptor — do not re-arm.
@@ -203,12 +227,13 @@ void TcpServerConnection::do_accept()
             return;
         }
 
-        // Assign under the mutex so stop()'s close() and our send_raw_bytes are
+        // Assign under the mutex so stop()'s close() and do_send() are
         // properly serialised against this assignment.
         {
             std::lock_guard<std::mutex> lock(_send_mutex);
             _client_socket = std::move(peer);
         }
+        _client_connected = true;
 
         // Start receiving from the newly accepted client.
         do_receive();
@@ -230,6 +255,7 @@ void TcpServerConnection::do_receive()
                 } else {
                     LogErr("TCP receive error: {}", ec.message());
                 }
+                _client_connected = false;
                 {
                     std::lock_guard<std::mutex> lock(_send_mutex);
                     asio::error_code close_ec;
@@ -246,17 +272,10 @@ void TcpServerConnection::do_receive()
 
             auto parse_result = _mavlink_receiver->parse_message();
             while (parse_result != MavlinkReceiver::ParseResult::NoneAvailable) {
-                receive_message(parse_result, _mavlink_receiver->get_last_message(), this);
+                receive_frame(parse_result);
                 parse_result = _mavlink_receiver->parse_message();
             }
 
-            if (_libmav_receiver) {
-                _libmav_receiver->set_new_datagram(_recv_buffer.data(), static_cast<int>(recv_len));
-                while (_libmav_receiver->parse_message()) {
-                    receive_libmav_message(_libmav_receiver->get_last_message(), this);
-                }
-            }
-
             // Re-arm for the next chunk.
             do_receive();
         });
@@ -8,6 +8,7 @@
 #include <asio/ip/tcp.hpp>
 
 #include "connection.hpp"
+#include "send_queue.hpp"
 
 namespace mavsdk {
 
@@ -26,10 +27,15 @@ public:
     ConnectionResult stop() override;
     std::pair<bool, std::string> send_message(const mavlink_message_t& message) override;
     std::pair<bool, std::string> send_raw_bytes(const char* bytes, size_t length) override;
+    std::optional<SendQueue::Stats> send_queue_stats() const override
+    {
+        return _send_queue.stats();
+    }
 
 private:
     void do_accept();
     void do_receive();
+    void do_send();
 
     std::string _local_ip;
     int _local_port;
@@ -37,9 +43,15 @@ private:
     // Set to true by stop() before closing sockets; prevents handlers from re-arming.
     std::atomic<bool> _stopping{false};
 
-    // Protects synchronous sends against concurrent close on the io_thread.
+    // Set while a client is connected, so send_raw_bytes() can refuse to queue otherwise.
+    std::atomic<bool> _client_connected{false};
+
+    // Protects starting a write against concurrent close on the io_thread.
     std::mutex _send_mutex{};
 
+    // Written in the background by do_send() on the io_context thread.
+    SendQueue _send_queue;
+
     // Asio objects — driven by MavsdkImpl::_io_context.
     asio::ip::tcp::acceptor _acceptor;
     asio::ip::tcp::socket _client_socket;
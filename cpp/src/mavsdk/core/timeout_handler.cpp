@@ -1,5 +1,4 @@
 #include "timeout_handler.hpp"
-#include <algorithm>
 #include <vector>
 
 namespace mavsdk {
@@ -8,73 +7,52 @@ TimeoutHandler::TimeoutHandler(Time& time) : _time(time) {}
 
 TimeoutHandler::Cookie TimeoutHandler::add(std::function<void()> callback, double duration_s)
 {
-    std::lock_guard<std::recursive_mutex> lock(_timeouts_mutex);
-    auto new_timeout = Timeout{};
-    new_timeout.callback = std::move(callback);
-    new_timeout.time = _time.steady_time_in_future(duration_s);
-    new_timeout.duration_s = duration_s;
-    new_timeout.cookie = _next_cookie++;
-    _timeouts.push_back(new_timeout);
+    Cookie cookie;
+    bool is_earliest;
+    {
+        std::lock_guard<std::recursive_mutex> lock(_timeouts_mutex);
+        const auto deadline = _time.steady_time_in_future(duration_s);
+        is_earliest = _timeouts.empty() || deadline < _timeouts.top().deadline;
+        cookie = _next_cookie++;
+        _timeouts.push(deadline, cookie, Timeout{std::move(callback), duration_s});
+    }
+
+    if (is_earliest && _earlier_deadline_callback) {
+        _earlier_deadline_callback();
+    }
 
-    return new_timeout.cookie;
+    return cookie;
 }
 
 void TimeoutHandler::refresh(Cookie cookie)
 {
     std::lock_guard<std::recursive_mutex> lock(_timeouts_mutex);
 
-    auto it = std::find_if(_timeouts.begin(), _timeouts.end(), [&](const Timeout& timeout) {
-        return timeout.cookie == cookie;
-    });
-    if (it != _timeouts.end()) {
-        auto future_time = _time.steady_time_in_future(it->duration_s);
-        it->time = future_time;
+    // Refreshing only ever moves a deadline later, so nobody needs to be woken up.
+    if (auto* timeout = _timeouts.find(cookie)) {
+        _timeouts.update(cookie, _time.steady_time_in_future(timeout->duration_s));
     }
 }
 
 void TimeoutHandler::remove(Cookie cookie)
 {
     std::lock_guard<std::recursive_mutex> lock(_timeouts_mutex);
-
-    auto it = std::find_if(_timeouts.begin(), _timeouts.end(), [&](auto& timeout) {
-        return timeout.cookie == cookie;
-    });
-
-    if (it != _timeouts.end()) {
-        _timeouts.erase(it);
-    }
+    _timeouts.remove(cookie);
 }
 
 void TimeoutHandler::run_once()
 {
-    // First, identify all timeouts that need to be executed and remove them
-    // while holding the lock
+    // First, take all timeouts that are due out of the heap while holding the lock.
     std::vector<std::function<void()>> callbacks_to_execute;
 
     {
         std::lock_guard<std::recursive_mutex> lock(_timeouts_mutex);
         auto now = _time.steady_time();
 
-        // Identify timeouts that need to be executed
-        std::vector<Cookie> cookies_to_remove;
-
-        for (const auto& timeout : _timeouts) {
-            if (timeout.time < now) {
-                if (timeout.callback) {
-                    callbacks_to_execute.push_back(timeout.callback);
-                }
-                cookies_to_remove.push_back(timeout.cookie);
-            }
-        }
-
-        // Remove all timeouts that need to be executed
-        for (const auto& cookie : cookies_to_remove) {
-            auto it = std::find_if(_timeouts.begin(), _timeouts.end(), [&](auto& timeout) {
-                return timeout.cookie == cookie;
-            });
-
-            if (it != _timeouts.end()) {
-                _timeouts.erase(it);
+        while (!_timeouts.empty() && _timeouts.top().deadline < now) {
+            auto timeout = _timeouts.pop();
+            if (timeout.value.callback) {
+                callbacks_to_execute.push_back(std::move(timeout.value.callback));
             }
         }
     }
@@ -85,4 +63,18 @@ void TimeoutHandler::run_once()
     }
 }
 
+std::optional<SteadyTimePoint> TimeoutHandler::next_deadline()
+{
+    std::lock_guard<std::recursive_mutex> lock(_timeouts_mutex);
+    if (_timeouts.empty()) {
+        return std::nullopt;
+    }
+    return _timeouts.top().deadline;
+}
+
+void TimeoutHandler::set_earlier_deadline_callback(std::function<void()> callback)
+{
+    _earlier_deadline_callback = std::move(callback);
+}
+
 } // namespace mavsdk
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "deadline_heap.hpp"
 #include "mavsdk_time.hpp"
 #include "mavsdk_export.h"
 
@@ -7,7 +8,7 @@
 #include <mutex>
 #include <memory>
 #include <functional>
-#include <list>
+#include <optional>
 
 namespace mavsdk {
 
@@ -30,16 +31,24 @@ public:
 
     void run_once();
 
+    // When run_once() next has something to do, if any timeout is pending.
+    std::optional<SteadyTimePoint> next_deadline();
+
+    // Called whenever a timeout is added that is due before all others, so
+    // that whoever sleeps until next_deadline() can wake up earlier. It is
+    // called without holding any lock and must be set before the handler is
+    // shared between threads.
+    void set_earlier_deadline_callback(std::function<void()> callback);
+
 private:
     struct Timeout {
         std::function<void()> callback{};
-        SteadyTimePoint time{};
         double duration_s{0.0};
-        Cookie cookie{0};
     };
 
-    std::list<Timeout> _timeouts{};
+    DeadlineHeap<Cookie, Timeout> _timeouts{};
     std::recursive_mutex _timeouts_mutex{};
+    std::function<void()> _earlier_deadline_callback{};
 
     Time& _time;
 
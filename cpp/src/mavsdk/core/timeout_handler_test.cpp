@@ -1,6 +1,7 @@
 #include "timeout_handler.hpp"
 #include "unused.hpp"
 #include <gtest/gtest.h>
+#include <vector>
 
 #ifdef FAKE_TIME
 #define Time FakeTime
@@ -200,3 +201,62 @@ TEST(TimeoutHandler, RefreshAfterFireDoesNotResurrect)
     th.run_once();
     EXPECT_EQ(fires, 1);
 }
+
+TEST(TimeoutHandler, NextDeadline)
+{
+    Time time{};
+    TimeoutHandler th(time);
+
+    int earlier_deadlines = 0;
+    th.set_earlier_deadline_callback([&earlier_deadlines]() { ++earlier_deadlines; });
+
+    EXPECT_FALSE(th.next_deadline());
+
+    auto cookie1 = th.add([]() {}, 0.5);
+    EXPECT_EQ(earlier_deadlines, 1);
+    const auto deadline1 = th.next_deadline();
+    ASSERT_TRUE(deadline1);
+
+    // Later than the first one: nobody needs to wake up earlier.
+    auto cookie2 = th.add([]() {}, 1.0);
+    EXPECT_EQ(earlier_deadlines, 1);
+    EXPECT_EQ(th.next_deadline(), deadline1);
+
+    auto cookie3 = th.add([]() {}, 0.1);
+    EXPECT_EQ(earlier_deadlines, 2);
+    EXPECT_LT(*th.next_deadline(), *deadline1);
+
+    th.remove(cookie3);
+    EXPECT_EQ(th.next_deadline(), deadline1);
+
+    // Refreshing moves the first one behind the second one.
+    time.sleep_for(std::chrono::milliseconds(600));
+    th.refresh(cookie1);
+    EXPECT_GT(*th.next_deadline(), *deadline1);
+
+    th.remove(cookie1);
+    th.remove(cookie2);
+    EXPECT_FALSE(th.next_deadline());
+}
+
+TEST(TimeoutHandler, FiresInDeadlineOrder)
+{
+    Time time{};
+    TimeoutHandler th(time);
+
+    std::vector<int> fired;
+    auto cookie1 = th.add([&fired]() { fired.push_back(3); }, 0.3);
+    auto cookie2 = th.add([&fired]() { fired.push_back(1); }, 0.1);
+    auto cookie3 = th.add([&fired]() { fired.push_back(2); }, 0.2);
+    auto cookie4 = th.add([&fired]() { fired.push_back(4); }, 10.0);
+
+    time.sleep_for(std::chrono::milliseconds(500));
+    th.run_once();
+    EXPECT_EQ(fired, (std::vector<int>{1, 2, 3}));
+    EXPECT_TRUE(th.next_deadline());
+
+    UNUSED(cookie1);
+    UNUSED(cookie2);
+    UNUSED(cookie3);
+    UNUSED(cookie4);
+}
@@ -0,0 +1,73 @@
+#include "tlog_reader.hpp"
+
+namespace mavsdk {
+
+namespace {
+
+constexpr std::size_t timestamp_len = 8;
+
+// See https://mavlink.io/en/guide/serialization.html
+constexpr uint8_t stx_v1 = 0xFE;
+constexpr uint8_t stx_v2 = 0xFD;
+constexpr std::size_t header_len_v1 = 6;
+constexpr std::size_t header_len_v2 = 10;
+constexpr std::size_t checksum_len = 2;
+constexpr std::size_t signature_len = 13;
+constexpr uint8_t incompat_flag_signed = 0x01;
+
+} // namespace
+
+TlogReader::TlogReader(const uint8_t* data, std::size_t size) : _data(data), _size(size) {}
+
+bool TlogReader::next(Record& record)
+{
+    if (_failed || _offset == _size) {
+        return false;
+    }
+
+    const std::size_t remaining = _size - _offset;
+    // Timestamp, start byte and payload length are needed to know the record length.
+    if (remaining < timestamp_len + 2) {
+        _failed = true;
+        return false;
+    }
+
+    const uint8_t* timestamp = _data + _offset;
+    const uint8_t* frame = timestamp + timestamp_len;
+    const std::size_t payload_len = frame[1];
+
+    std::size_t frame_len = 0;
+    if (frame[0] == stx_v1) {
+        frame_len = header_len_v1 + payload_len + checksum_len;
+    } else if (frame[0] == stx_v2) {
+        if (remaining < timestamp_len + 3) {
+            _failed = true;
+            return false;
+        }
+        frame_len = header_len_v2 + payload_len + checksum_len;
+        if ((frame[2] & incompat_flag_signed) != 0) {
+            frame_len += signature_len;
+        }
+    } else {
+        _failed = true;
+        return false;
+    }
+
+    if (remaining < timestamp_len + frame_len) {
+        // Truncated, e.g. because the recording did not end cleanly.
+        _failed = true;
+        return false;
+    }
+
+    record.timestamp_us = 0;
+    for (std::size_t i = 0; i < timestamp_len; ++i) {
+        record.timestamp_us = (record.timestamp_us << 8) | timestamp[i];
+    }
+    record.frame = frame;
+    record.frame_len = frame_len;
+
+    _offset += timestamp_len + frame_len;
+    return true;
+}
+
+} // namespace mavsdk
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "mavsdk_export.h"
+
+namespace mavsdk {
+
+/*
+ * Iterates over the records of a .tlog in memory.
+ *
+ * Each record is an 8-byte big-endian microsecond timestamp followed by a
+ * MAVLink v1 or v2 frame. The frame length is taken from the frame header,
+ * the frame itself is not checked.
+ */
+class MAVSDK_TEST_EXPORT TlogReader {
+public:
+    struct Record {
+        uint64_t timestamp_us{0};
+        const uint8_t* frame{nullptr};
+        std::size_t frame_len{0};
+    };
+
+    TlogReader(const uint8_t* data, std::size_t size);
+
+    // Returns false at the end, or if the rest of the data is not a valid
+    // record, in which case failed() is true.
+    bool next(Record& record);
+
+    bool failed() const { return _failed; }
+    std::size_t offset() const { return _offset; }
+
+private:
+    const uint8_t* _data;
+    std::size_t _size;
+    std::size_t _offset{0};
+    bool _failed{false};
+};
+
+} // namespace mavsdk
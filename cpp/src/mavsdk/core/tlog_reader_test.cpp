@@ -0,0 +1,143 @@
+#include "tlog_reader.hpp"
+#include "mapped_file.hpp"
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace mavsdk;
+
+namespace {
+
+void append_timestamp(std::vector<uint8_t>& tlog, uint64_t timestamp_us)
+{
+    for (int i = 7; i >= 0; --i) {
+        tlog.push_back(static_cast<uint8_t>(timestamp_us >> (8 * i)));
+    }
+}
+
+// Only the header fields needed to get the length are set, the rest is filler.
+std::vector<uint8_t> frame_v1(uint8_t payload_len)
+{
+    std::vector<uint8_t> frame{0xFE, payload_len};
+    frame.resize(6 + payload_len + 2, 0x11);
+    return frame;
+}
+
+std::vector<uint8_t> frame_v2(uint8_t payload_len, bool is_signed)
+{
+    std::vector<uint8_t> frame{0xFD, payload_len, static_cast<uint8_t>(is_signed ? 0x01 : 0x00)};
+    frame.resize(10 + payload_len + 2 + (is_signed ? 13 : 0), 0x22);
+    return frame;
+}
+
+void append_record(std::vector<uint8_t>& tlog, uint64_t timestamp_us, std::vector<uint8_t> frame)
+{
+    append_timestamp(tlog, timestamp_us);
+    tlog.insert(tlog.end(), frame.begin(), frame.end());
+}
+
+} // namespace
+
+TEST(TlogReader, ReadsRecords)
+{
+    std::vector<uint8_t> tlog;
+    append_record(tlog, 0x0102030405060708, frame_v1(9));
+    append_record(tlog, 2000, frame_v2(0, false));
+    append_record(tlog, 3000, frame_v2(255, true));
+
+    TlogReader reader(tlog.data(), tlog.size());
+    TlogReader::Record record;
+
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_EQ(record.timestamp_us, 0x0102030405060708u);
+    EXPECT_EQ(record.frame, tlog.data() + 8);
+    EXPECT_EQ(record.frame_len, frame_v1(9).size());
+
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_EQ(record.timestamp_us, 2000u);
+    EXPECT_EQ(record.frame_len, frame_v2(0, false).size());
+
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_EQ(record.timestamp_us, 3000u);
+    EXPECT_EQ(record.frame_len, frame_v2(255, true).size());
+
+    EXPECT_FALSE(reader.next(record));
+    EXPECT_FALSE(reader.failed());
+    EXPECT_EQ(reader.offset(), tlog.size());
+}
+
+TEST(TlogReader, Empty)
+{
+    TlogReader reader(nullptr, 0);
+    TlogReader::Record record;
+    EXPECT_FALSE(reader.next(record));
+    EXPECT_FALSE(reader.failed());
+}
+
+TEST(TlogReader, StopsAtTruncatedRecord)
+{
+    std::vector<uint8_t> tlog;
+    append_record(tlog, 1000, frame_v2(20, false));
+    append_record(tlog, 2000, frame_v2(20, false));
+    tlog.resize(tlog.size() - 1);
+
+    TlogReader reader(tlog.data(), tlog.size());
+    TlogReader::Record record;
+    EXPECT_TRUE(reader.next(record));
+    EXPECT_FALSE(reader.next(record));
+    EXPECT_TRUE(reader.failed());
+}
+
+TEST(TlogReader, StopsAtInvalidStartByte)
+{
+    std::vector<uint8_t> tlog;
+    append_record(tlog, 1000, frame_v1(4));
+    append_timestamp(tlog, 2000);
+    tlog.insert(tlog.end(), {0x55, 0x04, 0x00, 0x00});
+
+    TlogReader reader(tlog.data(), tlog.size());
+    TlogReader::Record record;
+    EXPECT_TRUE(reader.next(record));
+    EXPECT_FALSE(reader.next(record));
+    EXPECT_TRUE(reader.failed());
+}
+
+TEST(TlogReader, ReadsMappedFile)
+{
+    std::vector<uint8_t> tlog;
+    append_record(tlog, 1000, frame_v1(4));
+    append_record(tlog, 2000, frame_v2(8, false));
+
+    const auto path = testing::TempDir() + "tlog_reader_mapped.tlog";
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(
+            reinterpret_cast<const char*>(tlog.data()), static_cast<std::streamsize>(tlog.size()));
+    }
+
+    MappedFile mapped_file;
+    ASSERT_TRUE(mapped_file.open(path));
+    ASSERT_EQ(mapped_file.size(), tlog.size());
+
+    TlogReader reader(mapped_file.data(), mapped_file.size());
+    TlogReader::Record record;
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_EQ(record.timestamp_us, 1000u);
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_EQ(record.timestamp_us, 2000u);
+    EXPECT_EQ(
+        std::vector<uint8_t>(record.frame, record.frame + record.frame_len), frame_v2(8, false));
+    EXPECT_FALSE(reader.next(record));
+
+    mapped_file.close();
+    std::remove(path.c_str());
+}
+
+TEST(TlogReader, MappedFileMissing)
+{
+    MappedFile mapped_file;
+    EXPECT_FALSE(mapped_file.open("/nonexistent-directory/file.tlog"));
+}
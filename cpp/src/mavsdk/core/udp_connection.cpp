@@ -9,6 +9,8 @@
 #include <asio/socket_base.hpp>
 
 #include <algorithm>
+#include <cerrno>
+#include <cstring>
 #include <future>
 #include <utility>
 #include <sstream>
@@ -29,8 +31,16 @@ UdpConnection::UdpConnection(
         forwarding_option),
     _local_ip(std::move(local_ip)),
     _local_port_number(local_port_number),
-    _socket(mavsdk_impl.io_context())
-{}
+    _socket(mavsdk_impl.io_context()),
+    _aggregation_timer(mavsdk_impl.io_context())
+{
+#if defined(LINUX)
+    for (unsigned i = 0; i < RECV_BATCH_SIZE; ++i) {
+        _recv_iovecs[i].iov_base = _recv_buffers[i].data();
+        _recv_iovecs[i].iov_len = _recv_buffers[i].size();
+    }
+#endif
+}
 
 UdpConnection::~UdpConnection()
 {
@@ -104,9 +114,13 @@ ConnectionResult UdpConnection::stop()
             // the socket's internal state.
             std::promise<void> close_done;
             asio::post(io_ctx, [this, &close_done]() {
-                // send_raw_bytes() calls _socket.send_to() synchronously on a caller
+                // Send what is still waiting to be aggregated.
+                _aggregation_timer.cancel();
+                flush_aggregated();
+
+                // send_raw_bytes() sends synchronously on a caller
                 // thread while holding _remote_mutex, so take it here too: closing the
-                // socket concurrently with an in-flight send_to is a data race.
+                // socket concurrently with an in-flight send is a data race.
                 std::lock_guard<std::mutex> lock(_remote_mutex);
                 asio::error_code ec;
                 _socket.close(ec);
@@ -147,6 +161,17 @@ std::pair<bool, std::string> UdpConnection::send_message(const mavlink_message_t
 }
 
 std::pair<bool, std::string> UdpConnection::send_raw_bytes(const char* bytes, size_t length)
+{
+    capture_sent_bytes(bytes, length);
+
+    if (_aggregation_window.count() > 0) {
+        return aggregate(bytes, length);
+    }
+
+    return send_datagram(bytes, length);
+}
+
+std::pair<bool, std::string> UdpConnection::send_datagram(const char* bytes, size_t length)
 {
     std::pair<bool, std::string> result;
 
@@ -159,14 +184,17 @@ std::pair<bool, std::string> UdpConnection::send_raw_bytes(const char* bytes, si
         std::remove_if(
             _remotes.begin(),
             _remotes.end(),
-            [&now, this](const Remote& remote) {
+            [&now](const Remote& remote) {
                 const auto elapsed = now - remote.last_activity;
                 const bool inactive = elapsed > REMOTE_TIMEOUT;
 
                 const bool should_remove = inactive && remote.remote_option == RemoteOption::Found;
 
                 if (should_remove) {
-                    LogInfo("Removing inactive remote: {}:{}", remote.ip, remote.port_number);
+                    LogInfo(
+                        "Removing inactive remote: {}:{}",
+                        remote.endpoint.address().to_string(),
+                        remote.endpoint.port());
                 }
 
                 return should_remove;
@@ -182,26 +210,12 @@ std::pair<bool, std::string> UdpConnection::send_raw_bytes(const char* bytes, si
     // Send the raw bytes to all the remotes synchronously.
     result.first = true;
 
+#if defined(LINUX)
+    send_to_remotes(bytes, length, result);
+#else
     for (auto& remote : _remotes) {
         asio::error_code ec;
-        asio::ip::address dest_addr = asio::ip::make_address(remote.ip, ec);
-        if (ec) {
-            std::stringstream ss;
-            ss << "make_address failure for: " << remote.ip << ":" << remote.port_number << ": "
-               << ec.message();
-            LogErr("{}", ss.str());
-            result.first = false;
-            if (!result.second.empty()) {
-                result.second += ", ";
-            }
-            result.second += ss.str();
-            continue;
-        }
-
-        asio::ip::udp::endpoint dest_endpoint(
-            dest_addr, static_cast<unsigned short>(remote.port_number));
-
-        const auto send_len = _socket.send_to(asio::buffer(bytes, length), dest_endpoint, 0, ec);
+        const auto send_len = _socket.send_to(asio::buffer(bytes, length), remote.endpoint, 0, ec);
 
         if (ec || send_len != length) {
             std::stringstream ss;
@@ -209,7 +223,8 @@ std::pair<bool, std::string> UdpConnection::send_raw_bytes(const char* bytes, si
             if (ec) {
                 ss << ": " << ec.message();
             }
-            ss << " for: " << remote.ip << ":" << remote.port_number;
+            ss << " for: " << remote.endpoint.address().to_string() << ":"
+               << remote.endpoint.port();
             LogErr("{}", ss.str());
             result.first = false;
             if (!result.second.empty()) {
@@ -219,47 +234,228 @@ std::pair<bool, std::string> UdpConnection::send_raw_bytes(const char* bytes, si
             continue;
         }
     }
+#endif
+
+    return result;
+}
+
+#if defined(LINUX)
+void UdpConnection::send_to_remotes(
+    const char* bytes, size_t length, std::pair<bool, std::string>& result)
+{
+    // All remotes get the same datagram, sent with one sendmmsg() syscall.
+    iovec iov{const_cast<char*>(bytes), length};
+
+    _send_messages.resize(_remotes.size());
+    for (std::size_t i = 0; i < _remotes.size(); ++i) {
+        auto& header = _send_messages[i].msg_hdr;
+        header = {};
+        header.msg_name = _remotes[i].endpoint.data();
+        header.msg_namelen = static_cast<socklen_t>(_remotes[i].endpoint.size());
+        header.msg_iov = &iov;
+        header.msg_iovlen = 1;
+    }
+
+    std::size_t next = 0;
+    while (next < _send_messages.size()) {
+        const int sent = sendmmsg(
+            _socket.native_handle(),
+            &_send_messages[next],
+            static_cast<unsigned>(_send_messages.size() - next),
+            0);
+
+        if (sent > 0) {
+            next += static_cast<std::size_t>(sent);
+            continue;
+        }
+
+        // Sending to this remote failed, carry on with the next one.
+        const auto& endpoint = _remotes[next].endpoint;
+        std::stringstream ss;
+        ss << "sendmmsg failure: " << strerror(errno)
+           << " for: " << endpoint.address().to_string() << ":" << endpoint.port();
+        LogErr("{}", ss.str());
+        result.first = false;
+        if (!result.second.empty()) {
+            result.second += ", ";
+        }
+        result.second += ss.str();
+        ++next;
+    }
+}
+#endif
+
+void UdpConnection::enable_send_aggregation(std::chrono::microseconds window)
+{
+    _aggregation_window = window;
+}
+
+std::pair<bool, std::string> UdpConnection::aggregate(const char* bytes, size_t length)
+{
+    {
+        std::lock_guard<std::mutex> lock(_remote_mutex);
+        if (_remotes.empty()) {
+            return {false, "no remotes"};
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_aggregation_mutex);
+
+    std::pair<bool, std::string> result{true, {}};
+
+    if (length > _aggregation_buffer.size()) {
+        return send_datagram(bytes, length);
+    }
+
+    if (_aggregation_len + length > _aggregation_buffer.size()) {
+        // The datagram is full, so don't wait for the window to pass.
+        result = send_datagram(_aggregation_buffer.data(), _aggregation_len);
+        _aggregation_len = 0;
+    }
+
+    std::memcpy(_aggregation_buffer.data() + _aggregation_len, bytes, length);
+    _aggregation_len += length;
+
+    // The window starts with the first frame, the timer is only used on the io_context thread.
+    if (!_aggregation_timer_armed) {
+        _aggregation_timer_armed = true;
+        asio::post(_socket.get_executor(), [this]() { start_aggregation_timer(); });
+    }
 
     return result;
 }
 
+void UdpConnection::start_aggregation_timer()
+{
+    _aggregation_timer.expires_after(_aggregation_window);
+    _aggregation_timer.async_wait([this](const asio::error_code& ec) {
+        if (ec == asio::error::operation_aborted) {
+            return;
+        }
+        flush_aggregated();
+    });
+}
+
+void UdpConnection::flush_aggregated()
+{
+    std::lock_guard<std::mutex> lock(_aggregation_mutex);
+
+    _aggregation_timer_armed = false;
+
+    if (_aggregation_len == 0) {
+        return;
+    }
+
+    // Errors are logged by send_datagram, there is no caller left to report them to.
+    send_datagram(_aggregation_buffer.data(), _aggregation_len);
+    _aggregation_len = 0;
+}
+
 void UdpConnection::add_remote_to_keep(const std::string& remote_ip, const int remote_port)
 {
-    add_remote_impl(remote_ip, remote_port, 0, RemoteOption::Fixed);
+    asio::error_code ec;
+    const asio::ip::address address = asio::ip::make_address(remote_ip, ec);
+    if (ec) {
+        LogErr("Invalid remote IP '{}': {}", remote_ip, ec.message());
+        return;
+    }
+
+    add_remote_impl(
+        asio::ip::udp::endpoint(address, static_cast<unsigned short>(remote_port)),
+        0,
+        RemoteOption::Fixed);
 }
 
 void UdpConnection::add_remote_impl(
-    const std::string& remote_ip,
-    const int remote_port,
+    const asio::ip::udp::endpoint& endpoint,
     const uint8_t remote_sysid,
     RemoteOption remote_option)
 {
     std::lock_guard<std::mutex> lock(_remote_mutex);
-    Remote new_remote;
-    new_remote.ip = remote_ip;
-    new_remote.port_number = remote_port;
-    new_remote.last_activity = std::chrono::steady_clock::now();
-    new_remote.remote_option = remote_option;
-
-    auto existing_remote =
-        std::find_if(_remotes.begin(), _remotes.end(), [&new_remote](Remote& remote) {
-            return remote == new_remote;
+
+    auto existing_remote = std::find_if(
+        _remotes.begin(), _remotes.end(), [&endpoint](const Remote& remote) {
+            return remote.endpoint == endpoint;
         });
 
     if (existing_remote == _remotes.end()) {
         if (static_cast<int>(remote_sysid) != 0) {
             LogInfo(
                 "New system on: {}:{} (system ID: {})",
-                new_remote.ip,
-                new_remote.port_number,
+                endpoint.address().to_string(),
+                endpoint.port(),
                 static_cast<int>(remote_sysid));
         }
+        Remote new_remote;
+        new_remote.endpoint = endpoint;
+        new_remote.last_activity = std::chrono::steady_clock::now();
+        new_remote.remote_option = remote_option;
         _remotes.push_back(new_remote);
     } else {
         existing_remote->last_activity = std::chrono::steady_clock::now();
     }
 }
 
+#if defined(LINUX)
+void UdpConnection::do_receive()
+{
+    // Wait until the socket is readable, then read everything that is there
+    // with recvmmsg(). The handler runs on the dedicated io_context thread (_io_thread).
+    _socket.async_wait(asio::socket_base::wait_read, [this](const asio::error_code& ec) {
+        if (ec) {
+            // operation_aborted happens when the socket is closed (stop()), which is normal.
+            if (ec != asio::error::operation_aborted) {
+                LogErr("Error from async_wait: {}", ec.message());
+            }
+            // Do NOT re-post — the connection is being torn down.
+            return;
+        }
+
+        receive_batch();
+
+        // Re-post for the next datagrams.
+        do_receive();
+    });
+}
+
+void UdpConnection::receive_batch()
+{
+    for (unsigned i = 0; i < RECV_BATCH_SIZE; ++i) {
+        auto& header = _recv_messages[i].msg_hdr;
+        header = {};
+        header.msg_name = &_recv_addresses[i];
+        header.msg_namelen = sizeof(_recv_addresses[i]);
+        header.msg_iov = &_recv_iovecs[i];
+        header.msg_iovlen = 1;
+    }
+
+    const int received = recvmmsg(
+        _socket.native_handle(), _recv_messages.data(), RECV_BATCH_SIZE, MSG_DONTWAIT, nullptr);
+
+    if (received < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            LogErr("Error from recvmmsg: {}", strerror(errno));
+        }
+        return;
+    }
+
+    for (int i = 0; i < received; ++i) {
+        const auto& header = _recv_messages[i].msg_hdr;
+
+        asio::ip::udp::endpoint sender;
+        if (header.msg_namelen > sender.capacity()) {
+            continue;
+        }
+        std::memcpy(sender.data(), header.msg_name, header.msg_namelen);
+        sender.resize(header.msg_namelen);
+
+        receive_datagram(
+            sender,
+            reinterpret_cast<char*>(_recv_buffers[i].data()),
+            _recv_messages[i].msg_len);
+    }
+}
+#else
 void UdpConnection::do_receive()
 {
     // Post an async receive. The handler runs on the dedicated io_context thread (_io_thread).
@@ -276,45 +472,40 @@ void UdpConnection::do_receive()
                 return;
             }
 
-            if (recv_len == 0) {
-                // Empty datagram — re-post and continue.
-                do_receive();
-                return;
-            }
-
-            char* buffer = reinterpret_cast<char*>(_recv_buffer.data());
-
-            _mavlink_receiver->set_new_datagram(buffer, static_cast<int>(recv_len));
-
-            // Parse all mavlink messages in one datagram.
-            auto parse_result = _mavlink_receiver->parse_message();
-            while (parse_result != MavlinkReceiver::ParseResult::NoneAvailable) {
-                if (parse_result == MavlinkReceiver::ParseResult::MessageParsed) {
-                    const uint8_t sysid = _mavlink_receiver->get_last_message().sysid;
-                    if (sysid != 0) {
-                        add_remote_impl(
-                            _sender_endpoint.address().to_string(),
-                            static_cast<int>(_sender_endpoint.port()),
-                            sysid,
-                            RemoteOption::Found);
-                    }
-                }
-                receive_message(parse_result, _mavlink_receiver->get_last_message(), this);
-                parse_result = _mavlink_receiver->parse_message();
-            }
-
-            // Also parse with libmav if available
-            if (_libmav_receiver) {
-                _libmav_receiver->set_new_datagram(buffer, static_cast<int>(recv_len));
-
-                while (_libmav_receiver->parse_message()) {
-                    receive_libmav_message(_libmav_receiver->get_last_message(), this);
-                }
-            }
+            receive_datagram(
+                _sender_endpoint, reinterpret_cast<char*>(_recv_buffer.data()), recv_len);
 
             // Re-post for the next datagram.
             do_receive();
         });
 }
+#endif
+
+void UdpConnection::receive_datagram(
+    const asio::ip::udp::endpoint& sender, char* buffer, std::size_t len)
+{
+    if (len == 0) {
+        // Empty datagram, nothing to do.
+        return;
+    }
+
+    _mavlink_receiver->set_new_datagram(buffer, static_cast<int>(len));
+
+    // Parse all mavlink messages in one datagram.
+    bool remote_seen = false;
+    auto parse_result = _mavlink_receiver->parse_message();
+    while (parse_result != MavlinkReceiver::ParseResult::NoneAvailable) {
+        if (!remote_seen && parse_result == MavlinkReceiver::ParseResult::MessageParsed) {
+            // Refreshing the remote once per datagram is enough.
+            const uint8_t sysid = _mavlink_receiver->get_last_message().sysid;
+            if (sysid != 0) {
+                add_remote_impl(sender, sysid, RemoteOption::Found);
+                remote_seen = true;
+            }
+        }
+        receive_frame(parse_result);
+        parse_result = _mavlink_receiver->parse_message();
+    }
+}
 
 } // namespace mavsdk
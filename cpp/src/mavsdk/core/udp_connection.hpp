@@ -8,6 +8,12 @@
 #include <chrono>
 
 #include <asio/ip/udp.hpp>
+#include <asio/steady_timer.hpp>
+
+#if defined(LINUX)
+#include <sys/socket.h>
+#include <sys/uio.h>
+#endif
 
 #include "connection.hpp"
 
@@ -31,6 +37,10 @@ public:
 
     void add_remote_to_keep(const std::string& remote_ip, int remote_port);
 
+    // Pack frames sent within the window into one datagram, instead of sending a
+    // datagram per frame. To be called before start().
+    void enable_send_aggregation(std::chrono::microseconds window);
+
     // Non-copyable
     UdpConnection(const UdpConnection&) = delete;
     const UdpConnection& operator=(const UdpConnection&) = delete;
@@ -38,6 +48,17 @@ public:
 private:
     ConnectionResult setup_port();
     void do_receive();
+    void receive_datagram(const asio::ip::udp::endpoint& sender, char* buffer, std::size_t len);
+    std::pair<bool, std::string> send_datagram(const char* bytes, size_t length);
+
+    std::pair<bool, std::string> aggregate(const char* bytes, size_t length);
+    void start_aggregation_timer();
+    void flush_aggregated();
+
+#if defined(LINUX)
+    void receive_batch();
+    void send_to_remotes(const char* bytes, size_t length, std::pair<bool, std::string>& result);
+#endif
 
     enum class RemoteOption {
         Fixed,
@@ -45,32 +66,49 @@ private:
     };
 
     void add_remote_impl(
-        const std::string& remote_ip,
-        int remote_port,
-        uint8_t remote_sysid,
-        RemoteOption remote_option);
+        const asio::ip::udp::endpoint& endpoint, uint8_t remote_sysid, RemoteOption remote_option);
 
     std::string _local_ip;
     int _local_port_number;
 
     std::mutex _remote_mutex{};
     struct Remote {
-        std::string ip{};
-        int port_number{0};
+        // Resolved once when the remote is added, the textual form is only needed for logging.
+        asio::ip::udp::endpoint endpoint{};
         std::chrono::steady_clock::time_point last_activity{std::chrono::steady_clock::now()};
-        RemoteOption remote_option;
-
-        bool operator==(const UdpConnection::Remote& other) const
-        {
-            return ip == other.ip && port_number == other.port_number;
-        }
+        RemoteOption remote_option{RemoteOption::Found};
     };
+    // Flat map keyed by endpoint (address and port), there are only ever a few remotes.
     std::vector<Remote> _remotes{};
 
     // Asio socket — owned by this connection, driven by MavsdkImpl::_io_context
     asio::ip::udp::socket _socket;
+
+#if defined(LINUX)
+    // Datagrams read with one recvmmsg() per wakeup.
+    static constexpr unsigned RECV_BATCH_SIZE = 16;
+    std::array<std::array<uint8_t, 2048>, RECV_BATCH_SIZE> _recv_buffers{};
+    std::array<sockaddr_storage, RECV_BATCH_SIZE> _recv_addresses{};
+    std::array<iovec, RECV_BATCH_SIZE> _recv_iovecs{};
+    std::array<mmsghdr, RECV_BATCH_SIZE> _recv_messages{};
+
+    // One sendmmsg() entry per remote, guarded by _remote_mutex.
+    std::vector<mmsghdr> _send_messages{};
+#else
     asio::ip::udp::endpoint _sender_endpoint{};
     std::array<uint8_t, 2048> _recv_buffer{};
+#endif
+
+    // Keeps aggregated datagrams within a 1500 byte Ethernet MTU, including IPv4 and UDP headers.
+    static constexpr std::size_t MAX_AGGREGATED_LEN = 1472;
+
+    // Send aggregation, off while the window is 0.
+    std::chrono::microseconds _aggregation_window{0};
+    std::mutex _aggregation_mutex{};
+    std::array<char, MAX_AGGREGATED_LEN> _aggregation_buffer{};
+    std::size_t _aggregation_len{0};
+    bool _aggregation_timer_armed{false};
+    asio::steady_timer _aggregation_timer;
 
     // Timeout for inactive connections in seconds
     static constexpr std::chrono::seconds REMOTE_TIMEOUT{10};
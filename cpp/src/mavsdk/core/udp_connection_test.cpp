@@ -0,0 +1,192 @@
+#include "mavsdk_impl.hpp"
+#include "mavlink_include.hpp"
+
+#include <asio/buffer.hpp>
+#include <asio/io_context.hpp>
+#include <asio/ip/udp.hpp>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mavsdk;
+
+namespace {
+
+// Keeps aggregated datagrams within a 1500 byte Ethernet MTU, as in UdpConnection.
+constexpr std::size_t max_aggregated_len = 1472;
+
+// A plain socket, so that the datagrams of the connection under test are seen as sent.
+class DatagramReceiver {
+public:
+    DatagramReceiver() : _socket(_io_context)
+    {
+        asio::error_code ec;
+        _socket.open(asio::ip::udp::v4(), ec);
+        EXPECT_FALSE(ec);
+        _socket.bind({asio::ip::make_address("127.0.0.1", ec), 0}, ec);
+        EXPECT_FALSE(ec);
+        _socket.non_blocking(true, ec);
+        EXPECT_FALSE(ec);
+    }
+
+    std::string url(double aggregate_ms)
+    {
+        asio::error_code ec;
+        return "udpout://127.0.0.1:" + std::to_string(_socket.local_endpoint(ec).port()) +
+               "?aggregate_ms=" + std::to_string(aggregate_ms);
+    }
+
+    std::optional<std::vector<char>> receive(std::chrono::milliseconds timeout)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        std::vector<char> datagram(2048);
+        while (std::chrono::steady_clock::now() < deadline) {
+            asio::error_code ec;
+            const auto len = _socket.receive(asio::buffer(datagram), 0, ec);
+            if (!ec) {
+                datagram.resize(len);
+                return datagram;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return std::nullopt;
+    }
+
+private:
+    asio::io_context _io_context{};
+    asio::ip::udp::socket _socket;
+};
+
+struct Frames {
+    unsigned status_texts{0};
+    // No frame is cut off at the end of the datagram.
+    bool complete{false};
+};
+
+Frames parse_frames(const std::vector<char>& datagram)
+{
+    Frames frames;
+    mavlink_message_t buffer{};
+    mavlink_status_t buffer_status{};
+    mavlink_message_t message{};
+    mavlink_status_t status{};
+    for (const char byte : datagram) {
+        if (mavlink_frame_char_buffer(
+                &buffer, &buffer_status, static_cast<uint8_t>(byte), &message, &status) ==
+                MAVLINK_FRAMING_OK &&
+            message.msgid == MAVLINK_MSG_ID_STATUSTEXT) {
+            ++frames.status_texts;
+        }
+    }
+    frames.complete = buffer_status.parse_state == MAVLINK_PARSE_STATE_IDLE;
+    return frames;
+}
+
+// A STATUSTEXT with the full 50 characters, so the frames are 63 bytes.
+void send_status_text(MavsdkImpl& mavsdk_impl)
+{
+    char text[50];
+    std::memset(text, 'x', sizeof(text));
+    mavlink_message_t message;
+    mavlink_msg_statustext_pack(
+        mavsdk_impl.get_own_system_id(),
+        mavsdk_impl.get_own_component_id(),
+        &message,
+        MAV_SEVERITY_INFO,
+        text,
+        0,
+        0);
+    EXPECT_TRUE(mavsdk_impl.send_message(message));
+}
+
+} // namespace
+
+TEST(UdpConnection, AggregatedFlushedWhenWindowExpires)
+{
+    DatagramReceiver receiver;
+    MavsdkImpl mavsdk_impl{Mavsdk::Configuration{ComponentType::GroundStation}};
+    ASSERT_EQ(
+        mavsdk_impl.add_any_connection(receiver.url(200), ForwardingOption::ForwardingOff).first,
+        ConnectionResult::Success);
+
+    constexpr unsigned num_sent = 5;
+    for (unsigned i = 0; i < num_sent; ++i) {
+        send_status_text(mavsdk_impl);
+    }
+
+    // Nothing else flushes them: the datagram is far from full and the connection stays.
+    unsigned num_received = 0;
+    unsigned num_datagrams = 0;
+    while (num_received < num_sent) {
+        const auto datagram = receiver.receive(std::chrono::seconds(2));
+        ASSERT_TRUE(datagram);
+        const auto frames = parse_frames(*datagram);
+        EXPECT_TRUE(frames.complete);
+        if (frames.status_texts > 0) {
+            num_received += frames.status_texts;
+            ++num_datagrams;
+        }
+    }
+    EXPECT_EQ(num_received, num_sent);
+
+    // At most split by a window started by a heartbeat just before.
+    EXPECT_LE(num_datagrams, 2u);
+}
+
+TEST(UdpConnection, AggregatedFlushedWhenDatagramIsFull)
+{
+    DatagramReceiver receiver;
+    MavsdkImpl mavsdk_impl{Mavsdk::Configuration{ComponentType::GroundStation}};
+    // A window much longer than the test waits for a datagram.
+    ASSERT_EQ(
+        mavsdk_impl.add_any_connection(receiver.url(60000), ForwardingOption::ForwardingOff)
+            .first,
+        ConnectionResult::Success);
+
+    // More than fits into one datagram.
+    constexpr unsigned num_sent = 30;
+    for (unsigned i = 0; i < num_sent; ++i) {
+        send_status_text(mavsdk_impl);
+    }
+
+    const auto datagram = receiver.receive(std::chrono::seconds(2));
+    ASSERT_TRUE(datagram);
+    EXPECT_LE(datagram->size(), max_aggregated_len);
+    // Only sent because the next frame did not fit anymore.
+    EXPECT_GT(datagram->size(), max_aggregated_len - 63);
+
+    const auto frames = parse_frames(*datagram);
+    EXPECT_TRUE(frames.complete);
+    EXPECT_GT(frames.status_texts, 0u);
+    EXPECT_LT(frames.status_texts, num_sent);
+}
+
+TEST(UdpConnection, AggregatedFlushedOnStop)
+{
+    DatagramReceiver receiver;
+    MavsdkImpl mavsdk_impl{Mavsdk::Configuration{ComponentType::GroundStation}};
+    const auto [result, handle] =
+        mavsdk_impl.add_any_connection(receiver.url(60000), ForwardingOption::ForwardingOff);
+    ASSERT_EQ(result, ConnectionResult::Success);
+
+    constexpr unsigned num_sent = 3;
+    for (unsigned i = 0; i < num_sent; ++i) {
+        send_status_text(mavsdk_impl);
+    }
+
+    // Still waiting for the window to pass.
+    EXPECT_FALSE(receiver.receive(std::chrono::milliseconds(200)));
+
+    mavsdk_impl.remove_connection(handle);
+
+    const auto datagram = receiver.receive(std::chrono::seconds(2));
+    ASSERT_TRUE(datagram);
+    const auto frames = parse_frames(*datagram);
+    EXPECT_TRUE(frames.complete);
+    EXPECT_EQ(frames.status_texts, num_sent);
+}
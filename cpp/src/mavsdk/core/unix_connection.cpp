@@ -0,0 +1,352 @@
+#include "unix_connection.hpp"
+#include "mavsdk_impl.hpp"
+#include "log.hpp"
+
+#if !defined(WINDOWS)
+#include <asio/buffer.hpp>
+#include <asio/error.hpp>
+#include <asio/post.hpp>
+#include <asio/socket_base.hpp>
+#include <asio/write.hpp>
+
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <future>
+#include <utility>
+
+namespace mavsdk {
+
+UnixConnection::UnixConnection(
+    Connection::ReceiverCallback receiver_callback,
+    Connection::LibmavReceiverCallback libmav_receiver_callback,
+    MavsdkImpl& mavsdk_impl,
+    std::string path,
+    Mode mode,
+    ForwardingOption forwarding_option) :
+    Connection(
+        std::move(receiver_callback),
+        std::move(libmav_receiver_callback),
+        mavsdk_impl,
+        forwarding_option),
+    _path(std::move(path)),
+    _mode(mode),
+    _send_queue(SendQueue::Options{mavsdk_impl.get_configuration().get_send_queue_size()})
+#if !defined(WINDOWS)
+    ,
+    _acceptor(mavsdk_impl.io_context()),
+    _socket(mavsdk_impl.io_context()),
+    _reconnect_timer(mavsdk_impl.io_context())
+#endif
+{}
+
+UnixConnection::~UnixConnection()
+{
+    // If no one explicitly called stop before, we should at least do it.
+    stop();
+}
+
+#if defined(WINDOWS)
+
+ConnectionResult UnixConnection::start()
+{
+    LogErr("unix:// connections are not supported on Windows");
+    return ConnectionResult::NotImplemented;
+}
+
+ConnectionResult UnixConnection::stop()
+{
+    return ConnectionResult::Success;
+}
+
+std::pair<bool, std::string> UnixConnection::send_message(const mavlink_message_t&)
+{
+    return {false, "Not implemented"};
+}
+
+std::pair<bool, std::string> UnixConnection::send_raw_bytes(const char*, size_t)
+{
+    return {false, "Not implemented"};
+}
+
+#else
+
+ConnectionResult UnixConnection::start()
+{
+    if (!start_mavlink_receiver()) {
+        return ConnectionResult::ConnectionsExhausted;
+    }
+
+    if (!start_libmav_receiver()) {
+        return ConnectionResult::ConnectionsExhausted;
+    }
+
+    if (_mode == Mode::Listen) {
+        return start_listening();
+    }
+
+    // Kick off the first async connect — subsequent ones follow from do_receive() errors.
+    do_connect();
+
+    return ConnectionResult::Success;
+}
+
+ConnectionResult UnixConnection::start_listening()
+{
+    // A socket file left behind by a previous run would make bind() fail.
+    remove_socket_file();
+
+    asio::error_code ec;
+
+    _acceptor.open(asio::local::stream_protocol(), ec);
+    if (ec) {
+        LogErr("Socket open error: {}", ec.message());
+        return ConnectionResult::SocketError;
+    }
+
+    _acceptor.bind(asio::local::stream_protocol::endpoint(_path), ec);
+    if (ec) {
+        LogErr("Bind error for {}: {}", _path, ec.message());
+        return ConnectionResult::BindError;
+    }
+    _created_socket_file = true;
+
+    _acceptor.listen(asio::socket_base::max_listen_connections, ec);
+    if (ec) {
+        LogErr("Listen error: {}", ec.message());
+        return ConnectionResult::SocketError;
+    }
+
+    // Kick off the first async accept — subsequent ones follow after each client disconnects.
+    do_accept();
+
+    return ConnectionResult::Success;
+}
+
+ConnectionResult UnixConnection::stop()
+{
+    // Signal handlers to stop re-arming BEFORE cancelling/closing.
+    _stopping = true;
+
+    auto& io_ctx = static_cast<asio::io_context&>(_socket.get_executor().context());
+    if (!io_ctx.stopped()) {
+        // Cancel and close from the io_context thread, serialised with the handlers
+        // using the timer and the sockets, see TcpServerConnection::stop().
+        std::promise<void> close_done;
+        asio::post(io_ctx, [this, &close_done]() {
+            _reconnect_timer.cancel();
+            asio::error_code ec;
+            _acceptor.close(ec);
+            close_socket();
+            close_done.set_value();
+        });
+        close_done.get_future().wait();
+
+        // Drain any operation_aborted handlers queued by the close.
+        std::promise<void> fence;
+        asio::post(io_ctx, [&fence]() { fence.set_value(); });
+        fence.get_future().wait();
+    } else {
+        // io_context already stopped — no concurrent async operations are running.
+        _reconnect_timer.cancel();
+        asio::error_code ec;
+        _acceptor.close(ec);
+        close_socket();
+    }
+
+    if (_created_socket_file) {
+        remove_socket_file();
+        _created_socket_file = false;
+    }
+
+    // Stop this after stopping the socket so we don't interfere with message parsing.
+    stop_mavlink_receiver();
+
+    return ConnectionResult::Success;
+}
+
+void UnixConnection::remove_socket_file()
+{
+    // Anything else at that path is not ours to remove.
+    struct stat st {};
+    if (::lstat(_path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode)) {
+        ::unlink(_path.c_str());
+    }
+}
+
+void UnixConnection::close_socket()
+{
+    _connected = false;
+
+    // Hold _send_mutex so this close() is serialised with do_send().
+    std::lock_guard<std::mutex> lock(_send_mutex);
+    if (_socket.is_open()) {
+        asio::error_code ec;
+        _socket.close(ec);
+    }
+}
+
+std::pair<bool, std::string> UnixConnection::send_message(const mavlink_message_t& message)
+{
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    uint16_t buffer_len = mavlink_msg_to_send_buffer(buffer, &message);
+    return send_raw_bytes(reinterpret_cast<const char*>(buffer), buffer_len);
+}
+
+std::pair<bool, std::string> UnixConnection::send_raw_bytes(const char* bytes, size_t length)
+{
+    capture_sent_bytes(bytes, length);
+
+    if (!_connected) {
+        return {false, "Not connected"};
+    }
+
+    switch (_send_queue.push(bytes, length)) {
+        case SendQueue::PushResult::Rejected:
+            return {false, "Send queue full"};
+        case SendQueue::PushResult::StartWriting:
+            asio::post(_socket.get_executor(), [this]() { do_send(); });
+            break;
+        case SendQueue::PushResult::Queued:
+            break;
+    }
+
+    return {true, {}};
+}
+
+void UnixConnection::do_send()
+{
+    if (_stopping) {
+        return;
+    }
+
+    // Everything queued so far goes out in one write.
+    const auto& buffers = _send_queue.begin_write();
+    if (buffers.empty()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_send_mutex);
+    if (!_socket.is_open()) {
+        _send_queue.fail_write();
+        return;
+    }
+
+    asio::async_write(_socket, buffers, [this](const asio::error_code& ec, std::size_t) {
+        if (_stopping) {
+            return;
+        }
+        if (ec) {
+            // The receive side notices the lost peer and reconnects or accepts again.
+            if (ec != asio::error::operation_aborted && ec != asio::error::broken_pipe &&
+                ec != asio::error::connection_reset) {
+                LogErr("Send failure: {}", ec.message());
+            }
+            _send_queue.fail_write();
+            return;
+        }
+        _send_queue.complete_write();
+        do_send();
+    });
+}
+
+void UnixConnection::do_accept()
+{
+    _acceptor.async_accept(
+        [this](const asio::error_code& ec, asio::local::stream_protocol::socket peer) {
+            if (ec == asio::error::operation_aborted || _stopping) {
+                // stop() closed the acceptor — do not re-arm.
+                return;
+            }
+            if (ec) {
+                LogErr("Accept error: {}", ec.message());
+                do_accept();
+                return;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(_send_mutex);
+                _socket = std::move(peer);
+            }
+            _connected = true;
+
+            do_receive();
+        });
+}
+
+void UnixConnection::do_connect()
+{
+    close_socket();
+
+    _socket.async_connect(
+        asio::local::stream_protocol::endpoint(_path), [this](const asio::error_code& ec) {
+            if (ec == asio::error::operation_aborted || _stopping) {
+                // stop() was called — do not reconnect.
+                return;
+            }
+            if (ec) {
+                LogErr("Connect error for {}: {}", _path, ec.message());
+                start_reconnect();
+                return;
+            }
+            _connected = true;
+            do_receive();
+        });
+}
+
+void UnixConnection::start_reconnect()
+{
+    if (_stopping) {
+        return;
+    }
+    _reconnect_timer.expires_after(std::chrono::seconds(1));
+    _reconnect_timer.async_wait([this](const asio::error_code& ec) {
+        if (ec == asio::error::operation_aborted || _stopping) {
+            // stop() cancelled the timer — do not reconnect.
+            return;
+        }
+        do_connect();
+    });
+}
+
+void UnixConnection::do_receive()
+{
+    _socket.async_read_some(
+        asio::buffer(_recv_buffer), [this](const asio::error_code& ec, std::size_t recv_len) {
+            if (ec == asio::error::operation_aborted || _stopping) {
+                // stop() was called — do not reconnect.
+                return;
+            }
+
+            if (ec) {
+                if (ec == asio::error::eof || ec == asio::error::connection_reset) {
+                    LogInfo("Unix socket {} closed", _path);
+                } else {
+                    LogErr("Unix socket receive error: {}", ec.message());
+                }
+                close_socket();
+                if (_mode == Mode::Listen) {
+                    do_accept();
+                } else {
+                    start_reconnect();
+                }
+                return;
+            }
+
+            _mavlink_receiver->set_new_datagram(_recv_buffer.data(), static_cast<int>(recv_len));
+
+            auto parse_result = _mavlink_receiver->parse_message();
+            while (parse_result != MavlinkReceiver::ParseResult::NoneAvailable) {
+                receive_frame(parse_result);
+                parse_result = _mavlink_receiver->parse_message();
+            }
+
+            // Re-arm for the next chunk.
+            do_receive();
+        });
+}
+
+#endif
+
+} // namespace mavsdk
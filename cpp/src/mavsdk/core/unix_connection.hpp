@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <string>
+
+#if !defined(WINDOWS)
+#include <asio/local/stream_protocol.hpp>
+#include <asio/steady_timer.hpp>
+#endif
+
+#include "connection.hpp"
+#include "send_queue.hpp"
+
+namespace mavsdk {
+
+// Connection over a Unix domain socket, for unix:///path.
+//
+// A stream socket is used, like TCP, and MavlinkReceiver reassembles frames
+// from the byte stream. Either side can listen: in Listen mode the socket file
+// is created and one client at a time is served, in Connect mode we connect
+// to it and keep trying to reconnect every second.
+class UnixConnection : public Connection {
+public:
+    enum class Mode { Connect, Listen };
+
+    UnixConnection(
+        Connection::ReceiverCallback receiver_callback,
+        Connection::LibmavReceiverCallback libmav_receiver_callback,
+        MavsdkImpl& mavsdk_impl,
+        std::string path,
+        Mode mode,
+        ForwardingOption forwarding_option = ForwardingOption::ForwardingOff);
+    ~UnixConnection() override;
+
+    ConnectionResult start() override;
+    ConnectionResult stop() override;
+
+    std::pair<bool, std::string> send_message(const mavlink_message_t& message) override;
+    std::pair<bool, std::string> send_raw_bytes(const char* bytes, size_t length) override;
+    std::optional<SendQueue::Stats> send_queue_stats() const override
+    {
+        return _send_queue.stats();
+    }
+
+    // Non-copyable
+    UnixConnection(const UnixConnection&) = delete;
+    const UnixConnection& operator=(const UnixConnection&) = delete;
+
+private:
+#if !defined(WINDOWS)
+    ConnectionResult start_listening();
+    void do_accept();
+    void do_connect();
+    void start_reconnect();
+    void do_receive();
+    void do_send();
+    void close_socket();
+    void remove_socket_file();
+#endif
+
+    const std::string _path;
+    const Mode _mode;
+
+    // Set to true by stop() before closing sockets; prevents handlers from re-arming.
+    std::atomic<bool> _stopping{false};
+
+    // Set while connected, so send_raw_bytes() can refuse to queue otherwise.
+    std::atomic<bool> _connected{false};
+
+    // Protects starting a write against concurrent close on the io_thread.
+    std::mutex _send_mutex{};
+
+    // Written in the background by do_send() on the io_context thread.
+    SendQueue _send_queue;
+
+#if !defined(WINDOWS)
+    // Asio objects — driven by MavsdkImpl::_io_context.
+    asio::local::stream_protocol::acceptor _acceptor;
+    asio::local::stream_protocol::socket _socket;
+    asio::steady_timer _reconnect_timer;
+    std::array<char, 2048> _recv_buffer{};
+
+    // Only set in Listen mode once bind() created the socket file, which stop() removes.
+    bool _created_socket_file{false};
+#endif
+};
+
+} // namespace mavsdk
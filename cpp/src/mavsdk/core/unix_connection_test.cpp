@@ -0,0 +1,155 @@
+#include "mavsdk_impl.hpp"
+#include "mavlink_include.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace mavsdk;
+
+namespace {
+
+// Collects the texts of the STATUSTEXT messages a MavsdkImpl receives.
+class ReceivedStatusTexts {
+public:
+    explicit ReceivedStatusTexts(MavsdkImpl& mavsdk_impl) : _mavsdk_impl(mavsdk_impl)
+    {
+        _mavsdk_impl.intercept_incoming_messages_async([this](mavlink_message_t& message) {
+            if (message.msgid == MAVLINK_MSG_ID_STATUSTEXT) {
+                char text[51]{};
+                mavlink_msg_statustext_get_text(&message, text);
+                std::lock_guard<std::mutex> lock(_mutex);
+                _texts.emplace_back(text);
+                _cv.notify_all();
+            }
+            return true;
+        });
+    }
+
+    ~ReceivedStatusTexts() { _mavsdk_impl.intercept_incoming_messages_async(nullptr); }
+
+    bool wait_for(const std::string& text, std::chrono::milliseconds timeout)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        return _cv.wait_for(lock, timeout, [&]() {
+            return std::find(_texts.begin(), _texts.end(), text) != _texts.end();
+        });
+    }
+
+private:
+    MavsdkImpl& _mavsdk_impl;
+    std::mutex _mutex{};
+    std::condition_variable _cv{};
+    std::vector<std::string> _texts{};
+};
+
+void send_status_text(MavsdkImpl& mavsdk_impl, const std::string& text)
+{
+    mavlink_message_t message;
+    mavlink_msg_statustext_pack(
+        mavsdk_impl.get_own_system_id(),
+        mavsdk_impl.get_own_component_id(),
+        &message,
+        MAV_SEVERITY_INFO,
+        text.c_str(),
+        0,
+        0);
+    EXPECT_TRUE(mavsdk_impl.send_message(message));
+}
+
+// Sends until received, the connect side only connects after being added.
+bool send_until_received(MavsdkImpl& sender, ReceivedStatusTexts& received, const std::string& text)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (std::chrono::steady_clock::now() < deadline) {
+        send_status_text(sender, text);
+        if (received.wait_for(text, std::chrono::milliseconds(100))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string socket_path(const std::string& name)
+{
+    return (std::filesystem::temp_directory_path() /
+            ("mavsdk_" + name + "_" + std::to_string(getpid()) + ".sock"))
+        .string();
+}
+
+} // namespace
+
+TEST(UnixConnection, SendAndReceiveBothWays)
+{
+    const auto path = socket_path("both_ways");
+    MavsdkImpl listener{Mavsdk::Configuration{ComponentType::GroundStation}};
+    MavsdkImpl connector{Mavsdk::Configuration{ComponentType::GroundStation}};
+    ReceivedStatusTexts received_by_listener{listener};
+    ReceivedStatusTexts received_by_connector{connector};
+
+    ASSERT_EQ(
+        listener.add_any_connection("unixin://" + path, ForwardingOption::ForwardingOff).first,
+        ConnectionResult::Success);
+    ASSERT_EQ(
+        connector.add_any_connection("unix://" + path, ForwardingOption::ForwardingOff).first,
+        ConnectionResult::Success);
+
+    EXPECT_TRUE(send_until_received(connector, received_by_listener, "to listener"));
+    EXPECT_TRUE(send_until_received(listener, received_by_connector, "to connector"));
+}
+
+TEST(UnixConnection, ReconnectsAfterListenerStopped)
+{
+    const auto path = socket_path("reconnect");
+    MavsdkImpl connector{Mavsdk::Configuration{ComponentType::GroundStation}};
+    ASSERT_EQ(
+        connector.add_any_connection("unix://" + path, ForwardingOption::ForwardingOff).first,
+        ConnectionResult::Success);
+
+    {
+        MavsdkImpl listener{Mavsdk::Configuration{ComponentType::GroundStation}};
+        ReceivedStatusTexts received{listener};
+        const auto [result, handle] =
+            listener.add_any_connection("unixin://" + path, ForwardingOption::ForwardingOff);
+        ASSERT_EQ(result, ConnectionResult::Success);
+        EXPECT_TRUE(std::filesystem::exists(path));
+
+        EXPECT_TRUE(send_until_received(connector, received, "first"));
+
+        listener.remove_connection(handle);
+        // The socket file is ours, so it is removed again.
+        EXPECT_FALSE(std::filesystem::exists(path));
+    }
+
+    // The connect side keeps trying until there is a listener again.
+    MavsdkImpl listener{Mavsdk::Configuration{ComponentType::GroundStation}};
+    ReceivedStatusTexts received{listener};
+    ASSERT_EQ(
+        listener.add_any_connection("unixin://" + path, ForwardingOption::ForwardingOff).first,
+        ConnectionResult::Success);
+    EXPECT_TRUE(send_until_received(connector, received, "second"));
+}
+
+TEST(UnixConnection, StopWhileReconnecting)
+{
+    MavsdkImpl connector{Mavsdk::Configuration{ComponentType::GroundStation}};
+    // Nobody listens, so the connection is waiting to retry.
+    const auto [result, handle] = connector.add_any_connection(
+        "unix://" + socket_path("nobody"), ForwardingOption::ForwardingOff);
+    ASSERT_EQ(result, ConnectionResult::Success);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    // Does not wait for the retry.
+    const auto before = std::chrono::steady_clock::now();
+    connector.remove_connection(handle);
+    EXPECT_LT(std::chrono::steady_clock::now() - before, std::chrono::milliseconds(500));
+}
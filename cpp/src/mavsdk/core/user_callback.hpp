@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace mavsdk {
+
+/*
+ * A copyable `void()` callable with inline storage, used to hand callbacks to
+ * the user callback thread.
+ *
+ * std::function only stores very small callables (two pointers in libstdc++)
+ * inline, so the typical queued closure -- the subscriber's std::function plus
+ * a copy of the arguments -- would otherwise cost a heap allocation for every
+ * telemetry update. Callables up to INLINE_SIZE bytes are stored in place here;
+ * bigger ones still work but fall back to the heap.
+ */
+class UserCallback {
+public:
+    static constexpr std::size_t INLINE_SIZE = 96;
+
+    UserCallback() = default;
+
+    template<
+        typename F,
+        typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, UserCallback>>>
+    UserCallback(F&& func) // NOLINT(google-explicit-constructor)
+    {
+        using Func = std::decay_t<F>;
+        if constexpr (fits_inline<Func>()) {
+            new (&_storage) Func(std::forward<F>(func));
+            _ops = &inline_ops<Func>;
+        } else {
+            new (&_storage) Func*(new Func(std::forward<F>(func)));
+            _ops = &heap_ops<Func>;
+        }
+    }
+
+    UserCallback(const UserCallback& other) : _ops(other._ops)
+    {
+        if (_ops) {
+            _ops->copy(&_storage, &other._storage);
+        }
+    }
+
+    UserCallback(UserCallback&& other) noexcept : _ops(other._ops)
+    {
+        if (_ops) {
+            _ops->move(&_storage, &other._storage);
+            other._ops = nullptr;
+        }
+    }
+
+    UserCallback& operator=(const UserCallback& other)
+    {
+        if (this != &other) {
+            UserCallback copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    UserCallback& operator=(UserCallback&& other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            if (other._ops) {
+                other._ops->move(&_storage, &other._storage);
+                _ops = other._ops;
+                other._ops = nullptr;
+            }
+        }
+        return *this;
+    }
+
+    ~UserCallback() { reset(); }
+
+    void operator()() const { _ops->invoke(const_cast<Storage*>(&_storage)); }
+
+    explicit operator bool() const { return _ops != nullptr; }
+
+    // Whether the callable lives in the inline buffer (i.e. no heap allocation).
+    bool stored_inline() const { return _ops != nullptr && _ops->is_inline; }
+
+    void reset()
+    {
+        if (_ops) {
+            _ops->destroy(&_storage);
+            _ops = nullptr;
+        }
+    }
+
+private:
+    using Storage = std::aligned_storage_t<INLINE_SIZE, alignof(std::max_align_t)>;
+
+    struct Ops {
+        void (*invoke)(void* storage);
+        void (*copy)(void* dst, const void* src);
+        // Move-constructs into dst and destroys what is left in src.
+        void (*move)(void* dst, void* src);
+        void (*destroy)(void* storage);
+        bool is_inline;
+    };
+
+    template<typename Func> static constexpr bool fits_inline()
+    {
+        return sizeof(Func) <= INLINE_SIZE && alignof(Func) <= alignof(Storage) &&
+               std::is_nothrow_move_constructible_v<Func>;
+    }
+
+    template<typename Func> static constexpr Ops inline_ops{
+        [](void* storage) { (*static_cast<Func*>(storage))(); },
+        [](void* dst, const void* src) { new (dst) Func(*static_cast<const Func*>(src)); },
+        [](void* dst, void* src) {
+            new (dst) Func(std::move(*static_cast<Func*>(src)));
+            static_cast<Func*>(src)->~Func();
+        },
+        [](void* storage) { static_cast<Func*>(storage)->~Func(); },
+        true};
+
+    template<typename Func> static constexpr Ops heap_ops{
+        [](void* storage) { (**static_cast<Func**>(storage))(); },
+        [](void* dst, const void* src) {
+            new (dst) Func*(new Func(**static_cast<Func* const*>(src)));
+        },
+        [](void* dst, void* src) { new (dst) Func*(*static_cast<Func**>(src)); },
+        [](void* storage) { delete *static_cast<Func**>(storage); },
+        false};
+
+    Storage _storage;
+    const Ops* _ops{nullptr};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,117 @@
+#include "user_callback_queue.hpp"
+
+#include <cstdint>
+
+namespace mavsdk {
+
+// The ring follows Dmitry Vyukov's bounded queue: each slot carries a sequence
+// number telling whether it is free for the producer claiming position `pos`
+// (sequence == pos) or holds an item for the consumer at `pos`
+// (sequence == pos + 1). Producers claim a position with a CAS on
+// _enqueue_pos; the single consumer just advances _dequeue_pos.
+
+UserCallbackQueue::UserCallbackQueue()
+{
+    for (std::size_t i = 0; i < CAPACITY; ++i) {
+        _slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool UserCallbackQueue::try_push(UserCallback func, const char* filename, int linenumber)
+{
+    Slot* slot;
+    std::size_t pos = _enqueue_pos.load(std::memory_order_relaxed);
+    while (true) {
+        slot = &_slots[pos % CAPACITY];
+        const std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+        if (diff == 0) {
+            if (_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // The consumer has not freed this slot yet: full.
+            return false;
+        } else {
+            pos = _enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->item.func = std::move(func);
+    slot->item.filename = filename;
+    slot->item.linenumber = linenumber;
+    // seq_cst (here and on _consumer_waiting) so that either we see the
+    // consumer waiting below, or it sees this item before going to sleep.
+    slot->sequence.store(pos + 1, std::memory_order_seq_cst);
+
+    wake_consumer();
+    return true;
+}
+
+bool UserCallbackQueue::try_pop(Item& item)
+{
+    const std::size_t pos = _dequeue_pos.load(std::memory_order_relaxed);
+    Slot& slot = _slots[pos % CAPACITY];
+    if (slot.sequence.load(std::memory_order_acquire) != pos + 1) {
+        return false;
+    }
+
+    item.func = std::move(slot.item.func);
+    item.filename = slot.item.filename;
+    item.linenumber = slot.item.linenumber;
+    slot.item.func.reset();
+
+    slot.sequence.store(pos + CAPACITY, std::memory_order_release);
+    _dequeue_pos.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool UserCallbackQueue::wait_and_pop(Item& item)
+{
+    while (true) {
+        if (try_pop(item)) {
+            return true;
+        }
+        if (_should_exit.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        std::unique_lock<std::mutex> lock(_wait_mutex);
+        _consumer_waiting.store(true, std::memory_order_seq_cst);
+        _wait_cv.wait(lock, [this]() {
+            const std::size_t pos = _dequeue_pos.load(std::memory_order_relaxed);
+            return _slots[pos % CAPACITY].sequence.load(std::memory_order_seq_cst) == pos + 1 ||
+                   _should_exit.load(std::memory_order_acquire);
+        });
+        _consumer_waiting.store(false, std::memory_order_relaxed);
+    }
+}
+
+void UserCallbackQueue::wake_consumer()
+{
+    if (_consumer_waiting.load(std::memory_order_seq_cst)) {
+        std::lock_guard<std::mutex> lock(_wait_mutex);
+        _wait_cv.notify_one();
+    }
+}
+
+void UserCallbackQueue::stop()
+{
+    _should_exit.store(true, std::memory_order_release);
+    std::lock_guard<std::mutex> lock(_wait_mutex);
+    _wait_cv.notify_all();
+}
+
+void UserCallbackQueue::restart()
+{
+    _should_exit.store(false, std::memory_order_release);
+}
+
+std::size_t UserCallbackQueue::size() const
+{
+    const std::size_t dequeue_pos = _dequeue_pos.load(std::memory_order_acquire);
+    const std::size_t enqueue_pos = _enqueue_pos.load(std::memory_order_acquire);
+    return enqueue_pos > dequeue_pos ? enqueue_pos - dequeue_pos : 0;
+}
+
+} // namespace mavsdk
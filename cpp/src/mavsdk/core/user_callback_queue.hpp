@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+#include "mavsdk_export.h"
+#include "user_callback.hpp"
+
+namespace mavsdk {
+
+/*
+ * Bounded queue of user callbacks: many producers (io thread, plugin threads,
+ * timers), one consumer (the user callback thread).
+ *
+ * The slots are preallocated and reused, and push/pop are lock-free (a ring of
+ * sequence-numbered slots), so with inline-stored callbacks a busy telemetry
+ * stream is enqueued and run without heap allocations or mutex handoffs. The
+ * mutex and condition variable are only used to park the consumer when the
+ * queue runs empty; producers only take the mutex to wake it.
+ */
+class MAVSDK_TEST_EXPORT UserCallbackQueue {
+public:
+    static constexpr std::size_t CAPACITY = 128;
+
+    struct Item {
+        UserCallback func{};
+        const char* filename{""};
+        int linenumber{0};
+    };
+
+    UserCallbackQueue();
+
+    // Returns false if the queue is full, in which case the callback is dropped.
+    bool try_push(UserCallback func, const char* filename, int linenumber);
+
+    // Only to be called by the single consumer.
+    bool try_pop(Item& item);
+
+    // Blocks until an item is available or stop() is called. Returns false if
+    // stopped. Only to be called by the single consumer.
+    bool wait_and_pop(Item& item);
+
+    void stop();
+    void restart();
+
+    // Approximate while producers or the consumer are active.
+    std::size_t size() const;
+
+private:
+    struct Slot {
+        std::atomic<std::size_t> sequence{0};
+        Item item{};
+    };
+
+    void wake_consumer();
+
+    std::array<Slot, CAPACITY> _slots{};
+    alignas(64) std::atomic<std::size_t> _enqueue_pos{0};
+    alignas(64) std::atomic<std::size_t> _dequeue_pos{0};
+
+    std::mutex _wait_mutex{};
+    std::condition_variable _wait_cv{};
+    std::atomic<bool> _consumer_waiting{false};
+    std::atomic<bool> _should_exit{false};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,182 @@
+#include "user_callback_queue.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+TEST(UserCallback, StoresTypicalClosureInline)
+{
+    // What CallbackList queues: the subscriber's std::function plus the arguments.
+    std::function<void(double, double, float, float)> subscriber = [](auto...) {};
+    int calls = 0;
+    UserCallback callback = [&calls, subscriber, a = 1.0, b = 2.0, c = 3.0f, d = 4.0f]() {
+        subscriber(a, b, c, d);
+        ++calls;
+    };
+
+    EXPECT_TRUE(callback.stored_inline());
+    callback();
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(UserCallback, LargeClosureFallsBackToHeap)
+{
+    std::array<char, UserCallback::INLINE_SIZE + 1> big{};
+    big[0] = 42;
+    char seen = 0;
+    UserCallback callback = [&seen, big]() { seen = big[0]; };
+
+    EXPECT_FALSE(callback.stored_inline());
+    UserCallback copy = callback;
+    UserCallback moved = std::move(callback);
+    EXPECT_FALSE(static_cast<bool>(callback));
+
+    copy();
+    EXPECT_EQ(seen, 42);
+    seen = 0;
+    moved();
+    EXPECT_EQ(seen, 42);
+}
+
+TEST(UserCallback, CopyMoveAndReset)
+{
+    auto counter = std::make_shared<int>(0);
+    UserCallback callback = [counter]() { ++(*counter); };
+    EXPECT_EQ(counter.use_count(), 2);
+
+    UserCallback copy = callback;
+    EXPECT_EQ(counter.use_count(), 3);
+
+    UserCallback moved;
+    moved = std::move(copy);
+    EXPECT_EQ(counter.use_count(), 3);
+
+    callback();
+    moved();
+    EXPECT_EQ(*counter, 2);
+
+    callback.reset();
+    moved.reset();
+    EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(UserCallbackQueue, FifoAndLocation)
+{
+    UserCallbackQueue queue;
+    std::vector<int> order;
+
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_TRUE(queue.try_push([&order, i]() { order.push_back(i); }, "file.cpp", 10 + i));
+    }
+    EXPECT_EQ(queue.size(), 3u);
+
+    UserCallbackQueue::Item item;
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_TRUE(queue.try_pop(item));
+        EXPECT_STREQ(item.filename, "file.cpp");
+        EXPECT_EQ(item.linenumber, 10 + i);
+        item.func();
+    }
+    EXPECT_FALSE(queue.try_pop(item));
+    EXPECT_EQ(queue.size(), 0u);
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2}));
+}
+
+TEST(UserCallbackQueue, RejectsWhenFullAndReusesSlots)
+{
+    UserCallbackQueue queue;
+
+    for (int round = 0; round < 3; ++round) {
+        for (std::size_t i = 0; i < UserCallbackQueue::CAPACITY; ++i) {
+            EXPECT_TRUE(queue.try_push([]() {}, "", 0));
+        }
+        EXPECT_FALSE(queue.try_push([]() {}, "", 0));
+        EXPECT_EQ(queue.size(), UserCallbackQueue::CAPACITY);
+
+        UserCallbackQueue::Item item;
+        while (queue.try_pop(item)) {}
+        EXPECT_EQ(queue.size(), 0u);
+    }
+}
+
+TEST(UserCallbackQueue, PoppedSlotReleasesCallable)
+{
+    UserCallbackQueue queue;
+    auto counter = std::make_shared<int>(0);
+
+    EXPECT_TRUE(queue.try_push([counter]() {}, "", 0));
+    EXPECT_EQ(counter.use_count(), 2);
+
+    {
+        UserCallbackQueue::Item item;
+        EXPECT_TRUE(queue.try_pop(item));
+    }
+    EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(UserCallbackQueue, StopWakesWaitingConsumer)
+{
+    UserCallbackQueue queue;
+
+    std::thread consumer([&queue]() {
+        UserCallbackQueue::Item item;
+        EXPECT_FALSE(queue.wait_and_pop(item));
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.stop();
+    consumer.join();
+
+    queue.restart();
+    EXPECT_TRUE(queue.try_push([]() {}, "", 0));
+    UserCallbackQueue::Item item;
+    EXPECT_TRUE(queue.wait_and_pop(item));
+}
+
+TEST(UserCallbackQueue, MultipleProducers)
+{
+    UserCallbackQueue queue;
+    constexpr int num_producers = 4;
+    constexpr int per_producer = 10000;
+
+    std::atomic<int> sum{0};
+    std::atomic<int> executed{0};
+
+    std::thread consumer([&]() {
+        UserCallbackQueue::Item item;
+        while (queue.wait_and_pop(item)) {
+            item.func();
+            if (executed.fetch_add(1) + 1 == num_producers * per_producer) {
+                break;
+            }
+        }
+    });
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < num_producers; ++p) {
+        producers.emplace_back([&, p]() {
+            for (int i = 0; i < per_producer; ++i) {
+                const int value = p * per_producer + i;
+                // The queue is bounded, so back off when the consumer is behind.
+                while (!queue.try_push([&sum, value]() { sum += value; }, "", 0)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    consumer.join();
+
+    const int total = num_producers * per_producer;
+    EXPECT_EQ(executed, total);
+    EXPECT_EQ(sum, total * (total - 1) / 2);
+}
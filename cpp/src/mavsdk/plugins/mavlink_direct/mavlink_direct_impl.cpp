@@ -4,12 +4,26 @@
 #include "log.hpp"
 #include "connection.hpp"
 #include "libmav_conversions.hpp"
-#include "callback_list.tpp"
-#include "mavsdk_export.h"
+
+#include <utility>
 
 namespace mavsdk {
 
-template class MAVSDK_TEMPL_INST CallbackList<MavlinkDirect::MavlinkMessage>;
+namespace {
+
+MavlinkDirect::MavlinkMessage to_mavlink_direct_message(const Mavsdk::MavlinkMessage& message)
+{
+    MavlinkDirect::MavlinkMessage mavlink_direct_message;
+    mavlink_direct_message.message_name = message.message_name;
+    mavlink_direct_message.system_id = message.system_id;
+    mavlink_direct_message.component_id = message.component_id;
+    mavlink_direct_message.target_system_id = message.target_system_id;
+    mavlink_direct_message.target_component_id = message.target_component_id;
+    mavlink_direct_message.fields_json = message.fields_json;
+    return mavlink_direct_message;
+}
+
+} // namespace
 
 MavlinkDirectImpl::MavlinkDirectImpl(System& system) : PluginImplBase(system)
 {
@@ -39,37 +53,25 @@ MavlinkDirectImpl::~MavlinkDirectImpl()
 
 void MavlinkDirectImpl::init()
 {
-    // Subscribe to all messages from SystemImpl and distribute to internal CallbackList
-    _system_subscription = _system_impl->register_libmav_message_handler(
-        "", // Empty string means all messages
-        [this](const Mavsdk::MavlinkMessage& message) {
-            // Convert Mavsdk::MavlinkMessage to MavlinkDirect::MavlinkMessage
-            MavlinkDirect::MavlinkMessage mavlink_direct_message;
-            mavlink_direct_message.message_name = message.message_name;
-            mavlink_direct_message.system_id = message.system_id;
-            mavlink_direct_message.component_id = message.component_id;
-            mavlink_direct_message.target_system_id = message.target_system_id;
-            mavlink_direct_message.target_component_id = message.target_component_id;
-            mavlink_direct_message.fields_json = message.fields_json;
-
-            _callbacks(mavlink_direct_message);
-        });
+    // Nothing to do: handlers are registered with the system per subscription, so that
+    // messages nobody subscribed to are never decoded.
 }
 
 void MavlinkDirectImpl::deinit()
 {
-    // Stop dispatching to our own subscribers.
-    _callbacks.clear();
-
-    // Crucially, unregister our handler from the system BEFORE this object is destroyed.
-    // The registered callback captures 'this' and reaches into _callbacks, and it runs on
-    // the io thread. unregister_libmav_message_handler() is blocking: once it returns the
-    // io thread can no longer invoke that callback, so it can't touch a freed
-    // MavlinkDirectImpl (previously a teardown use-after-free, only visible as a rare
-    // io-thread crash).
-    if (_system_subscription.valid()) {
-        _system_impl->unregister_libmav_message_handler(_system_subscription);
-        _system_subscription = {};
+    std::map<MavlinkDirect::MessageHandle, Handle<Mavsdk::MavlinkMessage>> subscriptions;
+    {
+        std::lock_guard<std::mutex> lock(_subscriptions_mutex);
+        subscriptions.swap(_subscriptions);
+    }
+
+    // Crucially, unregister our handlers from the system BEFORE this object is destroyed.
+    // The registered callbacks capture 'this' and run on the io thread.
+    // unregister_libmav_message_handler() is blocking: once it returns the io thread can no
+    // longer invoke them, so they can't touch a freed MavlinkDirectImpl (previously a
+    // teardown use-after-free, only visible as a rare io-thread crash).
+    for (const auto& subscription : subscriptions) {
+        _system_impl->unregister_libmav_message_handler(subscription.second);
     }
 }
 
@@ -156,27 +158,37 @@ MavlinkDirect::Result MavlinkDirectImpl::send_message(MavlinkDirect::MavlinkMess
 MavlinkDirect::MessageHandle MavlinkDirectImpl::subscribe_message(
     std::string message_name, const MavlinkDirect::MessageCallback& callback)
 {
-    // filtering_callback is called synchronously on the I/O thread (via _callbacks()/exec()
-    // in init()).  It captures 'this' only to reach call_user_callback, and is never
-    // enqueued anywhere — so there is no lifetime issue.  deinit() calls _callbacks.clear()
-    // before unregistering the system handler, which blocks until any in-flight exec()
-    // completes; after that, filtering_callback will never be called again.
-    auto filtering_callback =
-        [this, message_name, callback](const MavlinkDirect::MavlinkMessage& message) {
-            if (!message_name.empty() && message_name != message.message_name) {
-                return;
-            }
-            _system_impl->call_user_callback([callback, message]() { callback(message); });
-        };
-
-    // Subscribe to internal CallbackList and return handle directly
-    return _callbacks.subscribe(filtering_callback);
+    // The system filters by message name (empty means all messages) and calls this on the
+    // io thread. It captures 'this' only to reach call_user_callback; deinit() unregisters
+    // it (blocking) before this object goes away.
+    auto system_subscription = _system_impl->register_libmav_message_handler(
+        message_name, [this, callback](const Mavsdk::MavlinkMessage& message) {
+            _system_impl->call_user_callback(
+                [callback, mavlink_direct_message = to_mavlink_direct_message(message)]() {
+                    callback(mavlink_direct_message);
+                });
+        });
+
+    std::lock_guard<std::mutex> lock(_subscriptions_mutex);
+    auto handle = _handle_factory.create();
+    _subscriptions.emplace(handle, system_subscription);
+    return handle;
 }
 
 void MavlinkDirectImpl::unsubscribe_message(MavlinkDirect::MessageHandle handle)
 {
-    // Unregister from internal CallbackList directly
-    _callbacks.unsubscribe(handle);
+    Handle<Mavsdk::MavlinkMessage> system_subscription{};
+    {
+        std::lock_guard<std::mutex> lock(_subscriptions_mutex);
+        auto it = _subscriptions.find(handle);
+        if (it == _subscriptions.end()) {
+            return;
+        }
+        system_subscription = it->second;
+        _subscriptions.erase(it);
+    }
+
+    _system_impl->unregister_libmav_message_handler(system_subscription);
 }
 
 MavlinkDirect::Result MavlinkDirectImpl::load_custom_xml(const std::string& xml_content)
@@ -3,7 +3,10 @@
 #include "plugins/mavlink_direct/mavlink_direct.hpp"
 
 #include "plugin_impl_base.hpp"
-#include "callback_list.hpp"
+#include "handle_factory.hpp"
+
+#include <map>
+#include <mutex>
 
 namespace mavsdk {
 
@@ -30,9 +33,11 @@ public:
     MavlinkDirect::Result load_custom_xml(const std::string& xml_content);
 
 private:
-    // Internal callback management
-    CallbackList<MavlinkDirect::MavlinkMessage> _callbacks{_system_impl->io_context()};
-    Handle<Mavsdk::MavlinkMessage> _system_subscription{};
+    // Each user subscription is registered with the system under its own message name, so
+    // that only messages somebody asked for get decoded and converted to JSON.
+    std::mutex _subscriptions_mutex{};
+    HandleFactory<MavlinkDirect::MavlinkMessage> _handle_factory{};
+    std::map<MavlinkDirect::MessageHandle, Handle<Mavsdk::MavlinkMessage>> _subscriptions{};
 
     bool _debugging = false;
 
@@ -2,8 +2,6 @@
 
 #include "libmav_conversions.hpp"
 #include "log.hpp"
-#include "callback_list.tpp"
-#include "mavsdk_export.h"
 
 #include <mav/Message.h>
 #include <mav/MessageSet.h>
@@ -12,7 +10,22 @@
 
 namespace mavsdk {
 
-template class MAVSDK_TEMPL_INST CallbackList<MavlinkDirectServer::MavlinkMessage>;
+namespace {
+
+MavlinkDirectServer::MavlinkMessage
+to_mavlink_direct_server_message(const Mavsdk::MavlinkMessage& message)
+{
+    MavlinkDirectServer::MavlinkMessage mavlink_direct_message;
+    mavlink_direct_message.message_name = message.message_name;
+    mavlink_direct_message.system_id = message.system_id;
+    mavlink_direct_message.component_id = message.component_id;
+    mavlink_direct_message.target_system_id = message.target_system_id;
+    mavlink_direct_message.target_component_id = message.target_component_id;
+    mavlink_direct_message.fields_json = message.fields_json;
+    return mavlink_direct_message;
+}
+
+} // namespace
 
 MavlinkDirectServerImpl::MavlinkDirectServerImpl(
     std::shared_ptr<ServerComponent> server_component) :
@@ -33,34 +46,23 @@ MavlinkDirectServerImpl::~MavlinkDirectServerImpl()
 
 void MavlinkDirectServerImpl::init()
 {
-    // Subscribe to all incoming messages and distribute to our internal CallbackList.
-    _server_subscription = _server_component_impl->register_libmav_message_handler(
-        "", // Empty string means all messages
-        [this](const Mavsdk::MavlinkMessage& message) {
-            MavlinkDirectServer::MavlinkMessage mavlink_direct_message;
-            mavlink_direct_message.message_name = message.message_name;
-            mavlink_direct_message.system_id = message.system_id;
-            mavlink_direct_message.component_id = message.component_id;
-            mavlink_direct_message.target_system_id = message.target_system_id;
-            mavlink_direct_message.target_component_id = message.target_component_id;
-            mavlink_direct_message.fields_json = message.fields_json;
-
-            _callbacks(mavlink_direct_message);
-        });
+    // Nothing to do: handlers are registered per subscription.
 }
 
 void MavlinkDirectServerImpl::deinit()
 {
-    // Stop dispatching to our own subscribers.
-    _callbacks.clear();
+    std::map<MavlinkDirectServer::MessageHandle, Handle<Mavsdk::MavlinkMessage>> subscriptions;
+    {
+        std::lock_guard<std::mutex> lock(_subscriptions_mutex);
+        subscriptions.swap(_subscriptions);
+    }
 
     // Unregister from the server component BEFORE this object is destroyed. The registered
-    // callback captures 'this' and reaches into _callbacks on the io thread;
-    // unregister_libmav_message_handler() is blocking, so once it returns the io thread can
-    // no longer invoke it against a freed MavlinkDirectServerImpl (see MavlinkDirectImpl).
-    if (_server_subscription.valid()) {
-        _server_component_impl->unregister_libmav_message_handler(_server_subscription);
-        _server_subscription = {};
+    // callbacks capture 'this' and run on the io thread; unregister_libmav_message_handler()
+    // is blocking, so once it returns the io thread can no longer invoke them against a
+    // freed MavlinkDirectServerImpl (see MavlinkDirectImpl).
+    for (const auto& subscription : subscriptions) {
+        _server_component_impl->unregister_libmav_message_handler(subscription.second);
     }
 }
 
@@ -136,20 +138,34 @@ MavlinkDirectServerImpl::send_message(MavlinkDirectServer::MavlinkMessage messag
 MavlinkDirectServer::MessageHandle MavlinkDirectServerImpl::subscribe_message(
     std::string message_name, const MavlinkDirectServer::MessageCallback& callback)
 {
-    auto filtering_callback = [this, message_name, callback](
-                                  const MavlinkDirectServer::MavlinkMessage& message) {
-        if (!message_name.empty() && message_name != message.message_name) {
-            return;
-        }
-        _server_component_impl->call_user_callback([callback, message]() { callback(message); });
-    };
+    auto server_subscription = _server_component_impl->register_libmav_message_handler(
+        message_name, [this, callback](const Mavsdk::MavlinkMessage& message) {
+            _server_component_impl->call_user_callback(
+                [callback, mavlink_direct_message = to_mavlink_direct_server_message(message)]() {
+                    callback(mavlink_direct_message);
+                });
+        });
 
-    return _callbacks.subscribe(filtering_callback);
+    std::lock_guard<std::mutex> lock(_subscriptions_mutex);
+    auto handle = _handle_factory.create();
+    _subscriptions.emplace(handle, server_subscription);
+    return handle;
 }
 
 void MavlinkDirectServerImpl::unsubscribe_message(MavlinkDirectServer::MessageHandle handle)
 {
-    _callbacks.unsubscribe(handle);
+    Handle<Mavsdk::MavlinkMessage> server_subscription{};
+    {
+        std::lock_guard<std::mutex> lock(_subscriptions_mutex);
+        auto it = _subscriptions.find(handle);
+        if (it == _subscriptions.end()) {
+            return;
+        }
+        server_subscription = it->second;
+        _subscriptions.erase(it);
+    }
+
+    _server_component_impl->unregister_libmav_message_handler(server_subscription);
 }
 
 MavlinkDirectServer::Result MavlinkDirectServerImpl::load_custom_xml(std::string xml_content)
@@ -3,7 +3,10 @@
 #include "plugins/mavlink_direct_server/mavlink_direct_server.hpp"
 
 #include "server_plugin_impl_base.hpp"
-#include "callback_list.hpp"
+#include "handle_factory.hpp"
+
+#include <map>
+#include <mutex>
 
 namespace mavsdk {
 
@@ -26,10 +29,12 @@ public:
     MavlinkDirectServer::Result load_custom_xml(std::string xml_content);
 
 private:
-    // Internal callback management
-    CallbackList<MavlinkDirectServer::MavlinkMessage> _callbacks{
-        _server_component_impl->io_context()};
-    Handle<Mavsdk::MavlinkMessage> _server_subscription{};
+    // Each user subscription is registered with the server component under its own message
+    // name, so that only messages somebody asked for get decoded (see MavlinkDirectImpl).
+    std::mutex _subscriptions_mutex{};
+    HandleFactory<MavlinkDirectServer::MavlinkMessage> _handle_factory{};
+    std::map<MavlinkDirectServer::MessageHandle, Handle<Mavsdk::MavlinkMessage>>
+        _subscriptions{};
 
     bool _debugging = false;
 };
@@ -930,6 +930,18 @@ void TelemetryImpl::process_wind(const mavlink_message_t& message)
 }
 
 void TelemetryImpl::process_imu_reading_ned(const mavlink_message_t& message)
+{
+    _imu_reading_ned.store(message);
+
+    if (_imu_reading_ned_subscriptions.empty()) {
+        return;
+    }
+
+    _imu_reading_ned_subscriptions.queue(
+        imu(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+}
+
+Telemetry::Imu TelemetryImpl::decode_imu_reading_ned(const mavlink_message_t& message)
 {
     mavlink_highres_imu_t highres_imu;
     mavlink_msg_highres_imu_decode(&message, &highres_imu);
@@ -946,13 +958,22 @@ void TelemetryImpl::process_imu_reading_ned(const mavlink_message_t& message)
     new_imu.temperature_degc = highres_imu.temperature;
     new_imu.timestamp_us = highres_imu.time_usec;
 
-    set_imu_reading_ned(new_imu);
-
-    _imu_reading_ned_subscriptions.queue(
-        imu(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    return new_imu;
 }
 
 void TelemetryImpl::process_scaled_imu(const mavlink_message_t& message)
+{
+    _scaled_imu.store(message);
+
+    if (_scaled_imu_subscriptions.empty()) {
+        return;
+    }
+
+    _scaled_imu_subscriptions.queue(
+        scaled_imu(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+}
+
+Telemetry::Imu TelemetryImpl::decode_scaled_imu(const mavlink_message_t& message)
 {
     mavlink_scaled_imu_t scaled_imu_reading;
     mavlink_msg_scaled_imu_decode(&message, &scaled_imu_reading);
@@ -972,13 +993,22 @@ void TelemetryImpl::process_scaled_imu(const mavlink_message_t& message)
     new_imu.temperature_degc = static_cast<float>(scaled_imu_reading.temperature) * 1e-2f;
     new_imu.timestamp_us = static_cast<uint64_t>(scaled_imu_reading.time_boot_ms) * 1000;
 
-    set_scaled_imu(new_imu);
-
-    _scaled_imu_subscriptions.queue(
-        scaled_imu(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    return new_imu;
 }
 
 void TelemetryImpl::process_raw_imu(const mavlink_message_t& message)
+{
+    _raw_imu.store(message);
+
+    if (_raw_imu_subscriptions.empty()) {
+        return;
+    }
+
+    _raw_imu_subscriptions.queue(
+        raw_imu(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+}
+
+Telemetry::Imu TelemetryImpl::decode_raw_imu(const mavlink_message_t& message)
 {
     mavlink_raw_imu_t raw_imu_reading;
     mavlink_msg_raw_imu_decode(&message, &raw_imu_reading);
@@ -995,10 +1025,7 @@ void TelemetryImpl::process_raw_imu(const mavlink_message_t& message)
     new_imu.temperature_degc = static_cast<float>(raw_imu_reading.temperature) * 1e-2f;
     new_imu.timestamp_us = raw_imu_reading.time_usec;
 
-    set_raw_imu(new_imu);
-
-    _raw_imu_subscriptions.queue(
-        raw_imu(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    return new_imu;
 }
 
 void TelemetryImpl::process_gps_raw_int(const mavlink_message_t& message)
@@ -1067,6 +1094,18 @@ void TelemetryImpl::process_gps_raw_int(const mavlink_message_t& message)
 }
 
 void TelemetryImpl::process_ground_truth(const mavlink_message_t& message)
+{
+    _ground_truth.store(message);
+
+    if (_ground_truth_subscriptions.empty()) {
+        return;
+    }
+
+    _ground_truth_subscriptions.queue(
+        ground_truth(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+}
+
+Telemetry::GroundTruth TelemetryImpl::decode_ground_truth(const mavlink_message_t& message)
 {
     mavlink_hil_state_quaternion_t hil_state_quaternion;
     mavlink_msg_hil_state_quaternion_decode(&message, &hil_state_quaternion);
@@ -1077,10 +1116,7 @@ void TelemetryImpl::process_ground_truth(const mavlink_message_t& message)
     new_ground_truth.absolute_altitude_m = hil_state_quaternion.alt * 1e-3f;
     new_ground_truth.timestamp_us = hil_state_quaternion.time_usec;
 
-    set_ground_truth(new_ground_truth);
-
-    _ground_truth_subscriptions.queue(
-        ground_truth(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    return new_ground_truth;
 }
 
 void TelemetryImpl::process_extended_sys_state(const mavlink_message_t& message)
@@ -1115,6 +1151,19 @@ void TelemetryImpl::process_extended_sys_state(const mavlink_message_t& message)
         in_air(), [this](const auto& func) { _system_impl->call_user_callback(func); });
 }
 void TelemetryImpl::process_fixedwing_metrics(const mavlink_message_t& message)
+{
+    _fixedwing_metrics.store(message);
+
+    if (_fixedwing_metrics_subscriptions.empty()) {
+        return;
+    }
+
+    _fixedwing_metrics_subscriptions.queue(
+        fixedwing_metrics(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+}
+
+Telemetry::FixedwingMetrics
+TelemetryImpl::decode_fixedwing_metrics(const mavlink_message_t& message)
 {
     mavlink_vfr_hud_t vfr_hud;
     mavlink_msg_vfr_hud_decode(&message, &vfr_hud);
@@ -1127,10 +1176,7 @@ void TelemetryImpl::process_fixedwing_metrics(const mavlink_message_t& message)
     new_fixedwing_metrics.absolute_altitude_m = vfr_hud.alt;
     new_fixedwing_metrics.climb_rate_m_s = vfr_hud.climb;
 
-    set_fixedwing_metrics(new_fixedwing_metrics);
-
-    _fixedwing_metrics_subscriptions.queue(
-        fixedwing_metrics(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    return new_fixedwing_metrics;
 }
 
 void TelemetryImpl::process_sys_status(const mavlink_message_t& message)
@@ -1362,58 +1408,99 @@ void TelemetryImpl::process_rc_channels(const mavlink_message_t& message)
 
 void TelemetryImpl::process_unix_epoch_time(const mavlink_message_t& message)
 {
-    mavlink_system_time_t system_time;
-    mavlink_msg_system_time_decode(&message, &system_time);
+    _unix_epoch_time_us.store(message);
 
-    set_unix_epoch_time_us(system_time.time_unix_usec);
+    if (_unix_epoch_time_subscriptions.empty()) {
+        return;
+    }
 
     _unix_epoch_time_subscriptions.queue(
         unix_epoch_time(), [this](const auto& func) { _system_impl->call_user_callback(func); });
 }
 
+uint64_t TelemetryImpl::decode_unix_epoch_time(const mavlink_message_t& message)
+{
+    mavlink_system_time_t system_time;
+    mavlink_msg_system_time_decode(&message, &system_time);
+
+    return system_time.time_unix_usec;
+}
+
 void TelemetryImpl::process_actuator_control_target(const mavlink_message_t& message)
+{
+    _actuator_control_target.store(message);
+
+    if (_actuator_control_target_subscriptions.empty()) {
+        return;
+    }
+
+    _actuator_control_target_subscriptions.queue(
+        actuator_control_target(),
+        [this](const auto& func) { _system_impl->call_user_callback(func); });
+}
+
+Telemetry::ActuatorControlTarget
+TelemetryImpl::decode_actuator_control_target(const mavlink_message_t& message)
 {
     mavlink_set_actuator_control_target_t target;
     mavlink_msg_set_actuator_control_target_decode(&message, &target);
 
-    uint32_t group = target.group_mlx;
-    std::vector<float> controls;
+    Telemetry::ActuatorControlTarget actuator_control_target;
+    actuator_control_target.group = target.group_mlx;
 
     const unsigned control_size = sizeof(target.controls) / sizeof(target.controls[0]);
     // Can't use std::copy because target is packed.
     for (std::size_t i = 0; i < control_size; ++i) {
-        controls.push_back(target.controls[i]);
+        actuator_control_target.controls.push_back(target.controls[i]);
     }
 
-    set_actuator_control_target(group, controls);
-
-    _actuator_control_target_subscriptions.queue(
-        actuator_control_target(),
-        [this](const auto& func) { _system_impl->call_user_callback(func); });
+    return actuator_control_target;
 }
 
 void TelemetryImpl::process_actuator_output_status(const mavlink_message_t& message)
+{
+    _actuator_output_status.store(message);
+
+    if (_actuator_output_status_subscriptions.empty()) {
+        return;
+    }
+
+    _actuator_output_status_subscriptions.queue(actuator_output_status(), [this](const auto& func) {
+        _system_impl->call_user_callback(func);
+    });
+}
+
+Telemetry::ActuatorOutputStatus
+TelemetryImpl::decode_actuator_output_status(const mavlink_message_t& message)
 {
     mavlink_actuator_output_status_t status;
     mavlink_msg_actuator_output_status_decode(&message, &status);
 
-    uint32_t active = status.active;
-    std::vector<float> actuators;
+    Telemetry::ActuatorOutputStatus actuator_output_status;
+    actuator_output_status.active = status.active;
 
     const unsigned actuators_size = sizeof(status.actuator) / sizeof(status.actuator[0]);
     // Can't use std::copy because status is packed.
     for (std::size_t i = 0; i < actuators_size; ++i) {
-        actuators.push_back(status.actuator[i]);
+        actuator_output_status.actuator.push_back(status.actuator[i]);
     }
 
-    set_actuator_output_status(active, actuators);
-
-    _actuator_output_status_subscriptions.queue(actuator_output_status(), [this](const auto& func) {
-        _system_impl->call_user_callback(func);
-    });
+    return actuator_output_status;
 }
 
 void TelemetryImpl::process_odometry(const mavlink_message_t& message)
+{
+    _odometry.store(message);
+
+    if (_odometry_subscriptions.empty()) {
+        return;
+    }
+
+    _odometry_subscriptions.queue(
+        odometry(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+}
+
+Telemetry::Odometry TelemetryImpl::decode_odometry(const mavlink_message_t& message)
 {
     mavlink_odometry_t odometry_msg;
     mavlink_msg_odometry_decode(&message, &odometry_msg);
@@ -1456,13 +1543,22 @@ void TelemetryImpl::process_odometry(const mavlink_message_t& message)
             odometry_msg.velocity_covariance[i]);
     }
 
-    set_odometry(odometry_struct);
-
-    _odometry_subscriptions.queue(
-        odometry(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    return odometry_struct;
 }
 
 void TelemetryImpl::process_distance_sensor(const mavlink_message_t& message)
+{
+    _distance_sensor.store(message);
+
+    if (_distance_sensor_subscriptions.empty()) {
+        return;
+    }
+
+    _distance_sensor_subscriptions.queue(
+        distance_sensor(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+}
+
+Telemetry::DistanceSensor TelemetryImpl::decode_distance_sensor(const mavlink_message_t& message)
 {
     mavlink_distance_sensor_t distance_sensor_msg;
     mavlink_msg_distance_sensor_decode(&message, &distance_sensor_msg);
@@ -1477,10 +1573,7 @@ void TelemetryImpl::process_distance_sensor(const mavlink_message_t& message)
         static_cast<float>(distance_sensor_msg.current_distance) * 1e-2f; // cm to m
     distance_sensor_struct.orientation = extractOrientation(distance_sensor_msg);
 
-    set_distance_sensor(distance_sensor_struct);
-
-    _distance_sensor_subscriptions.queue(
-        distance_sensor(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    return distance_sensor_struct;
 }
 
 Telemetry::EulerAngle
@@ -1694,6 +1787,18 @@ TelemetryImpl::extractOrientation(mavlink_distance_sensor_t distance_sensor_msg)
 }
 
 void TelemetryImpl::process_scaled_pressure(const mavlink_message_t& message)
+{
+    _scaled_pressure.store(message);
+
+    if (_scaled_pressure_subscriptions.empty()) {
+        return;
+    }
+
+    _scaled_pressure_subscriptions.queue(
+        scaled_pressure(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+}
+
+Telemetry::ScaledPressure TelemetryImpl::decode_scaled_pressure(const mavlink_message_t& message)
 {
     mavlink_scaled_pressure_t scaled_pressure_msg;
     mavlink_msg_scaled_pressure_decode(&message, &scaled_pressure_msg);
@@ -1709,10 +1814,7 @@ void TelemetryImpl::process_scaled_pressure(const mavlink_message_t& message)
     scaled_pressure_struct.differential_pressure_temperature_deg =
         static_cast<float>(scaled_pressure_msg.temperature_press_diff) * 1e-2f;
 
-    set_scaled_pressure(scaled_pressure_struct);
-
-    _scaled_pressure_subscriptions.queue(
-        scaled_pressure(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    return scaled_pressure_struct;
 }
 
 Telemetry::LandedState
@@ -1903,13 +2005,13 @@ Telemetry::AngularVelocityBody TelemetryImpl::attitude_angular_velocity_body() c
 Telemetry::GroundTruth TelemetryImpl::ground_truth() const
 {
     std::lock_guard<std::mutex> lock(_ground_truth_mutex);
-    return _ground_truth;
+    return _ground_truth.get(decode_ground_truth);
 }
 
 Telemetry::FixedwingMetrics TelemetryImpl::fixedwing_metrics() const
 {
     std::lock_guard<std::mutex> lock(_fixedwing_metrics_mutex);
-    return _fixedwing_metrics;
+    return _fixedwing_metrics.get(decode_fixedwing_metrics);
 }
 
 Telemetry::EulerAngle TelemetryImpl::attitude_euler() const
@@ -1937,18 +2039,6 @@ void TelemetryImpl::set_attitude_angular_velocity_body(
     _attitude_angular_velocity_body = angular_velocity_body;
 }
 
-void TelemetryImpl::set_ground_truth(Telemetry::GroundTruth ground_truth)
-{
-    std::lock_guard<std::mutex> lock(_ground_truth_mutex);
-    _ground_truth = ground_truth;
-}
-
-void TelemetryImpl::set_fixedwing_metrics(Telemetry::FixedwingMetrics fixedwing_metrics)
-{
-    std::lock_guard<std::mutex> lock(_fixedwing_metrics_mutex);
-    _fixedwing_metrics = fixedwing_metrics;
-}
-
 Telemetry::VelocityNed TelemetryImpl::velocity_ned() const
 {
     std::lock_guard<std::mutex> lock(_velocity_ned_mutex);
@@ -1964,37 +2054,19 @@ void TelemetryImpl::set_velocity_ned(Telemetry::VelocityNed velocity_ned)
 Telemetry::Imu TelemetryImpl::imu() const
 {
     std::lock_guard<std::mutex> lock(_imu_reading_ned_mutex);
-    return _imu_reading_ned;
-}
-
-void TelemetryImpl::set_imu_reading_ned(Telemetry::Imu imu_reading_ned)
-{
-    std::lock_guard<std::mutex> lock(_imu_reading_ned_mutex);
-    _imu_reading_ned = imu_reading_ned;
+    return _imu_reading_ned.get(decode_imu_reading_ned);
 }
 
 Telemetry::Imu TelemetryImpl::scaled_imu() const
 {
     std::lock_guard<std::mutex> lock(_scaled_imu_mutex);
-    return _scaled_imu;
-}
-
-void TelemetryImpl::set_scaled_imu(Telemetry::Imu scaled_imu)
-{
-    std::lock_guard<std::mutex> lock(_scaled_imu_mutex);
-    _scaled_imu = scaled_imu;
+    return _scaled_imu.get(decode_scaled_imu);
 }
 
 Telemetry::Imu TelemetryImpl::raw_imu() const
 {
     std::lock_guard<std::mutex> lock(_raw_imu_mutex);
-    return _raw_imu;
-}
-
-void TelemetryImpl::set_raw_imu(Telemetry::Imu raw_imu)
-{
-    std::lock_guard<std::mutex> lock(_raw_imu_mutex);
-    _raw_imu = raw_imu;
+    return _raw_imu.get(decode_raw_imu);
 }
 
 Telemetry::GpsInfo TelemetryImpl::gps_info() const
@@ -2065,37 +2137,37 @@ Telemetry::RcStatus TelemetryImpl::rc_status() const
 uint64_t TelemetryImpl::unix_epoch_time() const
 {
     std::lock_guard<std::mutex> lock(_unix_epoch_time_mutex);
-    return _unix_epoch_time_us;
+    return _unix_epoch_time_us.get(decode_unix_epoch_time);
 }
 
 Telemetry::ActuatorControlTarget TelemetryImpl::actuator_control_target() const
 {
     std::lock_guard<std::mutex> lock(_actuator_control_target_mutex);
-    return _actuator_control_target;
+    return _actuator_control_target.get(decode_actuator_control_target);
 }
 
 Telemetry::ActuatorOutputStatus TelemetryImpl::actuator_output_status() const
 {
     std::lock_guard<std::mutex> lock(_actuator_output_status_mutex);
-    return _actuator_output_status;
+    return _actuator_output_status.get(decode_actuator_output_status);
 }
 
 Telemetry::Odometry TelemetryImpl::odometry() const
 {
     std::lock_guard<std::mutex> lock(_odometry_mutex);
-    return _odometry;
+    return _odometry.get(decode_odometry);
 }
 
 Telemetry::DistanceSensor TelemetryImpl::distance_sensor() const
 {
     std::lock_guard<std::mutex> lock(_distance_sensor_mutex);
-    return _distance_sensor;
+    return _distance_sensor.get(decode_distance_sensor);
 }
 
 Telemetry::ScaledPressure TelemetryImpl::scaled_pressure() const
 {
     std::lock_guard<std::mutex> lock(_scaled_pressure_mutex);
-    return _scaled_pressure;
+    return _scaled_pressure.get(decode_scaled_pressure);
 }
 
 void TelemetryImpl::set_health_local_position(bool ok)
@@ -2181,44 +2253,6 @@ void TelemetryImpl::set_rc_status(
     }
 }
 
-void TelemetryImpl::set_unix_epoch_time_us(uint64_t time_us)
-{
-    std::lock_guard<std::mutex> lock(_unix_epoch_time_mutex);
-    _unix_epoch_time_us = time_us;
-}
-
-void TelemetryImpl::set_actuator_control_target(uint8_t group, const std::vector<float>& controls)
-{
-    std::lock_guard<std::mutex> lock(_actuator_control_target_mutex);
-    _actuator_control_target.group = group;
-    _actuator_control_target.controls = controls;
-}
-
-void TelemetryImpl::set_actuator_output_status(uint32_t active, const std::vector<float>& actuators)
-{
-    std::lock_guard<std::mutex> lock(_actuator_output_status_mutex);
-    _actuator_output_status.active = active;
-    _actuator_output_status.actuator = actuators;
-}
-
-void TelemetryImpl::set_odometry(Telemetry::Odometry& odometry)
-{
-    std::lock_guard<std::mutex> lock(_odometry_mutex);
-    _odometry = odometry;
-}
-
-void TelemetryImpl::set_distance_sensor(Telemetry::DistanceSensor& distance_sensor)
-{
-    std::lock_guard<std::mutex> lock(_distance_sensor_mutex);
-    _distance_sensor = distance_sensor;
-}
-
-void TelemetryImpl::set_scaled_pressure(Telemetry::ScaledPressure& scaled_pressure)
-{
-    std::lock_guard<std::mutex> lock(_scaled_pressure_mutex);
-    _scaled_pressure = scaled_pressure;
-}
-
 Telemetry::PositionVelocityNedHandle TelemetryImpl::subscribe_position_velocity_ned(
     const Telemetry::PositionVelocityNedCallback& callback)
 {
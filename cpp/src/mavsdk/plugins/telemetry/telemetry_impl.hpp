@@ -9,6 +9,7 @@
 #include "plugin_impl_base.hpp"
 #include "system.hpp"
 #include "callback_list.hpp"
+#include "latest_message_slot.hpp"
 
 namespace mavsdk {
 
@@ -216,12 +217,7 @@ private:
     void set_attitude_quaternion(Telemetry::Quaternion quaternion);
     void set_attitude_euler(Telemetry::EulerAngle euler);
     void set_attitude_angular_velocity_body(Telemetry::AngularVelocityBody angular_velocity_body);
-    void set_fixedwing_metrics(Telemetry::FixedwingMetrics fixedwing_metrics);
-    void set_ground_truth(Telemetry::GroundTruth ground_truth);
     void set_velocity_ned(Telemetry::VelocityNed velocity_ned);
-    void set_imu_reading_ned(Telemetry::Imu imu);
-    void set_scaled_imu(Telemetry::Imu imu);
-    void set_raw_imu(Telemetry::Imu imu);
     void set_gps_info(Telemetry::GpsInfo gps_info);
     void set_raw_gps(Telemetry::RawGps raw_gps);
     void set_battery(Telemetry::Battery battery);
@@ -233,12 +229,6 @@ private:
     void set_health_magnetometer_calibration(bool ok);
     void set_health_armable(bool ok);
     void set_rc_status(std::optional<bool> available, std::optional<float> signal_strength_percent);
-    void set_unix_epoch_time_us(uint64_t time_us);
-    void set_actuator_control_target(uint8_t group, const std::vector<float>& controls);
-    void set_actuator_output_status(uint32_t active, const std::vector<float>& actuators);
-    void set_odometry(Telemetry::Odometry& odometry);
-    void set_distance_sensor(Telemetry::DistanceSensor& distance_sensor);
-    void set_scaled_pressure(Telemetry::ScaledPressure& scaled_pressure);
     void set_heading(Telemetry::Heading heading);
     void set_altitude(Telemetry::Altitude altitude);
     void set_wind(Telemetry::Wind wind);
@@ -268,6 +258,20 @@ private:
     void process_altitude(const mavlink_message_t& message);
     void process_wind(const mavlink_message_t& message);
 
+    static Telemetry::Imu decode_imu_reading_ned(const mavlink_message_t& message);
+    static Telemetry::Imu decode_scaled_imu(const mavlink_message_t& message);
+    static Telemetry::Imu decode_raw_imu(const mavlink_message_t& message);
+    static Telemetry::GroundTruth decode_ground_truth(const mavlink_message_t& message);
+    static Telemetry::FixedwingMetrics decode_fixedwing_metrics(const mavlink_message_t& message);
+    static uint64_t decode_unix_epoch_time(const mavlink_message_t& message);
+    static Telemetry::ActuatorControlTarget
+    decode_actuator_control_target(const mavlink_message_t& message);
+    static Telemetry::ActuatorOutputStatus
+    decode_actuator_output_status(const mavlink_message_t& message);
+    static Telemetry::Odometry decode_odometry(const mavlink_message_t& message);
+    static Telemetry::DistanceSensor decode_distance_sensor(const mavlink_message_t& message);
+    static Telemetry::ScaledPressure decode_scaled_pressure(const mavlink_message_t& message);
+
     void receive_statustext(const MavlinkStatustextHandler::Statustext&);
 
     void request_home_position_again();
@@ -317,23 +321,26 @@ private:
     mutable std::mutex _attitude_angular_velocity_body_mutex{};
     Telemetry::AngularVelocityBody _attitude_angular_velocity_body{};
 
+    // The LazilyDecoded fields keep the latest message as received, and their getters only
+    // decode it when polled or when there are subscribers to queue it to. Their mutexes
+    // serialize the getters.
     mutable std::mutex _ground_truth_mutex{};
-    Telemetry::GroundTruth _ground_truth{};
+    mutable LazilyDecoded<Telemetry::GroundTruth> _ground_truth{};
 
     mutable std::mutex _fixedwing_metrics_mutex{};
-    Telemetry::FixedwingMetrics _fixedwing_metrics{};
+    mutable LazilyDecoded<Telemetry::FixedwingMetrics> _fixedwing_metrics{};
 
     mutable std::mutex _velocity_ned_mutex{};
     Telemetry::VelocityNed _velocity_ned{};
 
     mutable std::mutex _imu_reading_ned_mutex{};
-    Telemetry::Imu _imu_reading_ned{};
+    mutable LazilyDecoded<Telemetry::Imu> _imu_reading_ned{};
 
     mutable std::mutex _scaled_imu_mutex{};
-    Telemetry::Imu _scaled_imu{};
+    mutable LazilyDecoded<Telemetry::Imu> _scaled_imu{};
 
     mutable std::mutex _raw_imu_mutex{};
-    Telemetry::Imu _raw_imu{};
+    mutable LazilyDecoded<Telemetry::Imu> _raw_imu{};
 
     mutable std::mutex _gps_info_mutex{};
     Telemetry::GpsInfo _gps_info{};
@@ -357,22 +364,22 @@ private:
     Telemetry::RcStatus _rc_status{};
 
     mutable std::mutex _unix_epoch_time_mutex{};
-    uint64_t _unix_epoch_time_us{};
+    mutable LazilyDecoded<uint64_t> _unix_epoch_time_us{};
 
     mutable std::mutex _actuator_control_target_mutex{};
-    Telemetry::ActuatorControlTarget _actuator_control_target{};
+    mutable LazilyDecoded<Telemetry::ActuatorControlTarget> _actuator_control_target{};
 
     mutable std::mutex _actuator_output_status_mutex{};
-    Telemetry::ActuatorOutputStatus _actuator_output_status{};
+    mutable LazilyDecoded<Telemetry::ActuatorOutputStatus> _actuator_output_status{};
 
     mutable std::mutex _odometry_mutex{};
-    Telemetry::Odometry _odometry{};
+    mutable LazilyDecoded<Telemetry::Odometry> _odometry{};
 
     mutable std::mutex _distance_sensor_mutex{};
-    Telemetry::DistanceSensor _distance_sensor{};
+    mutable LazilyDecoded<Telemetry::DistanceSensor> _distance_sensor{};
 
     mutable std::mutex _scaled_pressure_mutex{};
-    Telemetry::ScaledPressure _scaled_pressure{};
+    mutable LazilyDecoded<Telemetry::ScaledPressure> _scaled_pressure{};
 
     mutable std::mutex _altitude_mutex{};
     Telemetry::Altitude _altitude{};
@@ -442,7 +449,7 @@ private:
 
     CallEveryHandler::Cookie _homepos_cookie{};
 
-    Telemetry::EulerAngle extractOrientation(mavlink_distance_sensor_t distance_sensor_msg);
+    static Telemetry::EulerAngle extractOrientation(mavlink_distance_sensor_t distance_sensor_msg);
 
     enum class MavSensorOrientation {
         MAV_SENSOR_ROTATION_NONE = 0, // Roll: 0, Pitch: 0, Yaw: 0